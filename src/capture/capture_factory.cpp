@@ -0,0 +1,25 @@
+#include "capture_interface.hpp"
+#include "dxgi_capture.hpp"
+#include "nvfbc_capture.hpp"
+#include "replay_capture.hpp"
+
+namespace capture {
+
+std::unique_ptr<CaptureInterface> createCapture(const std::string& method,
+                                                const core::CaptureConfig& config) {
+    if (method == "dxgi") {
+        return std::make_unique<DXGICapture>(config.cuda_interop
+            ? DXGICapture::Mode::CudaInterop
+            : DXGICapture::Mode::Staging);
+    }
+    if (method == "nvfbc") {
+        return std::make_unique<NvFBCCapture>(config);
+    }
+    if (method == "replay") {
+        return std::make_unique<ReplayCapture>(config);
+    }
+    // Add other capture methods here
+    return nullptr;
+}
+
+} // namespace capture
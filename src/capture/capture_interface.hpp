@@ -1,10 +1,22 @@
 #pragma once
 
+#include "../core/types.hpp"
+#include <cuda_runtime_api.h>
 #include <memory>
+#include <string>
 #include <cstdint>
 
 namespace capture {
 
+// Where Frame::data lives
+enum class FrameMemory : uint8_t {
+    Host,   // System memory (staging map, replay file, ...)
+    Device  // CUDA device memory, row pitch given by stride
+};
+
+// A frame passed to captureFrame with memory == Device and data set is a
+// caller-owned target (e.g. a FrameBuffer slot): backends write into it and
+// record ready_event on their stream instead of returning their own storage.
 struct Frame {
     uint8_t* data;
     uint32_t width;
@@ -12,6 +24,10 @@ struct Frame {
     uint32_t stride;
     uint64_t timestamp_ns;
     uint32_t frame_id;
+    FrameMemory memory{FrameMemory::Host};
+    cudaEvent_t ready_event{nullptr};  // Device frames: recorded once data is valid
+    uint64_t published_ns{0};          // Capture thread handed the slot to the ring
+    uint64_t source_timestamp_ns{0};   // Replay: original capture time (0 for live frames)
 };
 
 class CaptureInterface {
@@ -23,12 +39,19 @@ public:
     virtual bool stop() = 0;
     virtual bool captureFrame(Frame& frame) = 0;
     virtual void releaseFrame(Frame& frame) = 0;
-    
+
     virtual uint32_t getWidth() const = 0;
     virtual uint32_t getHeight() const = 0;
     virtual uint32_t getFrameRate() const = 0;
+
+    // Stream the backend writes device frames on (nullptr: legacy stream)
+    virtual cudaStream_t getStream() const { return nullptr; }
+
+    // Finite sources (replay) report when no further frame will come
+    virtual bool isExhausted() const { return false; }
 };
 
-std::unique_ptr<CaptureInterface> createCapture(const std::string& method);
+std::unique_ptr<CaptureInterface> createCapture(const std::string& method,
+                                                const core::CaptureConfig& config = {});
 
 } // namespace capture
@@ -1,31 +1,67 @@
 #include "dxgi_capture.hpp"
+#include "../utils/gpu_memory_pool.hpp"
 #include "../utils/logger.hpp"
+#include <chrono>
+
+#ifdef _WIN32
+#include <d3d11.h>
+#include <dxgi1_2.h>
+#include <cuda_d3d11_interop.h>
+#endif
 
 namespace capture {
 
-DXGICapture::DXGICapture() {
+#ifdef _WIN32
+namespace {
+
+template<typename T>
+void safeRelease(void*& handle) {
+    if (handle) {
+        static_cast<T*>(handle)->Release();
+        handle = nullptr;
+    }
+}
+
+constexpr UINT ACQUIRE_TIMEOUT_MS = 16;
+
+} // namespace
+#endif
+
+DXGICapture::DXGICapture(Mode mode)
+    : m_mode(mode) {
 }
 
 DXGICapture::~DXGICapture() {
     stop();
+    releaseResources();
 }
 
 bool DXGICapture::initialize() {
     auto& logger = utils::Logger::getInstance();
-    
+
     if (!initializeDXGI()) {
         logger.error("Failed to initialize DXGI");
         return false;
     }
-    
+
     if (!createTextures()) {
         logger.error("Failed to create DXGI textures");
         return false;
     }
-    
+
+    if (m_mode == Mode::CudaInterop && !registerCudaResource()) {
+        logger.error("Failed to register DXGI texture with CUDA");
+        return false;
+    }
+
+    // Both modes can write into caller-owned device frames
+    cudaStreamCreateWithFlags(&m_stream, cudaStreamNonBlocking);
+    cudaEventCreateWithFlags(&m_readyEvent, cudaEventDisableTiming);
+
     m_initialized = true;
-    logger.info("DXGI capture initialized: {}x{} @ {}Hz", m_width, m_height, m_frameRate);
-    
+    logger.info("DXGI capture initialized: {}x{} @ {}Hz ({})", m_width, m_height, m_frameRate,
+                m_mode == Mode::CudaInterop ? "CUDA interop" : "staging");
+
     return true;
 }
 
@@ -40,30 +76,323 @@ bool DXGICapture::stop() {
 }
 
 bool DXGICapture::captureFrame(Frame& frame) {
-    // TODO: Implement DXGI frame capture
+#ifdef _WIN32
+    if (!m_initialized) return false;
+
+    auto* duplication = static_cast<IDXGIOutputDuplication*>(m_duplication);
+    auto* context = static_cast<ID3D11DeviceContext*>(m_context);
+
+    DXGI_OUTDUPL_FRAME_INFO frameInfo{};
+    IDXGIResource* resource = nullptr;
+
+    HRESULT hr = duplication->AcquireNextFrame(ACQUIRE_TIMEOUT_MS, &frameInfo, &resource);
+    if (hr == DXGI_ERROR_WAIT_TIMEOUT) {
+        return false;  // Desktop unchanged
+    }
+    if (FAILED(hr)) {
+        utils::Logger::getInstance().error("AcquireNextFrame failed: 0x{:08X}",
+                                           static_cast<uint32_t>(hr));
+        return false;
+    }
+    m_frameAcquired = true;
+
+    const bool intoTarget = frame.memory == FrameMemory::Device && frame.data != nullptr;
+    if (!intoTarget) {
+        frame.data = nullptr;
+    }
+
+    ID3D11Texture2D* desktopTexture = nullptr;
+    hr = resource->QueryInterface(__uuidof(ID3D11Texture2D),
+                                  reinterpret_cast<void**>(&desktopTexture));
+    resource->Release();
+    if (FAILED(hr)) {
+        releaseFrame(frame);
+        return false;
+    }
+
+    context->CopyResource(static_cast<ID3D11Texture2D*>(m_texture), desktopTexture);
+    desktopTexture->Release();
+
+    frame.width = m_width;
+    frame.height = m_height;
+    frame.timestamp_ns = std::chrono::high_resolution_clock::now()
+                         .time_since_epoch().count();
+    frame.frame_id = m_frameCounter++;
+
+    if (m_mode == Mode::CudaInterop) {
+        // The copy is queued on the D3D context; the desktop image can go back to DWM
+        duplication->ReleaseFrame();
+        m_frameAcquired = false;
+        return copyToDevice(frame, intoTarget);
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    hr = context->Map(static_cast<ID3D11Texture2D*>(m_texture), 0, D3D11_MAP_READ, 0, &mapped);
+    if (FAILED(hr)) {
+        releaseFrame(frame);
+        return false;
+    }
+
+    m_textureMapped = true;
+
+    if (intoTarget) {
+        const bool uploaded = uploadMapped(frame, static_cast<const uint8_t*>(mapped.pData),
+                                           mapped.RowPitch);
+        releaseFrame(frame);
+        return uploaded;
+    }
+
+    frame.data = static_cast<uint8_t*>(mapped.pData);
+    frame.stride = mapped.RowPitch;
+    frame.memory = FrameMemory::Host;
+    frame.ready_event = nullptr;
+    return true;
+#else
+    (void)frame;
     return false;
+#endif
 }
 
 void DXGICapture::releaseFrame(Frame& frame) {
-    // TODO: Release DXGI frame
+#ifdef _WIN32
+    if (m_textureMapped) {
+        static_cast<ID3D11DeviceContext*>(m_context)->Unmap(
+            static_cast<ID3D11Texture2D*>(m_texture), 0);
+        m_textureMapped = false;
+        if (frame.memory == FrameMemory::Host) {
+            frame.data = nullptr;
+        }
+    }
+
+    if (m_frameAcquired) {
+        static_cast<IDXGIOutputDuplication*>(m_duplication)->ReleaseFrame();
+        m_frameAcquired = false;
+    }
+#else
+    (void)frame;
+#endif
 }
 
 bool DXGICapture::initializeDXGI() {
-    // TODO: Initialize DXGI Desktop Duplication
+#ifdef _WIN32
+    auto& logger = utils::Logger::getInstance();
+
+    IDXGIFactory1* factory = nullptr;
+    if (FAILED(CreateDXGIFactory1(__uuidof(IDXGIFactory1), reinterpret_cast<void**>(&factory)))) {
+        logger.error("CreateDXGIFactory1 failed");
+        return false;
+    }
+
+    // For interop the D3D device must live on the same adapter as the CUDA context
+    IDXGIAdapter1* adapter = nullptr;
+    for (UINT i = 0; factory->EnumAdapters1(i, &adapter) != DXGI_ERROR_NOT_FOUND; i++) {
+        int cudaDevice = -1;
+        if (m_mode == Mode::Staging ||
+            cudaD3D11GetDevice(&cudaDevice, adapter) == cudaSuccess) {
+            break;
+        }
+        adapter->Release();
+        adapter = nullptr;
+    }
+    factory->Release();
+
+    if (!adapter) {
+        logger.error("No DXGI adapter is usable by CUDA");
+        return false;
+    }
+
+    const D3D_FEATURE_LEVEL featureLevels[] = {D3D_FEATURE_LEVEL_11_1, D3D_FEATURE_LEVEL_11_0};
+    ID3D11Device* device = nullptr;
+    ID3D11DeviceContext* context = nullptr;
+
+    HRESULT hr = D3D11CreateDevice(adapter, D3D_DRIVER_TYPE_UNKNOWN, nullptr,
+                                   D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+                                   featureLevels, ARRAYSIZE(featureLevels),
+                                   D3D11_SDK_VERSION, &device, nullptr, &context);
+    if (FAILED(hr)) {
+        logger.error("D3D11CreateDevice failed: 0x{:08X}", static_cast<uint32_t>(hr));
+        adapter->Release();
+        return false;
+    }
+    m_device = device;
+    m_context = context;
+
+    IDXGIOutput* output = nullptr;
+    hr = adapter->EnumOutputs(0, &output);
+    adapter->Release();
+    if (FAILED(hr)) {
+        logger.error("Adapter has no attached output");
+        return false;
+    }
+
+    IDXGIOutput1* output1 = nullptr;
+    hr = output->QueryInterface(__uuidof(IDXGIOutput1), reinterpret_cast<void**>(&output1));
+    output->Release();
+    if (FAILED(hr)) {
+        logger.error("IDXGIOutput1 not supported");
+        return false;
+    }
+
+    IDXGIOutputDuplication* duplication = nullptr;
+    hr = output1->DuplicateOutput(device, &duplication);
+    output1->Release();
+    if (FAILED(hr)) {
+        logger.error("DuplicateOutput failed: 0x{:08X}", static_cast<uint32_t>(hr));
+        return false;
+    }
+    m_duplication = duplication;
+
+    DXGI_OUTDUPL_DESC desc{};
+    duplication->GetDesc(&desc);
+    m_width = desc.ModeDesc.Width;
+    m_height = desc.ModeDesc.Height;
+    if (desc.ModeDesc.RefreshRate.Denominator != 0) {
+        m_frameRate = desc.ModeDesc.RefreshRate.Numerator / desc.ModeDesc.RefreshRate.Denominator;
+    }
+
     return true;
+#else
+    return false;
+#endif
 }
 
 bool DXGICapture::createTextures() {
-    // TODO: Create staging textures for GPU-to-CPU transfer
+#ifdef _WIN32
+    D3D11_TEXTURE2D_DESC desc{};
+    desc.Width = m_width;
+    desc.Height = m_height;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+
+    if (m_mode == Mode::CudaInterop) {
+        // GPU-only copy target shared with CUDA
+        desc.Usage = D3D11_USAGE_DEFAULT;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    } else {
+        // Staging texture for GPU-to-CPU transfer
+        desc.Usage = D3D11_USAGE_STAGING;
+        desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    }
+
+    ID3D11Texture2D* texture = nullptr;
+    if (FAILED(static_cast<ID3D11Device*>(m_device)->CreateTexture2D(&desc, nullptr, &texture))) {
+        return false;
+    }
+    m_texture = texture;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool DXGICapture::registerCudaResource() {
+#ifdef _WIN32
+    auto& logger = utils::Logger::getInstance();
+
+    cudaError_t status = cudaGraphicsD3D11RegisterResource(
+        &m_cudaResource, static_cast<ID3D11Texture2D*>(m_texture),
+        cudaGraphicsRegisterFlagsNone);
+    if (status != cudaSuccess) {
+        logger.error("cudaGraphicsD3D11RegisterResource failed: {}", cudaGetErrorString(status));
+        return false;
+    }
+    cudaGraphicsResourceSetMapFlags(m_cudaResource, cudaGraphicsMapFlagsReadOnly);
+
+    m_deviceFrame = static_cast<uint8_t*>(utils::GpuMemoryPool::getInstance().allocatePitch(
+        static_cast<size_t>(m_width) * 4, m_height, m_devicePitch, utils::MemoryTag::Capture));
+    if (!m_deviceFrame) {
+        logger.error("Failed to allocate device frame");
+        return false;
+    }
+
+    logger.info("CUDA interop enabled ({:.2f} MB device frame)",
+                m_devicePitch * m_height / (1024.0f * 1024.0f));
     return true;
+#else
+    return false;
+#endif
 }
 
-std::unique_ptr<CaptureInterface> createCapture(const std::string& method) {
-    if (method == "dxgi") {
-        return std::make_unique<DXGICapture>();
+bool DXGICapture::copyToDevice(Frame& frame, bool intoTarget) {
+    uint8_t* target = intoTarget ? frame.data : m_deviceFrame;
+    const size_t pitch = intoTarget ? frame.stride : m_devicePitch;
+    cudaEvent_t fence = intoTarget && frame.ready_event ? frame.ready_event : m_readyEvent;
+
+    // Map the shared texture, copy the BGRA surface into linear device memory
+    cudaError_t status = cudaGraphicsMapResources(1, &m_cudaResource, m_stream);
+    if (status != cudaSuccess) {
+        utils::Logger::getInstance().error("cudaGraphicsMapResources failed: {}",
+                                           cudaGetErrorString(status));
+        return false;
+    }
+
+    cudaArray_t array = nullptr;
+    status = cudaGraphicsSubResourceGetMappedArray(&array, m_cudaResource, 0, 0);
+    if (status == cudaSuccess) {
+        status = cudaMemcpy2DFromArrayAsync(target, pitch, array, 0, 0,
+                                            static_cast<size_t>(m_width) * 4, m_height,
+                                            cudaMemcpyDeviceToDevice, m_stream);
+    }
+    cudaGraphicsUnmapResources(1, &m_cudaResource, m_stream);
+
+    if (status != cudaSuccess) {
+        utils::Logger::getInstance().error("Device frame copy failed: {}",
+                                           cudaGetErrorString(status));
+        return false;
     }
-    // Add other capture methods here
-    return nullptr;
+
+    cudaEventRecord(fence, m_stream);
+
+    frame.data = target;
+    frame.stride = static_cast<uint32_t>(pitch);
+    frame.memory = FrameMemory::Device;
+    frame.ready_event = fence;
+    return true;
+}
+
+bool DXGICapture::uploadMapped(Frame& frame, const uint8_t* mapped, uint32_t rowPitch) {
+    // Pageable source: the call returns once the driver has staged the rows,
+    // so the texture can be unmapped straight after
+    cudaError_t status = cudaMemcpy2DAsync(frame.data, frame.stride, mapped, rowPitch,
+                                           static_cast<size_t>(m_width) * 4, m_height,
+                                           cudaMemcpyHostToDevice, m_stream);
+    if (status != cudaSuccess) {
+        utils::Logger::getInstance().error("Staging upload failed: {}", cudaGetErrorString(status));
+        return false;
+    }
+
+    cudaEvent_t fence = frame.ready_event ? frame.ready_event : m_readyEvent;
+    cudaEventRecord(fence, m_stream);
+    frame.ready_event = fence;
+    return true;
+}
+
+void DXGICapture::releaseResources() {
+    if (m_cudaResource) {
+        cudaGraphicsUnregisterResource(m_cudaResource);
+        m_cudaResource = nullptr;
+    }
+    utils::GpuMemoryPool::getInstance().release(m_deviceFrame);
+    m_deviceFrame = nullptr;
+    if (m_readyEvent) {
+        cudaEventDestroy(m_readyEvent);
+        m_readyEvent = nullptr;
+    }
+    if (m_stream) {
+        cudaStreamDestroy(m_stream);
+        m_stream = nullptr;
+    }
+
+#ifdef _WIN32
+    safeRelease<ID3D11Texture2D>(m_texture);
+    safeRelease<IDXGIOutputDuplication>(m_duplication);
+    safeRelease<ID3D11DeviceContext>(m_context);
+    safeRelease<ID3D11Device>(m_device);
+#endif
+
+    m_initialized = false;
 }
 
 } // namespace capture
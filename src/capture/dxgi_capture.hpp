@@ -7,7 +7,12 @@ namespace capture {
 
 class DXGICapture : public CaptureInterface {
 public:
-    DXGICapture();
+    enum class Mode {
+        Staging,     // Desktop -> staging texture -> mapped host memory
+        CudaInterop  // Desktop -> shared texture -> CUDA device buffer (no PCIe round trip)
+    };
+
+    explicit DXGICapture(Mode mode = Mode::CudaInterop);
     ~DXGICapture() override;
 
     bool initialize() override;
@@ -15,24 +20,43 @@ public:
     bool stop() override;
     bool captureFrame(Frame& frame) override;
     void releaseFrame(Frame& frame) override;
-    
+
     uint32_t getWidth() const override { return m_width; }
     uint32_t getHeight() const override { return m_height; }
     uint32_t getFrameRate() const override { return m_frameRate; }
+    cudaStream_t getStream() const override { return m_stream; }
+
+    Mode getMode() const { return m_mode; }
 
 private:
     bool initializeDXGI();
     bool createTextures();
-    
+    bool registerCudaResource();
+    bool copyToDevice(Frame& frame, bool intoTarget);
+    bool uploadMapped(Frame& frame, const uint8_t* mapped, uint32_t rowPitch);
+    void releaseResources();
+
+    Mode m_mode;
     uint32_t m_width{0};
     uint32_t m_height{0};
     uint32_t m_frameRate{60};
+    uint32_t m_frameCounter{0};
     bool m_initialized{false};
-    
+    bool m_frameAcquired{false};
+    bool m_textureMapped{false};
+
     // Platform-specific handles
     void* m_device{nullptr};
     void* m_context{nullptr};
     void* m_duplication{nullptr};
+    void* m_texture{nullptr};  // Staging or CUDA-shared copy target
+
+    // CUDA interop resources
+    cudaGraphicsResource_t m_cudaResource{nullptr};
+    cudaStream_t m_stream{nullptr};
+    cudaEvent_t m_readyEvent{nullptr};
+    uint8_t* m_deviceFrame{nullptr};
+    size_t m_devicePitch{0};
 };
 
 } // namespace capture
@@ -1,40 +1,284 @@
 #pragma once
 
 #include "capture_interface.hpp"
+#include "../utils/gpu_memory_pool.hpp"
+#include "../utils/logger.hpp"
 #include <array>
 #include <atomic>
+#include <cstdint>
+#include <limits>
 #include <memory>
 
 namespace capture {
 
-template<size_t BufferCount = 8>
+/**
+ * Ring of device-memory frame slots shared by one capture producer and the
+ * GPU consumers. Ordering is carried entirely by CUDA events: the writer
+ * records a slot's ready fence on its stream, readers wait on it from their
+ * own stream, and a reader's release fence gates the next write into the
+ * slot. No call here blocks the host on the GPU.
+ *
+ * Slot lifecycle: Free -> Writing -> Ready -> Reading -> Free. When no slot
+ * is free the writer can reclaim the oldest Ready slot (latest-wins).
+ */
+template<size_t MaxSlots = 16>
 class FrameBuffer {
 public:
     FrameBuffer(uint32_t width, uint32_t height);
     ~FrameBuffer();
 
-    bool initialize();
-    
-    Frame* acquireWriteBuffer();
+    // Allocates slotCount (<= MaxSlots) BGRA slots from one pitched allocation
+    bool initialize(uint32_t slotCount = MaxSlots);
+
+    // Producer. The returned frame has data/stride/ready_event preset; the
+    // writer fills it on writerStream and records ready_event before release.
+    Frame* acquireWriteBuffer(cudaStream_t writerStream);
     void releaseWriteBuffer(Frame* frame);
-    
+    void abortWriteBuffer(Frame* frame);
+
+    // Consumer. Oldest ready frame first; GPU work on it must wait on
+    // frame->ready_event. Release records the slot's fence on readerStream.
     Frame* acquireReadBuffer();
-    void releaseReadBuffer(Frame* frame);
-    
-    uint32_t getAvailableFrames() const;
+    void releaseReadBuffer(Frame* frame, cudaStream_t readerStream);
+
+    uint32_t getAvailableFrames() const { return m_available.load(std::memory_order_acquire); }
+    // acquireWriteBuffer() would succeed: a free slot, or a ready one to reclaim
+    bool hasWritableSlot() const;
+    uint32_t getSlotCount() const { return m_slotCount; }
+    uint64_t getDroppedFrames() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // Reclaim the oldest ready frame when full (default) or refuse the write
+    void setReclaimOldest(bool reclaim) { m_reclaimOldest = reclaim; }
 
 private:
+    enum class SlotState : uint8_t { Free, Writing, Ready, Reading };
+
     struct BufferSlot {
-        Frame frame;
-        std::atomic<bool> inUse{false};
+        Frame frame{};
+        std::atomic<SlotState> state{SlotState::Free};
+        std::atomic<uint64_t> sequence{0};    // Publish order, for oldest-first reads
+        cudaEvent_t releasedEvent{nullptr};   // Recorded by the last reader
         uint8_t* cudaMemory{nullptr};
     };
-    
-    std::array<BufferSlot, BufferCount> m_buffers;
+
+    BufferSlot* slotOf(Frame* frame);
+    bool tryTransition(BufferSlot& slot, SlotState from, SlotState to);
+    BufferSlot* oldestReady();
+    void releaseResources();
+
+    std::array<BufferSlot, MaxSlots> m_buffers;
     uint32_t m_width;
     uint32_t m_height;
+    uint32_t m_slotCount{0};
+    bool m_reclaimOldest{true};
+
+    uint8_t* m_pool{nullptr};
+    size_t m_pitch{0};
+
     std::atomic<uint32_t> m_writeIndex{0};
-    std::atomic<uint32_t> m_readIndex{0};
+    std::atomic<uint64_t> m_nextSequence{0};
+    std::atomic<uint32_t> m_available{0};
+    std::atomic<uint64_t> m_dropped{0};
 };
 
+template<size_t MaxSlots>
+FrameBuffer<MaxSlots>::FrameBuffer(uint32_t width, uint32_t height)
+    : m_width(width), m_height(height) {
+}
+
+template<size_t MaxSlots>
+FrameBuffer<MaxSlots>::~FrameBuffer() {
+    releaseResources();
+}
+
+template<size_t MaxSlots>
+bool FrameBuffer<MaxSlots>::initialize(uint32_t slotCount) {
+    auto& logger = utils::Logger::getInstance();
+
+    if (slotCount < 2 || slotCount > MaxSlots) {
+        logger.error("Frame buffer needs 2..{} slots, got {}", MaxSlots, slotCount);
+        return false;
+    }
+    m_slotCount = slotCount;
+
+    // One pitched allocation, slots stacked vertically
+    m_pool = static_cast<uint8_t*>(utils::GpuMemoryPool::getInstance().allocatePitch(
+        static_cast<size_t>(m_width) * 4, static_cast<size_t>(m_height) * m_slotCount, m_pitch,
+        utils::MemoryTag::Frames));
+    if (!m_pool) {
+        logger.error("Failed to allocate frame pool");
+        return false;
+    }
+
+    cudaError_t status = cudaSuccess;
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        auto& slot = m_buffers[i];
+        slot.cudaMemory = m_pool + static_cast<size_t>(i) * m_pitch * m_height;
+
+        status = cudaEventCreateWithFlags(&slot.frame.ready_event, cudaEventDisableTiming);
+        if (status == cudaSuccess) {
+            status = cudaEventCreateWithFlags(&slot.releasedEvent, cudaEventDisableTiming);
+        }
+        if (status != cudaSuccess) {
+            logger.error("Failed to create frame fences: {}", cudaGetErrorString(status));
+            releaseResources();
+            return false;
+        }
+
+        slot.frame.data = slot.cudaMemory;
+        slot.frame.width = m_width;
+        slot.frame.height = m_height;
+        slot.frame.stride = static_cast<uint32_t>(m_pitch);
+        slot.frame.memory = FrameMemory::Device;
+        slot.state.store(SlotState::Free, std::memory_order_relaxed);
+    }
+
+    logger.info("Frame buffer: {} slots of {}x{} ({:.1f} MB)", m_slotCount, m_width, m_height,
+                m_pitch * m_height * m_slotCount / (1024.0f * 1024.0f));
+    return true;
+}
+
+template<size_t MaxSlots>
+Frame* FrameBuffer<MaxSlots>::acquireWriteBuffer(cudaStream_t writerStream) {
+    BufferSlot* claimed = nullptr;
+
+    // Round-robin over free slots
+    const uint32_t start = m_writeIndex.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < m_slotCount && !claimed; i++) {
+        const uint32_t index = (start + i) % m_slotCount;
+        if (tryTransition(m_buffers[index], SlotState::Free, SlotState::Writing)) {
+            claimed = &m_buffers[index];
+            m_writeIndex.store(index + 1, std::memory_order_relaxed);
+        }
+    }
+
+    // Consumers are behind: overwrite the oldest frame nobody has picked up
+    while (!claimed && m_reclaimOldest) {
+        BufferSlot* oldest = oldestReady();
+        if (!oldest) break;
+        if (tryTransition(*oldest, SlotState::Ready, SlotState::Writing)) {
+            m_available.fetch_sub(1, std::memory_order_acq_rel);
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            claimed = oldest;
+        }
+    }
+
+    if (!claimed) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    // The writer's copy must not start before the previous reader finished
+    cudaStreamWaitEvent(writerStream, claimed->releasedEvent, 0);
+
+    // Backends write into the preset target; restore it in case a failed
+    // capture left the frame pointing elsewhere
+    claimed->frame.data = claimed->cudaMemory;
+    claimed->frame.stride = static_cast<uint32_t>(m_pitch);
+    claimed->frame.memory = FrameMemory::Device;
+    return &claimed->frame;
+}
+
+template<size_t MaxSlots>
+void FrameBuffer<MaxSlots>::releaseWriteBuffer(Frame* frame) {
+    BufferSlot* slot = slotOf(frame);
+    if (!slot) return;
+
+    slot->sequence.store(m_nextSequence.fetch_add(1, std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+    slot->state.store(SlotState::Ready, std::memory_order_release);
+    m_available.fetch_add(1, std::memory_order_acq_rel);
+}
+
+template<size_t MaxSlots>
+void FrameBuffer<MaxSlots>::abortWriteBuffer(Frame* frame) {
+    BufferSlot* slot = slotOf(frame);
+    if (!slot) return;
+
+    slot->state.store(SlotState::Free, std::memory_order_release);
+}
+
+template<size_t MaxSlots>
+Frame* FrameBuffer<MaxSlots>::acquireReadBuffer() {
+    for (;;) {
+        BufferSlot* oldest = oldestReady();
+        if (!oldest) return nullptr;
+
+        // Lost a race with another reader or a reclaiming writer: rescan
+        if (tryTransition(*oldest, SlotState::Ready, SlotState::Reading)) {
+            m_available.fetch_sub(1, std::memory_order_acq_rel);
+            return &oldest->frame;
+        }
+    }
+}
+
+template<size_t MaxSlots>
+void FrameBuffer<MaxSlots>::releaseReadBuffer(Frame* frame, cudaStream_t readerStream) {
+    BufferSlot* slot = slotOf(frame);
+    if (!slot) return;
+
+    cudaEventRecord(slot->releasedEvent, readerStream);
+    slot->state.store(SlotState::Free, std::memory_order_release);
+}
+
+template<size_t MaxSlots>
+bool FrameBuffer<MaxSlots>::hasWritableSlot() const {
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        const SlotState state = m_buffers[i].state.load(std::memory_order_acquire);
+        if (state == SlotState::Free || (m_reclaimOldest && state == SlotState::Ready)) return true;
+    }
+    return false;
+}
+
+template<size_t MaxSlots>
+typename FrameBuffer<MaxSlots>::BufferSlot* FrameBuffer<MaxSlots>::slotOf(Frame* frame) {
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        if (&m_buffers[i].frame == frame) return &m_buffers[i];
+    }
+    return nullptr;
+}
+
+template<size_t MaxSlots>
+bool FrameBuffer<MaxSlots>::tryTransition(BufferSlot& slot, SlotState from, SlotState to) {
+    return slot.state.compare_exchange_strong(from, to, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed);
+}
+
+template<size_t MaxSlots>
+typename FrameBuffer<MaxSlots>::BufferSlot* FrameBuffer<MaxSlots>::oldestReady() {
+    BufferSlot* oldest = nullptr;
+    uint64_t oldestSequence = std::numeric_limits<uint64_t>::max();
+
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        auto& slot = m_buffers[i];
+        if (slot.state.load(std::memory_order_acquire) != SlotState::Ready) continue;
+
+        const uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        if (sequence < oldestSequence) {
+            oldestSequence = sequence;
+            oldest = &slot;
+        }
+    }
+    return oldest;
+}
+
+template<size_t MaxSlots>
+void FrameBuffer<MaxSlots>::releaseResources() {
+    for (auto& slot : m_buffers) {
+        if (slot.frame.ready_event) {
+            cudaEventDestroy(slot.frame.ready_event);
+            slot.frame.ready_event = nullptr;
+        }
+        if (slot.releasedEvent) {
+            cudaEventDestroy(slot.releasedEvent);
+            slot.releasedEvent = nullptr;
+        }
+        slot.cudaMemory = nullptr;
+    }
+
+    utils::GpuMemoryPool::getInstance().release(m_pool);
+    m_pool = nullptr;
+    m_slotCount = 0;
+}
+
 } // namespace capture
@@ -0,0 +1,144 @@
+#include "frame_recorder.hpp"
+#include "../utils/gpu_memory_pool.hpp"
+#include "../utils/logger.hpp"
+#include <chrono>
+
+namespace capture {
+
+namespace {
+
+constexpr auto WRITER_IDLE_INTERVAL = std::chrono::milliseconds(1);
+
+} // namespace
+
+FrameRecorder::FrameRecorder() {
+}
+
+FrameRecorder::~FrameRecorder() {
+    stop();
+    releaseResources();
+}
+
+bool FrameRecorder::start(const std::string& path, uint32_t width, uint32_t height, uint32_t frameRate) {
+    auto& logger = utils::Logger::getInstance();
+
+    if (m_running.load(std::memory_order_acquire)) return false;
+
+    m_width = width;
+    m_height = height;
+    const size_t frameBytes = static_cast<size_t>(width) * height * 4;
+
+    // Buffers survive restarts at the same size
+    if (frameBytes != m_stagingBytes) {
+        releaseResources();
+    }
+    for (auto& staging : m_staging) {
+        if (staging.host) continue;
+        staging.host = static_cast<uint8_t*>(
+            utils::GpuMemoryPool::getInstance().allocateHost(frameBytes, utils::MemoryTag::Capture));
+        const cudaError_t status = staging.host
+            ? cudaEventCreateWithFlags(&staging.copied, cudaEventDisableTiming)
+            : cudaErrorMemoryAllocation;
+        if (status != cudaSuccess) {
+            logger.error("Failed to allocate recorder staging: {}", cudaGetErrorString(status));
+            releaseResources();
+            return false;
+        }
+    }
+    m_stagingBytes = frameBytes;
+
+    if (!m_writer.open(path, RecordingCodec::RawBGRA, width, height, frameRate)) {
+        return false;
+    }
+
+    m_submitted.store(0, std::memory_order_relaxed);
+    m_written.store(0, std::memory_order_relaxed);
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&FrameRecorder::writerThreadFunc, this);
+
+    logger.info("Recording {}x{} frames to {} ({:.1f} MB per frame)", width, height, path,
+                frameBytes / (1024.0f * 1024.0f));
+    return true;
+}
+
+void FrameRecorder::stop() {
+    if (!m_running.exchange(false, std::memory_order_acq_rel)) return;
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_writer.close();
+
+    utils::Logger::getInstance().info("Recorder stopped: {} frames written, {} dropped",
+                                      m_written.load(std::memory_order_relaxed),
+                                      m_dropped.load(std::memory_order_relaxed));
+}
+
+bool FrameRecorder::submit(const Frame& frame, cudaStream_t stream) {
+    if (!m_running.load(std::memory_order_relaxed)) return false;
+
+    if (frame.width != m_width || frame.height != m_height) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    const uint64_t submitted = m_submitted.load(std::memory_order_relaxed);
+    if (submitted - m_written.load(std::memory_order_acquire) >= STAGING_BUFFERS) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Staging& staging = m_staging[submitted % STAGING_BUFFERS];
+    if (frame.memory == FrameMemory::Device && frame.ready_event) {
+        cudaStreamWaitEvent(stream, frame.ready_event, 0);
+    }
+
+    const size_t rowBytes = static_cast<size_t>(m_width) * 4;
+    const cudaError_t status = cudaMemcpy2DAsync(staging.host, rowBytes, frame.data, frame.stride,
+                                                 rowBytes, m_height, cudaMemcpyDefault, stream);
+    if (status != cudaSuccess) {
+        utils::Logger::getInstance().error("Recorder copy failed: {}", cudaGetErrorString(status));
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    cudaEventRecord(staging.copied, stream);
+
+    // Original capture time survives re-recording a replay
+    staging.timestamp_ns = frame.source_timestamp_ns ? frame.source_timestamp_ns : frame.timestamp_ns;
+    staging.frame_id = frame.frame_id;
+    m_submitted.store(submitted + 1, std::memory_order_release);
+    return true;
+}
+
+void FrameRecorder::writerThreadFunc() {
+    const size_t frameBytes = static_cast<size_t>(m_width) * m_height * 4;
+
+    for (;;) {
+        const uint64_t written = m_written.load(std::memory_order_relaxed);
+        if (written == m_submitted.load(std::memory_order_acquire)) {
+            if (!m_running.load(std::memory_order_acquire)) break;
+            std::this_thread::sleep_for(WRITER_IDLE_INTERVAL);
+            continue;
+        }
+
+        Staging& staging = m_staging[written % STAGING_BUFFERS];
+        cudaEventSynchronize(staging.copied);
+        m_writer.append(staging.host, frameBytes, staging.timestamp_ns, staging.frame_id);
+        m_written.store(written + 1, std::memory_order_release);
+    }
+}
+
+void FrameRecorder::releaseResources() {
+    m_stagingBytes = 0;
+    for (auto& staging : m_staging) {
+        utils::GpuMemoryPool::getInstance().releaseHost(staging.host);
+        staging.host = nullptr;
+        if (staging.copied) {
+            cudaEventDestroy(staging.copied);
+            staging.copied = nullptr;
+        }
+    }
+}
+
+} // namespace capture
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "capture_interface.hpp"
+#include "recording_writer.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace capture {
+
+/**
+ * Tees captured frames into a raw .bjrec recording without stalling the
+ * capture thread. submit() queues a GPU copy of the frame into a pinned
+ * staging buffer on the caller's stream and returns; a writer thread waits
+ * for the copy and appends it to disk. With every staging buffer in flight
+ * the frame is dropped and counted, never waited for.
+ */
+class FrameRecorder {
+public:
+    static constexpr uint32_t STAGING_BUFFERS = 8;
+
+    FrameRecorder();
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    bool start(const std::string& path, uint32_t width, uint32_t height, uint32_t frameRate);
+
+    // Writes out the queued frames and closes the recording
+    void stop();
+
+    // Capture thread. Enqueued on stream behind whatever produced the frame,
+    // so later captures on the same stream cannot overwrite it first.
+    bool submit(const Frame& frame, cudaStream_t stream);
+
+    uint64_t getFramesRecorded() const { return m_written.load(std::memory_order_relaxed); }
+    uint64_t getFramesDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Staging {
+        uint8_t* host{nullptr};  // Pinned, tightly packed BGRA
+        cudaEvent_t copied{nullptr};
+        uint64_t timestamp_ns{0};
+        uint32_t frame_id{0};
+    };
+
+    void writerThreadFunc();
+    void releaseResources();
+
+    RecordingWriter m_writer;
+    std::array<Staging, STAGING_BUFFERS> m_staging;
+    uint32_t m_width{0};
+    uint32_t m_height{0};
+    size_t m_stagingBytes{0};
+
+    // Submitted / written frame counts; their difference is the backlog
+    std::atomic<uint64_t> m_submitted{0};
+    std::atomic<uint64_t> m_written{0};
+    std::atomic<uint64_t> m_dropped{0};
+
+    std::atomic<bool> m_running{false};
+    std::thread m_thread;
+};
+
+} // namespace capture
@@ -0,0 +1,264 @@
+#include "nvdec_decoder.hpp"
+#include "../utils/logger.hpp"
+
+#ifdef BLACKJACK_NVDEC
+#include <cuda.h>
+#include <nvcuvid.h>
+#endif
+
+namespace capture {
+
+#ifdef BLACKJACK_NVDEC
+namespace {
+
+// Surfaces beyond the stream's DPB so display can lag decode by a few frames
+constexpr unsigned int EXTRA_DECODE_SURFACES = 4;
+
+} // namespace
+
+// Parser callbacks; run inside cuvidParseVideoData on the decoding thread
+struct NvdecCallbacks {
+    static int CUDAAPI sequence(void* user, CUVIDEOFORMAT* format) {
+        auto* self = static_cast<NvdecDecoder*>(user);
+        auto& logger = utils::Logger::getInstance();
+
+        if (format->bit_depth_luma_minus8 != 0 || format->chroma_format != cudaVideoChromaFormat_420) {
+            logger.error("NVDEC replay supports 8-bit 4:2:0 streams only");
+            return 0;
+        }
+
+        const uint32_t width = static_cast<uint32_t>(format->display_area.right - format->display_area.left);
+        const uint32_t height = static_cast<uint32_t>(format->display_area.bottom - format->display_area.top);
+        if (width != self->m_width || height != self->m_height) {
+            logger.error("Stream is {}x{}, recording header says {}x{}", width, height,
+                         self->m_width, self->m_height);
+            return 0;
+        }
+
+        const unsigned int surfaces = format->min_num_decode_surfaces + EXTRA_DECODE_SURFACES;
+        if (self->m_decoder) {
+            return static_cast<int>(surfaces);  // Repeated sequence header, same geometry
+        }
+
+        CUVIDDECODECREATEINFO info{};
+        info.CodecType = format->codec;
+        info.ChromaFormat = format->chroma_format;
+        info.OutputFormat = cudaVideoSurfaceFormat_NV12;
+        info.bitDepthMinus8 = 0;
+        info.DeinterlaceMode = cudaVideoDeinterlaceMode_Weave;
+        info.ulWidth = format->coded_width;
+        info.ulHeight = format->coded_height;
+        info.ulMaxWidth = format->coded_width;
+        info.ulMaxHeight = format->coded_height;
+        info.ulTargetWidth = width;
+        info.ulTargetHeight = height;
+        info.display_area.left = static_cast<short>(format->display_area.left);
+        info.display_area.top = static_cast<short>(format->display_area.top);
+        info.display_area.right = static_cast<short>(format->display_area.right);
+        info.display_area.bottom = static_cast<short>(format->display_area.bottom);
+        info.ulNumDecodeSurfaces = surfaces;
+        info.ulNumOutputSurfaces = 2;
+        info.ulCreationFlags = cudaVideoCreate_PreferCUVID;
+        info.vidLock = static_cast<CUvideoctxlock>(self->m_lock);
+
+        CUvideodecoder decoder = nullptr;
+        cuCtxPushCurrent(static_cast<CUcontext>(self->m_context));
+        const CUresult status = cuvidCreateDecoder(&decoder, &info);
+        cuCtxPopCurrent(nullptr);
+        if (status != CUDA_SUCCESS) {
+            logger.error("cuvidCreateDecoder failed: {}", static_cast<int>(status));
+            return 0;
+        }
+
+        self->m_decoder = decoder;
+        self->m_surfaceHeight = height;
+        logger.info("NVDEC decoder created: {}x{}, {} surfaces", width, height, surfaces);
+        return static_cast<int>(surfaces);
+    }
+
+    static int CUDAAPI decode(void* user, CUVIDPICPARAMS* picture) {
+        auto* self = static_cast<NvdecDecoder*>(user);
+        if (!self->m_decoder) return 0;
+        return cuvidDecodePicture(static_cast<CUvideodecoder>(self->m_decoder), picture) == CUDA_SUCCESS;
+    }
+
+    static int CUDAAPI display(void* user, CUVIDPARSERDISPINFO* info) {
+        if (!info) return 1;  // End of stream
+        auto* self = static_cast<NvdecDecoder*>(user);
+        self->m_pending.push_back({info->picture_index, info->progressive_frame, info->top_field_first});
+        return 1;
+    }
+};
+#endif
+
+NvdecDecoder::NvdecDecoder() {
+}
+
+NvdecDecoder::~NvdecDecoder() {
+    releaseResources();
+}
+
+bool NvdecDecoder::initialize(RecordingCodec codec, uint32_t width, uint32_t height, bool bt709) {
+    auto& logger = utils::Logger::getInstance();
+
+#ifdef BLACKJACK_NVDEC
+    releaseResources();
+    m_width = width;
+    m_height = height;
+    m_bt709 = bt709;
+
+    // Share the runtime's primary context so decoded surfaces feed the pipeline streams directly
+    cudaFree(nullptr);
+    CUcontext context = nullptr;
+    if (cuCtxGetCurrent(&context) != CUDA_SUCCESS || !context) {
+        logger.error("No CUDA context for NVDEC");
+        return false;
+    }
+    m_context = context;
+
+    CUvideoctxlock lock = nullptr;
+    if (cuvidCtxLockCreate(&lock, context) != CUDA_SUCCESS) {
+        logger.error("cuvidCtxLockCreate failed");
+        return false;
+    }
+    m_lock = lock;
+
+    CUVIDPARSERPARAMS params{};
+    params.CodecType = codec == RecordingCodec::HEVC ? cudaVideoCodec_HEVC : cudaVideoCodec_H264;
+    params.ulMaxNumDecodeSurfaces = 1;  // Raised by the sequence callback
+    params.ulMaxDisplayDelay = 0;       // Emit pictures as soon as they are decodable
+    params.pUserData = this;
+    params.pfnSequenceCallback = &NvdecCallbacks::sequence;
+    params.pfnDecodePicture = &NvdecCallbacks::decode;
+    params.pfnDisplayPicture = &NvdecCallbacks::display;
+
+    CUvideoparser parser = nullptr;
+    if (cuvidCreateVideoParser(&parser, &params) != CUDA_SUCCESS) {
+        logger.error("cuvidCreateVideoParser failed");
+        return false;
+    }
+    m_parser = parser;
+
+    logger.info("NVDEC replay initialized ({})", codec == RecordingCodec::HEVC ? "HEVC" : "H.264");
+    return true;
+#else
+    (void)codec;
+    (void)width;
+    (void)height;
+    (void)bt709;
+    logger.error("Built without NVDEC; set VIDEO_CODEC_SDK_DIR to replay compressed recordings");
+    return false;
+#endif
+}
+
+bool NvdecDecoder::decode(const uint8_t* data, size_t size, uint64_t timestampNs,
+                          uint8_t* target, size_t targetPitch, cudaStream_t stream) {
+#ifdef BLACKJACK_NVDEC
+    if (!m_parser) return false;
+
+    CUVIDSOURCEDATAPACKET packet{};
+    packet.payload = data;
+    packet.payload_size = static_cast<unsigned long>(size);
+    packet.flags = CUVID_PKT_TIMESTAMP;
+    packet.timestamp = static_cast<CUvideotimestamp>(timestampNs);
+    if (cuvidParseVideoData(static_cast<CUvideoparser>(m_parser), &packet) != CUDA_SUCCESS) {
+        utils::Logger::getInstance().error("cuvidParseVideoData failed");
+        return false;
+    }
+
+    if (m_pending.empty()) return false;
+
+    const PendingPicture picture = m_pending.front();
+    m_pending.pop_front();
+    return convertPicture(picture, target, targetPitch, stream);
+#else
+    (void)data;
+    (void)size;
+    (void)timestampNs;
+    (void)target;
+    (void)targetPitch;
+    (void)stream;
+    return false;
+#endif
+}
+
+void NvdecDecoder::reset() {
+#ifdef BLACKJACK_NVDEC
+    if (m_parser) {
+        CUVIDSOURCEDATAPACKET packet{};
+        packet.flags = CUVID_PKT_ENDOFSTREAM;
+        cuvidParseVideoData(static_cast<CUvideoparser>(m_parser), &packet);
+    }
+#endif
+    m_pending.clear();
+}
+
+bool NvdecDecoder::convertPicture(const PendingPicture& picture, uint8_t* target, size_t targetPitch,
+                                  cudaStream_t stream) {
+#ifdef BLACKJACK_NVDEC
+    auto* decoder = static_cast<CUvideodecoder>(m_decoder);
+
+    CUVIDPROCPARAMS params{};
+    params.progressive_frame = picture.progressive;
+    params.top_field_first = picture.topFieldFirst;
+    params.output_stream = static_cast<CUstream>(stream);
+
+    cuCtxPushCurrent(static_cast<CUcontext>(m_context));
+
+    CUdeviceptr surface = 0;
+    unsigned int pitch = 0;
+    if (cuvidMapVideoFrame64(decoder, picture.index, &surface, &pitch, &params) != CUDA_SUCCESS) {
+        cuCtxPopCurrent(nullptr);
+        utils::Logger::getInstance().error("cuvidMapVideoFrame failed");
+        return false;
+    }
+
+    // NV12: chroma plane follows the luma plane at the even-rounded surface height
+    const auto* luma = reinterpret_cast<const uint8_t*>(surface);
+    const uint8_t* chroma = luma + static_cast<size_t>(pitch) * ((m_surfaceHeight + 1) & ~1u);
+    cudaError_t status = cuda::nv12ToBGRA(luma, chroma, pitch, target, targetPitch,
+                                          m_width, m_height, m_bt709, stream);
+
+    // The surface goes back to the decoder on unmap; the kernel has to be done with it
+    if (status == cudaSuccess) {
+        status = cudaStreamSynchronize(stream);
+    }
+    cuvidUnmapVideoFrame64(decoder, surface);
+    cuCtxPopCurrent(nullptr);
+
+    if (status != cudaSuccess) {
+        utils::Logger::getInstance().error("NV12 conversion failed: {}", cudaGetErrorString(status));
+        return false;
+    }
+    return true;
+#else
+    (void)picture;
+    (void)target;
+    (void)targetPitch;
+    (void)stream;
+    return false;
+#endif
+}
+
+void NvdecDecoder::releaseResources() {
+#ifdef BLACKJACK_NVDEC
+    if (m_parser) {
+        cuvidDestroyVideoParser(static_cast<CUvideoparser>(m_parser));
+        m_parser = nullptr;
+    }
+    if (m_decoder) {
+        cuCtxPushCurrent(static_cast<CUcontext>(m_context));
+        cuvidDestroyDecoder(static_cast<CUvideodecoder>(m_decoder));
+        cuCtxPopCurrent(nullptr);
+        m_decoder = nullptr;
+    }
+    if (m_lock) {
+        cuvidCtxLockDestroy(static_cast<CUvideoctxlock>(m_lock));
+        m_lock = nullptr;
+    }
+#endif
+    m_context = nullptr;
+    m_pending.clear();
+}
+
+} // namespace capture
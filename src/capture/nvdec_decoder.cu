@@ -0,0 +1,68 @@
+// CUDA NV12 -> BGRA Conversion Kernel (NVDEC replay output)
+
+#include "nvdec_decoder.hpp"
+#include <cuda_runtime.h>
+#include <device_launch_parameters.h>
+
+namespace capture {
+namespace cuda {
+
+constexpr uint32_t BLOCK_WIDTH = 32;
+constexpr uint32_t BLOCK_HEIGHT = 8;
+
+struct YuvCoefficients {
+    float rv, gu, gv, bu;
+};
+
+// Limited-range (16-235 / 16-240) inverse matrices
+constexpr YuvCoefficients BT709 = {1.793f, -0.213f, -0.533f, 2.112f};
+constexpr YuvCoefficients BT601 = {1.596f, -0.392f, -0.813f, 2.017f};
+
+__device__ __forceinline__ uint8_t clampByte(float value) {
+    return static_cast<uint8_t>(fminf(fmaxf(value, 0.0f), 255.0f));
+}
+
+/**
+ * One thread per output pixel. Chroma is shared by each 2x2 quad and
+ * sampled without interpolation, matching how the desktop was subsampled.
+ */
+__global__ void nv12ToBGRAKernel(const uint8_t* __restrict__ luma,
+                                 const uint8_t* __restrict__ chroma,
+                                 size_t sourcePitch,
+                                 uint8_t* __restrict__ target,
+                                 size_t targetPitch,
+                                 uint32_t width, uint32_t height,
+                                 YuvCoefficients k) {
+    const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+    const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+    if (x >= width || y >= height) return;
+
+    const float yv = 1.164f * (static_cast<float>(luma[y * sourcePitch + x]) - 16.0f);
+    const uint8_t* uv = chroma + (y >> 1) * sourcePitch + (x & ~1u);
+    const float u = static_cast<float>(uv[0]) - 128.0f;
+    const float v = static_cast<float>(uv[1]) - 128.0f;
+
+    reinterpret_cast<uchar4*>(target + y * targetPitch)[x] = make_uchar4(
+        clampByte(yv + k.bu * u),
+        clampByte(yv + k.gu * u + k.gv * v),
+        clampByte(yv + k.rv * v),
+        255);
+}
+
+cudaError_t nv12ToBGRA(const uint8_t* luma, const uint8_t* chroma, size_t sourcePitch,
+                       uint8_t* target, size_t targetPitch,
+                       uint32_t width, uint32_t height, bool bt709, cudaStream_t stream) {
+    if (!luma || !chroma || !target || width == 0 || height == 0) {
+        return cudaErrorInvalidValue;
+    }
+
+    const dim3 block(BLOCK_WIDTH, BLOCK_HEIGHT);
+    const dim3 grid((width + BLOCK_WIDTH - 1) / BLOCK_WIDTH, (height + BLOCK_HEIGHT - 1) / BLOCK_HEIGHT);
+    nv12ToBGRAKernel<<<grid, block, 0, stream>>>(luma, chroma, sourcePitch, target, targetPitch,
+                                                 width, height, bt709 ? BT709 : BT601);
+
+    return cudaGetLastError();
+}
+
+} // namespace cuda
+} // namespace capture
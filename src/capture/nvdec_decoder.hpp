@@ -0,0 +1,74 @@
+#pragma once
+
+#include "recording_format.hpp"
+#include <cuda_runtime_api.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace capture {
+namespace cuda {
+
+/**
+ * Converts an NV12 surface (luma plane + interleaved CbCr plane, same pitch)
+ * to BGRA8 with alpha 255. Limited-range BT.709, or BT.601 when bt709 is false.
+ */
+cudaError_t nv12ToBGRA(const uint8_t* luma, const uint8_t* chroma, size_t sourcePitch,
+                       uint8_t* target, size_t targetPitch,
+                       uint32_t width, uint32_t height, bool bt709, cudaStream_t stream);
+
+} // namespace cuda
+
+struct NvdecCallbacks;
+
+/**
+ * NVDEC decode of the H.264/HEVC access units in a recording into BGRA
+ * device frames. The parser runs with zero display delay, so streams
+ * without B-frames hand back each picture from the call that fed it.
+ * Only available in builds with the Video Codec SDK (BLACKJACK_NVDEC).
+ */
+class NvdecDecoder {
+public:
+    NvdecDecoder();
+    ~NvdecDecoder();
+
+    NvdecDecoder(const NvdecDecoder&) = delete;
+    NvdecDecoder& operator=(const NvdecDecoder&) = delete;
+
+    bool initialize(RecordingCodec codec, uint32_t width, uint32_t height, bool bt709);
+
+    // Feeds one access unit. True once a picture was converted into target;
+    // false while the decoder is still filling its reorder window.
+    bool decode(const uint8_t* data, size_t size, uint64_t timestampNs,
+                uint8_t* target, size_t targetPitch, cudaStream_t stream);
+
+    // Drops queued pictures, e.g. before looping back to the first frame
+    void reset();
+
+private:
+    friend struct NvdecCallbacks;
+
+    struct PendingPicture {
+        int index;
+        int progressive;
+        int topFieldFirst;
+    };
+
+    bool convertPicture(const PendingPicture& picture, uint8_t* target, size_t targetPitch,
+                        cudaStream_t stream);
+    void releaseResources();
+
+    uint32_t m_width{0};
+    uint32_t m_height{0};
+    uint32_t m_surfaceHeight{0};
+    bool m_bt709{true};
+    std::deque<PendingPicture> m_pending;
+
+    // Video Codec SDK handles
+    void* m_context{nullptr};  // CUcontext (runtime primary context)
+    void* m_lock{nullptr};     // CUvideoctxlock
+    void* m_parser{nullptr};   // CUvideoparser
+    void* m_decoder{nullptr};  // CUvideodecoder
+};
+
+} // namespace capture
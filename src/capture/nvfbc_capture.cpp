@@ -0,0 +1,366 @@
+#include "nvfbc_capture.hpp"
+#include "../utils/gpu_memory_pool.hpp"
+#include "../utils/logger.hpp"
+#include <algorithm>
+#include <thread>
+
+#ifdef BLACKJACK_NVFBC
+#include <NvFBC.h>
+#include <cuda.h>
+#include <dlfcn.h>
+#endif
+
+namespace capture {
+
+#ifdef BLACKJACK_NVFBC
+namespace {
+
+constexpr const char* NVFBC_LIBRARY = "libnvidia-fbc.so.1";
+
+NVFBC_API_FUNCTION_LIST& api(void* functions) {
+    return *static_cast<NVFBC_API_FUNCTION_LIST*>(functions);
+}
+
+} // namespace
+#endif
+
+NvFBCCapture::NvFBCCapture(const core::CaptureConfig& config)
+    : m_config(config) {
+}
+
+NvFBCCapture::~NvFBCCapture() {
+    stop();
+    releaseResources();
+}
+
+bool NvFBCCapture::initialize() {
+    auto& logger = utils::Logger::getInstance();
+
+#ifdef BLACKJACK_NVFBC
+    if (!loadLibrary()) {
+        releaseResources();
+        return false;
+    }
+
+    NVFBC_CREATE_HANDLE_PARAMS handleParams{};
+    handleParams.dwVersion = NVFBC_CREATE_HANDLE_PARAMS_VER;
+    NVFBC_SESSION_HANDLE handle = 0;
+    NVFBCSTATUS status = api(m_api).nvFBCCreateHandle(&handle, &handleParams);
+    if (status != NVFBC_SUCCESS) {
+        logger.error("nvFBCCreateHandle failed: {}", static_cast<int>(status));
+        releaseResources();
+        return false;
+    }
+    m_handle = handle;
+    m_boundThread = std::this_thread::get_id();  // Creation makes the context current here
+
+    NVFBC_GET_STATUS_PARAMS statusParams{};
+    statusParams.dwVersion = NVFBC_GET_STATUS_PARAMS_VER;
+    status = api(m_api).nvFBCGetStatus(m_handle, &statusParams);
+    if (status != NVFBC_SUCCESS || !statusParams.bIsCapturePossible) {
+        logger.error("NvFBC capture is not possible on this system (driver or GPU does not allow it)");
+        releaseResources();
+        return false;
+    }
+    m_screenWidth = statusParams.screenSize.w;
+    m_screenHeight = statusParams.screenSize.h;
+
+    // Configured crop, clamped to the screen
+    const auto& box = m_config.capture_region;
+    if (box[2] > 0 && box[3] > 0 && box[0] < m_screenWidth && box[1] < m_screenHeight) {
+        m_initialRegion = {box[0], box[1],
+                           std::min(box[2], m_screenWidth - box[0]),
+                           std::min(box[3], m_screenHeight - box[1])};
+    } else {
+        m_initialRegion = {0, 0, m_screenWidth, m_screenHeight};
+    }
+
+    m_frameRate = std::max<uint32_t>(m_config.frame_rate, 1);
+    m_period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::nanoseconds(1'000'000'000ull / m_frameRate));
+
+    if (!createSession(m_initialRegion)) {
+        releaseResources();
+        return false;
+    }
+    m_width = m_initialRegion.width;
+    m_height = m_initialRegion.height;
+
+    cudaStreamCreateWithFlags(&m_stream, cudaStreamNonBlocking);
+    cudaEventCreateWithFlags(&m_readyEvent, cudaEventDisableTiming);
+    cudaEventCreateWithFlags(&m_copyDone, cudaEventDisableTiming);
+    m_deviceFrame = static_cast<uint8_t*>(utils::GpuMemoryPool::getInstance().allocatePitch(
+        static_cast<size_t>(m_width) * 4, m_height, m_devicePitch, utils::MemoryTag::Capture));
+    if (!m_deviceFrame) {
+        logger.error("Failed to allocate device frame");
+        releaseResources();
+        return false;
+    }
+
+    // The capture thread binds the context on its first grab
+    NVFBC_RELEASE_CONTEXT_PARAMS releaseParams{};
+    releaseParams.dwVersion = NVFBC_RELEASE_CONTEXT_PARAMS_VER;
+    api(m_api).nvFBCReleaseContext(m_handle, &releaseParams);
+    m_boundThread = {};
+
+    m_initialized = true;
+    logger.info("NvFBC capture initialized: {}x{} at ({}, {}) of {}x{} @ {}Hz", m_width, m_height,
+                m_region.x, m_region.y, m_screenWidth, m_screenHeight, m_frameRate);
+    return true;
+#else
+    logger.error("Built without NvFBC; set NVFBC_SDK_DIR to the Capture SDK");
+    return false;
+#endif
+}
+
+bool NvFBCCapture::start() {
+    m_nextGrab = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool NvFBCCapture::stop() {
+    return true;
+}
+
+bool NvFBCCapture::captureFrame(Frame& frame) {
+#ifdef BLACKJACK_NVFBC
+    if (!m_initialized) return false;
+    if (m_boundThread != std::this_thread::get_id() && !bindContext()) return false;
+
+    if (m_regionPending.exchange(false, std::memory_order_acquire)) {
+        ROI region;
+        {
+            std::lock_guard<std::mutex> lock(m_regionMutex);
+            region = m_pendingRegion;
+        }
+        destroySession();
+        if (!createSession(region) && !createSession(m_region)) {
+            return false;
+        }
+    }
+
+    // Fixed cadence: grabbing without waiting for damage keeps the frame
+    // rate steady on a static table
+    const auto now = std::chrono::steady_clock::now();
+    if (m_nextGrab > now) {
+        std::this_thread::sleep_until(m_nextGrab);
+    }
+    m_nextGrab = std::max(m_nextGrab + m_period, now);
+
+    // The previous frame's copy must be done before NvFBC overwrites its buffer
+    cudaEventSynchronize(m_copyDone);
+
+    CUdeviceptr grabbed = 0;
+    NVFBC_FRAME_GRAB_INFO grabInfo{};
+    NVFBC_TOCUDA_GRAB_FRAME_PARAMS grabParams{};
+    grabParams.dwVersion = NVFBC_TOCUDA_GRAB_FRAME_PARAMS_VER;
+    grabParams.dwFlags = NVFBC_TOCUDA_GRAB_FLAGS_NOWAIT;
+    grabParams.pCUDADeviceBuffer = &grabbed;
+    grabParams.pFrameGrabInfo = &grabInfo;
+
+    const NVFBCSTATUS status = api(m_api).nvFBCToCudaGrabFrame(m_handle, &grabParams);
+    if (status == NVFBC_ERR_MUST_RECREATE) {
+        // Mode switch or display reconfiguration
+        utils::Logger::getInstance().warning("NvFBC session lost, recreating");
+        destroySession();
+        createSession(m_region);
+        return false;
+    }
+    if (status != NVFBC_SUCCESS) {
+        utils::Logger::getInstance().error("nvFBCToCudaGrabFrame failed: {}",
+                                           api(m_api).nvFBCGetLastErrorStr(m_handle));
+        return false;
+    }
+
+    const bool intoTarget = frame.memory == FrameMemory::Device && frame.data != nullptr;
+    uint8_t* target = intoTarget ? frame.data : m_deviceFrame;
+    const size_t pitch = intoTarget ? frame.stride : m_devicePitch;
+    cudaEvent_t fence = intoTarget && frame.ready_event ? frame.ready_event : m_readyEvent;
+
+    const uint32_t width = std::min(grabInfo.dwWidth, m_width);
+    const uint32_t height = std::min(grabInfo.dwHeight, m_height);
+    const cudaError_t copyStatus = cudaMemcpy2DAsync(target, pitch, reinterpret_cast<const void*>(grabbed),
+                                                     static_cast<size_t>(grabInfo.dwWidth) * 4,
+                                                     static_cast<size_t>(width) * 4, height,
+                                                     cudaMemcpyDeviceToDevice, m_stream);
+    if (copyStatus != cudaSuccess) {
+        utils::Logger::getInstance().error("NvFBC frame copy failed: {}", cudaGetErrorString(copyStatus));
+        return false;
+    }
+    cudaEventRecord(m_copyDone, m_stream);
+    cudaEventRecord(fence, m_stream);
+
+    frame.data = target;
+    frame.width = width;
+    frame.height = height;
+    frame.stride = static_cast<uint32_t>(pitch);
+    frame.memory = FrameMemory::Device;
+    frame.ready_event = fence;
+    frame.timestamp_ns = std::chrono::high_resolution_clock::now()
+                         .time_since_epoch().count();
+    frame.frame_id = m_frameCounter++;
+    return true;
+#else
+    (void)frame;
+    return false;
+#endif
+}
+
+void NvFBCCapture::releaseFrame(Frame& frame) {
+    (void)frame;  // Device frames stay valid until the next capture
+}
+
+bool NvFBCCapture::setCaptureRegion(const ROI& region) {
+    ROI next = region.width == 0 || region.height == 0 ? m_initialRegion : region;
+    if (next.width > m_width || next.height > m_height ||
+        next.x + next.width > m_screenWidth || next.y + next.height > m_screenHeight) {
+        utils::Logger::getInstance().warning("Capture region {}x{} at ({}, {}) does not fit the {}x{} frames",
+                                             next.width, next.height, next.x, next.y, m_width, m_height);
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_regionMutex);
+        m_pendingRegion = next;
+    }
+    m_regionPending.store(true, std::memory_order_release);
+    return true;
+}
+
+bool NvFBCCapture::loadLibrary() {
+#ifdef BLACKJACK_NVFBC
+    auto& logger = utils::Logger::getInstance();
+
+    m_library = dlopen(NVFBC_LIBRARY, RTLD_NOW);
+    if (!m_library) {
+        logger.error("Failed to load {}: {}", NVFBC_LIBRARY, dlerror());
+        return false;
+    }
+
+    auto createInstance = reinterpret_cast<PNVFBCCREATEINSTANCE>(dlsym(m_library, "NvFBCCreateInstance"));
+    if (!createInstance) {
+        logger.error("{} has no NvFBCCreateInstance", NVFBC_LIBRARY);
+        return false;
+    }
+
+    auto* functions = new NVFBC_API_FUNCTION_LIST{};
+    functions->dwVersion = NVFBC_VERSION;
+    m_api = functions;
+    const NVFBCSTATUS status = createInstance(functions);
+    if (status != NVFBC_SUCCESS) {
+        logger.error("NvFBCCreateInstance failed: {} (driver too old for NvFBC {}.{}?)",
+                     static_cast<int>(status), NVFBC_VERSION_MAJOR, NVFBC_VERSION_MINOR);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool NvFBCCapture::createSession(const ROI& region) {
+#ifdef BLACKJACK_NVFBC
+    auto& logger = utils::Logger::getInstance();
+
+    NVFBC_CREATE_CAPTURE_SESSION_PARAMS sessionParams{};
+    sessionParams.dwVersion = NVFBC_CREATE_CAPTURE_SESSION_PARAMS_VER;
+    sessionParams.eCaptureType = NVFBC_CAPTURE_SHARED_CUDA;
+    sessionParams.eTrackingType = NVFBC_TRACKING_SCREEN;
+    sessionParams.bWithCursor = NVFBC_FALSE;
+    sessionParams.captureBox = {region.x, region.y, region.width, region.height};
+    sessionParams.frameSize = {region.width, region.height};  // Crop only, never scale
+    sessionParams.dwSamplingRateMs = std::max<uint32_t>(1000 / m_frameRate, 1);
+
+    NVFBCSTATUS status = api(m_api).nvFBCCreateCaptureSession(m_handle, &sessionParams);
+    if (status != NVFBC_SUCCESS) {
+        logger.error("nvFBCCreateCaptureSession failed: {}", api(m_api).nvFBCGetLastErrorStr(m_handle));
+        return false;
+    }
+    m_sessionOpen = true;
+
+    NVFBC_TOCUDA_SETUP_PARAMS setupParams{};
+    setupParams.dwVersion = NVFBC_TOCUDA_SETUP_PARAMS_VER;
+    setupParams.eBufferFormat = NVFBC_BUFFER_FORMAT_BGRA;
+    status = api(m_api).nvFBCToCudaSetUp(m_handle, &setupParams);
+    if (status != NVFBC_SUCCESS) {
+        logger.error("nvFBCToCudaSetUp failed: {}", api(m_api).nvFBCGetLastErrorStr(m_handle));
+        destroySession();
+        return false;
+    }
+
+    m_region = region;
+    return true;
+#else
+    (void)region;
+    return false;
+#endif
+}
+
+void NvFBCCapture::destroySession() {
+#ifdef BLACKJACK_NVFBC
+    if (!m_sessionOpen) return;
+    NVFBC_DESTROY_CAPTURE_SESSION_PARAMS params{};
+    params.dwVersion = NVFBC_DESTROY_CAPTURE_SESSION_PARAMS_VER;
+    api(m_api).nvFBCDestroyCaptureSession(m_handle, &params);
+    m_sessionOpen = false;
+#endif
+}
+
+bool NvFBCCapture::bindContext() {
+#ifdef BLACKJACK_NVFBC
+    NVFBC_BIND_CONTEXT_PARAMS params{};
+    params.dwVersion = NVFBC_BIND_CONTEXT_PARAMS_VER;
+    if (api(m_api).nvFBCBindContext(m_handle, &params) != NVFBC_SUCCESS) {
+        utils::Logger::getInstance().error("nvFBCBindContext failed: {}",
+                                           api(m_api).nvFBCGetLastErrorStr(m_handle));
+        return false;
+    }
+    m_boundThread = std::this_thread::get_id();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void NvFBCCapture::releaseResources() {
+    if (m_copyDone) {
+        cudaEventSynchronize(m_copyDone);
+        cudaEventDestroy(m_copyDone);
+        m_copyDone = nullptr;
+    }
+    utils::GpuMemoryPool::getInstance().release(m_deviceFrame);
+    m_deviceFrame = nullptr;
+    if (m_readyEvent) {
+        cudaEventDestroy(m_readyEvent);
+        m_readyEvent = nullptr;
+    }
+    if (m_stream) {
+        cudaStreamDestroy(m_stream);
+        m_stream = nullptr;
+    }
+
+#ifdef BLACKJACK_NVFBC
+    if (m_handle) {
+        // Teardown runs after the capture thread exited; take the context over
+        if (m_boundThread != std::this_thread::get_id()) {
+            bindContext();
+        }
+        destroySession();
+        NVFBC_DESTROY_HANDLE_PARAMS params{};
+        params.dwVersion = NVFBC_DESTROY_HANDLE_PARAMS_VER;
+        api(m_api).nvFBCDestroyHandle(m_handle, &params);
+        m_handle = 0;
+    }
+    delete static_cast<NVFBC_API_FUNCTION_LIST*>(m_api);
+    m_api = nullptr;
+    if (m_library) {
+        dlclose(m_library);
+        m_library = nullptr;
+    }
+#endif
+
+    m_boundThread = {};
+    m_initialized = false;
+}
+
+} // namespace capture
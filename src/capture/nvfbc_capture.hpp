@@ -0,0 +1,84 @@
+#pragma once
+
+#include "capture_interface.hpp"
+#include "roi_detector.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace capture {
+
+/**
+ * NVIDIA Frame Buffer Capture straight into CUDA memory. The driver grabs
+ * the scanout (optionally cropped to a region in hardware) into a device
+ * buffer; each frame is copied device-to-device into the caller's slot on
+ * the backend stream, so no pixel ever crosses PCIe. Frames are grabbed on
+ * a fixed cadence at the configured rate, whether or not the desktop
+ * changed. libnvidia-fbc is loaded at runtime; builds without the Capture
+ * SDK header (BLACKJACK_NVFBC) fail initialize().
+ */
+class NvFBCCapture : public CaptureInterface {
+public:
+    explicit NvFBCCapture(const core::CaptureConfig& config);
+    ~NvFBCCapture() override;
+
+    bool initialize() override;
+    bool start() override;
+    bool stop() override;
+    bool captureFrame(Frame& frame) override;
+    void releaseFrame(Frame& frame) override;
+
+    uint32_t getWidth() const override { return m_width; }
+    uint32_t getHeight() const override { return m_height; }
+    uint32_t getFrameRate() const override { return m_frameRate; }
+    cudaStream_t getStream() const override { return m_stream; }
+
+    // Re-crops to region (screen coordinates) from the next grab on. The
+    // region must fit in the size fixed at initialize(), which sizes the
+    // frame buffer slots; a zero-size region restores the initial one.
+    bool setCaptureRegion(const ROI& region);
+
+private:
+    bool loadLibrary();
+    bool createSession(const ROI& region);
+    void destroySession();
+    bool bindContext();
+    void releaseResources();
+
+    core::CaptureConfig m_config;
+    uint32_t m_width{0};
+    uint32_t m_height{0};
+    uint32_t m_frameRate{120};
+    uint32_t m_screenWidth{0};
+    uint32_t m_screenHeight{0};
+    uint32_t m_frameCounter{0};
+    bool m_initialized{false};
+
+    // Crop in effect, and a replacement queued by setCaptureRegion()
+    ROI m_region{};
+    ROI m_initialRegion{};
+    std::mutex m_regionMutex;
+    ROI m_pendingRegion{};
+    std::atomic<bool> m_regionPending{false};
+
+    // Grab cadence
+    std::chrono::steady_clock::duration m_period{};
+    std::chrono::steady_clock::time_point m_nextGrab{};
+
+    // NvFBC handles
+    void* m_library{nullptr};  // dlopen handle of libnvidia-fbc
+    void* m_api{nullptr};      // NVFBC_API_FUNCTION_LIST
+    uint64_t m_handle{0};      // NVFBC_SESSION_HANDLE
+    bool m_sessionOpen{false};
+    std::thread::id m_boundThread;  // Thread the NvFBC context is current on
+
+    // CUDA resources
+    cudaStream_t m_stream{nullptr};
+    cudaEvent_t m_readyEvent{nullptr};
+    cudaEvent_t m_copyDone{nullptr};  // NvFBC reuses its buffer on the next grab
+    uint8_t* m_deviceFrame{nullptr};  // Copy target when the caller gives none
+    size_t m_devicePitch{0};
+};
+
+} // namespace capture
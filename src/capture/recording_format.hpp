@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace capture {
+
+/**
+ * .bjrec session recordings, little-endian:
+ *
+ *   RecordingHeader                           64 bytes
+ *   frame payloads, each RECORDING_ALIGNMENT-aligned
+ *   RecordingIndexEntry[frame_count]          at index_offset
+ *
+ * Raw payloads are tightly packed BGRA rows (width * 4 bytes each).
+ * Compressed payloads are one Annex-B access unit per entry, decoded with
+ * NVDEC on replay. The writer fills in frame_count and index_offset on
+ * close, so an unfinished recording has index_offset == 0 and is rejected.
+ */
+
+constexpr std::array<char, 8> RECORDING_MAGIC = {'B', 'J', 'R', 'E', 'C', '0', '0', '1'};
+constexpr uint32_t RECORDING_VERSION = 1;
+constexpr uint64_t RECORDING_ALIGNMENT = 4096;  // Page-aligned payloads map and prefetch cleanly
+
+enum class RecordingCodec : uint32_t {
+    RawBGRA = 0,
+    H264 = 1,
+    HEVC = 2
+};
+
+struct RecordingHeader {
+    std::array<char, 8> magic;
+    uint32_t version;
+    RecordingCodec codec;
+    uint32_t width;
+    uint32_t height;
+    uint32_t frame_rate;    // Nominal rate of the source
+    uint32_t frame_count;
+    uint64_t index_offset;
+    uint64_t first_timestamp_ns;
+    std::array<uint8_t, 16> reserved;
+};
+
+enum RecordingFrameFlags : uint32_t {
+    RECORDING_FRAME_KEY = 1u << 0  // Raw frames always; IDR/IRAP access units
+};
+
+struct RecordingIndexEntry {
+    uint64_t offset;
+    uint32_t size;
+    uint32_t flags;
+    uint64_t timestamp_ns;  // Original capture time
+    uint32_t frame_id;      // Original frame id
+    uint32_t reserved;
+};
+
+static_assert(sizeof(RecordingHeader) == 64, "Recording header layout is part of the file format");
+static_assert(sizeof(RecordingIndexEntry) == 32, "Recording index layout is part of the file format");
+
+} // namespace capture
@@ -0,0 +1,95 @@
+#include "recording_writer.hpp"
+#include "../utils/logger.hpp"
+#include <array>
+
+namespace capture {
+
+namespace {
+
+constexpr std::array<char, RECORDING_ALIGNMENT> ZERO_PAGE{};
+
+uint64_t alignUp(uint64_t value) {
+    return (value + RECORDING_ALIGNMENT - 1) & ~(RECORDING_ALIGNMENT - 1);
+}
+
+} // namespace
+
+RecordingWriter::RecordingWriter() {
+}
+
+RecordingWriter::~RecordingWriter() {
+    close();
+}
+
+bool RecordingWriter::open(const std::string& path, RecordingCodec codec,
+                           uint32_t width, uint32_t height, uint32_t frameRate) {
+    close();
+
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        utils::Logger::getInstance().error("Failed to create recording: {}", path);
+        return false;
+    }
+
+    m_path = path;
+    m_header = {};
+    m_header.magic = RECORDING_MAGIC;
+    m_header.version = RECORDING_VERSION;
+    m_header.codec = codec;
+    m_header.width = width;
+    m_header.height = height;
+    m_header.frame_rate = frameRate;
+    m_index.clear();
+
+    // Placeholder header, rewritten by close()
+    m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+    m_offset = alignUp(sizeof(m_header));
+    m_file.write(ZERO_PAGE.data(), static_cast<std::streamsize>(m_offset - sizeof(m_header)));
+    return static_cast<bool>(m_file);
+}
+
+bool RecordingWriter::append(const uint8_t* data, size_t size, uint64_t timestampNs,
+                             uint32_t frameId, uint32_t flags) {
+    if (!m_file.is_open()) return false;
+
+    if (m_index.empty()) {
+        m_header.first_timestamp_ns = timestampNs;
+    }
+
+    m_file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    const uint64_t next = alignUp(m_offset + size);
+    m_file.write(ZERO_PAGE.data(), static_cast<std::streamsize>(next - m_offset - size));
+    if (!m_file) {
+        utils::Logger::getInstance().error("Failed to write recording frame {} to {}", frameId, m_path);
+        return false;
+    }
+
+    m_index.push_back({m_offset, static_cast<uint32_t>(size), flags, timestampNs, frameId, 0});
+    m_offset = next;
+    return true;
+}
+
+bool RecordingWriter::close() {
+    if (!m_file.is_open()) return false;
+
+    m_header.frame_count = static_cast<uint32_t>(m_index.size());
+    m_header.index_offset = m_offset;
+
+    m_file.write(reinterpret_cast<const char*>(m_index.data()),
+                 static_cast<std::streamsize>(m_index.size() * sizeof(RecordingIndexEntry)));
+    m_file.seekp(0);
+    m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+
+    const bool ok = static_cast<bool>(m_file);
+    m_file.close();
+
+    auto& logger = utils::Logger::getInstance();
+    if (!ok) {
+        logger.error("Failed to finalize recording: {}", m_path);
+        return false;
+    }
+    logger.info("Recording closed: {} frames in {}", m_header.frame_count, m_path);
+    return true;
+}
+
+} // namespace capture
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "recording_format.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace capture {
+
+// Synchronous .bjrec writer: payloads are appended in order and the index
+// is written on close(). Raw BGRA from the FrameRecorder, or pre-encoded
+// access units muxed from elsewhere.
+class RecordingWriter {
+public:
+    RecordingWriter();
+    ~RecordingWriter();
+
+    RecordingWriter(const RecordingWriter&) = delete;
+    RecordingWriter& operator=(const RecordingWriter&) = delete;
+
+    bool open(const std::string& path, RecordingCodec codec,
+              uint32_t width, uint32_t height, uint32_t frameRate);
+
+    bool append(const uint8_t* data, size_t size, uint64_t timestampNs,
+                uint32_t frameId, uint32_t flags = RECORDING_FRAME_KEY);
+
+    // Writes the index and patches the header; the file is unusable without it
+    bool close();
+
+    bool isOpen() const { return m_file.is_open(); }
+    uint32_t getFrameCount() const { return static_cast<uint32_t>(m_index.size()); }
+
+private:
+    std::ofstream m_file;
+    std::string m_path;
+    RecordingHeader m_header{};
+    std::vector<RecordingIndexEntry> m_index;
+    uint64_t m_offset{0};
+};
+
+} // namespace capture
@@ -0,0 +1,286 @@
+#include "replay_capture.hpp"
+#include "../utils/gpu_memory_pool.hpp"
+#include "../utils/logger.hpp"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace capture {
+
+namespace {
+
+// Longest a captureFrame call blocks, like the desktop acquire timeout
+constexpr auto MAX_FRAME_WAIT = std::chrono::milliseconds(16);
+
+// Frames paged in ahead of the cursor
+constexpr uint32_t PREFETCH_FRAMES = 4;
+
+const char* codecName(RecordingCodec codec) {
+    switch (codec) {
+        case RecordingCodec::RawBGRA: return "raw BGRA";
+        case RecordingCodec::H264: return "H.264";
+        case RecordingCodec::HEVC: return "HEVC";
+    }
+    return "unknown";
+}
+
+uint64_t wallClockNs() {
+    return static_cast<uint64_t>(std::chrono::high_resolution_clock::now()
+                                 .time_since_epoch().count());
+}
+
+} // namespace
+
+ReplayCapture::ReplayCapture(const core::CaptureConfig& config)
+    : m_config(config) {
+}
+
+ReplayCapture::~ReplayCapture() {
+    stop();
+    releaseResources();
+}
+
+bool ReplayCapture::initialize() {
+    auto& logger = utils::Logger::getInstance();
+
+    if (m_config.replay_path.empty()) {
+        logger.error("Replay capture needs capture.replay_path");
+        return false;
+    }
+    if (!m_file.open(m_config.replay_path)) {
+        logger.error("Failed to map recording: {}", m_config.replay_path);
+        return false;
+    }
+    if (!validate()) {
+        releaseResources();
+        return false;
+    }
+
+    cudaStreamCreateWithFlags(&m_stream, cudaStreamNonBlocking);
+    cudaEventCreateWithFlags(&m_readyEvent, cudaEventDisableTiming);
+
+    if (m_header.codec != RecordingCodec::RawBGRA) {
+        m_decoder = std::make_unique<NvdecDecoder>();
+        if (!m_decoder->initialize(m_header.codec, m_header.width, m_header.height,
+                                   m_config.color_space != "bt601")) {
+            releaseResources();
+            return false;
+        }
+
+        // Raw frames can be handed out from the mapping; decoded ones need somewhere to land
+        m_deviceFrame = static_cast<uint8_t*>(utils::GpuMemoryPool::getInstance().allocatePitch(
+            static_cast<size_t>(m_header.width) * 4, m_header.height, m_devicePitch,
+            utils::MemoryTag::Capture));
+        if (!m_deviceFrame) {
+            logger.error("Failed to allocate replay frame");
+            releaseResources();
+            return false;
+        }
+    }
+
+    const uint64_t durationNs = m_index.back().timestamp_ns - m_index.front().timestamp_ns;
+    logger.info("Replay capture initialized: {} ({} frames, {}x{}, {}, {:.1f} s)",
+                m_config.replay_path, m_header.frame_count, m_header.width, m_header.height,
+                codecName(m_header.codec), durationNs / 1e9);
+    return true;
+}
+
+bool ReplayCapture::start() {
+    m_cursor = 0;
+    m_frameCounter = 0;
+    m_loopOffsetNs = 0;
+    m_startTime = std::chrono::steady_clock::now();
+    if (m_decoder) {
+        m_decoder->reset();
+    }
+    return true;
+}
+
+bool ReplayCapture::stop() {
+    return true;
+}
+
+uint32_t ReplayCapture::getFrameRate() const {
+    return m_config.replay_pacing == core::CaptureConfig::ReplayPacing::Fixed
+        ? m_config.frame_rate
+        : m_header.frame_rate;
+}
+
+bool ReplayCapture::isExhausted() const {
+    return !m_config.replay_loop && m_cursor >= m_index.size();
+}
+
+bool ReplayCapture::captureFrame(Frame& frame) {
+    if (m_index.empty()) return false;
+
+    if (m_cursor >= m_index.size()) {
+        if (!m_config.replay_loop) {
+            std::this_thread::sleep_for(MAX_FRAME_WAIT);
+            return false;
+        }
+
+        // Next pass continues the recorded clock one frame after the last
+        const uint64_t period = m_header.frame_rate ? 1'000'000'000ull / m_header.frame_rate : 0;
+        m_loopOffsetNs += m_index.back().timestamp_ns - m_index.front().timestamp_ns + period;
+        m_cursor = 0;
+        if (m_decoder) {
+            m_decoder->reset();
+        }
+    }
+
+    const RecordingIndexEntry& entry = m_index[m_cursor];
+    if (!waitForDeadline(entry)) {
+        return false;  // Not due yet
+    }
+
+    const uint32_t ahead = std::min<uint32_t>(m_cursor + PREFETCH_FRAMES, m_header.frame_count - 1);
+    if (ahead > m_cursor) {
+        const RecordingIndexEntry& last = m_index[ahead];
+        m_file.prefetch(entry.offset, last.offset + last.size - entry.offset);
+    }
+    m_cursor++;
+
+    const bool intoTarget = frame.memory == FrameMemory::Device && frame.data != nullptr;
+    if (!uploadFrame(frame, entry, intoTarget)) {
+        return false;
+    }
+
+    frame.width = m_header.width;
+    frame.height = m_header.height;
+    frame.timestamp_ns = wallClockNs();
+    frame.source_timestamp_ns = entry.timestamp_ns + m_loopOffsetNs;
+    frame.frame_id = m_frameCounter++;
+    return true;
+}
+
+void ReplayCapture::releaseFrame(Frame& frame) {
+    (void)frame;  // Mapped and device frames stay valid until the next capture
+}
+
+bool ReplayCapture::validate() {
+    auto& logger = utils::Logger::getInstance();
+    const size_t fileSize = m_file.size();
+
+    if (fileSize < sizeof(RecordingHeader)) {
+        logger.error("Recording is truncated: {}", m_config.replay_path);
+        return false;
+    }
+    std::memcpy(&m_header, m_file.data(), sizeof(m_header));
+
+    if (m_header.magic != RECORDING_MAGIC || m_header.version != RECORDING_VERSION) {
+        logger.error("Not a version {} .bjrec recording: {}", RECORDING_VERSION, m_config.replay_path);
+        return false;
+    }
+    if (m_header.index_offset == 0) {
+        logger.error("Recording was never finalized: {}", m_config.replay_path);
+        return false;
+    }
+    if (m_header.width == 0 || m_header.height == 0 || m_header.frame_count == 0) {
+        logger.error("Recording has no frames: {}", m_config.replay_path);
+        return false;
+    }
+
+    const uint64_t indexBytes = static_cast<uint64_t>(m_header.frame_count) * sizeof(RecordingIndexEntry);
+    if (m_header.index_offset % alignof(RecordingIndexEntry) != 0 ||
+        m_header.index_offset > fileSize || indexBytes > fileSize - m_header.index_offset) {
+        logger.error("Recording index is out of bounds: {}", m_config.replay_path);
+        return false;
+    }
+    m_index = {reinterpret_cast<const RecordingIndexEntry*>(m_file.data() + m_header.index_offset),
+               m_header.frame_count};
+
+    const uint64_t rawBytes = static_cast<uint64_t>(m_header.width) * m_header.height * 4;
+    for (const RecordingIndexEntry& entry : m_index) {
+        const bool inBounds = entry.offset <= m_header.index_offset &&
+                              entry.size <= m_header.index_offset - entry.offset;
+        const bool sized = m_header.codec == RecordingCodec::RawBGRA ? entry.size == rawBytes : entry.size > 0;
+        if (!inBounds || !sized) {
+            logger.error("Recording frame {} is corrupt: {}", entry.frame_id, m_config.replay_path);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ReplayCapture::waitForDeadline(const RecordingIndexEntry& entry) {
+    using Pacing = core::CaptureConfig::ReplayPacing;
+
+    uint64_t dueNs = 0;
+    switch (m_config.replay_pacing) {
+        case Pacing::Recorded:
+            dueNs = entry.timestamp_ns - m_index.front().timestamp_ns + m_loopOffsetNs;
+            break;
+        case Pacing::Fixed:
+            if (m_config.frame_rate == 0) return true;
+            dueNs = static_cast<uint64_t>(m_frameCounter) * 1'000'000'000ull / m_config.frame_rate;
+            break;
+        case Pacing::Unthrottled:
+            return true;
+    }
+
+    const auto deadline = m_startTime + std::chrono::nanoseconds(dueNs);
+    const auto now = std::chrono::steady_clock::now();
+    if (deadline - now > MAX_FRAME_WAIT) {
+        std::this_thread::sleep_for(MAX_FRAME_WAIT);
+        return false;
+    }
+    std::this_thread::sleep_until(deadline);
+    return true;
+}
+
+bool ReplayCapture::uploadFrame(Frame& frame, const RecordingIndexEntry& entry, bool intoTarget) {
+    const uint8_t* payload = m_file.data() + entry.offset;
+    const size_t rowBytes = static_cast<size_t>(m_header.width) * 4;
+
+    if (m_header.codec == RecordingCodec::RawBGRA && !intoTarget) {
+        // Zero copy: the frame points into the mapping
+        frame.data = const_cast<uint8_t*>(payload);
+        frame.stride = static_cast<uint32_t>(rowBytes);
+        frame.memory = FrameMemory::Host;
+        frame.ready_event = nullptr;
+        return true;
+    }
+
+    uint8_t* target = intoTarget ? frame.data : m_deviceFrame;
+    const size_t pitch = intoTarget ? frame.stride : m_devicePitch;
+    cudaEvent_t fence = intoTarget && frame.ready_event ? frame.ready_event : m_readyEvent;
+
+    if (m_header.codec == RecordingCodec::RawBGRA) {
+        // Pageable source: returns once the driver has staged the rows
+        const cudaError_t status = cudaMemcpy2DAsync(target, pitch, payload, rowBytes, rowBytes,
+                                                     m_header.height, cudaMemcpyHostToDevice, m_stream);
+        if (status != cudaSuccess) {
+            utils::Logger::getInstance().error("Replay upload failed: {}", cudaGetErrorString(status));
+            return false;
+        }
+    } else if (!m_decoder->decode(payload, entry.size, entry.timestamp_ns, target, pitch, m_stream)) {
+        return false;  // Decoder still buffering, or a decode error it already logged
+    }
+
+    cudaEventRecord(fence, m_stream);
+
+    frame.data = target;
+    frame.stride = static_cast<uint32_t>(pitch);
+    frame.memory = FrameMemory::Device;
+    frame.ready_event = fence;
+    return true;
+}
+
+void ReplayCapture::releaseResources() {
+    m_decoder.reset();
+    // Only the replay stream writes the frame: free behind it, then destroy it
+    utils::GpuMemoryPool::getInstance().release(m_deviceFrame, m_stream);
+    m_deviceFrame = nullptr;
+    if (m_readyEvent) {
+        cudaEventDestroy(m_readyEvent);
+        m_readyEvent = nullptr;
+    }
+    if (m_stream) {
+        cudaStreamDestroy(m_stream);
+        m_stream = nullptr;
+    }
+    m_index = {};
+    m_file.close();
+}
+
+} // namespace capture
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "capture_interface.hpp"
+#include "nvdec_decoder.hpp"
+#include "recording_format.hpp"
+#include "../utils/mapped_file.hpp"
+#include <chrono>
+#include <memory>
+#include <span>
+
+namespace capture {
+
+/**
+ * Streams a .bjrec recording as if it were the desktop. The file is memory
+ * mapped; raw frames are uploaded straight from the mapping, compressed
+ * ones decoded with NVDEC. Frames are stamped with the replay clock so the
+ * pipeline latency stays meaningful, and carry their recorded time in
+ * source_timestamp_ns.
+ */
+class ReplayCapture : public CaptureInterface {
+public:
+    explicit ReplayCapture(const core::CaptureConfig& config);
+    ~ReplayCapture() override;
+
+    bool initialize() override;
+    bool start() override;
+    bool stop() override;
+    bool captureFrame(Frame& frame) override;
+    void releaseFrame(Frame& frame) override;
+
+    uint32_t getWidth() const override { return m_header.width; }
+    uint32_t getHeight() const override { return m_header.height; }
+    uint32_t getFrameRate() const override;
+    cudaStream_t getStream() const override { return m_stream; }
+    bool isExhausted() const override;
+
+    uint32_t getFrameCount() const { return m_header.frame_count; }
+
+private:
+    bool validate();
+    bool waitForDeadline(const RecordingIndexEntry& entry);  // False while the frame is not due
+    bool uploadFrame(Frame& frame, const RecordingIndexEntry& entry, bool intoTarget);
+    void releaseResources();
+
+    core::CaptureConfig m_config;
+    utils::MappedFile m_file;
+    RecordingHeader m_header{};
+    std::span<const RecordingIndexEntry> m_index;
+    std::unique_ptr<NvdecDecoder> m_decoder;
+
+    uint32_t m_cursor{0};        // Next index entry
+    uint32_t m_frameCounter{0};
+    uint64_t m_loopOffsetNs{0};  // Recorded time added per completed loop
+    std::chrono::steady_clock::time_point m_startTime;
+
+    cudaStream_t m_stream{nullptr};
+    cudaEvent_t m_readyEvent{nullptr};
+    uint8_t* m_deviceFrame{nullptr};  // Decode target when the caller gives none
+    size_t m_devicePitch{0};
+};
+
+} // namespace capture
@@ -0,0 +1,206 @@
+#include "roi_detector.hpp"
+#include "../core/constants.hpp"
+#include "../utils/gpu_memory_pool.hpp"
+#include "../utils/logger.hpp"
+#include <algorithm>
+
+namespace capture {
+
+namespace {
+
+constexpr uint32_t SAMPLE_STEP = 4;         // Every 4th pixel of every 4th row
+constexpr int FELT_SATURATION = 40;         // max - min channel, 0-255
+constexpr float FELT_LINE_COVERAGE = 0.2f;  // Rows/columns at least this much felt bound the table
+constexpr uint32_t ROI_TOLERANCE = 16;      // Pixels an edge may drift before the ROI is replaced
+constexpr size_t THUMBNAIL_BYTES =
+    static_cast<size_t>(cuda::TABLE_THUMBNAIL_SIZE) * cuda::TABLE_THUMBNAIL_SIZE * 4;
+
+// Table felt: saturated green or blue, never red-dominant (cards, chips, skin)
+bool isFelt(const uint8_t* bgra) {
+    const int b = bgra[0], g = bgra[1], r = bgra[2];
+    const int high = std::max({r, g, b});
+    const int low = std::min({r, g, b});
+    return high - low >= FELT_SATURATION && high != r;
+}
+
+// First and one-past-last index whose felt share reaches the coverage
+bool coveredSpan(const std::vector<uint32_t>& felt, uint32_t samples, uint32_t& begin, uint32_t& end) {
+    const auto threshold = static_cast<uint32_t>(samples * FELT_LINE_COVERAGE);
+    auto covered = [threshold](uint32_t count) { return count > 0 && count >= threshold; };
+
+    const auto first = std::find_if(felt.begin(), felt.end(), covered);
+    if (first == felt.end()) return false;
+    const auto last = std::find_if(felt.rbegin(), felt.rend(), covered);
+
+    begin = static_cast<uint32_t>(first - felt.begin());
+    end = static_cast<uint32_t>(felt.rend() - last);
+    return true;
+}
+
+// Felt bounds of a BGRA8 host image, sampling every step-th pixel of every step-th row
+bool feltBounds(const uint8_t* pixels, uint32_t width, uint32_t height, size_t pitch,
+                uint32_t step, ROI& bounds) {
+    if (!pixels || width < step || height < step) return false;
+
+    // Felt hits per sampled row and column
+    const uint32_t rows = height / step;
+    const uint32_t cols = width / step;
+    std::vector<uint32_t> rowFelt(rows, 0);
+    std::vector<uint32_t> colFelt(cols, 0);
+
+    for (uint32_t r = 0; r < rows; r++) {
+        const uint8_t* row = pixels + static_cast<size_t>(r) * step * pitch;
+        for (uint32_t c = 0; c < cols; c++) {
+            if (isFelt(row + static_cast<size_t>(c) * step * 4)) {
+                rowFelt[r]++;
+                colFelt[c]++;
+            }
+        }
+    }
+
+    uint32_t top, bottom, left, right;
+    if (!coveredSpan(rowFelt, cols, top, bottom) || !coveredSpan(colFelt, rows, left, right)) {
+        return false;
+    }
+
+    bounds.x = left * step;
+    bounds.y = top * step;
+    bounds.width = std::min(right * step, width) - bounds.x;
+    bounds.height = std::min(bottom * step, height) - bounds.y;
+    return true;
+}
+
+bool near(uint32_t a, uint32_t b) {
+    return (a > b ? a - b : b - a) <= ROI_TOLERANCE;
+}
+
+} // namespace
+
+ROIDetector::ROIDetector() {
+    m_cardRegions.reserve(core::constants::MAX_TRACKS);
+}
+
+ROIDetector::~ROIDetector() {
+    release();
+}
+
+bool ROIDetector::initialize() {
+    auto& pool = utils::GpuMemoryPool::getInstance();
+    if (!m_deviceThumbnail) {
+        m_deviceThumbnail = static_cast<uint8_t*>(pool.allocate(THUMBNAIL_BYTES, utils::MemoryTag::Capture));
+    }
+    if (!m_hostThumbnail) {
+        m_hostThumbnail = static_cast<uint8_t*>(pool.allocateHost(THUMBNAIL_BYTES, utils::MemoryTag::Capture));
+    }
+    if (!m_deviceThumbnail || !m_hostThumbnail) {
+        utils::Logger::getInstance().error("Failed to allocate table detection thumbnail");
+        release();
+        return false;
+    }
+    return true;
+}
+
+void ROIDetector::release() {
+    auto& pool = utils::GpuMemoryPool::getInstance();
+    if (m_deviceThumbnail) {
+        pool.release(m_deviceThumbnail);
+        m_deviceThumbnail = nullptr;
+    }
+    if (m_hostThumbnail) {
+        pool.releaseHost(m_hostThumbnail);
+        m_hostThumbnail = nullptr;
+    }
+}
+
+bool ROIDetector::detectTableRegion(const Frame& frame, cudaStream_t stream) {
+    if (!frame.data || frame.width == 0 || frame.height == 0) return false;
+    const size_t pitch = frame.stride ? frame.stride : static_cast<size_t>(frame.width) * 4;
+
+    if (frame.memory == FrameMemory::Host) {
+        return detectTableRegion(frame.data, frame.width, frame.height, pitch);
+    }
+    markRecalculated();
+    if (!m_deviceThumbnail || !m_hostThumbnail) return false;
+
+    // Every factor-th pixel, so the longer side fits the thumbnail
+    const uint32_t size = cuda::TABLE_THUMBNAIL_SIZE;
+    const uint32_t factor = std::max((frame.width + size - 1) / size, (frame.height + size - 1) / size);
+    const uint32_t width = frame.width / factor;
+    const uint32_t height = frame.height / factor;
+    const size_t bytes = static_cast<size_t>(width) * height * 4;
+
+    cudaError_t status = frame.ready_event ? cudaStreamWaitEvent(stream, frame.ready_event, 0) : cudaSuccess;
+    if (status == cudaSuccess) {
+        status = cuda::downsampleFrame(frame.data, pitch, factor, m_deviceThumbnail, width, height, stream);
+    }
+    if (status == cudaSuccess) {
+        status = cudaMemcpyAsync(m_hostThumbnail, m_deviceThumbnail, bytes, cudaMemcpyDeviceToHost, stream);
+    }
+    if (status == cudaSuccess) {
+        status = cudaStreamSynchronize(stream);
+    }
+    if (status != cudaSuccess) {
+        utils::Logger::getInstance().error("Table detection readback failed: {}", cudaGetErrorString(status));
+        return false;
+    }
+
+    ROI bounds{};
+    if (!feltBounds(m_hostThumbnail, width, height, static_cast<size_t>(width) * 4, 1, bounds)) {
+        m_tableROI = {};
+        return false;
+    }
+    bounds.x *= factor;
+    bounds.y *= factor;
+    bounds.width = std::min(bounds.width * factor, frame.width - bounds.x);
+    bounds.height = std::min(bounds.height * factor, frame.height - bounds.y);
+    adoptTableROI(bounds);
+    return true;
+}
+
+bool ROIDetector::detectTableRegion(const uint8_t* frame, uint32_t width, uint32_t height, size_t pitch) {
+    // A miss waits for the next interval like a hit, and falls back to the whole frame
+    markRecalculated();
+    ROI bounds{};
+    if (!feltBounds(frame, width, height, pitch, SAMPLE_STEP, bounds)) {
+        m_tableROI = {};
+        return false;
+    }
+    adoptTableROI(bounds);
+    return true;
+}
+
+// Edges that only drifted keep the previous ROI, so consumers keyed on it
+// (the motion gate's reference) are not invalidated by detection noise
+void ROIDetector::adoptTableROI(const ROI& roi) {
+    const ROI& old = m_tableROI;
+    if (old.width > 0 && near(old.x, roi.x) && near(old.y, roi.y) &&
+        near(old.x + old.width, roi.x + roi.width) && near(old.y + old.height, roi.y + roi.height)) {
+        return;
+    }
+    m_tableROI = roi;
+}
+
+void ROIDetector::setCardRegions(std::span<const core::Detection> cards,
+                                 uint32_t frameWidth, uint32_t frameHeight) {
+    m_cardRegions.clear();
+    for (const auto& card : cards) {
+        const float x0 = std::clamp(card.x, 0.0f, static_cast<float>(frameWidth));
+        const float y0 = std::clamp(card.y, 0.0f, static_cast<float>(frameHeight));
+        const float x1 = std::clamp(card.x + card.width, 0.0f, static_cast<float>(frameWidth));
+        const float y1 = std::clamp(card.y + card.height, 0.0f, static_cast<float>(frameHeight));
+        if (x1 <= x0 || y1 <= y0) continue;
+
+        m_cardRegions.push_back({static_cast<uint32_t>(x0), static_cast<uint32_t>(y0),
+                                 static_cast<uint32_t>(x1 - x0), static_cast<uint32_t>(y1 - y0)});
+    }
+}
+
+bool ROIDetector::needsRecalculation() const {
+    return m_framesSinceLastDetection >= RECALC_INTERVAL;
+}
+
+void ROIDetector::markRecalculated() {
+    m_framesSinceLastDetection = 0;
+}
+
+} // namespace capture
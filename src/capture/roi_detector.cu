@@ -0,0 +1,42 @@
+// CUDA Table-Detection Thumbnail Kernel
+
+#include "roi_detector.hpp"
+#include <cuda_runtime.h>
+#include <device_launch_parameters.h>
+
+namespace capture {
+namespace cuda {
+
+constexpr uint32_t BLOCK_WIDTH = 32;
+constexpr uint32_t BLOCK_HEIGHT = 8;
+
+// One thread per thumbnail pixel, nearest source pixel: felt detection only
+// needs saturation, so there is nothing to gain from filtering
+__global__ void downsampleFrameKernel(const uint8_t* __restrict__ source,
+                                      size_t sourcePitch,
+                                      uint32_t factor,
+                                      uint8_t* __restrict__ target,
+                                      uint32_t width, uint32_t height) {
+    const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+    const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+    if (x >= width || y >= height) return;
+
+    const uchar4* row = reinterpret_cast<const uchar4*>(source + static_cast<size_t>(y) * factor * sourcePitch);
+    reinterpret_cast<uchar4*>(target)[y * width + x] = row[x * factor];
+}
+
+cudaError_t downsampleFrame(const uint8_t* source, size_t sourcePitch, uint32_t factor,
+                            uint8_t* target, uint32_t width, uint32_t height, cudaStream_t stream) {
+    if (!source || !target || factor == 0 || width == 0 || height == 0) {
+        return cudaErrorInvalidValue;
+    }
+
+    const dim3 block(BLOCK_WIDTH, BLOCK_HEIGHT);
+    const dim3 grid((width + BLOCK_WIDTH - 1) / BLOCK_WIDTH, (height + BLOCK_HEIGHT - 1) / BLOCK_HEIGHT);
+    downsampleFrameKernel<<<grid, block, 0, stream>>>(source, sourcePitch, factor, target, width, height);
+
+    return cudaGetLastError();
+}
+
+} // namespace cuda
+} // namespace capture
@@ -1,6 +1,10 @@
 #pragma once
 
+#include "capture_interface.hpp"
+#include "../core/types.hpp"
+#include <cuda_runtime_api.h>
 #include <cstdint>
+#include <span>
 #include <vector>
 
 namespace capture {
@@ -9,23 +13,55 @@ struct ROI {
     uint32_t x, y, width, height;
 };
 
+namespace cuda {
+
+// Longest side of the table-detection thumbnail of a device frame
+constexpr uint32_t TABLE_THUMBNAIL_SIZE = 480;
+
+/**
+ * Point-samples every factor-th pixel of a pitched BGRA8 device surface
+ * into a tightly packed BGRA8 thumbnail of width x height.
+ */
+cudaError_t downsampleFrame(const uint8_t* source, size_t sourcePitch, uint32_t factor,
+                            uint8_t* target, uint32_t width, uint32_t height, cudaStream_t stream);
+
+} // namespace cuda
+
 class ROIDetector {
 public:
     ROIDetector();
     ~ROIDetector();
 
-    bool detectTableRegion(const uint8_t* frame, uint32_t width, uint32_t height);
+    // Thumbnail buffers for device frames
+    bool initialize();
+
+    // Felt bounds of the frame. Device frames are downsampled on stream and
+    // read back into a pinned thumbnail first; blocks until it is back.
+    bool detectTableRegion(const Frame& frame, cudaStream_t stream);
+    // BGRA8 host pixels, rows pitch bytes apart
+    bool detectTableRegion(const uint8_t* frame, uint32_t width, uint32_t height, size_t pitch);
     const ROI& getTableROI() const { return m_tableROI; }
-    std::vector<ROI> getCardRegions() const { return m_cardRegions; }
-    
+    const std::vector<ROI>& getCardRegions() const { return m_cardRegions; }
+
+    // Card regions for the next frame: the tracker's live boxes, clipped to the frame
+    void setCardRegions(std::span<const core::Detection> cards, uint32_t frameWidth, uint32_t frameHeight);
+
+    // Table detection is due on the first frame and every RECALC_INTERVAL frames after
     bool needsRecalculation() const;
     void markRecalculated();
+    void advanceFrame() { m_framesSinceLastDetection++; }
 
 private:
-    ROI m_tableROI;
+    void release();
+    void adoptTableROI(const ROI& roi);
+
+    ROI m_tableROI{};
     std::vector<ROI> m_cardRegions;
-    uint32_t m_framesSinceLastDetection{0};
+    uint32_t m_framesSinceLastDetection{RECALC_INTERVAL};
     static constexpr uint32_t RECALC_INTERVAL = 60;
+
+    uint8_t* m_deviceThumbnail{nullptr};
+    uint8_t* m_hostThumbnail{nullptr};  // Pinned
 };
 
 } // namespace capture
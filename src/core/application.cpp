@@ -27,8 +27,11 @@ bool Application::initialize() {
         // Initialize hardware
         initializeHardware();
         
-        // Initialize thread pool
-        initializeThreadPool();
+        // Build the stage pipeline
+        if (!initializePipeline()) {
+            logger.error("Failed to initialize pipeline");
+            return false;
+        }
         
         m_initialized = true;
         return true;
@@ -54,6 +57,9 @@ int Application::run() {
         // Process events
         // Update UI
         // Check for exit conditions
+        if (m_pipeline->isSourceExhausted()) {
+            m_running = false;  // Replay finished
+        }
     }
     
     stopPipeline();
@@ -72,21 +78,25 @@ void Application::initializeHardware() {
     // Initialize capture hardware
 }
 
-void Application::initializeThreadPool() {
-    // Initialize thread pool
-    // Pin threads to cores
-    // Set thread priorities
+bool Application::initializePipeline() {
+    m_pipeline = std::make_unique<pipeline::PipelineManager>();
+    return m_pipeline->initialize(*m_configManager);
 }
 
 void Application::startPipeline() {
-    // Start capture thread
-    // Start processing threads
-    // Start UI thread
+    if (!m_pipeline->start()) {
+        utils::Logger::getInstance().error("Failed to start pipeline");
+        m_running = false;
+        return;
+    }
+
+    // Edits to config.json reach the running stages from here on
+    m_configManager->watch(m_configManager->getSystemConfig().config_watch_interval_ms);
 }
 
 void Application::stopPipeline() {
-    // Stop all threads
-    // Wait for completion
+    m_configManager->unwatch();
+    m_pipeline->stop();
 }
 
 } // namespace core
@@ -3,6 +3,7 @@
 #include <memory>
 #include <atomic>
 #include "config_manager.hpp"
+#include "../pipeline/pipeline_manager.hpp"
 
 namespace core {
 
@@ -20,11 +21,12 @@ public:
 
 private:
     void initializeHardware();
-    void initializeThreadPool();
+    bool initializePipeline();
     void startPipeline();
     void stopPipeline();
 
     std::unique_ptr<ConfigManager> m_configManager;
+    std::unique_ptr<pipeline::PipelineManager> m_pipeline;
     std::atomic<bool> m_running{false};
     std::atomic<bool> m_initialized{false};
 };
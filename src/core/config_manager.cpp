@@ -1,27 +1,454 @@
 #include "config_manager.hpp"
+#include "../utils/json.hpp"
 #include "../utils/logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
 #include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace core {
 
+namespace {
+
+constexpr std::string_view SECTIONS[] = {
+    "system", "capture", "vision", "counting", "strategy", "betting", "ui"
+};
+
+// Typed reads of one top-level section. A missing key keeps the default;
+// a key of the wrong type or range fails the whole load with the first
+// error, so a half-edited file never becomes a snapshot.
+class SectionReader {
+public:
+    SectionReader(const utils::JsonValue& root, std::string_view name, std::string& error)
+        : m_section(root.find(name)), m_name(name), m_error(error) {
+        if (m_section && !m_section->isObject()) {
+            setError("section must be an object");
+            m_section = nullptr;
+        }
+    }
+
+    void read(const char* key, bool& field) {
+        if (const auto* value = lookup(key)) {
+            if (value->isBool()) field = value->asBool();
+            else mistyped(key, "a boolean", *value);
+        }
+    }
+
+    void read(const char* key, std::string& field) {
+        if (const auto* value = lookup(key)) {
+            if (value->isString()) field = value->asString();
+            else mistyped(key, "a string", *value);
+        }
+    }
+
+    void read(const char* key, float& field) {
+        if (const auto* value = lookup(key)) {
+            if (value->isNumber()) field = static_cast<float>(value->asNumber());
+            else mistyped(key, "a number", *value);
+        }
+    }
+
+    void read(const char* key, double& field) {
+        if (const auto* value = lookup(key)) {
+            if (value->isNumber()) field = value->asNumber();
+            else mistyped(key, "a number", *value);
+        }
+    }
+
+    void read(const char* key, uint32_t& field) {
+        if (const auto* value = lookup(key)) toInteger(key, *value, field);
+    }
+
+    void read(const char* key, int& field) {
+        if (const auto* value = lookup(key)) toInteger(key, *value, field);
+    }
+
+    template<typename T>
+    void read(const char* key, std::vector<T>& field) {
+        const auto* value = lookup(key);
+        if (!value) return;
+        if (!value->isArray()) return mistyped(key, "an array", *value);
+
+        std::vector<T> elements(value->asArray().size());
+        for (size_t i = 0; i < elements.size(); i++) {
+            if (!toInteger(key, value->asArray()[i], elements[i])) return;
+        }
+        field = std::move(elements);
+    }
+
+    template<size_t N>
+    void read(const char* key, std::array<uint32_t, N>& field) {
+        const auto* value = lookup(key);
+        if (!value) return;
+        if (!value->isArray() || value->asArray().size() != N) {
+            return setError(std::string(key) + " must be an array of " + std::to_string(N) + " integers");
+        }
+
+        std::array<uint32_t, N> elements{};
+        for (size_t i = 0; i < N; i++) {
+            if (!toInteger(key, value->asArray()[i], elements[i])) return;
+        }
+        field = elements;
+    }
+
+    template<typename E>
+    void readEnum(const char* key, E& field, std::initializer_list<std::pair<std::string_view, E>> names) {
+        const auto* value = lookup(key);
+        if (!value) return;
+        if (value->isString()) {
+            for (const auto& [name, option] : names) {
+                if (value->asString() == name) {
+                    field = option;
+                    return;
+                }
+            }
+        }
+
+        std::string expected;
+        for (const auto& [name, option] : names) {
+            expected += expected.empty() ? "\"" : ", \"";
+            expected += name;
+            expected += '"';
+        }
+        setError(std::string(key) + " must be one of " + expected);
+    }
+
+    // Keys nothing asked for are most likely typos
+    void finish() const {
+        if (!m_section) return;
+        for (const auto& [key, value] : m_section->asObject()) {
+            if (std::find(m_known.begin(), m_known.end(), key) == m_known.end()) {
+                utils::Logger::getInstance().warning("Unknown configuration key {}.{}", m_name, key);
+            }
+        }
+    }
+
+private:
+    const utils::JsonValue* lookup(const char* key) {
+        m_known.emplace_back(key);
+        return m_section ? m_section->find(key) : nullptr;
+    }
+
+    template<typename T>
+    bool toInteger(const char* key, const utils::JsonValue& value, T& field) {
+        if (value.isNumber()) {
+            const double number = value.asNumber();
+            if (number == std::floor(number) &&
+                number >= static_cast<double>(std::numeric_limits<T>::min()) &&
+                number <= static_cast<double>(std::numeric_limits<T>::max())) {
+                field = static_cast<T>(number);
+                return true;
+            }
+        }
+        setError(std::string(key) + (std::is_signed_v<T> ? " must be an integer" : " must be a non-negative integer"));
+        return false;
+    }
+
+    void mistyped(const char* key, const char* expected, const utils::JsonValue& value) {
+        setError(std::string(key) + " must be " + expected + ", not " + utils::jsonTypeName(value.type()));
+    }
+
+    void setError(const std::string& message) {
+        if (m_error.empty()) m_error = std::string(m_name) + ": " + message;
+    }
+
+    const utils::JsonValue* m_section;
+    std::string_view m_name;
+    std::string& m_error;
+    std::vector<std::string_view> m_known;
+};
+
+void readSystem(const utils::JsonValue& root, SystemConfig& config, std::string& error) {
+    SectionReader section(root, "system", error);
+    section.read("latency_target_ms", config.latency_target_ms);
+    section.read("gpu_device_id", config.gpu_device_id);
+    section.read("thread_affinity_enabled", config.thread_affinity_enabled);
+    section.read("real_time_priority", config.real_time_priority);
+    section.read("cuda_stream_priority", config.cuda_stream_priority);
+    section.read("cpu_core_affinity", config.cpu_core_affinity);
+    section.read("memory_pool_size_mb", config.memory_pool_size_mb);
+    section.read("enable_nvtx_markers", config.enable_nvtx_markers);
+    section.read("gpu_clock_lock_mhz", config.gpu_clock_lock_mhz);
+    section.read("queue_drop_oldest", config.queue_drop_oldest);
+    section.read("metrics_export_path", config.metrics_export_path);
+    section.read("trace_frames", config.trace_frames);
+    section.read("trace_output_path", config.trace_output_path);
+    section.read("config_watch_interval_ms", config.config_watch_interval_ms);
+    section.finish();
+}
+
+void readCapture(const utils::JsonValue& root, CaptureConfig& config, std::string& error) {
+    using Method = CaptureConfig::CaptureMethod;
+    using Pacing = CaptureConfig::ReplayPacing;
+
+    SectionReader section(root, "capture", error);
+    section.readEnum("method", config.method,
+                     {{"dxgi", Method::DXGI}, {"nvfbc", Method::NVFBC}, {"replay", Method::REPLAY}});
+    section.read("frame_rate", config.frame_rate);
+    section.read("buffer_count", config.buffer_count);
+    section.read("motion_detection_threshold", config.motion_detection_threshold);
+    section.read("motion_gating", config.motion_gating);
+    section.read("motion_min_changed_cells", config.motion_min_changed_cells);
+    section.read("motion_reverify_interval", config.motion_reverify_interval);
+    section.read("motion_cell_delta", config.motion_cell_delta);
+    section.read("use_hardware_encoding", config.use_hardware_encoding);
+    section.read("color_space", config.color_space);
+    section.read("hdr_enabled", config.hdr_enabled);
+    section.read("async_copy", config.async_copy);
+    section.read("cuda_interop", config.cuda_interop);
+    section.read("capture_region", config.capture_region);
+    section.read("replay_path", config.replay_path);
+    section.readEnum("replay_pacing", config.replay_pacing,
+                     {{"recorded", Pacing::Recorded}, {"fixed", Pacing::Fixed},
+                      {"unthrottled", Pacing::Unthrottled}});
+    section.read("replay_loop", config.replay_loop);
+    section.read("replay_lossless", config.replay_lossless);
+    section.read("record_path", config.record_path);
+    section.finish();
+}
+
+void readVision(const utils::JsonValue& root, VisionConfig& config, std::string& error) {
+    SectionReader section(root, "vision", error);
+    section.read("model_path", config.model_path);
+    section.read("onnx_path", config.onnx_path);
+    section.read("engine_cache_dir", config.engine_cache_dir);
+    section.read("fallback_model_path", config.fallback_model_path);
+    section.read("background_engine_build", config.background_engine_build);
+    section.read("model_type", config.model_type);
+    section.read("input_resolution", config.input_resolution);
+    section.read("resolution_profiles", config.resolution_profiles);
+    section.read("confidence_threshold", config.confidence_threshold);
+    section.read("nms_threshold", config.nms_threshold);
+    section.read("batch_size", config.batch_size);
+    section.read("use_fp16", config.use_fp16);
+    section.read("fp16_io", config.fp16_io);
+    section.read("use_int8", config.use_int8);
+    section.read("calibration_dir", config.calibration_dir);
+    section.read("calibration_cache", config.calibration_cache);
+    section.read("calibration_batch_size", config.calibration_batch_size);
+    section.read("calibration_max_frames", config.calibration_max_frames);
+    section.read("int8_accuracy_gate", config.int8_accuracy_gate);
+    section.read("int8_validation_dir", config.int8_validation_dir);
+    section.read("dla_core", config.dla_core);
+    section.read("max_workspace_size_mb", config.max_workspace_size_mb);
+    section.read("enable_cuda_graphs", config.enable_cuda_graphs);
+    section.read("inflight_depth", config.inflight_depth);
+    section.read("gpu_postprocessing", config.gpu_postprocessing);
+    section.read("inference_mode", config.inference_mode);
+    section.read("tile_model_path", config.tile_model_path);
+    section.read("tile_size", config.tile_size);
+    section.read("max_tiles", config.max_tiles);
+    section.read("localizer_model_path", config.localizer_model_path);
+    section.read("localizer_input_size", config.localizer_input_size);
+    section.read("classifier_model_path", config.classifier_model_path);
+    section.read("classifier_max_batch", config.classifier_max_batch);
+    section.read("cascade_skip_confidence", config.cascade_skip_confidence);
+    section.read("enable_tactic_sources", config.enable_tactic_sources);
+    section.read("profiling_verbosity", config.profiling_verbosity);
+    section.finish();
+}
+
+void readCounting(const utils::JsonValue& root, CountingConfig& config, std::string& error) {
+    using System = CountingConfig::CountingSystem;
+
+    SectionReader section(root, "counting", error);
+    section.readEnum("system", config.system,
+                     {{"hi-lo", System::HiLo}, {"ko", System::KO}, {"omega2", System::Omega2},
+                      {"halves", System::HalvesCount}});
+    section.read("deck_count", config.deck_count);
+    section.read("penetration", config.penetration);
+    section.read("history_size", config.history_size);
+    section.read("confirm_frames", config.confirm_frames);
+    section.read("confirm_confidence", config.confirm_confidence);
+    section.finish();
+}
+
+void readStrategy(const utils::JsonValue& root, StrategyConfig& config, std::string& error) {
+    SectionReader section(root, "strategy", error);
+    section.read("basic_strategy_rules", config.basic_strategy_rules);
+    section.read("deviations_enabled", config.deviations_enabled);
+    section.read("illustrious_18", config.illustrious_18);
+    section.read("fab_4", config.fab_4);
+    section.finish();
+}
+
+void readBetting(const utils::JsonValue& root, BettingConfig& config, std::string& error) {
+    SectionReader section(root, "betting", error);
+    section.read("kelly_fraction", config.kelly_fraction);
+    section.read("min_bet", config.min_bet);
+    section.read("max_bet", config.max_bet);
+    section.read("spread", config.spread);
+    section.finish();
+}
+
+void readUI(const utils::JsonValue& root, UIConfig& config, std::string& error) {
+    SectionReader section(root, "ui", error);
+    section.read("overlay_enabled", config.overlay_enabled);
+    section.read("transparency", config.transparency);
+    section.read("color_scheme", config.color_scheme);
+    section.read("show_performance_metrics", config.show_performance_metrics);
+    section.read("audio_alerts", config.audio_alerts);
+    section.finish();
+}
+
+// Values no stage could run with; caught here so a bad edit is rejected
+// instead of reaching the pipeline
+bool validate(const ConfigSnapshot& config, std::string& error) {
+    const auto unit = [](float value) { return value >= 0.0f && value <= 1.0f; };
+
+    if (!unit(config.vision.confidence_threshold) || !unit(config.vision.nms_threshold)) {
+        error = "vision: confidence_threshold and nms_threshold must be within [0, 1]";
+    } else if (config.vision.batch_size == 0 || config.vision.inflight_depth == 0) {
+        error = "vision: batch_size and inflight_depth must be at least 1";
+    } else if (config.vision.input_resolution[0] == 0 || config.vision.input_resolution[1] == 0) {
+        error = "vision: input_resolution must be non-zero";
+    } else if (config.vision.use_int8 && config.vision.int8_accuracy_gate &&
+               (config.vision.int8_validation_dir.empty() ||
+                config.vision.int8_validation_dir == config.vision.calibration_dir)) {
+        error = "vision: int8_validation_dir must be set and held out from calibration_dir";
+    } else if (config.capture.motion_cell_delta > 255) {
+        error = "capture: motion_cell_delta must be within [0, 255]";
+    } else if (config.counting.deck_count == 0) {
+        error = "counting: deck_count must be at least 1";
+    } else if (!unit(config.counting.confirm_confidence)) {
+        error = "counting: confirm_confidence must be within [0, 1]";
+    } else if (config.betting.min_bet <= 0.0 || config.betting.max_bet < config.betting.min_bet) {
+        error = "betting: need 0 < min_bet <= max_bet";
+    } else if (!unit(config.ui.transparency)) {
+        error = "ui: transparency must be within [0, 1]";
+    }
+    return error.empty();
+}
+
+bool readConfigFile(const std::string& path, ConfigSnapshot& config, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "cannot open file";
+        return false;
+    }
+    const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    utils::JsonValue root;
+    if (!utils::JsonValue::parse(text, root, error)) return false;
+    if (!root.isObject()) {
+        error = "top level must be an object";
+        return false;
+    }
+
+    for (const auto& [name, value] : root.asObject()) {
+        if (std::find(std::begin(SECTIONS), std::end(SECTIONS), name) == std::end(SECTIONS)) {
+            utils::Logger::getInstance().warning("Unknown configuration section {}", name);
+        }
+    }
+
+    readSystem(root, config.system, error);
+    readCapture(root, config.capture, error);
+    readVision(root, config.vision, error);
+    readCounting(root, config.counting, error);
+    readStrategy(root, config.strategy, error);
+    readBetting(root, config.betting, error);
+    readUI(root, config.ui, error);
+    return error.empty() && validate(config, error);
+}
+
+bool sameSettings(const ConfigSnapshot& a, const ConfigSnapshot& b) {
+    return a.system == b.system && a.capture == b.capture && a.vision == b.vision &&
+           a.counting == b.counting && a.strategy == b.strategy && a.betting == b.betting &&
+           a.ui == b.ui;
+}
+
+// Settings a stage re-reads at its frame boundary (PipelineManager::apply*Config)
+void adoptLiveSettings(ConfigSnapshot& to, const ConfigSnapshot& from) {
+    to.vision.confidence_threshold = from.vision.confidence_threshold;
+    to.vision.nms_threshold = from.vision.nms_threshold;
+    to.capture.motion_detection_threshold = from.capture.motion_detection_threshold;
+    to.capture.motion_min_changed_cells = from.capture.motion_min_changed_cells;
+    to.capture.motion_reverify_interval = from.capture.motion_reverify_interval;
+    to.capture.motion_cell_delta = from.capture.motion_cell_delta;
+    to.counting.system = from.counting.system;
+    to.counting.deck_count = from.counting.deck_count;
+    to.counting.confirm_frames = from.counting.confirm_frames;
+    to.counting.confirm_confidence = from.counting.confirm_confidence;
+    to.strategy.basic_strategy_rules = from.strategy.basic_strategy_rules;
+    to.betting = from.betting;
+    to.ui.transparency = from.ui.transparency;
+}
+
+// Settings that only shape the TensorRT plan of the full-frame engine
+void adoptPlanSettings(VisionConfig& to, const VisionConfig& from) {
+    to.model_path = from.model_path;
+    to.onnx_path = from.onnx_path;
+    to.engine_cache_dir = from.engine_cache_dir;
+    to.fallback_model_path = from.fallback_model_path;
+    to.background_engine_build = from.background_engine_build;
+    to.model_type = from.model_type;
+    to.input_resolution = from.input_resolution;
+    to.resolution_profiles = from.resolution_profiles;
+    to.batch_size = from.batch_size;
+    to.use_fp16 = from.use_fp16;
+    to.fp16_io = from.fp16_io;
+    to.use_int8 = from.use_int8;
+    to.calibration_dir = from.calibration_dir;
+    to.calibration_cache = from.calibration_cache;
+    to.calibration_batch_size = from.calibration_batch_size;
+    to.calibration_max_frames = from.calibration_max_frames;
+    to.int8_accuracy_gate = from.int8_accuracy_gate;
+    to.int8_validation_dir = from.int8_validation_dir;
+    to.dla_core = from.dla_core;
+    to.max_workspace_size_mb = from.max_workspace_size_mb;
+    to.enable_tactic_sources = from.enable_tactic_sources;
+    to.profiling_verbosity = from.profiling_verbosity;
+}
+
+} // namespace
+
 ConfigManager::ConfigManager() {
     // Initialize with default values
+    publishStartup();
 }
 
 ConfigManager::~ConfigManager() {
+    unwatch();
 }
 
 bool ConfigManager::load(const std::string& configPath) {
     auto& logger = utils::Logger::getInstance();
-    
+
     try {
-        // TODO: Parse JSON configuration file
-        // For now, use default values
-        
         m_configPath = configPath;
+
+        std::error_code error;
+        if (!std::filesystem::exists(configPath, error)) {
+            logger.warning("No configuration at {}, using defaults", configPath);
+            return true;
+        }
+
+        ConfigSnapshot config;
+        std::string message;
+        if (!readConfigFile(configPath, config, message)) {
+            logger.error("Invalid configuration {}: {}", configPath, message);
+            return false;
+        }
+
+        m_systemConfig = config.system;
+        m_captureConfig = config.capture;
+        m_visionConfig = config.vision;
+        m_countingConfig = config.counting;
+        m_strategyConfig = config.strategy;
+        m_bettingConfig = config.betting;
+        m_uiConfig = config.ui;
+        publishStartup();
+
         logger.info("Configuration loaded from: {}", configPath);
         return true;
-        
+
     } catch (const std::exception& e) {
         logger.error("Failed to load configuration: {}", e.what());
         return false;
@@ -34,7 +461,84 @@ bool ConfigManager::save(const std::string& configPath) {
 }
 
 bool ConfigManager::reload() {
-    return load(m_configPath);
+    auto& logger = utils::Logger::getInstance();
+    std::lock_guard<std::mutex> lock(m_reloadMutex);
+    if (m_configPath.empty()) return false;
+
+    ConfigSnapshot config;
+    std::string message;
+    try {
+        if (!readConfigFile(m_configPath, config, message)) {
+            logger.error("Configuration reload rejected, keeping the current settings: {}", message);
+            return false;
+        }
+    } catch (const std::exception& e) {
+        logger.error("Configuration reload failed: {}", e.what());
+        return false;
+    }
+
+    const ConfigImpact impact = assess(*getSnapshot(), config);
+    if (impact == ConfigImpact::None) return true;
+
+    publish(std::move(config));
+    const uint64_t version = getVersion();
+    switch (impact) {
+        case ConfigImpact::Live:
+            logger.info("Configuration reloaded (version {}), applied at the next frame", version);
+            break;
+        case ConfigImpact::Rebuild:
+            logger.info("Configuration reloaded (version {}), rebuilding the inference engine", version);
+            break;
+        default:
+            logger.warning("Configuration reloaded (version {}), some changes need a restart", version);
+            break;
+    }
+    return true;
+}
+
+bool ConfigManager::watch(uint32_t intervalMs) {
+    if (intervalMs == 0 || m_configPath.empty()) return false;
+    return m_watcher.start(m_configPath, std::chrono::milliseconds(intervalMs), [this] { reload(); });
+}
+
+void ConfigManager::unwatch() {
+    m_watcher.stop();
+}
+
+ConfigImpact ConfigManager::assess(const ConfigSnapshot& from, const ConfigSnapshot& to) {
+    if (sameSettings(from, to)) return ConfigImpact::None;
+
+    ConfigSnapshot structural = to;
+    adoptLiveSettings(structural, from);
+    if (sameSettings(structural, from)) return ConfigImpact::Live;
+
+    // Only the full-frame engine comes from a cache that can rebuild in the background
+    adoptPlanSettings(structural.vision, from.vision);
+    if (sameSettings(structural, from) && from.vision.inference_mode == "full_frame") {
+        return ConfigImpact::Rebuild;
+    }
+    return ConfigImpact::Restart;
+}
+
+void ConfigManager::publishStartup() {
+    ConfigSnapshot snapshot;
+    snapshot.system = m_systemConfig;
+    snapshot.capture = m_captureConfig;
+    snapshot.vision = m_visionConfig;
+    snapshot.counting = m_countingConfig;
+    snapshot.strategy = m_strategyConfig;
+    snapshot.betting = m_bettingConfig;
+    snapshot.ui = m_uiConfig;
+    publish(std::move(snapshot));
+}
+
+// Snapshot before version: a reader that sees the new version loads at
+// least the new snapshot
+void ConfigManager::publish(ConfigSnapshot snapshot) {
+    snapshot.version = m_version.load(std::memory_order_relaxed) + 1;
+    const uint64_t version = snapshot.version;
+    m_snapshot.store(std::make_shared<const ConfigSnapshot>(std::move(snapshot)), std::memory_order_release);
+    m_version.store(version, std::memory_order_release);
 }
 
 } // namespace core
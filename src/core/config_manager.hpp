@@ -1,11 +1,37 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <memory>
+#include <mutex>
 #include "types.hpp"
+#include "../utils/file_watcher.hpp"
 
 namespace core {
 
+// One complete, immutable configuration. Reloads publish a new snapshot
+// instead of editing the live one, so a stage holding a snapshot never
+// sees a mix of two file versions, and an old snapshot lives until the
+// last stage lets go of it.
+struct ConfigSnapshot {
+    SystemConfig system;
+    CaptureConfig capture;
+    VisionConfig vision;
+    CountingConfig counting;
+    StrategyConfig strategy;
+    BettingConfig betting;
+    UIConfig ui;
+    uint64_t version{0};  // Bumped by every publish
+};
+
+// What it takes to apply a changed configuration
+enum class ConfigImpact : uint8_t {
+    None,     // Identical settings
+    Live,     // Stages pick the values up at their next frame boundary
+    Rebuild,  // Inference engine is rebuilt in the background and hot-swapped
+    Restart   // Structural settings: held until the next start
+};
+
 class ConfigManager {
 public:
     ConfigManager();
@@ -13,35 +39,71 @@ public:
 
     bool load(const std::string& configPath);
     bool save(const std::string& configPath);
+
+    // Re-reads the file and publishes it as a new snapshot. A file that no
+    // longer parses leaves the current snapshot in place.
     bool reload();
 
+    // Reloads on every change to the loaded file, from a watcher thread
+    bool watch(uint32_t intervalMs);
+    void unwatch();
+
+    // Latest snapshot, for stages to hold across one frame
+    std::shared_ptr<const ConfigSnapshot> getSnapshot() const {
+        return m_snapshot.load(std::memory_order_acquire);
+    }
+    // Cheap per-frame check: re-fetch the snapshot only when this changed
+    uint64_t getVersion() const { return m_version.load(std::memory_order_acquire); }
+
+    static ConfigImpact assess(const ConfigSnapshot& from, const ConfigSnapshot& to);
+
+    // The getters return the configuration as loaded at startup, which the
+    // pipeline was built with; they stay valid and unchanged across reloads.
+
     // System configuration
     const SystemConfig& getSystemConfig() const { return m_systemConfig; }
-    
+
     // Capture configuration
     const CaptureConfig& getCaptureConfig() const { return m_captureConfig; }
-    
+
     // Vision configuration
     const VisionConfig& getVisionConfig() const { return m_visionConfig; }
-    
+
     // Counting configuration
     const CountingConfig& getCountingConfig() const { return m_countingConfig; }
-    
+
     // Strategy configuration
     const StrategyConfig& getStrategyConfig() const { return m_strategyConfig; }
-    
+
+    // Betting configuration
+    const BettingConfig& getBettingConfig() const { return m_bettingConfig; }
+
     // UI configuration
     const UIConfig& getUIConfig() const { return m_uiConfig; }
 
+    // Overrides for tools that drive the pipeline without a config file
+    void setCaptureConfig(const CaptureConfig& config) { m_captureConfig = config; publishStartup(); }
+    void setVisionConfig(const VisionConfig& config) { m_visionConfig = config; publishStartup(); }
+    void setUIConfig(const UIConfig& config) { m_uiConfig = config; publishStartup(); }
+
 private:
+    void publishStartup();
+    void publish(ConfigSnapshot snapshot);
+
     SystemConfig m_systemConfig;
     CaptureConfig m_captureConfig;
     VisionConfig m_visionConfig;
     CountingConfig m_countingConfig;
     StrategyConfig m_strategyConfig;
+    BettingConfig m_bettingConfig;
     UIConfig m_uiConfig;
-    
+
     std::string m_configPath;
+
+    std::atomic<std::shared_ptr<const ConfigSnapshot>> m_snapshot;
+    std::atomic<uint64_t> m_version{0};
+    std::mutex m_reloadMutex;  // One reload at a time
+    utils::FileWatcher m_watcher;
 };
 
 } // namespace core
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace core {
@@ -10,6 +11,8 @@ constexpr uint64_t CAPTURE_LATENCY_NS = 2'000'000;        // 2ms
 constexpr uint64_t PREPROCESSING_LATENCY_NS = 3'000'000;  // 3ms
 constexpr uint64_t INFERENCE_LATENCY_NS = 8'000'000;      // 8ms
 constexpr uint64_t POSTPROCESSING_LATENCY_NS = 2'000'000; // 2ms
+constexpr uint64_t COUNTING_LATENCY_NS = 100'000;         // 0.1ms per event
+constexpr uint64_t STRATEGY_LATENCY_NS = 1'000'000;       // 1ms
 constexpr uint64_t UI_UPDATE_LATENCY_NS = 1'000'000;      // 1ms
 constexpr uint64_t TOTAL_LATENCY_NS = 16'000'000;         // 16ms
 
@@ -21,14 +24,22 @@ constexpr float CPU_USAGE_LIMIT = 0.25f;  // 25%
 // Queue sizes
 constexpr uint32_t CAPTURE_QUEUE_SIZE = 16;
 constexpr uint32_t INFERENCE_QUEUE_SIZE = 8;
-constexpr uint32_t COUNTING_QUEUE_SIZE = 32;
+constexpr uint32_t COUNTING_QUEUE_SIZE = 32;  // CardEvents, a handful per hand
+constexpr uint32_t MAX_CAPTURE_BUFFERS = 32;  // Upper bound for capture.buffer_count
+constexpr uint32_t MAX_INFERENCE_SLOTS = 4;   // Upper bound for vision.inflight_depth
+
+// Detection limits
+constexpr uint32_t MAX_NMS_CANDIDATES = 1024;      // Boxes surviving confidence filter
+constexpr uint32_t MAX_DETECTIONS_PER_FRAME = 64;  // Boxes surviving NMS
+constexpr uint32_t MAX_TRACKS = 64;                // CardTracker table capacity
+constexpr uint32_t TRACK_HISTORY_LENGTH = 16;      // Detections kept per track
 
 // Card counting constants
 constexpr uint32_t STANDARD_DECK_SIZE = 52;
 constexpr uint32_t MAX_DECKS = 8;
 constexpr uint32_t CARD_HISTORY_SIZE = 512;
 
-// Thread priorities (Linux RT priorities)
+// Thread priorities: SCHED_FIFO on Linux, MMCSS classes on Windows
 constexpr int PRIORITY_CAPTURE = 99;
 constexpr int PRIORITY_INFERENCE = 95;
 constexpr int PRIORITY_COUNTING = 90;
@@ -18,36 +18,84 @@ struct SystemConfig {
     uint32_t memory_pool_size_mb = 2048;
     bool enable_nvtx_markers = true;
     uint32_t gpu_clock_lock_mhz = 2400;
+    bool queue_drop_oldest = true;  // Stage queue backpressure: evict oldest vs reject newest
+    std::string metrics_export_path = "";  // Line-delimited JSON stage metrics, empty = off
+    uint32_t trace_frames = 0;             // Chrome trace of the first N frames after start, 0 = off
+    std::string trace_output_path = "logs/pipeline_trace.json";
+    uint32_t config_watch_interval_ms = 500;  // Poll config.json and hot-reload changes, 0 = off
+
+    bool operator==(const SystemConfig&) const = default;
 };
 
 // Capture configuration
 struct CaptureConfig {
-    enum class CaptureMethod { DXGI, NVFBC };
+    enum class CaptureMethod { DXGI, NVFBC, REPLAY };
     CaptureMethod method = CaptureMethod::DXGI;
     uint32_t frame_rate = 120;
     uint32_t buffer_count = 16;
-    float motion_detection_threshold = 0.015f;
+    float motion_detection_threshold = 0.015f;  // Mean luma change that triggers inference
+    bool motion_gating = true;
+    uint32_t motion_min_changed_cells = 4;       // Local change that triggers inference
+    uint32_t motion_reverify_interval = 30;      // Static frames before a forced inference
+    uint32_t motion_cell_delta = 10;             // Luma change (0-255) that marks a grid cell changed
     bool use_hardware_encoding = true;
     std::string color_space = "bt709";
     bool hdr_enabled = false;
     bool async_copy = true;
+    bool cuda_interop = true;
+    std::array<uint32_t, 4> capture_region = {0, 0, 0, 0};  // NvFBC hardware crop x, y, w, h; zero size = full screen
+
+    // Offline replay of a .bjrec recording (method = replay)
+    enum class ReplayPacing { Recorded, Fixed, Unthrottled };
+    std::string replay_path = "";
+    ReplayPacing replay_pacing = ReplayPacing::Recorded;  // Fixed paces at frame_rate
+    bool replay_loop = false;
+    bool replay_lossless = true;   // Capture waits for a free slot instead of evicting frames
+    std::string record_path = "";  // Tee captured frames to a .bjrec, empty = off
+
+    bool operator==(const CaptureConfig&) const = default;
 };
 
 // Vision configuration
 struct VisionConfig {
     std::string model_path = "./models/yolov11x_card_detector.trt";
+    std::string onnx_path = "./models/yolov11x_card_detector.onnx";  // Source of cached plans
+    std::string engine_cache_dir = "./models/cache";
+    std::string fallback_model_path = "./models/yolov11n_card_detector.trt";  // Served while building
+    bool background_engine_build = true;
     std::string model_type = "yolov11x";
     std::array<uint32_t, 2> input_resolution = {1280, 1280};
+    std::vector<uint32_t> resolution_profiles;  // Extra input widths (dynamic H/W ONNX), switched at runtime
     float confidence_threshold = 0.65f;
     float nms_threshold = 0.45f;
     uint32_t batch_size = 1;
     bool use_fp16 = true;
+    bool fp16_io = false;  // FP16 input/output bindings (with use_fp16): no reformat layers
     bool use_int8 = false;
+    std::string calibration_dir = "./calibration/frames";  // PPM table captures (+ YOLO labels)
+    std::string calibration_cache = "./models/cache/yolov11x_card_detector.calib";
+    uint32_t calibration_batch_size = 8;
+    uint32_t calibration_max_frames = 512;
+    bool int8_accuracy_gate = true;  // Reject INT8 plans below DETECTION_PRECISION/RECALL
+    std::string int8_validation_dir = "./calibration/validation";  // Held-out labeled frames the gate scores
     int dla_core = -1;
     uint32_t max_workspace_size_mb = 4096;
     bool enable_cuda_graphs = true;
+    uint32_t inflight_depth = 2;  // Frames executing concurrently (1 = serial)
+    bool gpu_postprocessing = true;
+    std::string inference_mode = "full_frame";  // "full_frame", "roi_tiles" or "cascade"
+    std::string tile_model_path = "./models/yolov11x_card_detector_416.trt";
+    uint32_t tile_size = 416;
+    uint32_t max_tiles = 8;
+    std::string localizer_model_path = "./models/yolov11n_card_localizer_640.trt";  // Cascade stage 1
+    uint32_t localizer_input_size = 640;
+    std::string classifier_model_path = "./models/card_classifier_96.trt";         // Cascade stage 2
+    uint32_t classifier_max_batch = 16;
+    float cascade_skip_confidence = 0.9f;  // Tracked cards above this skip classification
     bool enable_tactic_sources = true;
     std::string profiling_verbosity = "detailed";
+
+    bool operator==(const VisionConfig&) const = default;
 };
 
 // Counting configuration
@@ -57,6 +105,10 @@ struct CountingConfig {
     uint32_t deck_count = 6;
     float penetration = 0.75f;
     uint32_t history_size = 512;
+    uint32_t confirm_frames = 5;      // Consistent tracked frames before a card is dealt
+    float confirm_confidence = 0.75f; // Minimum detection confidence for those frames
+
+    bool operator==(const CountingConfig&) const = default;
 };
 
 // Strategy configuration
@@ -65,6 +117,8 @@ struct StrategyConfig {
     bool deviations_enabled = true;
     bool illustrious_18 = true;
     bool fab_4 = true;
+
+    bool operator==(const StrategyConfig&) const = default;
 };
 
 // Betting configuration
@@ -73,6 +127,8 @@ struct BettingConfig {
     double min_bet = 10.0;
     double max_bet = 500.0;
     std::array<uint32_t, 5> spread = {1, 2, 4, 8, 12};
+
+    bool operator==(const BettingConfig&) const = default;
 };
 
 // UI configuration
@@ -82,6 +138,8 @@ struct UIConfig {
     std::string color_scheme = "dark";
     bool show_performance_metrics = true;
     bool audio_alerts = true;
+
+    bool operator==(const UIConfig&) const = default;
 };
 
 // Card representation
@@ -115,4 +173,29 @@ struct Detection {
     uint64_t timestamp_ns;
 };
 
+// Class id layout: suit * 13 + (rank - 1)
+inline Card cardFromId(uint8_t cardId, float confidence, uint64_t timestamp_ns) {
+    Card card;
+    card.rank = static_cast<CardRank>(cardId % 13 + 1);
+    card.suit = static_cast<CardSuit>(cardId / 13);
+    card.confidence = static_cast<uint8_t>(confidence * 100.0f);
+    card.timestamp_ns = timestamp_ns;
+    return card;
+}
+
+// Tracker -> counter events, each card is dealt exactly once
+enum class CardEventType : uint8_t {
+    CardDealt,     // Track confirmed: count the card
+    CardRemoved,   // A confirmed card left the table
+    ShoeShuffled   // New shoe: reset the count
+};
+
+struct CardEvent {
+    CardEventType type;
+    Card card;          // Voted identity (unused for ShoeShuffled)
+    uint32_t track_id;
+    uint64_t timestamp_ns;
+    float center_y{0.0f};  // CardDealt: box centre row in frame pixels, for seat assignment
+};
+
 } // namespace core
@@ -1,5 +1,6 @@
 #include "card_counter.hpp"
 #include "../../utils/logger.hpp"
+#include <algorithm>
 #include <cmath>
 
 namespace intelligence {
@@ -10,61 +11,121 @@ CardCounter::CardCounter() {
 CardCounter::~CardCounter() {
 }
 
-void CardCounter::initialize(uint32_t deckCount) {
+void CardCounter::initialize(uint32_t deckCount, CountingSystem primary) {
     m_deckCount = deckCount;
+    m_primary = systemIndex(primary);
     reset();
+
+    utils::Logger::getInstance().info("Card counter: {} primary, {} decks",
+                                      COUNTING_SYSTEMS[m_primary].name, m_deckCount);
 }
 
 void CardCounter::reset() {
-    m_runningCount = 0;
-    m_trueCount = 0.0f;
+    // Unbalanced systems start from their initial running count
+    for (size_t system = 0; system < COUNTING_SYSTEM_COUNT; system++) {
+        const auto& tags = COUNTING_SYSTEMS[system];
+        m_initialCounts[system] = (tags.initialCountBase +
+                                   tags.initialCountPerDeck * static_cast<int32_t>(m_deckCount)) * TAG_SCALE;
+    }
+    m_runningCounts = m_initialCounts;
+    m_trueCounts.fill(0.0f);
     m_confidence = 1.0f;
     m_cardsPlayed = 0;
+    m_cardsOnTable = 0;
+    m_acesSeen = 0;
     m_cardsSeen.fill(0);
 }
 
 void CardCounter::addCard(const core::Card& card) {
-    // Update running count using Hi-Lo system
-    int cardValue = getHiLoValue(card.rank);
-    m_runningCount += cardValue;
-    m_cardsPlayed++;
-    
-    // Update card tracking
-    uint8_t cardIndex = static_cast<uint8_t>(card.rank) + 
-                       static_cast<uint8_t>(card.suit) * 13;
-    if (cardIndex < 52) {
-        m_cardsSeen[cardIndex]++;
+    count(card);
+    updateTrueCount();
+    updateConfidence();
+}
+
+void CardCounter::addCards(std::span<const core::Card> cards) {
+    for (const auto& card : cards) {
+        count(card);
     }
-    
     updateTrueCount();
     updateConfidence();
 }
 
+void CardCounter::processEvent(const core::CardEvent& event) {
+    switch (event.type) {
+        case core::CardEventType::CardDealt:
+            addCard(event.card);
+            m_cardsOnTable++;
+            break;
+        case core::CardEventType::CardRemoved:
+            // Already counted when dealt
+            if (m_cardsOnTable > 0) m_cardsOnTable--;
+            break;
+        case core::CardEventType::ShoeShuffled:
+            reset();
+            break;
+    }
+}
+
+void CardCounter::count(const core::Card& card) {
+    const uint32_t rankIndex = static_cast<uint32_t>(card.rank) - 1;
+    if (rankIndex >= RANK_COUNT) return;
+
+    const auto& tags = RANK_TAGS[rankIndex];
+    for (size_t system = 0; system < COUNTING_SYSTEM_COUNT; system++) {
+        m_runningCounts[system] += tags[system];
+    }
+    m_cardsPlayed++;
+    m_acesSeen += card.rank == core::CardRank::Ace;
+
+    const uint32_t cardIndex = static_cast<uint32_t>(card.suit) * 13 + rankIndex;
+    if (cardIndex < m_cardsSeen.size()) {
+        m_cardsSeen[cardIndex]++;
+    }
+}
+
 float CardCounter::getTrueCount() const {
-    return m_trueCount;
+    return m_trueCounts[m_primary];
 }
 
-int CardCounter::getHiLoValue(core::CardRank rank) const {
-    // Hi-Lo counting system
-    int rankValue = static_cast<int>(rank);
-    
-    if (rankValue >= 2 && rankValue <= 6) {
-        return 1;  // Low cards: +1
-    } else if (rankValue >= 10 || rank == core::CardRank::Ace) {
-        return -1;  // High cards and Aces: -1
+uint32_t CardCounter::getAcesRemaining() const {
+    const uint32_t totalAces = m_deckCount * 4;
+    return totalAces > m_acesSeen ? totalAces - m_acesSeen : 0;
+}
+
+float CardCounter::getAceSideCount() const {
+    const float expectedAces = m_cardsPlayed / 13.0f;
+    return static_cast<float>(m_acesSeen) - expectedAces;
+}
+
+RankCounts CardCounter::getRemainingRanks() const {
+    RankCounts remaining{};
+    for (uint32_t rank = 0; rank < RANK_COUNT; rank++) {
+        const uint32_t index = std::min<uint32_t>(rank, 9);
+        uint32_t seen = 0;
+        for (uint32_t suit = 0; suit < 4; suit++) {
+            seen += m_cardsSeen[suit * 13 + rank];
+        }
+        const uint32_t total = m_deckCount * 4;
+        remaining[index] += static_cast<uint16_t>(total > seen ? total - seen : 0);
     }
-    return 0;  // Neutral cards (7, 8, 9)
+    return remaining;
 }
 
 void CardCounter::updateTrueCount() {
     uint32_t cardsRemaining = getCardsRemaining();
     if (cardsRemaining == 0) {
-        m_trueCount = 0.0f;
+        m_trueCounts.fill(0.0f);
         return;
     }
     
-    float decksRemaining = cardsRemaining / 52.0f;
-    m_trueCount = static_cast<float>(m_runningCount) / decksRemaining;
+    // Unbalanced systems drift by their deck sum; removing the expected drift
+    // puts every system on the same per-deck scale
+    const float decksRemaining = cardsRemaining / 52.0f;
+    for (size_t system = 0; system < COUNTING_SYSTEM_COUNT; system++) {
+        const float drift = deckTagSum(COUNTING_SYSTEMS[system]) * (m_cardsPlayed / 52.0f);
+        const float count = m_runningCounts[system] - m_initialCounts[system] - drift;
+        m_trueCounts[system] = count / (TAG_SCALE * decksRemaining);
+    }
 }
 
 void CardCounter::updateConfidence() {
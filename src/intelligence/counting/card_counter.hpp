@@ -1,25 +1,52 @@
 #pragma once
 
+#include "counting_systems.hpp"
 #include "../../core/types.hpp"
 #include <array>
+#include <span>
 
 namespace intelligence {
 
+// Cards left in the shoe by rank: Ace, Two-Nine, then all ten-valued ranks
+using RankCounts = std::array<uint16_t, 10>;
+
+// Runs every counting system in COUNTING_SYSTEMS side by side over the same
+// cards. Each card costs one row lookup in RANK_TAGS; the primary system
+// backs the unqualified getters.
 class CardCounter {
 public:
     CardCounter();
     ~CardCounter();
 
-    void initialize(uint32_t deckCount);
+    void initialize(uint32_t deckCount, CountingSystem primary = CountingSystem::HiLo);
     void reset();
     
     // Update count with new card
     void addCard(const core::Card& card);
+    void addCards(std::span<const core::Card> cards);  // Whole burst, one recount
+
+    // Apply a tracker event: dealt cards are counted, a shuffle resets
+    void processEvent(const core::CardEvent& event);
+    uint32_t getCardsOnTable() const { return m_cardsOnTable; }
     
-    // Get current counts
-    int32_t getRunningCount() const { return m_runningCount; }
+    // Primary system counts
+    int32_t getRunningCount() const { return m_runningCounts[m_primary] / TAG_SCALE; }
     float getTrueCount() const;
     float getConfidence() const { return m_confidence; }
+
+    // Any system, fractional for Halves
+    float getRunningCount(CountingSystem system) const {
+        return static_cast<float>(m_runningCounts[systemIndex(system)]) / TAG_SCALE;
+    }
+    float getTrueCount(CountingSystem system) const { return m_trueCounts[systemIndex(system)]; }
+    CountingSystem getPrimarySystem() const { return static_cast<CountingSystem>(m_primary); }
+
+    // Ace side count: aces seen beyond the share expected by this penetration
+    uint32_t getAcesRemaining() const;
+    float getAceSideCount() const;
+
+    // Composition of the unseen cards, for composition-dependent strategy
+    RankCounts getRemainingRanks() const;
     
     // Deck penetration
     void setDeckCount(uint32_t count) { m_deckCount = count; }
@@ -27,18 +54,23 @@ public:
     float getPenetration() const;
 
 private:
-    int getHiLoValue(core::CardRank rank) const;
+    void count(const core::Card& card);
     void updateTrueCount();
     void updateConfidence();
     
-    int32_t m_runningCount{0};
-    float m_trueCount{0.0f};
+    // Per system, in TAG_SCALE units
+    std::array<int32_t, COUNTING_SYSTEM_COUNT> m_runningCounts{};
+    std::array<int32_t, COUNTING_SYSTEM_COUNT> m_initialCounts{};
+    std::array<float, COUNTING_SYSTEM_COUNT> m_trueCounts{};
+    size_t m_primary{systemIndex(CountingSystem::HiLo)};
     float m_confidence{1.0f};
     
     uint32_t m_deckCount{6};
     uint32_t m_cardsPlayed{0};
+    uint32_t m_cardsOnTable{0};  // Dealt and not yet removed
+    uint32_t m_acesSeen{0};
     
-    // Card tracking
+    // Card tracking, indexed suit * 13 + (rank - 1)
     std::array<uint8_t, 52> m_cardsSeen{};
 };
 
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../../core/types.hpp"
+#include <array>
+#include <cstdint>
+
+namespace intelligence {
+
+using CountingSystem = core::CountingConfig::CountingSystem;
+
+// Tags are stored in fixed point so Halves' half-point tags stay integral
+constexpr int32_t TAG_SCALE = 2;
+constexpr size_t COUNTING_SYSTEM_COUNT = 4;
+constexpr size_t RANK_COUNT = 13;
+
+// Per-rank tags, Ace first, in TAG_SCALE units
+struct CountingSystemTags {
+    const char* name;
+    std::array<int8_t, RANK_COUNT> tags;
+    int32_t initialCountPerDeck;  // Unbalanced systems start below zero (KO: IRC = 4 - 4 * decks)
+    int32_t initialCountBase;
+};
+
+//                                                 A   2   3   4   5   6   7   8   9   T   J   Q   K
+constexpr CountingSystemTags HI_LO_TAGS   {"Hi-Lo",    {-2,  2,  2,  2,  2,  2,  0,  0,  0, -2, -2, -2, -2},  0, 0};
+constexpr CountingSystemTags KO_TAGS      {"KO",       {-2,  2,  2,  2,  2,  2,  2,  0,  0, -2, -2, -2, -2}, -4, 4};
+constexpr CountingSystemTags OMEGA_2_TAGS {"Omega II", { 0,  2,  2,  4,  4,  4,  2,  0, -2, -4, -4, -4, -4},  0, 0};
+constexpr CountingSystemTags HALVES_TAGS  {"Halves",   {-2,  1,  2,  2,  3,  2,  1,  0, -1, -2, -2, -2, -2},  0, 0};
+
+// Indexed by CountingSystem
+constexpr std::array<CountingSystemTags, COUNTING_SYSTEM_COUNT> COUNTING_SYSTEMS = {
+    HI_LO_TAGS, KO_TAGS, OMEGA_2_TAGS, HALVES_TAGS
+};
+
+// Rank-major transpose: one card updates every system from one contiguous row
+constexpr auto buildRankTags() {
+    std::array<std::array<int32_t, COUNTING_SYSTEM_COUNT>, RANK_COUNT> table{};
+    for (size_t rank = 0; rank < RANK_COUNT; rank++) {
+        for (size_t system = 0; system < COUNTING_SYSTEM_COUNT; system++) {
+            table[rank][system] = COUNTING_SYSTEMS[system].tags[rank];
+        }
+    }
+    return table;
+}
+
+constexpr auto RANK_TAGS = buildRankTags();
+
+// Sum of one deck's tags (4 suits); zero for balanced systems
+constexpr int32_t deckTagSum(const CountingSystemTags& system) {
+    int32_t sum = 0;
+    for (int8_t tag : system.tags) sum += 4 * tag;
+    return sum;
+}
+
+static_assert(deckTagSum(HI_LO_TAGS) == 0, "Hi-Lo is balanced");
+static_assert(deckTagSum(OMEGA_2_TAGS) == 0, "Omega II is balanced");
+static_assert(deckTagSum(HALVES_TAGS) == 0, "Halves is balanced");
+static_assert(deckTagSum(KO_TAGS) == 4 * TAG_SCALE, "KO gains 4 per deck");
+
+constexpr size_t systemIndex(CountingSystem system) {
+    return static_cast<size_t>(system);
+}
+
+} // namespace intelligence
@@ -0,0 +1,454 @@
+#include "shoe_simulator.hpp"
+#include "xoshiro.hpp"
+#include "../counting/card_counter.hpp"
+#include "../../utils/logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace intelligence {
+
+namespace {
+
+constexpr char CHECKPOINT_MAGIC[8] = {'B', 'J', 'S', 'I', 'M', 'C', 'K', '1'};
+constexpr uint32_t MAX_HANDS = 4;          // Resplit to four hands, aces once
+constexpr uint32_t MAX_ROUND_CARDS = 48;
+constexpr uint32_t MAX_SHOE_CARDS = 8 * 52;
+constexpr double Z_95 = 1.959964;
+
+struct CheckpointHeader {
+    char magic[8];
+    uint64_t digest;
+    uint64_t folded_chunks;
+    SimulationStats stats;
+};
+
+struct Hand {
+    uint32_t sum;
+    bool hasAce;
+    uint32_t cards;
+    uint8_t firstValue;
+    double bet;
+    bool fromSplit;
+    bool splitAces;
+    bool surrendered;
+};
+
+uint32_t cardValue(uint8_t cardId) {
+    return std::min<uint32_t>(cardId % 13 + 1, 10);
+}
+
+uint32_t effectiveTotal(uint32_t sum, bool hasAce) {
+    return (hasAce && sum + 10 <= 21) ? sum + 10 : sum;
+}
+
+// One table: shoe, count and the round loop. Lives for one chunk.
+class Table {
+public:
+    Table(const SimulationConfig& config, const BasicStrategy& strategy,
+          const BettingStrategy& betting, uint64_t seed)
+        : m_config(config), m_strategy(strategy), m_betting(betting), m_rng(seed) {
+        m_shoeSize = std::min(config.decks, 8u) * 52;
+        for (uint32_t i = 0; i < m_shoeSize; i++) {
+            m_shoe[i] = static_cast<uint8_t>(i % 52);
+        }
+        m_cut = static_cast<uint32_t>(m_shoeSize * std::clamp(config.penetration, 0.1f, 0.95f));
+        m_counter.initialize(m_shoeSize / 52, config.counting_system);
+        shuffle();
+    }
+
+    void playRound(SimulationStats& stats) {
+        if (m_position >= m_cut) {
+            shuffle();
+            m_counter.reset();
+        }
+
+        // The count the player sees when betting and deciding; this round's
+        // cards are counted as one burst when it ends
+        const float trueCount = m_counter.getTrueCount();
+        const double bet = m_config.flat_bet ? m_config.min_bet
+                                             : m_betting.calculateBet(trueCount, m_config.bankroll);
+        m_roundCards = 0;
+
+        const uint8_t first = draw();
+        const uint8_t up = draw();
+        const uint8_t second = draw();
+        const uint8_t hole = draw();
+        const core::CardRank upRank = static_cast<core::CardRank>(up % 13 + 1);
+
+        const uint32_t dealerSum = cardValue(up) + cardValue(hole);
+        const bool dealerAce = cardValue(up) == 1 || cardValue(hole) == 1;
+        const bool dealerBlackjack = effectiveTotal(dealerSum, dealerAce) == 21;
+        const bool playerBlackjack = effectiveTotal(cardValue(first) + cardValue(second),
+                                                    cardValue(first) == 1 || cardValue(second) == 1) == 21;
+
+        double net = 0.0;
+        double wagered = bet;
+        uint32_t handCount = 1;
+
+        if (cardValue(up) == 1 && m_strategy.takeInsurance(trueCount)) {
+            net += dealerBlackjack ? bet : -0.5 * bet;
+            wagered += 0.5 * bet;
+        }
+
+        if (dealerBlackjack || playerBlackjack) {
+            if (!dealerBlackjack) net += 1.5 * bet;
+            else if (!playerBlackjack) net -= bet;
+        } else {
+            m_hands[0] = {cardValue(first) + cardValue(second),
+                          cardValue(first) == 1 || cardValue(second) == 1,
+                          2, static_cast<uint8_t>(cardValue(first)), bet, false, false, false};
+
+            for (uint32_t h = 0; h < handCount; h++) {
+                playHand(h, handCount, upRank, trueCount, wagered);
+            }
+            net += settle(handCount, up, hole);
+        }
+
+        m_counter.addCards(std::span(m_roundBuffer.data(), m_roundCards));
+
+        stats.rounds++;
+        stats.hands += handCount;
+        stats.initial_bets += bet;
+        stats.wagered += wagered;
+        stats.result += net;
+        stats.result_squares += net * net;
+    }
+
+private:
+    void playHand(uint32_t index, uint32_t& handCount, core::CardRank upRank,
+                  float trueCount, double& wagered) {
+        Hand& hand = m_hands[index];
+
+        while (true) {
+            if (hand.cards == 1) {
+                addCard(hand, draw());
+                if (hand.splitAces) return;  // One card on split aces
+                continue;
+            }
+
+            const uint32_t total = effectiveTotal(hand.sum, hand.hasAce);
+            if (total >= 21) return;
+
+            const bool twoCards = hand.cards == 2;
+            const uint32_t secondValue = hand.sum - hand.firstValue;
+            const bool pair = twoCards && hand.firstValue == secondValue && handCount < MAX_HANDS;
+            const bool canDouble = twoCards && (!hand.fromSplit || m_strategy.doubleAfterSplit());
+            const bool canSurrender = twoCards && !hand.fromSplit && handCount == 1 &&
+                                      m_strategy.lateSurrender();
+            const bool soft = hand.hasAce && hand.sum + 10 <= 21;
+
+            switch (m_strategy.getPlay(total, upRank, trueCount, soft, canDouble, pair, canSurrender)) {
+                case Action::Stand:
+                    return;
+                case Action::Hit:
+                    addCard(hand, draw());
+                    break;
+                case Action::Double:
+                    wagered += hand.bet;
+                    hand.bet *= 2.0;
+                    addCard(hand, draw());
+                    return;
+                case Action::Surrender:
+                    hand.surrendered = true;
+                    return;
+                case Action::Split: {
+                    const bool aces = hand.firstValue == 1;
+                    Hand split{hand.firstValue, aces, 1, hand.firstValue, hand.bet, true, aces, false};
+                    hand = split;
+                    m_hands[handCount++] = split;
+                    wagered += split.bet;
+                    break;
+                }
+            }
+        }
+    }
+
+    double settle(uint32_t handCount, uint8_t up, uint8_t hole) {
+        bool live = false;
+        for (uint32_t h = 0; h < handCount; h++) {
+            live |= !m_hands[h].surrendered && m_hands[h].sum <= 21;
+        }
+
+        uint32_t dealerSum = cardValue(up) + cardValue(hole);
+        bool dealerAce = cardValue(up) == 1 || cardValue(hole) == 1;
+        if (live) {
+            while (true) {
+                const uint32_t total = effectiveTotal(dealerSum, dealerAce);
+                const bool soft17 = total == 17 && dealerAce && dealerSum == 7;
+                if (total > 17 || (total == 17 && !(soft17 && m_strategy.hitsSoft17()))) break;
+                const uint8_t card = draw();
+                dealerSum += cardValue(card);
+                dealerAce |= cardValue(card) == 1;
+            }
+        }
+        const uint32_t dealerTotal = effectiveTotal(dealerSum, dealerAce);
+
+        double net = 0.0;
+        for (uint32_t h = 0; h < handCount; h++) {
+            const Hand& hand = m_hands[h];
+            const uint32_t total = effectiveTotal(hand.sum, hand.hasAce);
+            if (hand.surrendered) net -= 0.5 * hand.bet;
+            else if (hand.sum > 21) net -= hand.bet;
+            else if (dealerTotal > 21 || total > dealerTotal) net += hand.bet;
+            else if (total < dealerTotal) net -= hand.bet;
+        }
+        return net;
+    }
+
+    static void addCard(Hand& hand, uint8_t card) {
+        hand.sum += cardValue(card);
+        hand.hasAce |= cardValue(card) == 1;
+        hand.cards++;
+    }
+
+    uint8_t draw() {
+        // A round never outruns the shoe past the cut by more than this
+        if (m_position == m_shoeSize) shuffle();
+        const uint8_t card = m_shoe[m_position++];
+        if (m_roundCards < MAX_ROUND_CARDS) {
+            m_roundBuffer[m_roundCards++] = core::cardFromId(card, 1.0f, 0);
+        }
+        return card;
+    }
+
+    // Fisher-Yates; each 64-bit draw supplies two 32-bit index samples
+    void shuffle() {
+        uint32_t i = m_shoeSize - 1;
+        for (; i >= 2; i -= 2) {
+            const uint64_t random = m_rng.next();
+            std::swap(m_shoe[i], m_shoe[m_rng.bounded(static_cast<uint32_t>(random >> 32), i + 1)]);
+            std::swap(m_shoe[i - 1], m_shoe[m_rng.bounded(static_cast<uint32_t>(random), i)]);
+        }
+        if (i == 1) {
+            std::swap(m_shoe[1], m_shoe[m_rng.bounded(2)]);
+        }
+        m_position = 0;
+    }
+
+    const SimulationConfig& m_config;
+    const BasicStrategy& m_strategy;
+    const BettingStrategy& m_betting;
+    Xoshiro256 m_rng;
+    CardCounter m_counter;
+
+    std::array<uint8_t, MAX_SHOE_CARDS> m_shoe{};
+    uint32_t m_shoeSize{0};
+    uint32_t m_position{0};
+    uint32_t m_cut{0};
+
+    std::array<Hand, MAX_HANDS> m_hands{};
+    std::array<core::Card, MAX_ROUND_CARDS> m_roundBuffer{};
+    uint32_t m_roundCards{0};
+};
+
+} // namespace
+
+void SimulationStats::merge(const SimulationStats& other) {
+    rounds += other.rounds;
+    hands += other.hands;
+    initial_bets += other.initial_bets;
+    wagered += other.wagered;
+    result += other.result;
+    result_squares += other.result_squares;
+}
+
+ShoeSimulator::ShoeSimulator(const SimulationConfig& config)
+    : m_config(config) {
+    m_strategy.initialize(config.rules);
+    m_strategy.setDeviationSets(config.illustrious_18, config.fab_4);
+    m_betting.configure(config.min_bet, config.max_bet, config.kelly_fraction);
+    m_betting.setSpread(config.spread);
+}
+
+ShoeSimulator::~ShoeSimulator() {
+}
+
+bool ShoeSimulator::run(SimulationStats& stats, const ProgressCallback& progress) {
+    auto& logger = utils::Logger::getInstance();
+
+    m_config.chunk_rounds = std::max<uint64_t>(m_config.chunk_rounds, 1);
+    m_chunkCount = (m_config.rounds + m_config.chunk_rounds - 1) / m_config.chunk_rounds;
+    m_chunkStats.assign(m_chunkCount, SimulationStats{});
+    m_chunkDone = std::make_unique<std::atomic<bool>[]>(m_chunkCount);
+
+    stats = SimulationStats{};
+    m_foldedChunks = 0;
+    m_checkpointChunks = 0;
+    m_checkpointStats = SimulationStats{};
+    if (!m_config.checkpoint_path.empty() && loadCheckpoint(stats)) {
+        logger.info("Resuming simulation at chunk {} of {}", m_foldedChunks, m_chunkCount);
+    }
+    m_nextChunk.store(m_foldedChunks, std::memory_order_relaxed);
+
+    const uint32_t threadCount = m_config.threads > 0 ? m_config.threads
+                                                      : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ShoeSimulator::worker, this);
+    }
+
+    // Fold finished chunks in order; checkpoint the folded prefix
+    auto lastCheckpoint = std::chrono::steady_clock::now();
+    while (foldCompleted(stats) < m_chunkCount) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        if (progress) progress(stats.rounds, m_config.rounds);
+
+        const auto now = std::chrono::steady_clock::now();
+        if (!m_config.checkpoint_path.empty() &&
+            now - lastCheckpoint >= std::chrono::seconds(m_config.checkpoint_interval_s)) {
+            saveCheckpoint();
+            lastCheckpoint = now;
+        }
+    }
+
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    if (progress) progress(stats.rounds, m_config.rounds);
+
+    if (!m_config.checkpoint_path.empty() && !saveCheckpoint()) {
+        logger.error("Failed to write simulation checkpoint: {}", m_config.checkpoint_path);
+        return false;
+    }
+    return true;
+}
+
+SimulationReport ShoeSimulator::summarize(const SimulationStats& stats, double bankroll) {
+    SimulationReport report{};
+    if (stats.rounds < 2) return report;
+
+    const double n = static_cast<double>(stats.rounds);
+    const double mean = stats.result / n;
+    const double variance = std::max(0.0, (stats.result_squares - n * mean * mean) / (n - 1));
+    const double sd = std::sqrt(variance);
+    const double standardError = sd / std::sqrt(n);
+    const double meanBet = stats.initial_bets / n;
+
+    report.ev_per_round = mean;
+    report.ev_ci95 = Z_95 * standardError;
+    report.sd_per_round = sd;
+    report.edge = meanBet > 0.0 ? mean / meanBet : 0.0;
+    report.edge_ci95 = meanBet > 0.0 ? report.ev_ci95 / meanBet : 0.0;
+    report.n0 = mean != 0.0 ? variance / (mean * mean) : INFINITY;
+
+    // Diffusion approximation: RoR = exp(-2 * mu * B / sigma^2)
+    auto ruin = [&](double mu) {
+        if (mu <= 0.0 || variance == 0.0) return 1.0;
+        return std::exp(-2.0 * mu * bankroll / variance);
+    };
+    report.risk_of_ruin = ruin(mean);
+    report.risk_of_ruin_low = ruin(mean + report.ev_ci95);
+    report.risk_of_ruin_high = ruin(mean - report.ev_ci95);
+    return report;
+}
+
+void ShoeSimulator::worker() {
+    while (true) {
+        const uint64_t chunk = m_nextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= m_chunkCount) return;
+
+        simulateChunk(chunk, m_chunkStats[chunk]);
+        m_chunkDone[chunk].store(true, std::memory_order_release);
+    }
+}
+
+void ShoeSimulator::simulateChunk(uint64_t chunk, SimulationStats& stats) const {
+    uint64_t seedState = m_config.seed ^ (chunk * 0xD1B54A32D192ED03ull);
+    Table table(m_config, m_strategy, m_betting, splitMix64(seedState));
+
+    const uint64_t begin = chunk * m_config.chunk_rounds;
+    const uint64_t rounds = std::min(m_config.chunk_rounds, m_config.rounds - begin);
+    SimulationStats local;
+    for (uint64_t i = 0; i < rounds; i++) {
+        table.playRound(local);
+    }
+    stats = local;
+}
+
+uint64_t ShoeSimulator::foldCompleted(SimulationStats& stats) {
+    while (m_foldedChunks < m_chunkCount &&
+           m_chunkDone[m_foldedChunks].load(std::memory_order_acquire)) {
+        stats.merge(m_chunkStats[m_foldedChunks]);
+        m_foldedChunks++;
+        if (m_chunkStats[m_foldedChunks - 1].rounds == m_config.chunk_rounds) {
+            m_checkpointChunks = m_foldedChunks;
+            m_checkpointStats = stats;
+        }
+    }
+    return m_foldedChunks;
+}
+
+bool ShoeSimulator::loadCheckpoint(SimulationStats& stats) {
+    std::ifstream file(m_config.checkpoint_path, std::ios::binary);
+    if (!file) return false;
+
+    CheckpointHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0 ||
+        header.digest != configDigest() || header.folded_chunks > m_chunkCount) {
+        utils::Logger::getInstance().warning("Ignoring checkpoint from a different configuration: {}",
+                                             m_config.checkpoint_path);
+        return false;
+    }
+
+    stats = header.stats;
+    m_foldedChunks = header.folded_chunks;
+    m_checkpointChunks = header.folded_chunks;
+    m_checkpointStats = header.stats;
+    return true;
+}
+
+bool ShoeSimulator::saveCheckpoint() const {
+    CheckpointHeader header{};
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    header.digest = configDigest();
+    header.folded_chunks = m_checkpointChunks;
+    header.stats = m_checkpointStats;
+
+    // Write then rename, so an interrupted save keeps the previous checkpoint
+    const std::string temporary = m_config.checkpoint_path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(&header), sizeof(header))) return false;
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, m_config.checkpoint_path, error);
+    return !error;
+}
+
+// Everything that changes a chunk's outcome; the round total is excluded so
+// a finished run can be extended
+uint64_t ShoeSimulator::configDigest() const {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+        }
+    };
+
+    mix(&m_config.seed, sizeof(m_config.seed));
+    mix(&m_config.chunk_rounds, sizeof(m_config.chunk_rounds));
+    mix(&m_config.decks, sizeof(m_config.decks));
+    mix(&m_config.penetration, sizeof(m_config.penetration));
+    mix(m_config.rules.data(), m_config.rules.size());
+    mix(&m_config.illustrious_18, sizeof(m_config.illustrious_18));
+    mix(&m_config.fab_4, sizeof(m_config.fab_4));
+    mix(&m_config.counting_system, sizeof(m_config.counting_system));
+    mix(&m_config.bankroll, sizeof(m_config.bankroll));
+    mix(&m_config.min_bet, sizeof(m_config.min_bet));
+    mix(&m_config.max_bet, sizeof(m_config.max_bet));
+    mix(&m_config.kelly_fraction, sizeof(m_config.kelly_fraction));
+    mix(m_config.spread.data(), sizeof(m_config.spread));
+    mix(&m_config.flat_bet, sizeof(m_config.flat_bet));
+    return hash;
+}
+
+} // namespace intelligence
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "../counting/counting_systems.hpp"
+#include "../strategy/basic_strategy.hpp"
+#include "../strategy/betting_strategy.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace intelligence {
+
+struct SimulationConfig {
+    uint64_t rounds = 100'000'000;
+    uint32_t threads = 0;              // 0 = all hardware threads
+    uint64_t seed = 0x5EED;            // Same seed, same results, any thread count
+    uint64_t chunk_rounds = 1 << 20;   // Unit of work and of checkpointing
+
+    uint32_t decks = 6;
+    float penetration = 0.75f;
+    std::string rules = "s17_das";
+    bool illustrious_18 = true;
+    bool fab_4 = true;
+    CountingSystem counting_system = CountingSystem::HiLo;
+
+    // Bets are sized against a fixed bankroll, so rounds stay independent
+    double bankroll = 10000.0;
+    double min_bet = 10.0;
+    double max_bet = 500.0;
+    float kelly_fraction = 0.25f;
+    std::array<uint32_t, 5> spread = {1, 2, 4, 8, 12};
+    bool flat_bet = false;             // Min bet every round: pure playing edge
+
+    std::string checkpoint_path;       // Empty: no checkpoint; existing file: resume
+    uint32_t checkpoint_interval_s = 30;
+};
+
+// Additive per-round sums; merged in chunk order so results are reproducible
+struct SimulationStats {
+    uint64_t rounds{0};
+    uint64_t hands{0};
+    double initial_bets{0.0};
+    double wagered{0.0};      // Including doubles and splits
+    double result{0.0};       // Net won
+    double result_squares{0.0};
+
+    void merge(const SimulationStats& other);
+};
+
+struct SimulationReport {
+    double ev_per_round;       // Net won per round
+    double ev_ci95;            // Half-width of the 95% interval
+    double sd_per_round;
+    double edge;               // Net won per unit of initial bet
+    double edge_ci95;
+    double n0;                 // Rounds until EV equals one SD
+    double risk_of_ruin;       // For SimulationConfig::bankroll
+    double risk_of_ruin_low;   // At the upper EV bound
+    double risk_of_ruin_high;  // At the lower EV bound
+};
+
+// Monte Carlo shoe simulator over BasicStrategy, the deviation sets,
+// BettingStrategy and CardCounter. Worker threads claim chunks of rounds
+// from a shared cursor; each chunk seeds its own generator from
+// (seed, chunk), so results do not depend on scheduling.
+class ShoeSimulator {
+public:
+    using ProgressCallback = std::function<void(uint64_t completedRounds, uint64_t totalRounds)>;
+
+    explicit ShoeSimulator(const SimulationConfig& config);
+    ~ShoeSimulator();
+
+    bool run(SimulationStats& stats, const ProgressCallback& progress = {});
+
+    static SimulationReport summarize(const SimulationStats& stats, double bankroll);
+
+private:
+    void worker();
+    void simulateChunk(uint64_t chunk, SimulationStats& stats) const;
+    uint64_t foldCompleted(SimulationStats& stats);
+
+    bool loadCheckpoint(SimulationStats& stats);
+    bool saveCheckpoint() const;
+    uint64_t configDigest() const;
+
+    SimulationConfig m_config;
+    BasicStrategy m_strategy;
+    BettingStrategy m_betting;
+
+    uint64_t m_chunkCount{0};
+    std::atomic<uint64_t> m_nextChunk{0};
+    uint64_t m_foldedChunks{0};  // Completed prefix already in the running stats
+    // Prefix of full chunks: a partial last chunk is rerun on resume, which
+    // lets a finished run be extended
+    uint64_t m_checkpointChunks{0};
+    SimulationStats m_checkpointStats;
+    std::vector<SimulationStats> m_chunkStats;
+    std::unique_ptr<std::atomic<bool>[]> m_chunkDone;
+};
+
+} // namespace intelligence
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+namespace intelligence {
+
+// SplitMix64, used to expand one seed into generator state
+inline uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// xoshiro256** (Blackman & Vigna): fast, 256-bit state, one per thread
+class Xoshiro256 {
+public:
+    explicit Xoshiro256(uint64_t seed) {
+        for (auto& word : m_state) word = splitMix64(seed);
+    }
+
+    uint64_t next() {
+        const uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        const uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, range) from 32 random bits, Lemire's multiply-shift
+    // with rejection only on the biased sliver
+    uint32_t bounded(uint32_t random, uint32_t range) {
+        uint64_t product = static_cast<uint64_t>(random) * range;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < range) {
+            const uint32_t threshold = (0u - range) % range;
+            while (low < threshold) {
+                product = static_cast<uint64_t>(static_cast<uint32_t>(next() >> 32)) * range;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+    uint32_t bounded(uint32_t range) {
+        return bounded(static_cast<uint32_t>(next() >> 32), range);
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t m_state[4];
+};
+
+} // namespace intelligence
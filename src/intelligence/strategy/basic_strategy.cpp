@@ -0,0 +1,117 @@
+#include "basic_strategy.hpp"
+#include "../../utils/logger.hpp"
+#include <algorithm>
+
+namespace intelligence {
+
+BasicStrategy::BasicStrategy() {
+}
+
+BasicStrategy::~BasicStrategy() {
+}
+
+void BasicStrategy::initialize(const std::string& rules) {
+    m_rules = rules;
+    m_hitSoft17 = rules.find("h17") != std::string::npos;
+    m_doubleAfterSplit = rules.find("das") != std::string::npos;
+    m_lateSurrender = rules.find("ls") != std::string::npos;
+
+    m_tables = &STRATEGY_TABLES[rulesIndex(m_hitSoft17, m_doubleAfterSplit)];
+
+    utils::Logger::getInstance().info("Basic strategy: {}", m_rules);
+}
+
+void BasicStrategy::setDeviationSets(bool illustrious18, bool fab4) {
+    m_illustrious18 = illustrious18;
+    m_fab4 = fab4;
+    m_deviationsEnabled = illustrious18 || fab4;
+    m_indexTable = &INDEX_TABLES[deviationIndex(illustrious18, fab4)];
+}
+
+Action BasicStrategy::getAction(uint32_t playerTotal,
+                                core::CardRank dealerUpcard,
+                                bool isSoft,
+                                bool canDouble,
+                                bool canSplit,
+                                bool canSurrender) const {
+    if (playerTotal >= 21) return Action::Stand;
+
+    const uint32_t column = dealerColumn(dealerUpcard);
+    if (canSplit) {
+        const uint32_t pairRank = (isSoft && playerTotal == 12) ? 0 : std::min(playerTotal / 2, 10u) - 1;
+        if (m_tables->pairs[pairRank][column] == Action::Split) return Action::Split;
+    }
+
+    Action action = isSoft ? m_tables->soft[std::max(playerTotal, 12u)][column]
+                           : m_tables->hard[std::max(playerTotal, 4u)][column];
+
+    if (action == Action::Double && !canDouble) {
+        action = (isSoft && playerTotal >= 18) ? Action::Stand : Action::Hit;
+    } else if (action == Action::Surrender && !canSurrender) {
+        action = playerTotal >= 17 ? Action::Stand : Action::Hit;
+    }
+    return action;
+}
+
+bool BasicStrategy::getDeviationAction(uint32_t playerTotal,
+                                       core::CardRank dealerUpcard,
+                                       float trueCount,
+                                       bool isSoft,
+                                       bool canDouble,
+                                       bool canSplit,
+                                       bool canSurrender,
+                                       Action& action) const {
+    if (!m_deviationsEnabled || isSoft || playerTotal >= TOTAL_ROWS) return false;
+
+    const uint32_t column = dealerColumn(dealerUpcard);
+    auto apply = [&](const IndexCell& cell, bool surrenderOnly) {
+        for (uint32_t i = 0; i < cell.count; i++) {
+            const IndexEntry& entry = cell.plays[i];
+            const bool above = trueCount >= entry.index;
+            if (!above && entry.belowIsBasic) continue;
+
+            const Action play = above ? entry.above : entry.below;
+            if (play == Action::Double && !canDouble) continue;
+            if (play == Action::Surrender && !canSurrender) continue;
+            if (surrenderOnly && entry.above != Action::Surrender) continue;
+
+            action = play;
+            return true;
+        }
+        return false;
+    };
+
+    // Pair plays first; total plays only for pairs the chart does not split
+    if (canSplit) {
+        const uint32_t pairRank = std::min(playerTotal / 2, 10u) - 1;
+        if (apply(m_indexTable->pairs[pairRank][column], false)) return true;
+        if (m_tables->pairs[pairRank][column] == Action::Split) return false;
+    }
+
+    // A chart surrender outranks the stand/hit indices of the same hand
+    // (16vT, 16v9, 15vT): those only apply when surrender is not offered.
+    // A Fab 4 surrender index still decides both sides of its count
+    const bool chartSurrenders = canSurrender && m_tables->hard[playerTotal][column] == Action::Surrender;
+    return apply(m_indexTable->hard[playerTotal][column], chartSurrenders);
+}
+
+Action BasicStrategy::getPlay(uint32_t playerTotal,
+                              core::CardRank dealerUpcard,
+                              float trueCount,
+                              bool isSoft,
+                              bool canDouble,
+                              bool canSplit,
+                              bool canSurrender) const {
+    Action action;
+    if (getDeviationAction(playerTotal, dealerUpcard, trueCount, isSoft,
+                           canDouble, canSplit, canSurrender, action)) {
+        return action;
+    }
+    return getAction(playerTotal, dealerUpcard, isSoft, canDouble, canSplit, canSurrender);
+}
+
+bool BasicStrategy::takeInsurance(float trueCount) const {
+    return m_illustrious18 && trueCount >= 3.0f;
+}
+
+} // namespace intelligence
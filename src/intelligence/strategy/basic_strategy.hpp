@@ -1,45 +1,69 @@
 #pragma once
 
+#include "strategy_tables.hpp"
 #include "../../core/types.hpp"
+#include <cstdint>
+#include <string>
 
 namespace intelligence {
 
-enum class Action {
-    Hit,
-    Stand,
-    Double,
-    Split,
-    Surrender
-};
-
 class BasicStrategy {
 public:
     BasicStrategy();
     ~BasicStrategy();
 
+    // Rules string: "s17"/"h17", "das", "ls" (late surrender), e.g. "s17_das"
     void initialize(const std::string& rules);
+    void setDeviationSets(bool illustrious18, bool fab4);
     
+    // playerTotal counts one ace as 11 when soft. With canSplit the hand is a
+    // pair (aces: soft 12). Doubles and surrenders that are not allowed fall
+    // back to the play the chart lists next.
     Action getAction(uint32_t playerTotal, 
                     core::CardRank dealerUpcard,
                     bool isSoft,
                     bool canDouble,
-                    bool canSplit) const;
+                    bool canSplit,
+                    bool canSurrender = false) const;
     
-    Action getDeviationAction(uint32_t playerTotal,
-                             core::CardRank dealerUpcard,
-                             float trueCount) const;
+    // Index play for this hand at trueCount; false when none applies.
+    // One or two reads of the precompiled index table.
+    bool getDeviationAction(uint32_t playerTotal,
+                            core::CardRank dealerUpcard,
+                            float trueCount,
+                            bool isSoft,
+                            bool canDouble,
+                            bool canSplit,
+                            bool canSurrender,
+                            Action& action) const;
+
+    // Basic strategy with the enabled index plays applied
+    Action getPlay(uint32_t playerTotal,
+                   core::CardRank dealerUpcard,
+                   float trueCount,
+                   bool isSoft,
+                   bool canDouble,
+                   bool canSplit,
+                   bool canSurrender = false) const;
+
+    // Illustrious 18 #1: insure at true count +3
+    bool takeInsurance(float trueCount) const;
+
+    bool hitsSoft17() const { return m_hitSoft17; }
+    bool doubleAfterSplit() const { return m_doubleAfterSplit; }
+    bool lateSurrender() const { return m_lateSurrender; }
 
 private:
-    void buildStrategyTables();
-    void loadIllustrious18();
-    void loadFab4();
-    
-    // Strategy lookup tables [player total][dealer upcard]
-    Action m_hardTotals[22][13];
-    Action m_softTotals[22][13];
-    Action m_pairSplitting[13][13];
+    // Compile-time tables for the configured rules and deviation sets
+    const StrategyTables* m_tables{&STRATEGY_TABLES[rulesIndex(false, true)]};
+    const IndexTable* m_indexTable{&INDEX_TABLES[deviationIndex(true, true)]};
     
     bool m_deviationsEnabled{true};
+    bool m_illustrious18{true};
+    bool m_fab4{true};
+    bool m_hitSoft17{false};
+    bool m_doubleAfterSplit{true};
+    bool m_lateSurrender{false};
     std::string m_rules;
 };
 
@@ -0,0 +1,51 @@
+#include "betting_strategy.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace intelligence {
+
+namespace {
+
+constexpr float BASE_EDGE = -0.005f;           // Off the top, typical 6-deck S17 DAS
+constexpr float EDGE_PER_TRUE_COUNT = 0.005f;
+constexpr double HAND_VARIANCE = 1.33;         // Per hand, in squared units
+
+} // namespace
+
+BettingStrategy::BettingStrategy() {
+}
+
+BettingStrategy::~BettingStrategy() {
+}
+
+void BettingStrategy::configure(double minBet, double maxBet, float kellyFraction) {
+    m_minBet = minBet;
+    m_maxBet = std::max(minBet, maxBet);
+    m_kellyFraction = kellyFraction;
+}
+
+double BettingStrategy::calculateBet(float trueCount, double bankroll) const {
+    const double kelly = calculateKellyBet(estimateAdvantage(trueCount), bankroll);
+
+    // Never spread wider than the configured ramp
+    const double cap = std::min(m_maxBet, m_minBet * m_betSpread.back());
+    return std::clamp(kelly, m_minBet, cap);
+}
+
+double BettingStrategy::calculateKellyBet(float advantage, double bankroll) const {
+    if (advantage <= 0.0f) return 0.0;
+    return bankroll * m_kellyFraction * advantage / HAND_VARIANCE;
+}
+
+// Whole-unit ramp by true count: TC <= 1 bets the first step
+double BettingStrategy::getCamouflageBet(float trueCount) const {
+    const int step = std::clamp(static_cast<int>(std::floor(trueCount)) - 1, 0,
+                                static_cast<int>(m_betSpread.size()) - 1);
+    return std::min(m_maxBet, m_minBet * m_betSpread[step]);
+}
+
+float BettingStrategy::estimateAdvantage(float trueCount) {
+    return BASE_EDGE + EDGE_PER_TRUE_COUNT * trueCount;
+}
+
+} // namespace intelligence
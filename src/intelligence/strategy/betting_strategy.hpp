@@ -11,6 +11,7 @@ public:
     ~BettingStrategy();
 
     void configure(double minBet, double maxBet, float kellyFraction);
+    void setSpread(const std::array<uint32_t, 5>& spread) { m_betSpread = spread; }
     
     double calculateBet(float trueCount, double bankroll) const;
     double calculateKellyBet(float advantage, double bankroll) const;
@@ -21,6 +22,9 @@ public:
     // Camouflage betting
     double getCamouflageBet(float trueCount) const;
 
+    // Player edge at this true count (Hi-Lo, multi-deck rule of thumb)
+    static float estimateAdvantage(float trueCount);
+
 private:
     double m_minBet{10.0};
     double m_maxBet{500.0};
@@ -0,0 +1,272 @@
+#include "ev_engine.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace intelligence {
+
+namespace {
+
+constexpr double UNAVAILABLE = -std::numeric_limits<double>::infinity();
+constexpr uint32_t TEN_INDEX = 9;
+
+// Rank index: 0 = Ace, 1-8 = Two-Nine, 9 = ten-valued
+constexpr uint32_t rankValue(uint32_t rank) { return rank + 1; }
+
+uint32_t rankIndex(core::CardRank rank) {
+    return std::min<uint32_t>(static_cast<uint32_t>(rank) - 1, TEN_INDEX);
+}
+
+// Best total counting one ace as 11 where it fits
+uint32_t effectiveTotal(uint32_t sum, bool hasAce) {
+    return (hasAce && sum + 10 <= 21) ? sum + 10 : sum;
+}
+
+} // namespace
+
+Action ActionEV::best() const {
+    Action action = Action::Stand;
+    double value = stand;
+    if (hit > value) { action = Action::Hit; value = hit; }
+    if (double_down > value) { action = Action::Double; value = double_down; }
+    if (split > value) { action = Action::Split; value = split; }
+    if (surrender > value) { action = Action::Surrender; }
+    return action;
+}
+
+double ActionEV::bestValue() const {
+    return std::max({hit, stand, double_down, split, surrender});
+}
+
+EvEngine::EvEngine()
+    : m_memo(MEMO_SIZE) {
+}
+
+EvEngine::~EvEngine() {
+}
+
+void EvEngine::configure(const std::string& rules) {
+    m_hitSoft17 = rules.find("h17") != std::string::npos;
+    m_doubleAfterSplit = rules.find("das") != std::string::npos;
+    m_lateSurrender = rules.find("ls") != std::string::npos;
+
+    // Rule changes invalidate every cached dealer table
+    std::fill(m_memo.begin(), m_memo.end(), MemoEntry{});
+    m_primedShoe = ~0ull;
+}
+
+void EvEngine::prime(const RankCounts& remaining) {
+    const Shoe shoe = makeShoe(remaining);
+    if (shoe.total == 0) return;
+
+    for (uint32_t upcard = 0; upcard < 10; upcard++) {
+        upcardOutcomes(shoe, upcard);
+    }
+}
+
+bool EvEngine::evaluate(const RankCounts& remaining,
+                        std::span<const core::CardRank> playerCards,
+                        core::CardRank dealerUpcard,
+                        ActionEV& out) {
+    const Shoe shoe = makeShoe(remaining);
+    if (shoe.total == 0 || playerCards.empty()) return false;
+
+    uint32_t sum = 0;
+    bool hasAce = false;
+    for (core::CardRank rank : playerCards) {
+        const uint32_t index = rankIndex(rank);
+        sum += rankValue(index);
+        hasAce |= index == 0;
+    }
+
+    const Outcomes& dealer = upcardOutcomes(shoe, rankIndex(dealerUpcard));
+    for (auto& known : m_hitKnown) known.fill(false);
+
+    const bool firstDecision = playerCards.size() == 2;
+    const bool pair = firstDecision && rankIndex(playerCards[0]) == rankIndex(playerCards[1]);
+
+    out.stand = standValue(sum, hasAce, dealer);
+    out.hit = sum < 21 ? hitValue(sum, hasAce, shoe, dealer) : UNAVAILABLE;
+    out.double_down = firstDecision ? doubleValue(sum, hasAce, shoe, dealer) : UNAVAILABLE;
+    out.split = pair ? splitValue(rankIndex(playerCards[0]), shoe, dealer) : UNAVAILABLE;
+    out.surrender = (firstDecision && m_lateSurrender) ? -0.5 : UNAVAILABLE;
+    return true;
+}
+
+EvEngine::Shoe EvEngine::makeShoe(const RankCounts& remaining) {
+    Shoe shoe{};
+    for (uint32_t rank = 0; rank < 10; rank++) {
+        // Clamp to the key's field width (8 decks fit)
+        const uint16_t limit = rank == TEN_INDEX ? 255 : 63;
+        shoe.counts[rank] = std::min(remaining[rank], limit);
+        shoe.total += shoe.counts[rank];
+        shoe.packed += shoe.counts[rank] * rankUnit(rank);
+    }
+    return shoe;
+}
+
+uint64_t EvEngine::rankUnit(uint32_t rank) {
+    return 1ull << (6 * rank);
+}
+
+// Exact dealer distribution, drawing without replacement. Terminal hands
+// resolve before the memo; everything else is keyed by shoe and hand.
+EvEngine::Outcomes EvEngine::dealer(Shoe& shoe, uint32_t sum, bool hasAce, uint32_t cards) {
+    Outcomes result{};
+
+    const uint32_t total = effectiveTotal(sum, hasAce);
+    if (cards >= 2) {
+        if (cards == 2 && total == 21) {
+            result.p[BLACKJACK] = 1.0;
+            return result;
+        }
+        if (sum > 21) {
+            result.p[BUST] = 1.0;
+            return result;
+        }
+        const bool soft17 = total == 17 && hasAce && sum == 7;
+        if (total >= 17 && !(soft17 && m_hitSoft17)) {
+            result.p[total - 17] = 1.0;
+            return result;
+        }
+    }
+
+    const uint32_t state = 1 | (sum << 1) | (uint32_t(hasAce) << 6) | (std::min(cards, 2u) << 7);
+    const size_t slot = ((shoe.packed ^ (uint64_t(state) << 56)) * 0x9E3779B97F4A7C15ull) >> 49;
+    MemoEntry& entry = m_memo[slot & (MEMO_SIZE - 1)];
+    if (entry.state == state && entry.shoe == shoe.packed) {
+        m_cacheHits++;
+        return entry.outcomes;
+    }
+    m_cacheMisses++;
+
+    if (shoe.total == 0) {
+        // Exhausted shoe: treat the hand as final
+        result.p[total >= 17 && total <= 21 ? total - 17 : BUST] = 1.0;
+        return result;
+    }
+
+    const double inverseTotal = 1.0 / shoe.total;
+    for (uint32_t rank = 0; rank < 10; rank++) {
+        const uint32_t count = shoe.counts[rank];
+        if (count == 0) continue;
+
+        shoe.counts[rank]--;
+        shoe.total--;
+        shoe.packed -= rankUnit(rank);
+        const Outcomes next = dealer(shoe, sum + rankValue(rank), hasAce || rank == 0, cards + 1);
+        shoe.counts[rank]++;
+        shoe.total++;
+        shoe.packed += rankUnit(rank);
+
+        const double probability = count * inverseTotal;
+        for (uint32_t lane = 0; lane < OUTCOME_LANES; lane++) {
+            result.p[lane] += probability * next.p[lane];
+        }
+    }
+
+    // The recursion may have evicted the slot; rewrite it
+    MemoEntry& store = m_memo[slot & (MEMO_SIZE - 1)];
+    store.shoe = shoe.packed;
+    store.state = state;
+    store.outcomes = result;
+    return result;
+}
+
+// Outcomes once the dealer has peeked: blackjack is ruled out and the rest
+// renormalized
+const EvEngine::Outcomes& EvEngine::upcardOutcomes(const Shoe& shoe, uint32_t upcard) {
+    if (m_primedShoe != shoe.packed) {
+        m_primedShoe = shoe.packed;
+        m_primedValid.fill(false);
+    }
+    if (m_primedValid[upcard]) return m_primed[upcard];
+
+    Shoe working = shoe;
+    Outcomes outcomes = dealer(working, rankValue(upcard), upcard == 0, 1);
+
+    const double live = 1.0 - outcomes.p[BLACKJACK];
+    outcomes.p[BLACKJACK] = 0.0;
+    if (live > 0.0) {
+        const double scale = 1.0 / live;
+        for (uint32_t lane = 0; lane < OUTCOME_LANES; lane++) {
+            outcomes.p[lane] *= scale;
+        }
+    }
+
+    m_primed[upcard] = outcomes;
+    m_primedValid[upcard] = true;
+    return m_primed[upcard];
+}
+
+double EvEngine::standValue(uint32_t sum, bool hasAce, const Outcomes& dealer) const {
+    if (sum > 21) return -1.0;
+
+    const uint32_t total = effectiveTotal(sum, hasAce);
+    double value = dealer.p[BUST];
+    for (uint32_t dealerTotal = 17; dealerTotal <= 21; dealerTotal++) {
+        const double p = dealer.p[dealerTotal - 17];
+        if (total > dealerTotal) value += p;
+        else if (total < dealerTotal) value -= p;
+    }
+    // Dealer makes 17+, so player totals below 17 only win on a bust
+    return value;
+}
+
+double EvEngine::hitValue(uint32_t sum, bool hasAce, const Shoe& shoe, const Outcomes& dealer) {
+    if (m_hitKnown[sum][hasAce]) return m_hitMemo[sum][hasAce];
+
+    const double inverseTotal = 1.0 / shoe.total;
+    double value = 0.0;
+    for (uint32_t rank = 0; rank < 10; rank++) {
+        if (shoe.counts[rank] == 0) continue;
+        value += shoe.counts[rank] * inverseTotal *
+                 bestAfterHit(sum + rankValue(rank), hasAce || rank == 0, shoe, dealer);
+    }
+
+    m_hitMemo[sum][hasAce] = value;
+    m_hitKnown[sum][hasAce] = true;
+    return value;
+}
+
+double EvEngine::bestAfterHit(uint32_t sum, bool hasAce, const Shoe& shoe, const Outcomes& dealer) {
+    if (sum > 21) return -1.0;
+    const double stand = standValue(sum, hasAce, dealer);
+    if (effectiveTotal(sum, hasAce) == 21) return stand;
+    return std::max(stand, hitValue(sum, hasAce, shoe, dealer));
+}
+
+double EvEngine::doubleValue(uint32_t sum, bool hasAce, const Shoe& shoe, const Outcomes& dealer) const {
+    const double inverseTotal = 1.0 / shoe.total;
+    double value = 0.0;
+    for (uint32_t rank = 0; rank < 10; rank++) {
+        if (shoe.counts[rank] == 0) continue;
+        value += shoe.counts[rank] * inverseTotal *
+                 standValue(sum + rankValue(rank), hasAce || rank == 0, dealer);
+    }
+    return 2.0 * value;
+}
+
+double EvEngine::splitValue(uint32_t rank, const Shoe& shoe, const Outcomes& dealer) {
+    const double inverseTotal = 1.0 / shoe.total;
+    const bool aces = rank == 0;
+
+    // One post-split hand; split aces take a single card
+    double hand = 0.0;
+    for (uint32_t next = 0; next < 10; next++) {
+        if (shoe.counts[next] == 0) continue;
+
+        const uint32_t sum = rankValue(rank) + rankValue(next);
+        const bool hasAce = aces || next == 0;
+        double value = standValue(sum, hasAce, dealer);
+        if (!aces) {
+            value = std::max(value, bestAfterHit(sum, hasAce, shoe, dealer));
+            if (m_doubleAfterSplit) {
+                value = std::max(value, doubleValue(sum, hasAce, shoe, dealer));
+            }
+        }
+        hand += shoe.counts[next] * inverseTotal * value;
+    }
+    return 2.0 * hand;
+}
+
+} // namespace intelligence
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "basic_strategy.hpp"
+#include "../counting/card_counter.hpp"
+#include "../../core/types.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace intelligence {
+
+// Expected value of each action for one unit bet. Unavailable actions are -inf.
+struct ActionEV {
+    double hit;
+    double stand;
+    double double_down;
+    double split;
+    double surrender;
+
+    Action best() const;
+    double bestValue() const;
+};
+
+// Composition-dependent EV. Dealer outcome probabilities are exact for the
+// remaining shoe (drawing without replacement) and memoized by
+// (remaining-rank vector, dealer hand); the memo persists across calls, so
+// the subtrees a new composition shares with earlier ones are not recomputed.
+// The player's own draws use the composition at decision time. Splits are
+// evaluated as two independent hands without resplitting.
+// Not thread-safe: owned by the strategy thread.
+class EvEngine {
+public:
+    EvEngine();
+    ~EvEngine();
+
+    // Rules string as in StrategyConfig: "s17"/"h17", "das", "ls" (late surrender)
+    void configure(const std::string& rules);
+
+    // Dealer tables for every upcard of this shoe, so the next evaluate() on
+    // it only runs the player side
+    void prime(const RankCounts& remaining);
+
+    // remaining must already exclude the player's cards and the upcard, as
+    // CardCounter::getRemainingRanks() does once they are counted
+    bool evaluate(const RankCounts& remaining,
+                  std::span<const core::CardRank> playerCards,
+                  core::CardRank dealerUpcard,
+                  ActionEV& out);
+
+    uint64_t getCacheHits() const { return m_cacheHits; }
+    uint64_t getCacheMisses() const { return m_cacheMisses; }
+
+private:
+    // Dealer final totals 17-21, bust, blackjack, padded to 8 lanes
+    enum Outcome : uint32_t { BUST = 5, BLACKJACK = 6, OUTCOME_LANES = 8 };
+    struct alignas(64) Outcomes {
+        std::array<double, OUTCOME_LANES> p;
+    };
+
+    struct Shoe {
+        RankCounts counts;
+        uint32_t total;
+        uint64_t packed;  // Memo key: 6 bits per rank A-9, 8 bits for tens
+    };
+
+    struct MemoEntry {
+        uint64_t shoe;
+        uint32_t state;  // 0 = empty
+        Outcomes outcomes;
+    };
+
+    static constexpr size_t MEMO_SIZE = 1 << 15;  // Entries, direct-mapped
+    static constexpr uint32_t PLAYER_STATES = 32;
+
+    static Shoe makeShoe(const RankCounts& remaining);
+    static uint64_t rankUnit(uint32_t rank);
+
+    Outcomes dealer(Shoe& shoe, uint32_t sum, bool hasAce, uint32_t cards);
+    const Outcomes& upcardOutcomes(const Shoe& shoe, uint32_t upcard);
+
+    double standValue(uint32_t sum, bool hasAce, const Outcomes& dealer) const;
+    double hitValue(uint32_t sum, bool hasAce, const Shoe& shoe, const Outcomes& dealer);
+    double bestAfterHit(uint32_t sum, bool hasAce, const Shoe& shoe, const Outcomes& dealer);
+    double doubleValue(uint32_t sum, bool hasAce, const Shoe& shoe, const Outcomes& dealer) const;
+    double splitValue(uint32_t rank, const Shoe& shoe, const Outcomes& dealer);
+
+    bool m_hitSoft17{false};
+    bool m_doubleAfterSplit{true};
+    bool m_lateSurrender{false};
+
+    std::vector<MemoEntry> m_memo;
+
+    // Primed shoe: conditioned (no dealer blackjack) outcomes per upcard
+    uint64_t m_primedShoe{~0ull};
+    std::array<Outcomes, 10> m_primed{};
+    std::array<bool, 10> m_primedValid{};
+
+    // Player hit memo for the current evaluate()
+    std::array<std::array<double, 2>, PLAYER_STATES> m_hitMemo{};
+    std::array<std::array<bool, 2>, PLAYER_STATES> m_hitKnown{};
+
+    uint64_t m_cacheHits{0};
+    uint64_t m_cacheMisses{0};
+};
+
+} // namespace intelligence
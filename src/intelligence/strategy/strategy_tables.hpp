@@ -0,0 +1,210 @@
+#pragma once
+
+#include "../../core/types.hpp"
+#include <array>
+#include <cstdint>
+
+namespace intelligence {
+
+enum class Action {
+    Hit,
+    Stand,
+    Double,
+    Split,
+    Surrender
+};
+
+// Dealer columns: A, 2-9, ten-valued
+constexpr uint32_t DEALER_COLUMNS = 10;
+constexpr uint32_t TOTAL_ROWS = 22;   // Indexed by player total
+constexpr uint32_t PAIR_ROWS = 10;    // Indexed by pair rank - 1, ten-valued last
+constexpr uint32_t MAX_PLAYS_PER_CELL = 2;
+
+constexpr uint32_t dealerColumn(core::CardRank upcard) {
+    const uint32_t rank = static_cast<uint32_t>(upcard);
+    return (rank < 10 ? rank : 10) - 1;
+}
+
+// Basic strategy charts
+// ---------------------
+
+struct StrategyTables {
+    std::array<std::array<Action, DEALER_COLUMNS>, TOTAL_ROWS> hard{};
+    std::array<std::array<Action, DEALER_COLUMNS>, TOTAL_ROWS> soft{};
+    std::array<std::array<Action, DEALER_COLUMNS>, PAIR_ROWS> pairs{};  // Split, or Hit: play the total
+};
+
+constexpr Action chartAction(char entry) {
+    switch (entry) {
+        case 'S': return Action::Stand;
+        case 'D': return Action::Double;
+        case 'P': return Action::Split;
+        case 'R': return Action::Surrender;
+        default:  return Action::Hit;
+    }
+}
+
+// Chart rows list the upcards 2-9, T, A
+constexpr void setRow(std::array<Action, DEALER_COLUMNS>& row, const char* chart) {
+    for (uint32_t i = 0; i < DEALER_COLUMNS; i++) {
+        row[i == DEALER_COLUMNS - 1 ? 0 : i + 1] = chartAction(chart[i]);
+    }
+}
+
+// Multi-deck charts, dealer peeks
+constexpr StrategyTables buildStrategyTables(bool hitSoft17, bool doubleAfterSplit) {
+    StrategyTables tables;
+    for (auto& row : tables.hard) setRow(row, "HHHHHHHHHH");
+    for (auto& row : tables.soft) setRow(row, "SSSSSSSSSS");
+    for (auto& row : tables.pairs) setRow(row, "HHHHHHHHHH");
+
+    //                              2345678 9TA
+    setRow(tables.hard[9],         "HDDDDHHHHH");
+    setRow(tables.hard[10],        "DDDDDDDDHH");
+    setRow(tables.hard[11], hitSoft17 ? "DDDDDDDDDD" : "DDDDDDDDDH");
+    setRow(tables.hard[12],        "HHSSSHHHHH");
+    setRow(tables.hard[13],        "SSSSSHHHHH");
+    setRow(tables.hard[14],        "SSSSSHHHHH");
+    setRow(tables.hard[15], hitSoft17 ? "SSSSSHHHRR" : "SSSSSHHHRH");
+    setRow(tables.hard[16],        "SSSSSHHRRR");
+    setRow(tables.hard[17], hitSoft17 ? "SSSSSSSSSR" : "SSSSSSSSSS");
+    for (uint32_t total = 18; total < TOTAL_ROWS; total++) setRow(tables.hard[total], "SSSSSSSSSS");
+
+    setRow(tables.soft[12],        "HHHHHHHHHH");
+    setRow(tables.soft[13],        "HHHDDHHHHH");
+    setRow(tables.soft[14],        "HHHDDHHHHH");
+    setRow(tables.soft[15],        "HHDDDHHHHH");
+    setRow(tables.soft[16],        "HHDDDHHHHH");
+    setRow(tables.soft[17],        "HDDDDHHHHH");
+    setRow(tables.soft[18], hitSoft17 ? "DDDDDSSHHH" : "SDDDDSSHHH");
+    setRow(tables.soft[19], hitSoft17 ? "SSSSDSSSSS" : "SSSSSSSSSS");
+
+    setRow(tables.pairs[0],        "PPPPPPPPPP");
+    setRow(tables.pairs[1], doubleAfterSplit ? "PPPPPPHHHH" : "HHPPPPHHHH");
+    setRow(tables.pairs[2], doubleAfterSplit ? "PPPPPPHHHH" : "HHPPPPHHHH");
+    setRow(tables.pairs[3], doubleAfterSplit ? "HHHPPHHHHH" : "HHHHHHHHHH");
+    setRow(tables.pairs[5], doubleAfterSplit ? "PPPPPHHHHH" : "HPPPPHHHHH");
+    setRow(tables.pairs[6],        "PPPPPPHHHH");
+    setRow(tables.pairs[7],        "PPPPPPPPPP");
+    setRow(tables.pairs[8],        "PPPPPSPPSS");
+    return tables;
+}
+
+constexpr size_t rulesIndex(bool hitSoft17, bool doubleAfterSplit) {
+    return (hitSoft17 ? 2 : 0) + (doubleAfterSplit ? 1 : 0);
+}
+
+// Every rule set, generated at compile time
+constexpr std::array<StrategyTables, 4> STRATEGY_TABLES = {
+    buildStrategyTables(false, false), buildStrategyTables(false, true),
+    buildStrategyTables(true, false), buildStrategyTables(true, true)
+};
+
+// Index plays
+// -----------
+
+// At or above index take `above`, below it take `below` (or play on)
+struct IndexPlay {
+    uint8_t total;
+    core::CardRank upcard;
+    bool pair;
+    float index;
+    Action above;
+    Action below;
+    bool belowIsBasic;
+};
+
+// Illustrious 18 (Hi-Lo, multi-deck); #1, insurance at +3, is not a chart play.
+// 11vA plays basic below its index: H17 charts already double it
+constexpr std::array<IndexPlay, 17> ILLUSTRIOUS_18 = {{
+    {16, core::CardRank::Ten,   false,  0.0f, Action::Stand,  Action::Hit,   false},
+    {15, core::CardRank::Ten,   false,  4.0f, Action::Stand,  Action::Hit,   false},
+    {20, core::CardRank::Five,  true,   5.0f, Action::Split,  Action::Stand, false},
+    {20, core::CardRank::Six,   true,   4.0f, Action::Split,  Action::Stand, false},
+    {10, core::CardRank::Ten,   false,  4.0f, Action::Double, Action::Hit,   false},
+    {12, core::CardRank::Three, false,  2.0f, Action::Stand,  Action::Hit,   false},
+    {12, core::CardRank::Two,   false,  3.0f, Action::Stand,  Action::Hit,   false},
+    {11, core::CardRank::Ace,   false,  1.0f, Action::Double, Action::Hit,   true},
+    {9,  core::CardRank::Two,   false,  1.0f, Action::Double, Action::Hit,   false},
+    {10, core::CardRank::Ace,   false,  4.0f, Action::Double, Action::Hit,   false},
+    {9,  core::CardRank::Seven, false,  3.0f, Action::Double, Action::Hit,   false},
+    {16, core::CardRank::Nine,  false,  5.0f, Action::Stand,  Action::Hit,   false},
+    {13, core::CardRank::Two,   false, -1.0f, Action::Stand,  Action::Hit,   false},
+    {12, core::CardRank::Four,  false,  0.0f, Action::Stand,  Action::Hit,   false},
+    {12, core::CardRank::Five,  false, -2.0f, Action::Stand,  Action::Hit,   false},
+    {12, core::CardRank::Six,   false, -1.0f, Action::Stand,  Action::Hit,   false},
+    {13, core::CardRank::Three, false, -2.0f, Action::Stand,  Action::Hit,   false},
+}};
+
+// Fab 4 surrenders; below the index the hand plays on. 15vT and 15vA hit
+// there: late-surrender charts surrender them, which would hide the index
+constexpr std::array<IndexPlay, 4> FAB_4 = {{
+    {14, core::CardRank::Ten,  false, 3.0f, Action::Surrender, Action::Surrender, true},
+    {15, core::CardRank::Ten,  false, 0.0f, Action::Surrender, Action::Hit,       false},
+    {15, core::CardRank::Nine, false, 2.0f, Action::Surrender, Action::Surrender, true},
+    {15, core::CardRank::Ace,  false, 1.0f, Action::Surrender, Action::Hit,       false},
+}};
+
+struct IndexEntry {
+    float index;
+    Action above;
+    Action below;
+    bool belowIsBasic;
+};
+
+// Plays for one (hand, upcard), in decision order: surrenders first, then
+// by ascending threshold
+struct IndexCell {
+    std::array<IndexEntry, MAX_PLAYS_PER_CELL> plays{};
+    uint32_t count{0};
+};
+
+struct IndexTable {
+    std::array<std::array<IndexCell, DEALER_COLUMNS>, TOTAL_ROWS> hard{};
+    std::array<std::array<IndexCell, DEALER_COLUMNS>, PAIR_ROWS> pairs{};
+};
+
+constexpr void insertPlay(IndexTable& table, const IndexPlay& play) {
+    IndexCell& cell = play.pair ? table.pairs[play.total / 2 - 1][dealerColumn(play.upcard)]
+                                : table.hard[play.total][dealerColumn(play.upcard)];
+    if (cell.count == MAX_PLAYS_PER_CELL) {
+        throw "MAX_PLAYS_PER_CELL exceeded";  // Fails the constant evaluation
+    }
+
+    const IndexEntry entry{play.index, play.above, play.below, play.belowIsBasic};
+    auto before = [](const IndexEntry& a, const IndexEntry& b) {
+        const bool aSurrender = a.above == Action::Surrender;
+        const bool bSurrender = b.above == Action::Surrender;
+        return aSurrender != bSurrender ? aSurrender : a.index < b.index;
+    };
+
+    uint32_t position = cell.count++;
+    while (position > 0 && before(entry, cell.plays[position - 1])) {
+        cell.plays[position] = cell.plays[position - 1];
+        position--;
+    }
+    cell.plays[position] = entry;
+}
+
+constexpr IndexTable buildIndexTable(bool illustrious18, bool fab4) {
+    IndexTable table;
+    if (fab4) {
+        for (const auto& play : FAB_4) insertPlay(table, play);
+    }
+    if (illustrious18) {
+        for (const auto& play : ILLUSTRIOUS_18) insertPlay(table, play);
+    }
+    return table;
+}
+
+constexpr size_t deviationIndex(bool illustrious18, bool fab4) {
+    return (illustrious18 ? 2 : 0) + (fab4 ? 1 : 0);
+}
+
+// Every deviation-set combination, generated at compile time
+constexpr std::array<IndexTable, 4> INDEX_TABLES = {
+    buildIndexTable(false, false), buildIndexTable(false, true),
+    buildIndexTable(true, false), buildIndexTable(true, true)
+};
+
+} // namespace intelligence
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace pipeline {
+
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// What a full queue does with a new item
+enum class OverflowPolicy {
+    Reject,     // Keep queued items, refuse the new one
+    DropOldest  // Evict the oldest queued item to make room
+};
+
+enum class PushResult {
+    Pushed,
+    DroppedOldest,  // Pushed after evicting the oldest item
+    Rejected
+};
+
+/**
+ * Bounded single-producer/single-consumer ring.
+ * Head and tail live on separate cache lines, each side keeps a cached copy
+ * of the other side's index so the fast path touches no shared line.
+ */
+template<typename T, size_t Capacity>
+class SPSCQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+public:
+    bool tryPush(const T& item) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity) return false;
+        }
+
+        m_slots[tail & MASK] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& item) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) return false;
+        }
+
+        item = std::move(m_slots[head & MASK]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    size_t size() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    // Consumer line
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head{0};
+    size_t m_cachedTail{0};
+
+    // Producer line
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail{0};
+    size_t m_cachedHead{0};
+
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> m_slots{};
+};
+
+/**
+ * Bounded multi-producer/multi-consumer queue (Vyukov): each cell carries
+ * a sequence number, so producers and consumers only contend on their own
+ * index. Because any thread may pop, a producer can evict the oldest item
+ * itself, which is what the DropOldest policy relies on.
+ */
+template<typename T, size_t Capacity>
+class MPMCQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+public:
+    MPMCQueue() {
+        for (size_t i = 0; i < Capacity; i++) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(const T& item) {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        for (;;) {
+            cell = &m_cells[pos & MASK];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = item;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& item) {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        for (;;) {
+            cell = &m_cells[pos & MASK];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Empty
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        item = std::move(cell->data);
+        cell->sequence.store(pos + MASK + 1, std::memory_order_release);
+        return true;
+    }
+
+    PushResult push(const T& item, OverflowPolicy policy) {
+        bool evicted = false;
+
+        while (!tryPush(item)) {
+            if (policy == OverflowPolicy::Reject) {
+                m_rejected.fetch_add(1, std::memory_order_relaxed);
+                return PushResult::Rejected;
+            }
+
+            T oldest;
+            if (tryPop(oldest)) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                evicted = true;
+            }
+        }
+
+        return evicted ? PushResult::DroppedOldest : PushResult::Pushed;
+    }
+
+    bool empty() const {
+        return m_dequeuePos.load(std::memory_order_acquire) >=
+               m_enqueuePos.load(std::memory_order_acquire);
+    }
+
+    uint64_t getDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+    uint64_t getRejected() const { return m_rejected.load(std::memory_order_relaxed); }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    alignas(CACHE_LINE_SIZE) std::array<Cell, Capacity> m_cells;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_enqueuePos{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_dequeuePos{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_rejected{0};
+};
+
+} // namespace pipeline
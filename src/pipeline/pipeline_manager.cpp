@@ -0,0 +1,1071 @@
+#include "pipeline_manager.hpp"
+#include "../utils/gpu_memory_pool.hpp"
+#include "../utils/logger.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+namespace pipeline {
+
+namespace {
+
+// Same clock the capture backends stamp frames with
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::high_resolution_clock::now()
+                                 .time_since_epoch().count());
+}
+
+// Trace row of each stage
+constexpr utils::TraceCategory stageCategory(Stage stage) {
+    switch (stage) {
+        case Stage::Capture: return utils::TraceCategory::Capture;
+        case Stage::Preprocess: return utils::TraceCategory::Preprocess;
+        case Stage::Inference: return utils::TraceCategory::Inference;
+        case Stage::Postprocess: return utils::TraceCategory::Postprocess;
+        case Stage::Counting: return utils::TraceCategory::Counting;
+        case Stage::Strategy: return utils::TraceCategory::Strategy;
+        case Stage::UI: return utils::TraceCategory::UI;
+        default: break;
+    }
+    return utils::TraceCategory::Postprocess;
+}
+
+const char* actionName(intelligence::Action action) {
+    switch (action) {
+        case intelligence::Action::Hit: return "HIT";
+        case intelligence::Action::Stand: return "STAND";
+        case intelligence::Action::Double: return "DOUBLE";
+        case intelligence::Action::Split: return "SPLIT";
+        case intelligence::Action::Surrender: return "SURRENDER";
+    }
+    return "STAND";
+}
+
+// Confirmed cards still on the table, for the counting thread to tell
+// the current hand from. Dealt order is kept; removal is by track.
+class TableCards {
+public:
+    void add(const core::CardEvent& event) {
+        if (m_count == m_cards.size()) return;
+        m_cards[m_count++] = {event.track_id, event.card.rank, event.center_y};
+    }
+
+    void remove(uint32_t trackId) {
+        const auto end = m_cards.begin() + m_count;
+        const auto it = std::find_if(m_cards.begin(), end,
+                                     [trackId](const Entry& entry) { return entry.trackId == trackId; });
+        if (it == end) return;
+        std::move(it + 1, end, it);
+        m_count--;
+    }
+
+    void clear() { m_count = 0; }
+
+    // Dealer above midlineY, player below; the dealer's first card is the upcard
+    TableHand hand(float midlineY) const {
+        TableHand hand{};
+        for (uint32_t i = 0; i < m_count; i++) {
+            const Entry& entry = m_cards[i];
+            if (entry.centerY < midlineY) {
+                if (!hand.has_upcard) {
+                    hand.dealer_upcard = entry.rank;
+                    hand.has_upcard = true;
+                }
+            } else if (hand.player_count < hand.player.size()) {
+                hand.player[hand.player_count++] = entry.rank;
+            }
+        }
+        return hand;
+    }
+
+private:
+    struct Entry {
+        uint32_t trackId;
+        core::CardRank rank;
+        float centerY;
+    };
+
+    std::array<Entry, core::constants::MAX_TRACKS> m_cards{};
+    uint32_t m_count{0};
+};
+
+const char* captureMethodName(core::CaptureConfig::CaptureMethod method) {
+    switch (method) {
+        case core::CaptureConfig::CaptureMethod::DXGI: return "dxgi";
+        case core::CaptureConfig::CaptureMethod::NVFBC: return "nvfbc";
+        case core::CaptureConfig::CaptureMethod::REPLAY: return "replay";
+    }
+    return "dxgi";
+}
+
+} // namespace
+
+PipelineManager::PipelineManager() {
+    m_tileDetections.reserve(core::constants::MAX_DETECTIONS_PER_FRAME);
+    m_trackerInput.reserve(core::constants::MAX_DETECTIONS_PER_FRAME);
+}
+
+PipelineManager::~PipelineManager() {
+    stop();
+
+    for (cudaEvent_t event : m_inputReadyEvents) {
+        if (event) cudaEventDestroy(event);
+    }
+    if (m_preprocessStream) {
+        cudaStreamDestroy(m_preprocessStream);
+    }
+}
+
+bool PipelineManager::initialize(const core::ConfigManager& config) {
+    auto& logger = utils::Logger::getInstance();
+    m_config = &config;
+
+    utils::nvtx::setEnabled(config.getSystemConfig().enable_nvtx_markers);
+
+    // Every stage below allocates from the shared pool, so it comes first
+    const auto& systemConfig = config.getSystemConfig();
+    if (cudaSetDevice(systemConfig.gpu_device_id) != cudaSuccess) {
+        logger.error("Failed to select GPU {}", systemConfig.gpu_device_id);
+        return false;
+    }
+    const size_t reserveBytes = static_cast<size_t>(systemConfig.memory_pool_size_mb) << 20;
+    if (!utils::GpuMemoryPool::getInstance().initialize(
+            systemConfig.gpu_device_id, reserveBytes,
+            std::max(reserveBytes, core::constants::GPU_MEMORY_LIMIT))) {
+        logger.error("Failed to create GPU memory pool");
+        return false;
+    }
+
+    const auto& captureConfig = config.getCaptureConfig();
+    const auto& visionConfig = config.getVisionConfig();
+
+    // Backpressure policy for the latest-wins links
+    const OverflowPolicy policy = config.getSystemConfig().queue_drop_oldest
+        ? OverflowPolicy::DropOldest
+        : OverflowPolicy::Reject;
+    m_strategyQueue.setPolicy(policy);
+    m_uiQueue.setPolicy(policy);
+
+    // Capture
+    m_capture = capture::createCapture(captureMethodName(captureConfig.method), captureConfig);
+    if (!m_capture || !m_capture->initialize()) {
+        logger.error("Failed to initialize capture backend");
+        return false;
+    }
+    m_roiDetector = std::make_unique<capture::ROIDetector>();
+    if (!m_roiDetector->initialize()) {
+        return false;
+    }
+
+    // Device frame ring between capture and the GPU stages
+    m_frameBuffer = std::make_unique<FrameRing>(m_capture->getWidth(), m_capture->getHeight());
+    // A lossless replay waits for the consumers, so every recorded frame is processed
+    const bool lossless = captureConfig.method == core::CaptureConfig::CaptureMethod::REPLAY &&
+                          captureConfig.replay_lossless;
+    m_frameBuffer->setReclaimOldest(!lossless && policy == OverflowPolicy::DropOldest);
+    const uint32_t slotCount = std::min<uint32_t>(captureConfig.buffer_count,
+                                                  core::constants::MAX_CAPTURE_BUFFERS);
+    if (!m_frameBuffer->initialize(slotCount)) {
+        logger.error("Failed to allocate capture frame buffer");
+        return false;
+    }
+
+    // Vision
+    if (visionConfig.inference_mode == "roi_tiles") {
+        m_tiledInference = std::make_unique<vision::TiledInference>(visionConfig);
+        if (!m_tiledInference->initialize()) {
+            logger.error("Failed to initialize tiled inference");
+            return false;
+        }
+    } else if (visionConfig.inference_mode == "cascade") {
+        m_cascade = std::make_unique<vision::CascadeDetector>(visionConfig);
+        if (!m_cascade->initialize()) {
+            logger.error("Failed to initialize cascade detector");
+            return false;
+        }
+    } else {
+        // Cached plan, or a fallback while the real plan builds in the background
+        m_engineCache = std::make_unique<vision::EngineCache>(visionConfig);
+        m_engine = m_engineCache->acquireEngine();
+        if (!m_engine) {
+            logger.error("Failed to load engine: {}", visionConfig.model_path);
+            return false;
+        }
+        m_publishedEngine.store(m_engine, std::memory_order_release);
+
+        m_preprocessor = std::make_unique<vision::Preprocessor>();
+        if (!m_preprocessor->initialize(m_engine->getInputWidth(), m_engine->getInputHeight(),
+                                        m_engine->getInputPrecision())) {
+            logger.error("Failed to initialize preprocessor");
+            return false;
+        }
+
+        // Adaptive input resolution across the plan's optimization profiles
+        if (!visionConfig.resolution_profiles.empty()) {
+            m_governor = std::make_unique<ResolutionGovernor>(core::constants::TOTAL_LATENCY_NS,
+                                                              visionConfig.confidence_threshold);
+            adoptEngineProfiles();
+        }
+
+        // With graphs the letterbox kernel runs inside the engine's per-slot
+        // graph and the preprocess thread submits directly
+        m_fusedSubmission = visionConfig.enable_cuda_graphs;
+
+        // Preprocess runs on its own stream; each engine slot waits on its input event
+        cudaStreamCreateWithFlags(&m_preprocessStream, cudaStreamNonBlocking);
+        for (uint32_t i = 0; i < m_engine->getInFlightDepth(); i++) {
+            cudaEventCreateWithFlags(&m_inputReadyEvents[i], cudaEventDisableTiming);
+        }
+    }
+
+    // Skip inference while the table is static
+    if (captureConfig.motion_gating) {
+        m_motionGate = std::make_unique<vision::MotionGate>();
+        if (!m_motionGate->initialize(captureConfig.motion_detection_threshold,
+                                      captureConfig.motion_min_changed_cells,
+                                      captureConfig.motion_reverify_interval,
+                                      captureConfig.motion_cell_delta)) {
+            logger.error("Failed to initialize motion gate");
+            return false;
+        }
+    }
+
+    const auto& countingConfig = config.getCountingConfig();
+    m_tracker = std::make_unique<vision::CardTracker>();
+    m_eventEmitter = std::make_unique<vision::CardEventEmitter>();
+    m_eventEmitter->configure(countingConfig.confirm_frames, countingConfig.confirm_confidence);
+
+    // Intelligence
+    m_counter = std::make_unique<intelligence::CardCounter>();
+    m_counter->initialize(countingConfig.deck_count, countingConfig.system);
+
+    const auto& bettingConfig = config.getBettingConfig();
+    m_betting = std::make_unique<intelligence::BettingStrategy>();
+    m_betting->configure(bettingConfig.min_bet, bettingConfig.max_bet, bettingConfig.kelly_fraction);
+    m_betting->setSpread(bettingConfig.spread);
+
+    m_evEngine = std::make_unique<intelligence::EvEngine>();
+    m_evEngine->configure(config.getStrategyConfig().basic_strategy_rules);
+
+    // UI (GL context is created on the UI thread)
+    if (config.getUIConfig().overlay_enabled) {
+        m_overlay = std::make_unique<ui::OverlayRenderer>();
+    }
+
+    m_initialized = true;
+    utils::GpuMemoryPool::getInstance().logUsage();
+    logger.info("Pipeline initialized ({} inference)", visionConfig.inference_mode);
+    return true;
+}
+
+bool PipelineManager::start() {
+    if (!m_initialized || m_running) {
+        return false;
+    }
+
+    if (!m_capture->start()) {
+        utils::Logger::getInstance().error("Failed to start capture");
+        return false;
+    }
+
+    if (const std::string& recordPath = m_config->getCaptureConfig().record_path; !recordPath.empty()) {
+        if (!m_recorder) {
+            m_recorder = std::make_unique<capture::FrameRecorder>();
+        }
+        if (!m_recorder->start(recordPath, m_capture->getWidth(), m_capture->getHeight(),
+                               m_capture->getFrameRate())) {
+            utils::Logger::getInstance().warning("Recording disabled: could not start {}", recordPath);
+        }
+    }
+
+    // Engines are warmed up and every buffer is sized; the frame loop allocates nothing
+    utils::GpuMemoryPool::getInstance().markSteadyState();
+
+    m_running.store(true, std::memory_order_release);
+
+    using StageBody = void (PipelineManager::*)();
+    std::vector<std::pair<ThreadRole, StageBody>> stages{{ThreadRole::Capture, &PipelineManager::captureThreadFunc}};
+    if (m_engine) {
+        stages.emplace_back(ThreadRole::Preprocess, &PipelineManager::preprocessThreadFunc);
+    }
+    if (!m_fusedSubmission) {
+        stages.emplace_back(ThreadRole::Inference, &PipelineManager::inferenceThreadFunc);
+    }
+    stages.emplace_back(ThreadRole::Postprocess, &PipelineManager::postprocessThreadFunc);
+    stages.emplace_back(ThreadRole::Counting, &PipelineManager::countingThreadFunc);
+    stages.emplace_back(ThreadRole::Strategy, &PipelineManager::strategyThreadFunc);
+    if (m_overlay) {
+        stages.emplace_back(ThreadRole::UI, &PipelineManager::uiThreadFunc);
+    }
+    if (!m_config->getSystemConfig().metrics_export_path.empty()) {
+        stages.emplace_back(ThreadRole::Metrics, &PipelineManager::metricsThreadFunc);
+    }
+
+    // Placement depends on which stages run, so plan before the first one starts
+    std::vector<ThreadRole> roles;
+    for (const auto& stage : stages) roles.push_back(stage.first);
+    m_scheduler.plan(m_config->getSystemConfig(), roles);
+
+    for (const auto& [role, body] : stages) {
+        m_threads.emplace_back(&PipelineManager::runStage, this, role, body);
+    }
+    if (const auto& system = m_config->getSystemConfig(); system.trace_frames > 0) {
+        m_trace.arm(system.trace_frames, system.trace_output_path);
+    }
+
+    return true;
+}
+
+bool PipelineManager::stop() {
+    if (!m_running.exchange(false, std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    // Wake every parked stage so it observes m_running and exits
+    m_frameSignal.notifyAll();
+    m_frameReleasedSignal.notifyAll();
+    m_inferenceQueue.wakeAll();
+    m_detectionQueue.wakeAll();
+    m_identityQueue.wakeAll();
+    m_overlayQueue.wakeAll();
+    m_countingQueue.wakeAll();
+    m_strategyQueue.wakeAll();
+    m_uiQueue.wakeAll();
+    m_inputSlotSignal.notifyAll();
+
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    m_threads.clear();
+    m_trace.stop();  // A trace cut short still gets written
+    if (m_recorder) {
+        m_recorder->stop();
+    }
+
+    m_capture->stop();
+    utils::GpuMemoryPool::getInstance().logUsage();
+    return true;
+}
+
+float PipelineManager::getAverageLatency() const {
+    return static_cast<float>(m_metrics.getMeanLatency(Stage::EndToEnd) / 1e6);
+}
+
+uint32_t PipelineManager::getFramesProcessed() const {
+    return m_framesProcessed.load(std::memory_order_relaxed);
+}
+
+float PipelineManager::getInferenceSkipRate() const {
+    return m_motionGate ? m_motionGate->getSkipRate() : 0.0f;
+}
+
+uint32_t PipelineManager::getFramesDropped() const {
+    return static_cast<uint32_t>(m_frameBuffer->getDroppedFrames() + m_detectionQueue.getDropped());
+}
+
+// Stage threads
+
+void PipelineManager::captureThreadFunc() {
+    auto& logger = utils::Logger::getInstance();
+    cudaStream_t writerStream = m_capture->getStream();
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        capture::Frame* slot = m_frameBuffer->acquireWriteBuffer(writerStream);
+        if (!slot) {
+            // Every slot is being read; park until a consumer hands one back
+            m_frameReleasedSignal.wait([this] { return m_frameBuffer->hasWritableSlot(); }, m_running);
+            continue;
+        }
+
+        NVTX_RANGE(utils::TraceCategory::Capture, "capture");
+        uint8_t* target = slot->data;
+        if (!m_capture->captureFrame(*slot)) {
+            m_frameBuffer->abortWriteBuffer(slot);
+            continue;  // Timed out waiting for a new desktop frame
+        }
+
+        if (slot->data != target) {
+            // Backend handed back its own storage instead of filling the slot
+            logger.error("Capture backend ignored the frame buffer target");
+            m_capture->releaseFrame(*slot);
+            m_frameBuffer->abortWriteBuffer(slot);
+            continue;
+        }
+
+        if (m_recorder) {
+            m_recorder->submit(*slot, writerStream);
+        }
+
+        slot->published_ns = nowNs();
+        if (slot->published_ns > slot->timestamp_ns) {
+            m_trace.beginFrame(slot->frame_id);
+            recordStage(Stage::Capture, slot->timestamp_ns, slot->published_ns, slot->frame_id);
+        }
+
+        m_capture->releaseFrame(*slot);
+        m_frameBuffer->releaseWriteBuffer(slot);
+        m_frameSignal.notify();
+    }
+}
+
+// Table felt bounds, re-detected on the first frame and every recalculation
+// interval after; nullptr while no table was found. Called from the one
+// thread that gates motion for the inference mode.
+const capture::ROI* PipelineManager::refreshTableROI(const capture::Frame& frame, cudaStream_t stream) {
+    if (m_roiDetector->needsRecalculation()) {
+        NVTX_RANGE(utils::TraceCategory::Preprocess, "table_roi");
+        m_roiDetector->detectTableRegion(frame, stream);
+    }
+    m_roiDetector->advanceFrame();
+
+    const auto& table = m_roiDetector->getTableROI();
+    return (table.width > 0 && table.height > 0) ? &table : nullptr;
+}
+
+void PipelineManager::preprocessThreadFunc() {
+    auto& logger = utils::Logger::getInstance();
+    ConfigPtr config = m_config->getSnapshot();
+
+    while (capture::Frame* frame = waitForFrame()) {
+        NVTX_RANGE(utils::TraceCategory::Preprocess, "preprocess");
+        const uint32_t frameId = frame->frame_id;
+        uint64_t start = nowNs();
+        if (const ConfigPtr previous = refreshConfig(config)) {
+            applyPreprocessConfig(*previous, config);
+        }
+        pollRebuild();
+
+        const capture::ROI* roi = refreshTableROI(*frame, m_preprocessStream);
+
+        if (m_motionGate &&
+            m_motionGate->evaluate(*frame, m_preprocessStream, roi) == vision::MotionDecision::Reuse) {
+            InferenceJob job{};
+            job.frame = *frame;
+            job.reuse = true;
+            releaseReadFrame(frame, m_preprocessStream);
+            if (m_fusedSubmission) {
+                DetectionBatch batch;
+                batch.source = BatchSource::Reuse;
+                batch.count = 0;
+                pushDetections(batch, job.frame);
+            } else {
+                m_inferenceQueue.push(job);  // Dropping a reuse job when full is harmless
+            }
+            recordStage(Stage::Preprocess, start, nowNs(), frameId);
+            continue;
+        }
+
+        // Slots latch the engine profile as they are acquired
+        if (m_governor) {
+            selectResolution(*frame, roi);
+        }
+
+        // Claim an engine slot; one frees up whenever postprocess collects a result
+        uint32_t slot = 0;
+        while (!m_engine->acquireSlot(slot) && m_running.load(std::memory_order_relaxed)) {
+            m_inputSlotSignal.wait([this] { return m_engine->getFreeSlots() > 0; }, m_running);
+        }
+        if (!m_running.load(std::memory_order_relaxed)) {
+            releaseReadFrame(frame, m_preprocessStream);
+            break;
+        }
+        start = nowNs();  // Waiting for a slot is backpressure, not preprocessing
+
+        if (m_fusedSubmission) {
+            submitFused(frame, slot, roi, config->vision);
+            recordStage(Stage::Preprocess, start, nowNs(), frameId);
+            continue;
+        }
+
+        // Waits on the frame's ready fence on the preprocess stream; nothing blocks the host
+        const bool ok = m_preprocessor->process(*frame, m_engine->getDeviceInputBuffer(slot),
+                                                m_preprocessStream, roi);
+        const capture::Frame meta = *frame;
+        releaseReadFrame(frame, m_preprocessStream);
+
+        if (!ok) {
+            logger.error("Preprocessing failed for frame {}", meta.frame_id);
+            m_engine->releaseSlot(slot);
+            continue;
+        }
+
+        cudaEvent_t inputReady = m_inputReadyEvents[slot];
+        cudaEventRecord(inputReady, m_preprocessStream);
+
+        // Reuse jobs can fill the queue; a rejected job must hand its slot back
+        if (m_inferenceQueue.push({meta, m_preprocessor->getLastTransform(), inputReady, slot, false}) ==
+            PushResult::Rejected) {
+            m_engine->releaseSlot(slot);
+        }
+        recordStage(Stage::Preprocess, start, nowNs(), frameId);
+    }
+}
+
+// A newer snapshot if one was published since this stage last looked, which
+// then replaces `config`; the one it replaced is returned for comparison.
+// One atomic load per frame while nothing changes.
+PipelineManager::ConfigPtr PipelineManager::refreshConfig(ConfigPtr& config) const {
+    if (m_config->getVersion() == config->version) {
+        return nullptr;
+    }
+    return std::exchange(config, m_config->getSnapshot());
+}
+
+// Full-frame mode gates motion on this thread, and owns the engine cache
+void PipelineManager::applyPreprocessConfig(const core::ConfigSnapshot& previous, const ConfigPtr& config) {
+    if (m_motionGate) {
+        m_motionGate->configure(config->capture.motion_detection_threshold,
+                                config->capture.motion_min_changed_cells,
+                                config->capture.motion_reverify_interval,
+                                config->capture.motion_cell_delta);
+    }
+    if (core::ConfigManager::assess(previous, *config) == core::ConfigImpact::Rebuild) {
+        m_deferredRebuild = config;
+    }
+}
+
+// Drives a rebuild for a reloaded vision config: one build at a time, the
+// latest request wins, and the current engine keeps serving until the new
+// one is warm. A failed rebuild leaves the current engine in place.
+void PipelineManager::pollRebuild() {
+    // Not building means the outcome is final; checking readiness first could
+    // miss an engine finishing in between
+    if (m_pendingCache && !m_pendingCache->isBuilding()) {
+        if (m_pendingCache->hasReadyEngine()) {
+            m_engineCache = std::move(m_pendingCache);
+        } else {
+            m_pendingCache.reset();  // The cache logged why
+        }
+    }
+
+    if (m_deferredRebuild && !m_pendingCache && !m_engineCache->isBuilding()) {
+        m_pendingCache = std::make_unique<vision::EngineCache>(m_deferredRebuild->vision);
+        m_deferredRebuild.reset();
+        if (!m_pendingCache->startRebuild()) {
+            m_pendingCache.reset();
+        }
+    }
+
+    if (m_engineCache->hasReadyEngine()) {
+        swapEngine();
+    }
+}
+
+// Install the background-built engine. Only this thread acquires slots, so
+// once every slot is back no job or ticket refers to the old engine; the
+// other stages load the new one with the next message they receive.
+void PipelineManager::swapEngine() {
+    auto engine = m_engineCache->takeReadyEngine();
+    if (!engine || engine->getInFlightDepth() != m_engine->getInFlightDepth()) {
+        return;
+    }
+
+    while (m_engine->getFreeSlots() < m_engine->getInFlightDepth() &&
+           m_running.load(std::memory_order_relaxed)) {
+        m_inputSlotSignal.wait([this] {
+            return m_engine->getFreeSlots() == m_engine->getInFlightDepth();
+        }, m_running);
+    }
+    if (!m_running.load(std::memory_order_relaxed)) return;
+
+    // A stage returning from its last wait() may still hold the old one; it
+    // is normally destroyed here, on the next swap
+    m_retiredEngine = std::move(m_engine);
+    m_engine = std::move(engine);
+    m_publishedEngine.store(m_engine, std::memory_order_release);
+
+    // The fallback and the real plan may bind different input types and resolutions
+    if (m_governor) {
+        adoptEngineProfiles();
+    }
+    if (m_preprocessor->getPrecision() != m_engine->getInputPrecision() ||
+        m_preprocessor->getInputWidth() != m_engine->getInputWidth() ||
+        m_preprocessor->getInputHeight() != m_engine->getInputHeight()) {
+        m_preprocessor->initialize(m_engine->getInputWidth(), m_engine->getInputHeight(),
+                                   m_engine->getInputPrecision());
+    }
+    utils::Logger::getInstance().info("Hot-swapped inference engine ({})",
+                                      m_engineCache->getPlanPath());
+}
+
+// Profile sizes of the current engine; the governor continues from its initial profile
+void PipelineManager::adoptEngineProfiles() {
+    m_profileSizes.clear();
+    for (const auto& profile : m_engine->getProfiles()) {
+        m_profileSizes.push_back(std::max(profile.width, profile.height));
+    }
+    m_governor->reset(m_engine->getActiveProfile());
+}
+
+// Drop resolution when frames run over budget, raise it for large ROIs or
+// low confidence; the preprocessor follows the engine's input size
+void PipelineManager::selectResolution(const capture::Frame& frame, const capture::ROI* roi) {
+    if (m_profileSizes.size() < 2) return;
+
+    const uint32_t roiSize = roi ? std::max(roi->width, roi->height)
+                                 : std::max(frame.width, frame.height);
+    const uint32_t profile = m_governor->select(m_profileSizes, roiSize);
+    if (profile == m_engine->getActiveProfile() || !m_engine->selectProfile(profile)) return;
+
+    m_preprocessor->initialize(m_engine->getInputWidth(), m_engine->getInputHeight(),
+                               m_engine->getInputPrecision());
+}
+
+// Whole frame on the slot stream: one graph launch letterboxes, infers and
+// decodes, the frame slot is released behind it
+void PipelineManager::submitFused(capture::Frame* frame, uint32_t slot, const capture::ROI* roi,
+                                  const core::VisionConfig& vision) {
+    cudaStream_t slotStream = m_engine->getStream(slot);
+
+    DetectionBatch batch;
+    vision::cuda::LetterboxParams params;
+    const bool prepared = m_preprocessor->prepare(*frame, slotStream, roi,
+                                                  m_engine->getDeviceInputBuffer(slot), params);
+    const bool ok = prepared &&
+        m_engine->submitFrame(slot, params, m_preprocessor->getLastTransform(),
+                              vision.confidence_threshold, vision.nms_threshold, batch.ticket);
+
+    const capture::Frame meta = *frame;
+    releaseReadFrame(frame, slotStream);
+
+    if (!ok) {
+        utils::Logger::getInstance().error("Failed to submit frame {}", meta.frame_id);
+        if (!prepared) {
+            m_engine->releaseSlot(slot);  // submitFrame releases on its own failures
+        }
+        return;
+    }
+
+    batch.source = BatchSource::Ticket;
+    batch.count = 0;
+    pushDetections(batch, meta);
+}
+
+void PipelineManager::inferenceThreadFunc() {
+    ConfigPtr config = m_config->getSnapshot();
+    InferenceJob job{};
+    std::shared_ptr<vision::TensorRTEngine> engine = m_publishedEngine.load(std::memory_order_acquire);
+
+    for (;;) {
+        DetectionBatch batch;
+        // Tiled and cascade modes gate motion here rather than in preprocess
+        if (refreshConfig(config) && !engine && m_motionGate) {
+            m_motionGate->configure(config->capture.motion_detection_threshold,
+                                    config->capture.motion_min_changed_cells,
+                                    config->capture.motion_reverify_interval,
+                                    config->capture.motion_cell_delta);
+        }
+        const auto& visionConfig = config->vision;
+
+        if (!engine) {
+            // Tiled and cascade modes letterbox their own crops, straight from the frame buffer
+            capture::Frame* frame = waitForFrame();
+            if (!frame) break;
+
+            cudaStream_t stream = m_tiledInference ? m_tiledInference->getStream()
+                                                   : m_cascade->getStream();
+            job.frame = *frame;
+            const capture::ROI* roi = refreshTableROI(*frame, stream);
+            if (m_motionGate &&
+                m_motionGate->evaluate(*frame, stream, roi) == vision::MotionDecision::Reuse) {
+                releaseReadFrame(frame, stream);
+                batch.source = BatchSource::Reuse;
+                batch.count = 0;
+                pushDetections(batch, job.frame);
+                continue;
+            }
+
+            NVTX_RANGE(utils::TraceCategory::Inference, "infer");
+            const uint64_t start = nowNs();
+            bool ok;
+            if (m_tiledInference) {
+                // Crop around the latest tracked boxes; none yet means a table scan
+                IdentitySnapshot tracks;
+                bool fresh = false;
+                while (m_identityQueue.tryPop(tracks)) fresh = true;
+                if (fresh) {
+                    m_roiDetector->setCardRegions(std::span(tracks.cards.data(), tracks.count),
+                                                  frame->width, frame->height);
+                }
+
+                ok = m_tiledInference->infer(*frame, *m_roiDetector, m_tileDetections,
+                                             visionConfig.confidence_threshold,
+                                             visionConfig.nms_threshold);
+            } else {
+                // Latest identities only; older snapshots are superseded
+                IdentitySnapshot identities;
+                bool fresh = false;
+                while (m_identityQueue.tryPop(identities)) fresh = true;
+                if (fresh) {
+                    m_cascade->setIdentifiedCards(std::span(identities.cards.data(), identities.count));
+                }
+
+                ok = m_cascade->infer(*frame, roi, m_tileDetections,
+                                      visionConfig.confidence_threshold,
+                                      visionConfig.nms_threshold);
+            }
+            releaseReadFrame(frame, stream);
+            if (!ok) continue;
+            recordStage(Stage::Inference, start, nowNs(), job.frame.frame_id);
+
+            batch.source = BatchSource::Detections;
+            batch.count = static_cast<uint32_t>(std::min<size_t>(m_tileDetections.size(),
+                                                                 batch.detections.size()));
+            std::copy_n(m_tileDetections.begin(), batch.count, batch.detections.begin());
+        } else {
+            if (!m_inferenceQueue.pop(job, m_running)) break;
+
+            if (job.reuse) {
+                batch.source = BatchSource::Reuse;
+                batch.count = 0;
+                pushDetections(batch, job.frame);
+                continue;
+            }
+
+            // The job's slot pins the engine that was current when it was pushed
+            engine = m_publishedEngine.load(std::memory_order_acquire);
+
+            // Submit without waiting; postprocess redeems the ticket, so the
+            // next slot can start while this one still executes
+            NVTX_RANGE(utils::TraceCategory::Inference, "submit");
+            const uint64_t start = nowNs();
+            cudaStreamWaitEvent(engine->getStream(job.slot), job.input_ready, 0);
+            if (!engine->submit(job.slot, visionConfig.confidence_threshold,
+                                  visionConfig.nms_threshold,
+                                  std::span(&job.transform, 1), batch.ticket)) {
+                m_inputSlotSignal.notify();
+                continue;
+            }
+            // GPU time is recorded when postprocess redeems the ticket
+            m_trace.record("submit", utils::TraceCategory::Inference, start, nowNs(), job.frame.frame_id);
+
+            batch.source = BatchSource::Ticket;
+            batch.count = 0;
+        }
+
+        pushDetections(batch, job.frame);
+    }
+}
+
+void PipelineManager::pushDetections(DetectionBatch& batch, const capture::Frame& frame) {
+    batch.frame_id = frame.frame_id;
+    batch.timestamp_ns = frame.timestamp_ns;
+
+    if (m_detectionQueue.push(batch) == PushResult::Rejected &&
+        batch.source == BatchSource::Ticket) {
+        // Postprocess is behind: drain the result here so the slot is not lost
+        m_publishedEngine.load(std::memory_order_acquire)->wait(batch.ticket, m_tileDetections);
+        m_inputSlotSignal.notify();
+    }
+}
+
+void PipelineManager::postprocessThreadFunc() {
+    ConfigPtr config = m_config->getSnapshot();
+    DetectionBatch batch;
+
+    while (m_detectionQueue.pop(batch, m_running)) {
+        NVTX_RANGE(utils::TraceCategory::Postprocess, "postprocess");
+        const uint64_t start = nowNs();
+        if (refreshConfig(config)) {
+            m_eventEmitter->configure(config->counting.confirm_frames, config->counting.confirm_confidence);
+        }
+        if (batch.source == BatchSource::Ticket) {
+            // Tickets arrive in submission order, so waiting on each in turn
+            // keeps frames ordered while later slots keep the GPU busy. The
+            // ticket's slot keeps the engine from being swapped until then.
+            const auto engine = m_publishedEngine.load(std::memory_order_acquire);
+            float gpuMilliseconds = 0.0f;
+            const bool ok = engine->wait(batch.ticket, m_trackerInput, &gpuMilliseconds);
+            m_trace.record("wait", utils::TraceCategory::Postprocess, start, nowNs(), batch.frame_id);
+            m_inputSlotSignal.notify();
+            if (!ok) continue;
+            m_metrics.record(Stage::Inference,
+                             static_cast<uint64_t>(gpuMilliseconds * 1e6f));
+        } else if (batch.source == BatchSource::Detections) {
+            m_trackerInput.assign(batch.detections.begin(), batch.detections.begin() + batch.count);
+        }
+        // Reuse: m_trackerInput still holds the last inferred detections, which
+        // keeps their tracks alive without spawning new ones
+
+        const uint64_t trackStart = nowNs();
+        m_tracker->update(m_trackerInput);
+        m_trace.record("track", utils::TraceCategory::Tracking, trackStart, nowNs(), batch.frame_id);
+        if (m_cascade) {
+            publishIdentities();
+        } else if (m_tiledInference) {
+            publishTrackRegions();
+        }
+        if (m_overlay) {
+            publishOverlay();
+        }
+
+        // Confirmed tracks become events, so each card is counted once
+        if (m_shufflePending.exchange(false, std::memory_order_relaxed)) {
+            m_eventEmitter->notifyShuffle();
+        }
+        for (const auto& event : m_eventEmitter->update(*m_tracker, batch.timestamp_ns)) {
+            if (!m_countingQueue.push(event, m_running)) return;
+        }
+
+        m_framesProcessed.fetch_add(1, std::memory_order_relaxed);
+        const uint64_t end = nowNs();
+        recordStage(Stage::Postprocess, start, end, batch.frame_id);
+        m_metrics.record(Stage::EndToEnd, end - batch.timestamp_ns);
+        if (m_governor && batch.source == BatchSource::Ticket) {
+            float confidence = 0.0f;
+            for (const auto& det : m_trackerInput) confidence += det.confidence;
+            const auto count = static_cast<uint32_t>(m_trackerInput.size());
+            m_governor->report(end - batch.timestamp_ns, count ? confidence / count : 0.0f, count);
+        }
+        m_trace.endFrame(batch.frame_id);
+    }
+}
+
+// Cards the tracker currently sees, for the cascade to skip re-classifying.
+// Only tracks matched this frame: a coasting track's box may no longer be
+// over the same card.
+void PipelineManager::publishIdentities() {
+    IdentitySnapshot snapshot;
+    snapshot.count = 0;
+    for (const auto& track : m_tracker->getTrackedCards()) {
+        if (track.age > 0 || snapshot.count == snapshot.cards.size()) continue;
+        snapshot.cards[snapshot.count++] = track.detection;
+    }
+    m_identityQueue.push(snapshot);
+}
+
+// Every live track, coasting ones included, for tiled mode to crop around
+void PipelineManager::publishTrackRegions() {
+    IdentitySnapshot snapshot;
+    snapshot.count = 0;
+    for (const auto& track : m_tracker->getTrackedCards()) {
+        if (snapshot.count == snapshot.cards.size()) break;
+        snapshot.cards[snapshot.count++] = track.detection;
+    }
+    m_identityQueue.push(snapshot);
+}
+
+// Every live track for the overlay to box; latest wins, the UI thread skips ahead
+void PipelineManager::publishOverlay() {
+    ui::OverlayTrackBatch batch;
+    batch.count = 0;
+    for (const auto& track : m_tracker->getTrackedCards()) {
+        if (batch.count == core::constants::MAX_TRACKS) break;
+        const auto& det = track.detection;
+        batch.tracks[batch.count++] = {det.x, det.y, det.width, det.height, det.confidence,
+                                       det.card_id, static_cast<uint8_t>(track.age > 0)};
+    }
+    m_overlayQueue.push(batch);
+}
+
+void PipelineManager::countingThreadFunc() {
+    ConfigPtr config = m_config->getSnapshot();
+    core::CardEvent event;
+    TableCards table;
+    const float midlineY = 0.5f * static_cast<float>(m_capture->getHeight());
+
+    while (m_countingQueue.pop(event, m_running)) {
+        NVTX_RANGE(utils::TraceCategory::Counting, "card event");
+        const uint64_t start = nowNs();
+        // A count kept under another system or shoe size is meaningless: start over
+        if (const ConfigPtr previous = refreshConfig(config);
+            previous && (previous->counting.deck_count != config->counting.deck_count ||
+                         previous->counting.system != config->counting.system)) {
+            m_counter->initialize(config->counting.deck_count, config->counting.system);
+            utils::Logger::getInstance().info("Counting settings changed, count reset");
+        }
+        m_counter->processEvent(event);
+        // A removal leaves the count as is but changes the hand on the table
+        switch (event.type) {
+            case core::CardEventType::CardDealt: table.add(event); break;
+            case core::CardEventType::CardRemoved: table.remove(event.track_id); break;
+            case core::CardEventType::ShoeShuffled: table.clear(); break;
+        }
+
+        CountUpdate update;
+        update.running_count = m_counter->getRunningCount();
+        update.true_count = m_counter->getTrueCount();
+        update.penetration = m_counter->getPenetration();
+        update.cards_remaining = m_counter->getCardsRemaining();
+        update.remaining_ranks = m_counter->getRemainingRanks();
+        update.hand = table.hand(midlineY);
+        update.timestamp_ns = event.timestamp_ns;
+        m_strategyQueue.push(update);
+        recordStage(Stage::Counting, start, nowNs());
+    }
+}
+
+void PipelineManager::strategyThreadFunc() {
+    ConfigPtr config = m_config->getSnapshot();
+    CountUpdate update;
+
+    while (m_strategyQueue.pop(update, m_running)) {
+        NVTX_RANGE(utils::TraceCategory::Strategy, "strategy");
+        const uint64_t start = nowNs();
+        if (const ConfigPtr previous = refreshConfig(config)) {
+            const auto& betting = config->betting;
+            m_betting->configure(betting.min_bet, betting.max_bet, betting.kelly_fraction);
+            m_betting->setSpread(betting.spread);
+            if (previous->strategy.basic_strategy_rules != config->strategy.basic_strategy_rules) {
+                m_evEngine->configure(config->strategy.basic_strategy_rules);
+            }
+        }
+        StrategyUpdate strategy;
+        strategy.count = update;
+        strategy.recommended_bet = m_betting->calculateBet(update.true_count, m_betting->getBankroll());
+
+        // The player's decision once their cards and the upcard are down;
+        // the counted cards are already out of remaining_ranks
+        const TableHand& hand = update.hand;
+        strategy.has_decision = hand.has_upcard && hand.player_count >= 2 &&
+            m_evEngine->evaluate(update.remaining_ranks,
+                                 std::span(hand.player.data(), hand.player_count),
+                                 hand.dealer_upcard, strategy.ev);
+        strategy.best_action = strategy.has_decision ? strategy.ev.best() : intelligence::Action::Stand;
+        m_uiQueue.push(strategy);
+
+        // Dealer tables for the new shoe, ready before the next decision
+        m_evEngine->prime(update.remaining_ranks);
+        recordStage(Stage::Strategy, start, nowNs());
+    }
+}
+
+void PipelineManager::uiThreadFunc() {
+    auto& logger = utils::Logger::getInstance();
+
+    if (!m_overlay->initialize()) {
+        logger.error("Failed to initialize overlay");
+        return;
+    }
+    m_overlay->setFrameSize(m_capture->getWidth(), m_capture->getHeight());
+
+    ConfigPtr config = m_config->getSnapshot();
+    m_overlay->setTransparency(config->ui.transparency);
+
+    MetricsSnapshot snapshot;
+    ui::OverlayTrackBatch tracks;
+    uint32_t lastFrames = m_framesProcessed.load(std::memory_order_relaxed);
+    auto lastSample = std::chrono::steady_clock::now();
+    auto nextFrame = lastSample;
+
+    // Renders at a fixed rate and drains whatever updates arrived in between
+    while (m_running.load(std::memory_order_relaxed)) {
+        const uint64_t start = nowNs();
+        if (refreshConfig(config)) {
+            m_overlay->setTransparency(config->ui.transparency);
+        }
+        StrategyUpdate update;
+        bool hasUpdate = false;
+        while (m_uiQueue.tryPop(update)) {
+            hasUpdate = true;
+        }
+
+        if (hasUpdate) {
+            m_overlay->updateCount(update.count.running_count, update.count.true_count);
+            m_overlay->updateBet(update.recommended_bet);
+            if (update.has_decision) {
+                char action[32];
+                std::snprintf(action, sizeof(action), "%s EV %+.3f",
+                              actionName(update.best_action), update.ev.bestValue());
+                m_overlay->updateAction(action);
+            } else {
+                m_overlay->updateAction("");
+            }
+        }
+
+        bool freshTracks = false;
+        while (m_overlayQueue.tryPop(tracks)) {
+            freshTracks = true;
+        }
+        if (freshTracks) {
+            m_overlay->updateTracks(tracks);
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const float elapsed = std::chrono::duration<float>(now - lastSample).count();
+        if (elapsed >= 1.0f) {
+            const uint32_t frames = m_framesProcessed.load(std::memory_order_relaxed);
+            m_fps.store((frames - lastFrames) / elapsed, std::memory_order_relaxed);
+            lastFrames = frames;
+            lastSample = now;
+
+            m_metrics.snapshot(snapshot);
+            const auto& endToEnd = snapshot.stages[static_cast<size_t>(Stage::EndToEnd)];
+            uint64_t violations = 0;
+            for (const auto& stage : snapshot.stages) {
+                violations += stage.budget_violations;
+            }
+            m_overlay->updateLatencyTail(endToEnd.latency.p99_ns / 1e6f, violations);
+            // Once a second: readouts that change every frame would redraw every frame
+            m_overlay->updateMetrics(m_fps.load(std::memory_order_relaxed), getAverageLatency());
+        }
+
+        // Draws only if one of the updates above changed what is shown
+        {
+            NVTX_RANGE(utils::TraceCategory::UI, "render");
+            m_overlay->render();
+        }
+        recordStage(Stage::UI, start, nowNs());
+
+        nextFrame += UI_FRAME_INTERVAL;
+        std::this_thread::sleep_until(nextFrame);
+    }
+
+    m_overlay->shutdown();
+}
+
+// Stage body on a thread placed by the scheduler
+void PipelineManager::runStage(ThreadRole role, void (PipelineManager::*body)()) {
+    // The current device is per thread; the overlay's GL interop needs it too
+    cudaSetDevice(m_config->getSystemConfig().gpu_device_id);
+    m_scheduler.enter(role);
+    (this->*body)();
+    m_scheduler.leave();
+}
+
+// Stage latency into the histograms, and into the trace while one is armed
+void PipelineManager::recordStage(Stage stage, uint64_t startNs, uint64_t endNs, uint32_t frameId) {
+    m_metrics.record(stage, endNs - startNs);
+    m_trace.record(stageName(stage), stageCategory(stage), startNs, endNs, frameId);
+}
+
+// Appends one JSON snapshot per second; off the stage threads entirely
+void PipelineManager::metricsThreadFunc() {
+    const std::string& path = m_config->getSystemConfig().metrics_export_path;
+    std::ofstream file(path, std::ios::app);
+    if (!file) {
+        utils::Logger::getInstance().error("Failed to open metrics export file: {}", path);
+        return;
+    }
+
+    MetricsSnapshot snapshot;
+    auto next = std::chrono::steady_clock::now();
+    while (m_running.load(std::memory_order_relaxed)) {
+        next += std::chrono::seconds(1);
+        std::this_thread::sleep_until(next);
+
+        m_metrics.snapshot(snapshot);
+        file << PipelineMetrics::toJson(snapshot) << '\n';
+        file.flush();
+    }
+}
+
+void PipelineManager::releaseReadFrame(capture::Frame* frame, cudaStream_t stream) {
+    m_frameBuffer->releaseReadBuffer(frame, stream);
+    m_frameReleasedSignal.notify();
+}
+
+capture::Frame* PipelineManager::waitForFrame() {
+    while (m_running.load(std::memory_order_relaxed)) {
+        if (capture::Frame* frame = m_frameBuffer->acquireReadBuffer()) {
+            return frame;
+        }
+        m_frameSignal.wait([this] { return m_frameBuffer->getAvailableFrames() > 0; }, m_running);
+    }
+    return nullptr;
+}
+
+} // namespace pipeline
@@ -1,26 +1,75 @@
 #pragma once
 
+#include "stage_channel.hpp"
+#include "stage_messages.hpp"
+#include "pipeline_metrics.hpp"
+#include "resolution_governor.hpp"
+#include "thread_scheduler.hpp"
+#include "../utils/trace_recorder.hpp"
+#include "../core/config_manager.hpp"
+#include "../capture/capture_interface.hpp"
+#include "../capture/frame_buffer.hpp"
+#include "../capture/frame_recorder.hpp"
+#include "../capture/roi_detector.hpp"
+#include "../vision/preprocessing/preprocessor.hpp"
+#include "../vision/preprocessing/motion_gate.hpp"
+#include "../vision/inference/tensorrt_engine.hpp"
+#include "../vision/inference/engine_cache.hpp"
+#include "../vision/inference/tiled_inference.hpp"
+#include "../vision/inference/cascade_detector.hpp"
+#include "../vision/postprocessing/card_tracker.hpp"
+#include "../vision/postprocessing/card_event_emitter.hpp"
+#include "../intelligence/counting/card_counter.hpp"
+#include "../intelligence/strategy/betting_strategy.hpp"
+#include "../intelligence/strategy/ev_engine.hpp"
+#include "../ui/overlay/overlay_renderer.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
+#include <vector>
 
 namespace pipeline {
 
+// One thread per stage, linked by a device frame ring and lock-free channels:
+// capture -> preprocess -> inference -> postprocess -> counting -> strategy -> UI
 class PipelineManager {
 public:
     PipelineManager();
     ~PipelineManager();
 
-    bool initialize();
+    bool initialize(const core::ConfigManager& config);
     bool start();
     bool stop();
-    
-    bool isRunning() const { return m_running; }
-    
+
+    bool isRunning() const { return m_running.load(std::memory_order_relaxed); }
+
+    // A finite capture source (replay) has delivered its last frame
+    bool isSourceExhausted() const { return m_capture && m_capture->isExhausted(); }
+
     // Get performance metrics
     float getAverageLatency() const;
     uint32_t getFramesProcessed() const;
     uint32_t getFramesDropped() const;
+    float getInferenceSkipRate() const;  // Frames the motion gate answered with reused detections
+
+    // Per-stage latency histograms and budget violations; never blocks the stages
+    void getMetrics(MetricsSnapshot& out) const { m_metrics.snapshot(out); }
+
+    // Chrome trace of the next frames' stage timings, written in the background
+    bool startTrace(uint32_t frames, const std::string& outputPath) { return m_trace.arm(frames, outputPath); }
+
+    // New shoe: the count resets once the event reaches the counting thread
+    void notifyShuffle() { m_shufflePending.store(true, std::memory_order_relaxed); }
 
 private:
+    using FrameRing = capture::FrameBuffer<core::constants::MAX_CAPTURE_BUFFERS>;
+    using ConfigPtr = std::shared_ptr<const core::ConfigSnapshot>;
+
+    static constexpr size_t UPDATE_QUEUE_SIZE = 8;
+    static constexpr auto UI_FRAME_INTERVAL = std::chrono::microseconds(8333);  // 120 Hz
+
     void captureThreadFunc();
     void preprocessThreadFunc();
     void inferenceThreadFunc();
@@ -28,8 +77,89 @@ private:
     void countingThreadFunc();
     void strategyThreadFunc();
     void uiThreadFunc();
-    
-    bool m_running{false};
+    void metricsThreadFunc();
+    void runStage(ThreadRole role, void (PipelineManager::*body)());
+    void recordStage(Stage stage, uint64_t startNs, uint64_t endNs,
+                     uint32_t frameId = utils::TraceRecorder::NO_FRAME);
+
+    capture::Frame* waitForFrame();
+    void releaseReadFrame(capture::Frame* frame, cudaStream_t stream);  // Wakes a parked capture thread
+    ConfigPtr refreshConfig(ConfigPtr& config) const;
+    void applyPreprocessConfig(const core::ConfigSnapshot& previous, const ConfigPtr& config);
+    void pollRebuild();
+    void swapEngine();
+    const capture::ROI* refreshTableROI(const capture::Frame& frame, cudaStream_t stream);
+    void selectResolution(const capture::Frame& frame, const capture::ROI* roi);
+    void adoptEngineProfiles();
+    void submitFused(capture::Frame* frame, uint32_t slot, const capture::ROI* roi,
+                     const core::VisionConfig& vision);
+    void pushDetections(DetectionBatch& batch, const capture::Frame& frame);
+    void publishIdentities();
+    void publishTrackRegions();
+    void publishOverlay();
+
+    const core::ConfigManager* m_config{nullptr};
+
+    // Stage components
+    std::unique_ptr<capture::CaptureInterface> m_capture;
+    std::unique_ptr<capture::FrameRecorder> m_recorder;  // Tees captured frames to capture.record_path
+    std::unique_ptr<capture::ROIDetector> m_roiDetector;
+    std::unique_ptr<vision::Preprocessor> m_preprocessor;
+    std::unique_ptr<vision::MotionGate> m_motionGate;
+    std::unique_ptr<vision::EngineCache> m_engineCache;
+    std::unique_ptr<vision::EngineCache> m_pendingCache;  // Rebuild for a reloaded vision config
+    ConfigPtr m_deferredRebuild;                          // Reload that arrived while a build was running
+    // Owned by the preprocess thread, which alone swaps it. The other stages
+    // load m_publishedEngine per message, the same way they pick up config.
+    std::shared_ptr<vision::TensorRTEngine> m_engine;
+    std::shared_ptr<vision::TensorRTEngine> m_retiredEngine;  // Previous engine after a hot-swap
+    std::atomic<std::shared_ptr<vision::TensorRTEngine>> m_publishedEngine;
+    std::unique_ptr<ResolutionGovernor> m_governor;  // With vision.resolution_profiles
+    std::vector<uint32_t> m_profileSizes;            // Longest side per engine profile (preprocess thread)
+    std::unique_ptr<vision::TiledInference> m_tiledInference;
+    std::unique_ptr<vision::CascadeDetector> m_cascade;
+    std::unique_ptr<vision::CardTracker> m_tracker;
+    std::unique_ptr<vision::CardEventEmitter> m_eventEmitter;
+    std::unique_ptr<intelligence::CardCounter> m_counter;
+    std::unique_ptr<intelligence::BettingStrategy> m_betting;
+    std::unique_ptr<intelligence::EvEngine> m_evEngine;
+    std::unique_ptr<ui::OverlayRenderer> m_overlay;
+
+    // Capture -> GPU stages: device frame slots fenced by CUDA events
+    std::unique_ptr<FrameRing> m_frameBuffer;
+    StageSignal m_frameSignal;
+    StageSignal m_frameReleasedSignal;  // Capture parks here while every slot is being read
+
+    // Stage links. Jobs and detection batches hold engine slots and are
+    // bounded by them, so they never overflow; updates are latest-wins; card
+    // events are lossless because a dropped event corrupts the count.
+    StageChannel<InferenceJob, core::constants::INFERENCE_QUEUE_SIZE> m_inferenceQueue{OverflowPolicy::Reject};
+    StageChannel<DetectionBatch, core::constants::INFERENCE_QUEUE_SIZE> m_detectionQueue{OverflowPolicy::Reject};
+    LosslessChannel<core::CardEvent, core::constants::COUNTING_QUEUE_SIZE> m_countingQueue;
+    StageChannel<IdentitySnapshot, 2> m_identityQueue{OverflowPolicy::DropOldest};
+    StageChannel<ui::OverlayTrackBatch, 2> m_overlayQueue{OverflowPolicy::DropOldest};
+    StageChannel<CountUpdate, UPDATE_QUEUE_SIZE> m_strategyQueue;
+    StageChannel<StrategyUpdate, UPDATE_QUEUE_SIZE> m_uiQueue;
+
+    // Engine in-flight slots: preprocess parks here until postprocess frees one
+    StageSignal m_inputSlotSignal;
+    cudaStream_t m_preprocessStream{nullptr};
+    bool m_fusedSubmission{false};  // Preprocess thread submits whole-frame graphs, no inference thread
+    std::array<cudaEvent_t, core::constants::MAX_INFERENCE_SLOTS> m_inputReadyEvents{};
+
+    std::vector<std::thread> m_threads;
+    ThreadScheduler m_scheduler;  // Cores and priorities for m_threads
+    std::vector<core::Detection> m_tileDetections;  // Inference (or fused preprocess) thread scratch
+    std::vector<core::Detection> m_trackerInput;    // Postprocess thread scratch
+    std::atomic<bool> m_shufflePending{false};
+
+    // Metrics
+    std::atomic<uint32_t> m_framesProcessed{0};
+    PipelineMetrics m_metrics;
+    utils::TraceRecorder m_trace;
+    std::atomic<float> m_fps{0.0f};
+
+    std::atomic<bool> m_running{false};
     bool m_initialized{false};
 };
 
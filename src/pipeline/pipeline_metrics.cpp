@@ -0,0 +1,78 @@
+#include "pipeline_metrics.hpp"
+#include "../core/constants.hpp"
+#include <chrono>
+#include <cstdio>
+
+namespace pipeline {
+
+namespace {
+
+constexpr std::array<uint64_t, STAGE_COUNT> STAGE_BUDGETS = {
+    core::constants::CAPTURE_LATENCY_NS,
+    core::constants::PREPROCESSING_LATENCY_NS,
+    core::constants::INFERENCE_LATENCY_NS,
+    core::constants::POSTPROCESSING_LATENCY_NS,
+    core::constants::COUNTING_LATENCY_NS,
+    core::constants::STRATEGY_LATENCY_NS,
+    core::constants::UI_UPDATE_LATENCY_NS,
+    core::constants::TOTAL_LATENCY_NS
+};
+
+} // namespace
+
+const char* stageName(Stage stage) {
+    switch (stage) {
+        case Stage::Capture: return "capture";
+        case Stage::Preprocess: return "preprocess";
+        case Stage::Inference: return "inference";
+        case Stage::Postprocess: return "postprocess";
+        case Stage::Counting: return "counting";
+        case Stage::Strategy: return "strategy";
+        case Stage::UI: return "ui";
+        case Stage::EndToEnd: return "end_to_end";
+        case Stage::Count: break;
+    }
+    return "unknown";
+}
+
+PipelineMetrics::PipelineMetrics() {
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        m_stages[i].budget = STAGE_BUDGETS[i];
+    }
+}
+
+void PipelineMetrics::snapshot(MetricsSnapshot& out) const {
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        out.stages[i].latency = m_stages[i].histogram.summarize();
+        out.stages[i].budget_ns = m_stages[i].budget;
+        out.stages[i].budget_violations = m_stages[i].violations.load(std::memory_order_relaxed);
+    }
+    out.timestamp_ns = static_cast<uint64_t>(std::chrono::high_resolution_clock::now()
+                                             .time_since_epoch().count());
+}
+
+std::string PipelineMetrics::toJson(const MetricsSnapshot& snapshot) {
+    std::string json = "{\"timestamp_ns\":" + std::to_string(snapshot.timestamp_ns) + ",\"stages\":{";
+
+    char entry[320];
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        const auto& stage = snapshot.stages[i];
+        std::snprintf(entry, sizeof(entry),
+                      "%s\"%s\":{\"count\":%llu,\"mean_ns\":%.0f,\"p50_ns\":%llu,\"p90_ns\":%llu,"
+                      "\"p99_ns\":%llu,\"p999_ns\":%llu,\"max_ns\":%llu,\"budget_ns\":%llu,\"violations\":%llu}",
+                      i > 0 ? "," : "", stageName(static_cast<Stage>(i)),
+                      static_cast<unsigned long long>(stage.latency.count), stage.latency.mean_ns,
+                      static_cast<unsigned long long>(stage.latency.p50_ns),
+                      static_cast<unsigned long long>(stage.latency.p90_ns),
+                      static_cast<unsigned long long>(stage.latency.p99_ns),
+                      static_cast<unsigned long long>(stage.latency.p999_ns),
+                      static_cast<unsigned long long>(stage.latency.max_ns),
+                      static_cast<unsigned long long>(stage.budget_ns),
+                      static_cast<unsigned long long>(stage.budget_violations));
+        json += entry;
+    }
+    json += "}}";
+    return json;
+}
+
+} // namespace pipeline
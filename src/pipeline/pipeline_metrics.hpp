@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../utils/latency_histogram.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace pipeline {
+
+enum class Stage : uint32_t {
+    Capture,      // Backend frame timestamp -> slot published
+    Preprocess,   // Frame taken -> job submitted
+    Inference,    // GPU execution (engine events), or host time in tiled/cascade mode
+    Postprocess,  // Batch taken -> card events queued
+    Counting,     // Per card event
+    Strategy,     // Per count update
+    UI,           // Per rendered overlay frame
+    EndToEnd,     // Capture timestamp -> card events queued
+    Count
+};
+
+constexpr size_t STAGE_COUNT = static_cast<size_t>(Stage::Count);
+
+const char* stageName(Stage stage);
+
+struct StageSnapshot {
+    utils::HistogramSummary latency;
+    uint64_t budget_ns;
+    uint64_t budget_violations;
+};
+
+struct MetricsSnapshot {
+    std::array<StageSnapshot, STAGE_COUNT> stages;
+    uint64_t timestamp_ns;
+};
+
+// Latency histograms and budget-violation counters per stage. Every stage is
+// recorded from exactly one thread, which keeps recording store-only; any
+// thread can take a snapshot without blocking the writers.
+class PipelineMetrics {
+public:
+    PipelineMetrics();
+
+    void record(Stage stage, uint64_t latencyNs) {
+        auto& metrics = m_stages[static_cast<size_t>(stage)];
+        metrics.histogram.record(latencyNs);
+        if (latencyNs > metrics.budget) {
+            metrics.violations.store(metrics.violations.load(std::memory_order_relaxed) + 1,
+                                     std::memory_order_relaxed);
+        }
+    }
+
+    void snapshot(MetricsSnapshot& out) const;
+    double getMeanLatency(Stage stage) const {
+        return m_stages[static_cast<size_t>(stage)].histogram.getMean();
+    }
+
+    // One JSON object per snapshot, for the exporter's line-delimited log
+    static std::string toJson(const MetricsSnapshot& snapshot);
+
+private:
+    struct StageMetrics {
+        utils::LatencyHistogram histogram;
+        uint64_t budget{0};
+        std::atomic<uint64_t> violations{0};
+    };
+
+    std::array<StageMetrics, STAGE_COUNT> m_stages;
+};
+
+} // namespace pipeline
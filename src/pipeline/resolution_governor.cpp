@@ -0,0 +1,86 @@
+#include "resolution_governor.hpp"
+#include "../utils/logger.hpp"
+#include <algorithm>
+
+namespace pipeline {
+
+namespace {
+
+constexpr float LATENCY_SMOOTHING = 0.1f;     // EWMA weight of the newest frame
+constexpr float CONFIDENCE_SMOOTHING = 0.05f;
+constexpr float BEHIND_FRACTION = 0.95f;      // Over this share of the budget: step down
+constexpr float SLACK_FRACTION = 0.70f;       // Under it: room to step up
+constexpr float HARD_CONFIDENCE_MARGIN = 0.1f;
+constexpr uint32_t HOLD_FRAMES = 30;          // Frames between switches (~0.25 s at 120 fps)
+
+} // namespace
+
+ResolutionGovernor::ResolutionGovernor(uint64_t budgetNs, float confidenceThreshold)
+    : m_budgetNs(budgetNs)
+    , m_hardConfidence(confidenceThreshold + HARD_CONFIDENCE_MARGIN) {
+}
+
+void ResolutionGovernor::reset(uint32_t profile) {
+    m_profile = profile;
+    m_holdFrames = HOLD_FRAMES;
+}
+
+void ResolutionGovernor::report(uint64_t latencyNs, float meanConfidence, uint32_t detectionCount) {
+    const uint64_t previous = m_latencyNs.load(std::memory_order_relaxed);
+    const uint64_t smoothed = previous == 0
+        ? latencyNs
+        : static_cast<uint64_t>(previous + LATENCY_SMOOTHING * (static_cast<double>(latencyNs) - previous));
+    m_latencyNs.store(smoothed, std::memory_order_relaxed);
+
+    if (detectionCount > 0) {
+        const float confidence = m_confidence.load(std::memory_order_relaxed);
+        m_confidence.store(confidence + CONFIDENCE_SMOOTHING * (meanConfidence - confidence),
+                           std::memory_order_relaxed);
+    }
+}
+
+uint32_t ResolutionGovernor::select(std::span<const uint32_t> profileSizes, uint32_t roiSize) {
+    if (profileSizes.empty()) return 0;
+    m_profile = std::min(m_profile, static_cast<uint32_t>(profileSizes.size()) - 1);
+
+    if (m_holdFrames > 0) {
+        m_holdFrames--;
+        return m_profile;
+    }
+
+    const uint64_t latency = m_latencyNs.load(std::memory_order_relaxed);
+    if (latency == 0) return m_profile;  // Nothing measured yet
+
+    const bool behind = latency > BEHIND_FRACTION * m_budgetNs;
+    const bool slack = latency < SLACK_FRACTION * m_budgetNs;
+    const bool hard = m_confidence.load(std::memory_order_relaxed) < m_hardConfidence;
+
+    // Above the ROI's own size the letterbox only upsamples; a hard scene
+    // may still go there for the small-object gain
+    const uint32_t top = static_cast<uint32_t>(profileSizes.size()) - 1;
+    uint32_t ceiling = top;
+    if (roiSize > 0 && !hard) {
+        const auto fit = std::lower_bound(profileSizes.begin(), profileSizes.end(), roiSize);
+        ceiling = fit == profileSizes.end()
+            ? top : static_cast<uint32_t>(fit - profileSizes.begin());
+    }
+
+    uint32_t next = m_profile;
+    if (behind || m_profile > ceiling) {
+        next = m_profile > 0 ? m_profile - 1 : 0;
+    } else if (slack && m_profile < ceiling) {
+        next = m_profile + 1;
+    }
+
+    if (next != m_profile) {
+        utils::Logger::getInstance().info(
+            "Input resolution {} -> {} (latency {:.1f} ms, confidence {:.2f})",
+            profileSizes[m_profile], profileSizes[next], latency / 1e6,
+            m_confidence.load(std::memory_order_relaxed));
+        m_profile = next;
+        m_holdFrames = HOLD_FRAMES;
+    }
+    return m_profile;
+}
+
+} // namespace pipeline
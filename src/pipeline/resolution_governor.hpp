@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <span>
+
+namespace pipeline {
+
+// Picks the engine input resolution per frame from the latency slack and
+// scene difficulty. Steps down one profile when the frames run over budget;
+// steps up when there is slack and either confidence dropped or the table
+// ROI is larger than the current input. Each switch is followed by a hold
+// window, so the engine does not flap between two profiles.
+//
+// report() is called by the postprocess thread, select() and reset() by
+// the preprocess thread; they share only two atomics.
+class ResolutionGovernor {
+public:
+    ResolutionGovernor(uint64_t budgetNs, float confidenceThreshold);
+
+    // New engine: continue from its initial profile
+    void reset(uint32_t profile);
+
+    // One inferred frame: capture-to-detections latency and the mean
+    // confidence of its detections (ignored when there are none)
+    void report(uint64_t latencyNs, float meanConfidence, uint32_t detectionCount);
+
+    // Profile for the next frame. profileSizes holds the longest input side
+    // of each engine profile, ascending; roiSize is the longest side of the
+    // region that will be letterboxed into the input.
+    uint32_t select(std::span<const uint32_t> profileSizes, uint32_t roiSize);
+
+private:
+    uint32_t m_profile{0};
+    uint32_t m_holdFrames{0};
+    uint64_t m_budgetNs;
+    float m_hardConfidence;  // Mean confidence below this marks a hard scene
+
+    // Smoothed by the reporting thread, read by the selecting one
+    std::atomic<uint64_t> m_latencyNs{0};
+    std::atomic<float> m_confidence{1.0f};
+};
+
+} // namespace pipeline
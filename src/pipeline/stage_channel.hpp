@@ -0,0 +1,154 @@
+#pragma once
+
+#include "lockfree_queue.hpp"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace pipeline {
+
+inline void cpuRelax() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * Spin-then-park wakeup for a stage thread.
+ * The consumer spins briefly, then yields, then parks on an epoch counter.
+ * Producers only pay for a futex wake when the consumer is actually parked.
+ */
+class StageSignal {
+public:
+    template<typename Ready>
+    void wait(Ready&& ready, const std::atomic<bool>& running) {
+        for (uint32_t i = 0; i < SPIN_ITERATIONS; i++) {
+            if (ready() || !running.load(std::memory_order_relaxed)) return;
+            cpuRelax();
+        }
+
+        for (uint32_t i = 0; i < YIELD_ITERATIONS; i++) {
+            if (ready() || !running.load(std::memory_order_relaxed)) return;
+            std::this_thread::yield();
+        }
+
+        const uint32_t epoch = m_epoch.load(std::memory_order_acquire);
+        m_parked.store(true, std::memory_order_seq_cst);
+        if (!ready() && running.load(std::memory_order_acquire)) {
+            m_epoch.wait(epoch, std::memory_order_acquire);
+        }
+        m_parked.store(false, std::memory_order_relaxed);
+    }
+
+    void notify() {
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (m_parked.load(std::memory_order_seq_cst)) {
+            m_epoch.notify_one();
+        }
+    }
+
+    // Shutdown: wake unconditionally
+    void notifyAll() {
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        m_epoch.notify_all();
+    }
+
+private:
+    static constexpr uint32_t SPIN_ITERATIONS = 2048;
+    static constexpr uint32_t YIELD_ITERATIONS = 64;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> m_epoch{0};
+    std::atomic<bool> m_parked{false};
+};
+
+/**
+ * Lossy stage link: MPMC ring with a configurable overflow policy.
+ * Used where only the freshest data matters (frames, detections, counts).
+ */
+template<typename T, size_t Capacity>
+class StageChannel {
+public:
+    explicit StageChannel(OverflowPolicy policy = OverflowPolicy::DropOldest)
+        : m_policy(policy) {}
+
+    void setPolicy(OverflowPolicy policy) { m_policy = policy; }
+
+    PushResult push(const T& item) {
+        const PushResult result = m_queue.push(item, m_policy);
+        if (result != PushResult::Rejected) {
+            m_signal.notify();
+        }
+        return result;
+    }
+
+    // Blocks (spin-then-park) until an item arrives or `running` clears
+    bool pop(T& item, const std::atomic<bool>& running) {
+        while (running.load(std::memory_order_relaxed)) {
+            if (m_queue.tryPop(item)) return true;
+            m_signal.wait([this] { return !m_queue.empty(); }, running);
+        }
+        return false;
+    }
+
+    bool tryPop(T& item) { return m_queue.tryPop(item); }
+    void wakeAll() { m_signal.notifyAll(); }
+
+    uint64_t getDropped() const { return m_queue.getDropped() + m_queue.getRejected(); }
+
+private:
+    MPMCQueue<T, Capacity> m_queue;
+    StageSignal m_signal;
+    OverflowPolicy m_policy;
+};
+
+/**
+ * Lossless stage link: SPSC ring, the producer waits when it is full.
+ * Used for counting events, where dropping an item breaks the count.
+ */
+template<typename T, size_t Capacity>
+class LosslessChannel {
+public:
+    bool push(const T& item, const std::atomic<bool>& running) {
+        while (!m_queue.tryPush(item)) {
+            if (!running.load(std::memory_order_relaxed)) return false;
+            m_stalls.fetch_add(1, std::memory_order_relaxed);
+            m_spaceSignal.wait([this] { return m_queue.size() < Capacity; }, running);
+        }
+        m_dataSignal.notify();
+        return true;
+    }
+
+    bool pop(T& item, const std::atomic<bool>& running) {
+        while (running.load(std::memory_order_relaxed)) {
+            if (m_queue.tryPop(item)) {
+                m_spaceSignal.notify();
+                return true;
+            }
+            m_dataSignal.wait([this] { return !m_queue.empty(); }, running);
+        }
+        return false;
+    }
+
+    void wakeAll() {
+        m_dataSignal.notifyAll();
+        m_spaceSignal.notifyAll();
+    }
+
+    uint64_t getStalls() const { return m_stalls.load(std::memory_order_relaxed); }
+
+private:
+    SPSCQueue<T, Capacity> m_queue;
+    StageSignal m_dataSignal;
+    StageSignal m_spaceSignal;
+    std::atomic<uint64_t> m_stalls{0};
+};
+
+} // namespace pipeline
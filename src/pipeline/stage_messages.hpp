@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../core/types.hpp"
+#include "../core/constants.hpp"
+#include "../capture/capture_interface.hpp"
+#include "../vision/preprocessing/fused_preprocess.hpp"
+#include "../vision/inference/tensorrt_engine.hpp"
+#include "../intelligence/counting/card_counter.hpp"
+#include "../intelligence/strategy/ev_engine.hpp"
+#include <array>
+#include <cstdint>
+
+namespace pipeline {
+
+// Payloads passed between stage threads. All are trivially copyable and
+// fixed-size so queue slots never allocate.
+
+// Preprocess -> inference: the engine input buffer holds this frame,
+// unless the motion gate decided to reuse the previous detections
+struct InferenceJob {
+    capture::Frame frame;
+    vision::cuda::LetterboxTransform transform;
+    cudaEvent_t input_ready;  // Recorded after the engine input was written
+    uint32_t slot;            // Engine in-flight slot holding the input
+    bool reuse;               // Static scene: no input, nothing to submit
+};
+
+// Where a DetectionBatch's detections come from
+enum class BatchSource : uint8_t {
+    Detections,  // Inline in the batch
+    Ticket,      // Still executing on the GPU, redeem the ticket
+    Reuse        // Static scene, repeat the previous frame's detections
+};
+
+// Inference -> postprocess
+struct DetectionBatch {
+    uint32_t frame_id;
+    uint64_t timestamp_ns;  // Capture time of the source frame
+    BatchSource source;
+    vision::InferenceTicket ticket;
+    uint32_t count;
+    std::array<core::Detection, core::constants::MAX_DETECTIONS_PER_FRAME> detections;
+};
+
+// Postprocess -> crop inference: tracked cards to look at next frame. The
+// cascade gets the ones whose identity is settled, tiled mode every live track
+struct IdentitySnapshot {
+    uint32_t count;
+    std::array<core::Detection, core::constants::MAX_DETECTIONS_PER_FRAME> cards;
+};
+
+constexpr uint32_t MAX_HAND_CARDS = 11;  // Most cards a hand holds without busting
+
+// The round on the table: confirmed cards still down, in the order they were
+// dealt. Cards above the frame's midline are the dealer's, the rest the player's.
+struct TableHand {
+    uint32_t player_count;
+    std::array<core::CardRank, MAX_HAND_CARDS> player;
+    core::CardRank dealer_upcard;
+    bool has_upcard;
+};
+
+// Counting -> strategy
+struct CountUpdate {
+    int32_t running_count;
+    float true_count;
+    float penetration;
+    uint32_t cards_remaining;
+    intelligence::RankCounts remaining_ranks;  // Shoe composition for the EV engine
+    TableHand hand;
+    uint64_t timestamp_ns;
+};
+
+// Strategy -> UI
+struct StrategyUpdate {
+    CountUpdate count;
+    double recommended_bet;
+    bool has_decision;                 // Player hand and upcard are down
+    intelligence::Action best_action;  // Highest composition-dependent EV
+    intelligence::ActionEV ev;
+};
+
+} // namespace pipeline
@@ -0,0 +1,310 @@
+#include "thread_scheduler.hpp"
+#include "../core/constants.hpp"
+#include "../utils/logger.hpp"
+#include <algorithm>
+#include <string>
+#include <tuple>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <avrt.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <cstring>
+#endif
+
+namespace pipeline {
+
+namespace {
+
+constexpr ThreadRole LAST_PINNED_ROLE = ThreadRole::Strategy;  // Later roles float over a core set
+
+int rolePriority(ThreadRole role) {
+    switch (role) {
+        case ThreadRole::Capture:     return core::constants::PRIORITY_CAPTURE;
+        case ThreadRole::Preprocess:
+        case ThreadRole::Inference:
+        case ThreadRole::Postprocess: return core::constants::PRIORITY_INFERENCE;
+        case ThreadRole::Counting:    return core::constants::PRIORITY_COUNTING;
+        case ThreadRole::Strategy:    return core::constants::PRIORITY_STRATEGY;
+        case ThreadRole::UI:          return core::constants::PRIORITY_UI;
+        default:                      return 0;
+    }
+}
+
+#ifdef _WIN32
+thread_local HANDLE t_mmcssTask = nullptr;
+
+struct MmcssClass {
+    const wchar_t* task;
+    const char* name;
+    AVRT_PRIORITY priority;
+};
+
+// Pro Audio is the one stock task in the High scheduling category
+MmcssClass mmcssClass(int priority) {
+    if (priority >= core::constants::PRIORITY_CAPTURE) return {L"Pro Audio", "Pro Audio/critical", AVRT_PRIORITY_CRITICAL};
+    if (priority >= core::constants::PRIORITY_INFERENCE) return {L"Pro Audio", "Pro Audio/high", AVRT_PRIORITY_HIGH};
+    if (priority >= core::constants::PRIORITY_STRATEGY) return {L"Games", "Games/high", AVRT_PRIORITY_HIGH};
+    return {L"Games", "Games/normal", AVRT_PRIORITY_NORMAL};
+}
+
+bool pinCurrentThread(const std::vector<uint32_t>& cpus) {
+    KAFFINITY mask = 0;
+    for (const uint32_t cpu : cpus) {
+        if (cpu < 64) mask |= KAFFINITY{1} << cpu;
+    }
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+}
+
+std::vector<uint32_t> currentAffinity() {
+    std::vector<uint32_t> cpus;
+    GROUP_AFFINITY affinity{};
+    if (GetThreadGroupAffinity(GetCurrentThread(), &affinity)) {
+        for (uint32_t cpu = 0; cpu < 64; cpu++) {
+            if (affinity.Mask & (KAFFINITY{1} << cpu)) cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+std::string raiseCurrentThread(int priority) {
+    const MmcssClass mmcss = mmcssClass(priority);
+    DWORD taskIndex = 0;
+    t_mmcssTask = AvSetMmThreadCharacteristicsW(mmcss.task, &taskIndex);
+    if (!t_mmcssTask) {
+        return "normal priority (MMCSS error " + std::to_string(GetLastError()) + ")";
+    }
+    AvSetMmThreadPriority(t_mmcssTask, mmcss.priority);
+    return std::string("MMCSS ") + mmcss.name;
+}
+
+void restoreCurrentThread() {
+    if (t_mmcssTask) {
+        AvRevertMmThreadCharacteristics(t_mmcssTask);
+        t_mmcssTask = nullptr;
+    }
+}
+#else
+bool pinCurrentThread(const std::vector<uint32_t>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const uint32_t cpu : cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return CPU_COUNT(&set) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+std::vector<uint32_t> currentAffinity() {
+    std::vector<uint32_t> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+        for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+std::string raiseCurrentThread(int priority) {
+    sched_param param{};
+    param.sched_priority = std::clamp(priority, sched_get_priority_min(SCHED_FIFO),
+                                      sched_get_priority_max(SCHED_FIFO));
+    if (const int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param); result != 0) {
+        return std::string("normal priority (SCHED_FIFO: ") + std::strerror(result) + ")";
+    }
+
+    // Report what the kernel actually applied
+    int policy = SCHED_OTHER;
+    pthread_getschedparam(pthread_self(), &policy, &param);
+    return policy == SCHED_FIFO ? "SCHED_FIFO " + std::to_string(param.sched_priority)
+                                : std::string("normal priority");
+}
+
+void restoreCurrentThread() {}
+#endif
+
+// "cpu 4 (P-core, L3 0)", "cpus 16-23 (E-cores, L3 1)"
+std::string describePlacement(const utils::CpuTopology& topology, const std::vector<uint32_t>& cpus) {
+    bool anyPerformance = false;
+    bool anyEfficiency = false;
+    uint32_t domain = UINT32_MAX;
+    bool oneDomain = true;
+    for (const uint32_t id : cpus) {
+        const utils::LogicalCpu* cpu = topology.find(id);
+        if (!cpu) continue;
+        anyPerformance |= cpu->coreClass == utils::CoreClass::Performance;
+        anyEfficiency |= cpu->coreClass == utils::CoreClass::Efficiency;
+        oneDomain &= domain == UINT32_MAX || domain == cpu->cacheDomain;
+        domain = cpu->cacheDomain;
+    }
+
+    const bool single = cpus.size() == 1;
+    std::string text = (single ? "cpu " : "cpus ") + utils::formatCpuList(cpus);
+    std::string detail;
+    if (topology.hybrid && anyPerformance != anyEfficiency) {
+        detail = anyPerformance ? (single ? "P-core" : "P-cores") : (single ? "E-core" : "E-cores");
+    }
+    if (oneDomain && domain != UINT32_MAX && topology.cacheDomainCount > 1) {
+        detail += (detail.empty() ? "L3 " : ", L3 ") + std::to_string(domain);
+    }
+    return detail.empty() ? text : text + " (" + detail + ")";
+}
+
+} // anonymous namespace
+
+const char* threadRoleName(ThreadRole role) {
+    switch (role) {
+        case ThreadRole::Preprocess:  return "preprocess";
+        case ThreadRole::Inference:   return "inference";
+        case ThreadRole::Capture:     return "capture";
+        case ThreadRole::Postprocess: return "postprocess";
+        case ThreadRole::Counting:    return "counting";
+        case ThreadRole::Strategy:    return "strategy";
+        case ThreadRole::UI:          return "ui";
+        case ThreadRole::Metrics:     return "metrics";
+        default:                      return "unknown";
+    }
+}
+
+void ThreadScheduler::plan(const core::SystemConfig& config, std::span<const ThreadRole> roles) {
+    auto& logger = utils::Logger::getInstance();
+
+    m_topology = utils::CpuTopology::detect();
+    m_placements = {};
+    logger.info("CPU topology: {}", m_topology.describe());
+
+    std::array<bool, THREAD_ROLE_COUNT> running{};
+    for (const ThreadRole role : roles) {
+        running[static_cast<size_t>(role)] = true;
+        m_placements[static_cast<size_t>(role)].priority = config.real_time_priority ? rolePriority(role) : 0;
+    }
+    if (!config.thread_affinity_enabled) {
+        // Unpinned: no more real-time latency roles than CPUs, later roles yield first
+        size_t realTime = 0;
+        for (size_t role = 0; role <= static_cast<size_t>(LAST_PINNED_ROLE); role++) {
+            auto& placement = m_placements[role];
+            if (running[role] && placement.priority && !m_topology.cpus.empty() &&
+                ++realTime > m_topology.cpus.size()) {
+                placement.priority = 0;
+                logger.warning("Fewer CPUs than real-time stages: {} runs at normal priority",
+                               threadRoleName(static_cast<ThreadRole>(role)));
+            }
+        }
+        return;
+    }
+
+    // cpu_core_affinity restricts the CPUs stage threads may use; empty allows all
+    std::vector<const utils::LogicalCpu*> candidates;
+    if (config.cpu_core_affinity.empty()) {
+        for (const auto& cpu : m_topology.cpus) candidates.push_back(&cpu);
+    }
+    for (const int id : config.cpu_core_affinity) {
+        const utils::LogicalCpu* cpu = id >= 0 ? m_topology.find(static_cast<uint32_t>(id)) : nullptr;
+        if (cpu) {
+            if (std::find(candidates.begin(), candidates.end(), cpu) == candidates.end()) {
+                candidates.push_back(cpu);
+            }
+        } else {
+            logger.warning("cpu_core_affinity: no CPU {}, ignored", id);
+        }
+    }
+    if (candidates.empty()) {
+        logger.warning("No usable CPU for stage threads, leaving them unpinned");
+        return;
+    }
+
+    // The frame path lives in the L3 domain offering the most P-cores
+    std::vector<uint32_t> performanceCores(m_topology.cacheDomainCount);
+    for (const auto* cpu : candidates) {
+        if (cpu->primaryThread && cpu->coreClass == utils::CoreClass::Performance) {
+            performanceCores[cpu->cacheDomain]++;
+        }
+    }
+    const auto home = static_cast<uint32_t>(
+        std::max_element(performanceCores.begin(), performanceCores.end()) - performanceCores.begin());
+
+    // P-cores before E-cores, a core of its own before an SMT sibling, home domain first
+    std::vector<const utils::LogicalCpu*> ranked = candidates;
+    std::sort(ranked.begin(), ranked.end(), [home](const utils::LogicalCpu* a, const utils::LogicalCpu* b) {
+        const auto key = [home](const utils::LogicalCpu& cpu) {
+            return std::tuple(cpu.coreClass, !cpu.primaryThread, cpu.cacheDomain != home, cpu.id);
+        };
+        return key(*a) < key(*b);
+    });
+
+    // One CPU per latency-critical role, in role order. Roles left over join
+    // the background set at normal priority: two real-time threads sharing a
+    // CPU would let the higher one starve the other.
+    std::vector<bool> taken(ranked.size(), false);
+    std::vector<size_t> unplaced;
+    size_t next = 0;
+    for (size_t role = 0; role <= static_cast<size_t>(LAST_PINNED_ROLE); role++) {
+        if (!running[role]) continue;
+        if (next == ranked.size()) {
+            unplaced.push_back(role);
+            continue;
+        }
+        taken[next] = true;
+        m_placements[role].cpus = {ranked[next++]->id};
+    }
+
+    // Preprocess feeds the engine in full-frame mode, the inference thread otherwise
+    const auto& preprocess = m_placements[static_cast<size_t>(ThreadRole::Preprocess)].cpus;
+    const auto& feed = preprocess.empty() ? m_placements[static_cast<size_t>(ThreadRole::Inference)].cpus
+                                          : preprocess;
+    if (const utils::LogicalCpu* feeder = feed.empty() ? nullptr : m_topology.find(feed.front());
+        feeder && feeder->coreClass == utils::CoreClass::Efficiency) {
+        logger.warning("The thread feeding inference is on E-core {}; expect higher latency variance",
+                       feeder->id);
+    }
+
+    // Background roles share the untaken E-cores, else whatever is left, else everything
+    std::vector<uint32_t> background;
+    for (int pass = 0; pass < 3 && background.empty(); pass++) {
+        for (size_t i = 0; i < ranked.size(); i++) {
+            const bool efficiency = ranked[i]->coreClass == utils::CoreClass::Efficiency;
+            if ((pass == 0 && (taken[i] || !efficiency)) || (pass == 1 && taken[i])) continue;
+            background.push_back(ranked[i]->id);
+        }
+    }
+    // Real-time only on CPUs of their own: on a pinned role's CPU, or next to
+    // an unplaced one, background roles run at normal priority too
+    const bool shared = !unplaced.empty() ||
+        std::find(taken.begin(), taken.end(), false) == taken.end();
+    for (size_t role = static_cast<size_t>(LAST_PINNED_ROLE) + 1; role < THREAD_ROLE_COUNT; role++) {
+        if (!running[role]) continue;
+        m_placements[role].cpus = background;
+        if (shared) m_placements[role].priority = 0;
+    }
+    for (const size_t role : unplaced) {
+        m_placements[role] = {background, 0};
+        logger.warning("No CPU left for the {} thread: it shares the background CPUs at normal priority",
+                       threadRoleName(static_cast<ThreadRole>(role)));
+    }
+}
+
+void ThreadScheduler::enter(ThreadRole role) const {
+    const Placement& placement = m_placements[static_cast<size_t>(role)];
+
+    std::string where = "unpinned";
+    if (!placement.cpus.empty()) {
+        // Read back: the OS may have narrowed the mask to CPUs the process can use
+        where = pinCurrentThread(placement.cpus)
+            ? describePlacement(m_topology, currentAffinity())
+            : "unpinned (affinity rejected)";
+    }
+    const std::string scheduling = placement.priority ? raiseCurrentThread(placement.priority)
+                                                      : "normal priority";
+
+    utils::Logger::getInstance().info("{} thread: {}, {}", threadRoleName(role), where, scheduling);
+}
+
+void ThreadScheduler::leave() const {
+    restoreCurrentThread();
+}
+
+} // namespace pipeline
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../core/types.hpp"
+#include "../utils/cpu_topology.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace pipeline {
+
+// Stage threads the scheduler places, in placement priority order
+enum class ThreadRole : uint8_t {
+    Preprocess,   // Feeds the engine; its jitter lands on every frame
+    Inference,
+    Capture,
+    Postprocess,
+    Counting,
+    Strategy,
+    UI,
+    Metrics,
+    Count
+};
+
+constexpr size_t THREAD_ROLE_COUNT = static_cast<size_t>(ThreadRole::Count);
+
+const char* threadRoleName(ThreadRole role);
+
+// Maps stage threads onto the CPU topology. The frame path (capture,
+// preprocess, inference, postprocess) and then counting and strategy get
+// a physical core each, P-cores first, inside the L3 domain with the most
+// P-cores, so frames and jobs handed between them stay in one cache. UI
+// and metrics float over the E-cores, or whatever the others left.
+//
+// PRIORITY_* become SCHED_FIFO priorities on Linux and MMCSS task classes
+// on Windows. Both need privileges (CAP_SYS_NICE / an rtprio limit, or the
+// MMCSS service); without them threads keep normal scheduling and the
+// startup report says so.
+class ThreadScheduler {
+public:
+    // Plans the roles that will run; call before their threads start
+    void plan(const core::SystemConfig& config, std::span<const ThreadRole> roles);
+
+    // Calling thread takes on the role's placement and logs where it landed
+    void enter(ThreadRole role) const;
+    // Undoes what enter() registered for the calling thread
+    void leave() const;
+
+private:
+    struct Placement {
+        std::vector<uint32_t> cpus;  // Empty: not pinned
+        int priority{0};             // 0: normal scheduling
+    };
+
+    utils::CpuTopology m_topology;
+    std::array<Placement, THREAD_ROLE_COUNT> m_placements{};
+};
+
+} // namespace pipeline
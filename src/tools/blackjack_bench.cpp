@@ -0,0 +1,550 @@
+/**
+ * Blackjack Benchmarks
+ * Per-stage microbenchmarks and a replay-driven pipeline run, reported as JSON
+ */
+
+#include "core/config_manager.hpp"
+#include "intelligence/counting/card_counter.hpp"
+#include "pipeline/pipeline_manager.hpp"
+#include "utils/latency_histogram.hpp"
+#include "vision/inference/tensorrt_engine.hpp"
+#include "vision/postprocessing/card_tracker.hpp"
+#include "vision/postprocessing/nms_processor.hpp"
+#include "vision/preprocessing/preprocessor.hpp"
+#include <cuda_runtime_api.h>
+#include <cuda_fp16.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+    std::printf(
+        "Usage: blackjack_bench [options]\n"
+        "  --iterations N      Timed calls per benchmark (default 1000)\n"
+        "  --warmup N          Untimed calls before timing (default 50)\n"
+        "  --filter S          Run benchmarks whose name contains S\n"
+        "  --json PATH         Write the JSON report to PATH (default: stdout)\n"
+        "  --engine PATH       TensorRT plan to benchmark; repeat for each precision\n"
+        "  --replay PATH       .bjrec recording for the full pipeline run\n");
+}
+
+struct BenchOptions {
+    uint32_t iterations = 1000;
+    uint32_t warmup = 50;
+    std::string filter;
+    std::string jsonPath;
+    std::vector<std::string> enginePaths;
+    std::string replayPath;
+};
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations;
+    uint32_t itemsPerCall;  // Work per timed call (frames, images, cards)
+    double seconds;
+    utils::HistogramSummary latency;  // Per call
+};
+
+// Times each call of a benchmark body into an HDR histogram. Bodies return
+// false on failure, which abandons that benchmark and fails the run.
+class BenchRunner {
+public:
+    explicit BenchRunner(const BenchOptions& options)
+        : m_options(options) {
+    }
+
+    bool selected(const std::string& name) const {
+        return m_options.filter.empty() || name.find(m_options.filter) != std::string::npos;
+    }
+
+    template<typename Fn>
+    void run(const std::string& name, Fn&& body, uint32_t itemsPerCall = 1) {
+        if (!selected(name)) return;
+
+        for (uint32_t i = 0; i < m_options.warmup; i++) {
+            if (!body()) return fail(name);
+        }
+
+        auto histogram = std::make_unique<utils::LatencyHistogram>();
+        const uint64_t start = nowNs();
+        for (uint32_t i = 0; i < m_options.iterations; i++) {
+            const uint64_t callStart = nowNs();
+            if (!body()) return fail(name);
+            histogram->record(nowNs() - callStart);
+        }
+        add(name, histogram->summarize(), m_options.iterations, itemsPerCall, (nowNs() - start) / 1e9);
+    }
+
+    void add(const std::string& name, const utils::HistogramSummary& latency,
+             uint64_t iterations, uint32_t itemsPerCall, double seconds) {
+        std::fprintf(stderr, "%-40s p50 %10.1f us   p99 %10.1f us   p99.9 %10.1f us\n", name.c_str(),
+                     latency.p50_ns / 1e3, latency.p99_ns / 1e3, latency.p999_ns / 1e3);
+        m_results.push_back({name, iterations, itemsPerCall, seconds, latency});
+    }
+
+    void fail(const std::string& name) {
+        std::fprintf(stderr, "%-40s FAILED\n", name.c_str());
+        m_failures++;
+    }
+
+    bool hasFailures() const { return m_failures > 0; }
+
+    bool writeJson(const std::string& device) const;
+
+private:
+    const BenchOptions& m_options;
+    std::vector<BenchResult> m_results;
+    uint32_t m_failures{0};
+};
+
+// Names are ours or file stems; escaping quotes and backslashes is enough
+std::string jsonString(const std::string& value) {
+    std::string out = "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+bool BenchRunner::writeJson(const std::string& device) const {
+    FILE* out = m_options.jsonPath.empty() ? stdout : std::fopen(m_options.jsonPath.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "Cannot write %s\n", m_options.jsonPath.c_str());
+        return false;
+    }
+
+    std::fprintf(out, "{\n  \"context\": {\"device\": %s, \"iterations\": %u, \"warmup\": %u},\n",
+                 jsonString(device).c_str(), m_options.iterations, m_options.warmup);
+    std::fprintf(out, "  \"benchmarks\": [");
+    for (size_t i = 0; i < m_results.size(); i++) {
+        const BenchResult& r = m_results[i];
+        const double itemsPerSecond = r.seconds > 0 ? r.iterations * r.itemsPerCall / r.seconds : 0.0;
+        std::fprintf(out,
+                     "%s\n    {\"name\": %s, \"iterations\": %llu, \"items_per_call\": %u, "
+                     "\"items_per_second\": %.1f, \"mean_ns\": %.0f, \"min_ns\": %llu, \"p50_ns\": %llu, "
+                     "\"p90_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"max_ns\": %llu}",
+                     i > 0 ? "," : "", jsonString(r.name).c_str(),
+                     static_cast<unsigned long long>(r.iterations), r.itemsPerCall, itemsPerSecond,
+                     r.latency.mean_ns,
+                     static_cast<unsigned long long>(r.latency.min_ns),
+                     static_cast<unsigned long long>(r.latency.p50_ns),
+                     static_cast<unsigned long long>(r.latency.p90_ns),
+                     static_cast<unsigned long long>(r.latency.p99_ns),
+                     static_cast<unsigned long long>(r.latency.p999_ns),
+                     static_cast<unsigned long long>(r.latency.max_ns));
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+
+    if (out != stdout) std::fclose(out);
+    return true;
+}
+
+// Benchmarks
+
+const char* precisionName(vision::cuda::TensorPrecision precision) {
+    return precision == vision::cuda::TensorPrecision::FP16 ? "fp16" : "fp32";
+}
+
+void benchPreprocess(BenchRunner& runner, const core::VisionConfig& config, cudaStream_t stream) {
+    struct Resolution {
+        const char* name;
+        uint32_t width, height;
+    };
+    constexpr Resolution RESOLUTIONS[] = {
+        {"720p", 1280, 720}, {"1080p", 1920, 1080}, {"1440p", 2560, 1440}, {"2160p", 3840, 2160}};
+
+    const uint32_t inputWidth = config.input_resolution[0];
+    const uint32_t inputHeight = config.input_resolution[1];
+
+    void* tensor = nullptr;
+    if (cudaMalloc(&tensor, static_cast<size_t>(3) * inputWidth * inputHeight * sizeof(float)) != cudaSuccess) {
+        return runner.fail("preprocess");
+    }
+
+    for (auto precision : {vision::cuda::TensorPrecision::FP32, vision::cuda::TensorPrecision::FP16}) {
+        vision::Preprocessor preprocessor;
+        if (!preprocessor.initialize(inputWidth, inputHeight, precision)) {
+            runner.fail(std::string("preprocess/") + precisionName(precision));
+            continue;
+        }
+
+        for (const Resolution& resolution : RESOLUTIONS) {
+            const std::string name = std::string("preprocess/") + resolution.name + "/" + precisionName(precision);
+            if (!runner.selected(name)) continue;
+
+            uint8_t* source = nullptr;
+            size_t pitch = 0;
+            if (cudaMallocPitch(reinterpret_cast<void**>(&source), &pitch,
+                                static_cast<size_t>(resolution.width) * 4, resolution.height) != cudaSuccess) {
+                runner.fail(name);
+                continue;
+            }
+            cudaMemset2D(source, pitch, 0x80, static_cast<size_t>(resolution.width) * 4, resolution.height);
+
+            capture::Frame frame{};
+            frame.data = source;
+            frame.width = resolution.width;
+            frame.height = resolution.height;
+            frame.stride = static_cast<uint32_t>(pitch);
+            frame.memory = capture::FrameMemory::Device;
+
+            runner.run(name, [&] {
+                return preprocessor.process(frame, tensor, stream) &&
+                       cudaStreamSynchronize(stream) == cudaSuccess;
+            });
+            cudaFree(source);
+        }
+    }
+    cudaFree(tensor);
+}
+
+// YOLOv11-shaped output: low background scores plus overlapping clusters
+// that survive the confidence filter and exercise NMS
+std::vector<float> syntheticYoloOutput(uint32_t predictions, uint32_t classes, float modelSize) {
+    constexpr uint32_t CLUSTERS = 48;
+    constexpr uint32_t BOXES_PER_CLUSTER = 6;
+
+    const uint32_t stride = 4 + classes;
+    std::vector<float> output(static_cast<size_t>(predictions) * stride);
+    std::mt19937 rng(0xB3AC);
+    std::uniform_real_distribution<float> background(0.0f, 0.2f);
+    std::uniform_real_distribution<float> position(64.0f, modelSize - 64.0f);
+    std::uniform_real_distribution<float> jitter(-4.0f, 4.0f);
+
+    for (uint32_t i = 0; i < predictions; i++) {
+        float* pred = &output[static_cast<size_t>(i) * stride];
+        pred[0] = position(rng);
+        pred[1] = position(rng);
+        pred[2] = 72.0f;
+        pred[3] = 100.0f;
+        for (uint32_t c = 0; c < classes; c++) pred[4 + c] = background(rng);
+    }
+
+    const uint32_t boxes = std::min(CLUSTERS * BOXES_PER_CLUSTER, predictions);
+    for (uint32_t i = 0; i < boxes; i++) {
+        float* cluster = &output[static_cast<size_t>(i / BOXES_PER_CLUSTER * BOXES_PER_CLUSTER) * stride];
+        float* pred = &output[static_cast<size_t>(i) * stride];
+        pred[0] = cluster[0] + jitter(rng);
+        pred[1] = cluster[1] + jitter(rng);
+        pred[4 + (i / BOXES_PER_CLUSTER) % classes] = 0.7f + 0.04f * (i % BOXES_PER_CLUSTER);
+    }
+    return output;
+}
+
+void benchGpuDecode(BenchRunner& runner, const std::string& name, const void* output,
+                    vision::cuda::TensorPrecision precision, uint32_t predictions, uint32_t classes,
+                    const core::VisionConfig& config, cudaStream_t stream) {
+    vision::cuda::DecodeWorkspace workspace{};
+    void* deviceOutput = nullptr;
+    vision::cuda::DetectionResult* hostResult = nullptr;
+    const size_t outputBytes = static_cast<size_t>(predictions) * (4 + classes) *
+                               vision::cuda::elementSize(precision);
+    if (!vision::cuda::allocateDecodeWorkspace(workspace) ||
+        cudaMalloc(&deviceOutput, outputBytes) != cudaSuccess ||
+        cudaMallocHost(reinterpret_cast<void**>(&hostResult), sizeof(*hostResult)) != cudaSuccess) {
+        runner.fail(name);
+    } else {
+        cudaMemcpy(deviceOutput, output, outputBytes, cudaMemcpyHostToDevice);
+        runner.run(name, [&] {
+            cudaError_t status = vision::cuda::decodeYOLOv11(deviceOutput, precision, predictions, predictions,
+                                                             nullptr, classes, config.confidence_threshold,
+                                                             workspace, stream);
+            if (status == cudaSuccess) {
+                status = vision::cuda::suppressAndCompact(config.nms_threshold, workspace, stream);
+            }
+            if (status == cudaSuccess) {
+                status = cudaMemcpyAsync(hostResult, workspace.result, sizeof(*hostResult),
+                                         cudaMemcpyDeviceToHost, stream);
+            }
+            return status == cudaSuccess && cudaStreamSynchronize(stream) == cudaSuccess;
+        });
+    }
+
+    if (hostResult) cudaFreeHost(hostResult);
+    if (deviceOutput) cudaFree(deviceOutput);
+    vision::cuda::freeDecodeWorkspace(workspace);
+}
+
+void benchDecode(BenchRunner& runner, vision::TensorRTEngine& engine, const std::string& prefix,
+                 const core::VisionConfig& config, cudaStream_t stream) {
+    const uint32_t predictions = engine.getPredictionsPerImage();
+    const uint32_t classes = static_cast<uint32_t>(engine.getNumClasses());
+    const std::vector<float> output =
+        syntheticYoloOutput(predictions, classes, static_cast<float>(engine.getInputWidth()));
+
+    std::vector<core::Detection> detections;
+    runner.run(prefix + "/decode_nms/cpu", [&] {
+        engine.decodeHostOutput(output.data(), 1, detections, config.confidence_threshold, config.nms_threshold);
+        return true;
+    });
+
+    // Same scores in the output type of an fp16_io plan
+    std::vector<__half> outputHalf(output.size());
+    std::transform(output.begin(), output.end(), outputHalf.begin(),
+                   [](float value) { return __float2half(value); });
+
+    for (auto precision : {vision::cuda::TensorPrecision::FP32, vision::cuda::TensorPrecision::FP16}) {
+        const std::string gpuName = prefix + (precision == vision::cuda::TensorPrecision::FP16
+                                              ? "/decode_nms/gpu_fp16" : "/decode_nms/gpu");
+        if (!runner.selected(gpuName)) continue;
+
+        const void* hostOutput = precision == vision::cuda::TensorPrecision::FP16
+            ? static_cast<const void*>(outputHalf.data()) : static_cast<const void*>(output.data());
+        benchGpuDecode(runner, gpuName, hostOutput, precision, predictions, classes, config, stream);
+    }
+}
+
+void benchEngine(BenchRunner& runner, const std::string& path, const core::VisionConfig& config,
+                 cudaStream_t stream) {
+    const std::string prefix = "engine/" + std::filesystem::path(path).stem().string();
+
+    vision::TensorRTEngine engine(config);
+    if (!engine.loadSerializedEngine(path)) {
+        return runner.fail(prefix);
+    }
+
+    const float conf = config.confidence_threshold;
+    const float nms = config.nms_threshold;
+    std::vector<core::Detection> detections;
+
+    // Host input, full batch: copy in, execute, decode
+    // Zero bits read as 0.0 in either input precision; sized for the largest profile
+    size_t imageBytes = 0;
+    for (const auto& profile : engine.getProfiles()) {
+        imageBytes = std::max(imageBytes, static_cast<size_t>(3) * profile.width * profile.height *
+                                          vision::cuda::elementSize(engine.getInputPrecision()));
+    }
+    std::vector<uint8_t> hostInput(imageBytes * engine.getBatchSize(), 0);
+    runner.run(prefix + "/infer", [&] {
+        return engine.infer(hostInput.data(), detections, conf, nms);
+    }, engine.getBatchSize());
+
+    // The same at every resolution profile the governor can switch to
+    const auto& profiles = engine.getProfiles();
+    if (profiles.size() > 1) {
+        const uint32_t active = engine.getActiveProfile();
+        for (uint32_t p = 0; p < profiles.size(); p++) {
+            engine.selectProfile(p);
+            runner.run(prefix + "/infer/" + std::to_string(profiles[p].width) + "x" +
+                       std::to_string(profiles[p].height), [&] {
+                return engine.infer(hostInput.data(), detections, conf, nms);
+            }, engine.getBatchSize());
+        }
+        engine.selectProfile(active);
+    }
+
+    std::vector<uint32_t> batches;
+    if (engine.hasDynamicBatch()) {
+        for (uint32_t batch = 1; batch < engine.getBatchSize(); batch *= 2) batches.push_back(batch);
+    }
+    batches.push_back(engine.getBatchSize());
+
+    for (uint32_t batch : batches) {
+        const std::vector<vision::cuda::LetterboxTransform> transforms(batch);
+        const std::string suffix = "/b" + std::to_string(batch);
+
+        // Input already on the device, one synchronous call at a time
+        runner.run(prefix + "/device" + suffix, [&] {
+            return engine.inferDeviceInput(detections, conf, nms, transforms);
+        }, batch);
+
+        // Steady state with every in-flight slot busy: each call retires the
+        // oldest ticket once the pipeline is full, then submits
+        std::deque<vision::InferenceTicket> inFlight;
+        runner.run(prefix + "/pipelined" + suffix, [&] {
+            if (inFlight.size() == engine.getInFlightDepth()) {
+                if (!engine.wait(inFlight.front(), detections)) return false;
+                inFlight.pop_front();
+            }
+            uint32_t slot = 0;
+            vision::InferenceTicket ticket;
+            if (!engine.acquireSlot(slot)) return false;
+            if (!engine.submit(slot, conf, nms, transforms, ticket)) return false;
+            inFlight.push_back(ticket);
+            return true;
+        }, batch);
+        for (const auto& ticket : inFlight) {
+            engine.wait(ticket, detections);
+        }
+    }
+
+    benchDecode(runner, engine, prefix, config, stream);
+}
+
+void benchTracker(BenchRunner& runner) {
+    for (uint32_t count : {8u, 16u, 32u, 64u}) {
+        const std::string name = "tracker/update/" + std::to_string(count);
+        if (!runner.selected(name)) continue;
+
+        // Cards laid out on a grid, drifting a pixel per frame
+        std::vector<core::Detection> detections(count);
+        for (uint32_t i = 0; i < count; i++) {
+            detections[i] = {100.0f + (i % 8) * 200.0f, 100.0f + (i / 8) * 150.0f, 72.0f, 100.0f,
+                             static_cast<uint8_t>(i % 52), 0.9f, 0};
+        }
+
+        auto tracker = std::make_unique<vision::CardTracker>();
+        uint64_t frame = 0;
+        runner.run(name, [&] {
+            const float drift = (frame++ % 64) < 32 ? 1.0f : -1.0f;
+            for (auto& detection : detections) {
+                detection.x += drift;
+                detection.timestamp_ns = frame;
+            }
+            tracker->update(detections);
+            return true;
+        });
+    }
+}
+
+void benchCounter(BenchRunner& runner) {
+    constexpr uint32_t DECKS = 6;
+
+    // One shuffled six-deck shoe, counted card by card and as a burst
+    std::vector<core::Card> shoe;
+    for (uint32_t deck = 0; deck < DECKS; deck++) {
+        for (uint8_t id = 0; id < 52; id++) {
+            shoe.push_back(core::cardFromId(id, 0.95f, 0));
+        }
+    }
+    std::shuffle(shoe.begin(), shoe.end(), std::mt19937(0x5EED));
+    const uint32_t cards = static_cast<uint32_t>(shoe.size());
+
+    intelligence::CardCounter counter;
+    counter.initialize(DECKS);
+
+    runner.run("counter/add_card/shoe", [&] {
+        counter.reset();
+        for (const auto& card : shoe) counter.addCard(card);
+        return true;
+    }, cards);
+
+    runner.run("counter/add_cards/shoe", [&] {
+        counter.reset();
+        counter.addCards(shoe);
+        return true;
+    }, cards);
+}
+
+// Whole pipeline over a recording, unthrottled and lossless, with the
+// motion gate off so every frame reaches the detector. Reports the
+// pipeline's own stage histograms.
+void benchPipeline(BenchRunner& runner, const BenchOptions& options) {
+    constexpr auto POLL_INTERVAL = std::chrono::milliseconds(100);
+    constexpr uint32_t IDLE_POLLS = 10;  // Exhausted source and no progress for a second: drained
+
+    if (options.replayPath.empty() || !runner.selected("pipeline/replay")) return;
+
+    core::ConfigManager config;
+    auto capture = config.getCaptureConfig();
+    capture.method = core::CaptureConfig::CaptureMethod::REPLAY;
+    capture.replay_path = options.replayPath;
+    capture.replay_pacing = core::CaptureConfig::ReplayPacing::Unthrottled;
+    capture.replay_loop = false;
+    capture.replay_lossless = true;
+    capture.motion_gating = false;
+    config.setCaptureConfig(capture);
+
+    auto vision = config.getVisionConfig();
+    if (!options.enginePaths.empty()) {
+        vision.model_path = options.enginePaths.front();
+    }
+    config.setVisionConfig(vision);
+
+    auto ui = config.getUIConfig();
+    ui.overlay_enabled = false;
+    config.setUIConfig(ui);
+
+    auto pipeline = std::make_unique<pipeline::PipelineManager>();
+    if (!pipeline->initialize(config) || !pipeline->start()) {
+        return runner.fail("pipeline/replay");
+    }
+
+    const uint64_t start = nowNs();
+    uint32_t lastProcessed = 0;
+    uint32_t idlePolls = 0;
+    while (idlePolls < IDLE_POLLS) {
+        std::this_thread::sleep_for(POLL_INTERVAL);
+        const uint32_t processed = pipeline->getFramesProcessed();
+        idlePolls = pipeline->isSourceExhausted() && processed == lastProcessed ? idlePolls + 1 : 0;
+        lastProcessed = processed;
+    }
+    const double seconds = (nowNs() - start) / 1e9 - IDLE_POLLS * std::chrono::duration<double>(POLL_INTERVAL).count();
+    pipeline->stop();
+
+    pipeline::MetricsSnapshot snapshot{};
+    pipeline->getMetrics(snapshot);
+    for (size_t i = 0; i < pipeline::STAGE_COUNT; i++) {
+        const auto& stage = snapshot.stages[i];
+        if (stage.latency.count == 0) continue;
+        runner.add(std::string("pipeline/replay/") + pipeline::stageName(static_cast<pipeline::Stage>(i)),
+                   stage.latency, stage.latency.count, 1, seconds);
+    }
+    if (pipeline->getFramesDropped() > 0) {
+        std::fprintf(stderr, "pipeline/replay: %u frames dropped\n", pipeline->getFramesDropped());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        auto value = [&]() { return std::string(argv[++i]); };
+
+        if (arg == "--iterations" && hasValue) options.iterations = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--warmup" && hasValue) options.warmup = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--filter" && hasValue) options.filter = value();
+        else if (arg == "--json" && hasValue) options.jsonPath = value();
+        else if (arg == "--engine" && hasValue) options.enginePaths.push_back(value());
+        else if (arg == "--replay" && hasValue) options.replayPath = value();
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    cudaDeviceProp properties{};
+    if (cudaGetDeviceProperties(&properties, 0) != cudaSuccess) {
+        std::fprintf(stderr, "No CUDA device\n");
+        return 1;
+    }
+
+    cudaStream_t stream = nullptr;
+    cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking);
+
+    BenchRunner runner(options);
+    const core::VisionConfig visionConfig;
+
+    benchPreprocess(runner, visionConfig, stream);
+    for (const auto& path : options.enginePaths) {
+        benchEngine(runner, path, visionConfig, stream);
+    }
+    benchTracker(runner);
+    benchCounter(runner);
+    benchPipeline(runner, options);
+
+    cudaStreamDestroy(stream);
+
+    if (!runner.writeJson(properties.name)) return 1;
+    return runner.hasFailures() ? 1 : 0;
+}
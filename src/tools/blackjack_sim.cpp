@@ -0,0 +1,108 @@
+/**
+ * Blackjack Shoe Simulator
+ * Measures basic strategy, index plays and bet ramps over the intelligence library
+ */
+
+#include "intelligence/simulation/shoe_simulator.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+void printUsage() {
+    std::printf(
+        "Usage: blackjack_sim [options]\n"
+        "  --rounds N          Rounds to play (default 100000000)\n"
+        "  --threads N         Worker threads (default: all)\n"
+        "  --seed N            RNG seed (default 0x5EED)\n"
+        "  --decks N           Decks per shoe (default 6)\n"
+        "  --penetration F     Cut card position, 0-1 (default 0.75)\n"
+        "  --rules S           s17/h17, das, ls (default s17_das)\n"
+        "  --system S          hilo, ko, omega2, halves (default hilo)\n"
+        "  --no-i18            Disable the Illustrious 18\n"
+        "  --no-fab4           Disable the Fab 4 surrenders\n"
+        "  --bankroll F        Bet sizing and risk of ruin bankroll (default 10000)\n"
+        "  --min-bet F         Table minimum (default 10)\n"
+        "  --max-bet F         Table maximum (default 500)\n"
+        "  --kelly F           Kelly fraction (default 0.25)\n"
+        "  --flat              Bet the minimum every round\n"
+        "  --checkpoint PATH   Checkpoint file; resumes when it exists\n");
+}
+
+bool parseSystem(const std::string& name, intelligence::CountingSystem& system) {
+    using intelligence::CountingSystem;
+    if (name == "hilo") system = CountingSystem::HiLo;
+    else if (name == "ko") system = CountingSystem::KO;
+    else if (name == "omega2") system = CountingSystem::Omega2;
+    else if (name == "halves") system = CountingSystem::HalvesCount;
+    else return false;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    intelligence::SimulationConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        auto value = [&]() { return std::string(argv[++i]); };
+
+        if (arg == "--rounds" && hasValue) config.rounds = std::strtoull(value().c_str(), nullptr, 0);
+        else if (arg == "--threads" && hasValue) config.threads = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--seed" && hasValue) config.seed = std::strtoull(value().c_str(), nullptr, 0);
+        else if (arg == "--decks" && hasValue) config.decks = static_cast<uint32_t>(std::stoul(value()));
+        else if (arg == "--penetration" && hasValue) config.penetration = std::stof(value());
+        else if (arg == "--rules" && hasValue) config.rules = value();
+        else if (arg == "--system" && hasValue) {
+            if (!parseSystem(value(), config.counting_system)) {
+                printUsage();
+                return 1;
+            }
+        }
+        else if (arg == "--no-i18") config.illustrious_18 = false;
+        else if (arg == "--no-fab4") config.fab_4 = false;
+        else if (arg == "--bankroll" && hasValue) config.bankroll = std::stod(value());
+        else if (arg == "--min-bet" && hasValue) config.min_bet = std::stod(value());
+        else if (arg == "--max-bet" && hasValue) config.max_bet = std::stod(value());
+        else if (arg == "--kelly" && hasValue) config.kelly_fraction = std::stof(value());
+        else if (arg == "--flat") config.flat_bet = true;
+        else if (arg == "--checkpoint" && hasValue) config.checkpoint_path = value();
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    intelligence::ShoeSimulator simulator(config);
+    intelligence::SimulationStats stats;
+
+    const auto start = std::chrono::steady_clock::now();
+    auto lastReport = start;
+    const bool ok = simulator.run(stats, [&](uint64_t completed, uint64_t total) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastReport < std::chrono::seconds(5)) return;
+        lastReport = now;
+        std::fprintf(stderr, "  %llu / %llu rounds\n",
+                     static_cast<unsigned long long>(completed), static_cast<unsigned long long>(total));
+    });
+    if (!ok) return 1;
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto report = intelligence::ShoeSimulator::summarize(stats, config.bankroll);
+
+    std::printf("Rounds:        %llu (%llu hands)\n",
+                static_cast<unsigned long long>(stats.rounds), static_cast<unsigned long long>(stats.hands));
+    std::printf("EV per round:  %.5f +/- %.5f\n", report.ev_per_round, report.ev_ci95);
+    std::printf("SD per round:  %.4f\n", report.sd_per_round);
+    std::printf("Edge:          %.4f%% +/- %.4f%% of initial bet\n", 100.0 * report.edge, 100.0 * report.edge_ci95);
+    std::printf("N0:            %.0f rounds\n", report.n0);
+    std::printf("Risk of ruin:  %.4f%% [%.4f%%, %.4f%%] at bankroll %.0f\n",
+                100.0 * report.risk_of_ruin, 100.0 * report.risk_of_ruin_low,
+                100.0 * report.risk_of_ruin_high, config.bankroll);
+    std::printf("Throughput:    %.1f M rounds/s (%.1f s)\n", stats.rounds / seconds / 1e6, seconds);
+    return 0;
+}
@@ -0,0 +1,661 @@
+#include "overlay_renderer.hpp"
+#include "../../utils/logger.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <GL/gl.h>
+#endif
+
+namespace ui {
+
+namespace {
+
+constexpr uint32_t HUD_COLOR = 0xFFF0F0F0u;  // Near white; pure black is the color key
+constexpr float HUD_MARGIN = 16.0f;
+constexpr float HUD_LINE_SPACING = GLYPH_HEIGHT + 4.0f;
+
+} // namespace
+
+#ifdef _WIN32
+namespace {
+
+// Past OpenGL 1.1, which is all the Windows headers declare
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_DYNAMIC_DRAW
+#define GL_DYNAMIC_DRAW 0x88E8
+#endif
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER 0x8B31
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS 0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS 0x8B82
+#endif
+#ifndef GL_TEXTURE0
+#define GL_TEXTURE0 0x84C0
+#endif
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+#ifndef GL_R8
+#define GL_R8 0x8229
+#endif
+
+using GLchar = char;
+using GLsizeiptr = ptrdiff_t;
+using GLintptr = ptrdiff_t;
+
+constexpr const wchar_t* WINDOW_CLASS = L"BlackjackOverlay";
+constexpr float BOX_BORDER = 2.0f;
+
+// Font atlas: ASCII 32..127 in a 16 x 6 grid of cells
+constexpr int ATLAS_COLUMNS = 16;
+constexpr int ATLAS_ROWS = 6;
+constexpr int CELL_WIDTH = 16;
+constexpr int CELL_HEIGHT = 24;
+
+// Quad corners from gl_VertexID, frame pixels to clip space
+const char* VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec4 rect;
+layout(location = 1) in uint glyph;
+layout(location = 2) in vec4 color;
+uniform vec2 viewport;
+out vec2 local;
+out vec2 size;
+out vec2 atlas;
+out vec4 tint;
+flat out uint outline;
+void main() {
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vec2 pixel = rect.xy + corner * rect.zw;
+    gl_Position = vec4(pixel.x / viewport.x * 2.0 - 1.0, 1.0 - pixel.y / viewport.y * 2.0, 0.0, 1.0);
+    local = corner * rect.zw;
+    size = rect.zw;
+    uint cell = glyph - 32u;
+    atlas = (vec2(cell % 16u, cell / 16u) + corner) / vec2(16.0, 6.0);
+    tint = color;
+    outline = glyph == 0xFFFFFFFFu ? 1u : 0u;
+}
+)";
+
+// No blending: the color-keyed window shows any non-black pixel as is
+const char* FRAGMENT_SHADER = R"(#version 330 core
+in vec2 local;
+in vec2 size;
+in vec2 atlas;
+in vec4 tint;
+flat in uint outline;
+uniform sampler2D font;
+uniform float border;
+out vec4 fragment;
+void main() {
+    if (outline == 1u) {
+        vec2 edge = min(local, size - local);
+        if (min(edge.x, edge.y) > border) discard;
+    } else if (texture(font, atlas).r < 0.5) {
+        discard;
+    }
+    fragment = tint;
+}
+)";
+
+// Marks the overlay for a redraw when Windows asks for a repaint
+LRESULT CALLBACK overlayWindowProc(HWND window, UINT message, WPARAM wParam, LPARAM lParam) {
+    switch (message) {
+        case WM_PAINT:
+            if (auto* redraw = reinterpret_cast<bool*>(GetWindowLongPtrW(window, GWLP_USERDATA))) {
+                *redraw = true;
+            }
+            ValidateRect(window, nullptr);
+            return 0;
+        case WM_ERASEBKGND:
+            return 1;
+        default:
+            return DefWindowProcW(window, message, wParam, lParam);
+    }
+}
+
+template<typename T>
+bool loadFunction(T& function, const char* name) {
+    function = reinterpret_cast<T>(wglGetProcAddress(name));
+    if (!function) {
+        utils::Logger::getInstance().error("OpenGL function {} unavailable", name);
+    }
+    return function != nullptr;
+}
+
+} // namespace
+
+// GL 2.0+ entry points, resolved from the current context
+struct GlFunctions {
+    GLuint (APIENTRY* createShader)(GLenum);
+    void (APIENTRY* shaderSource)(GLuint, GLsizei, const GLchar* const*, const GLint*);
+    void (APIENTRY* compileShader)(GLuint);
+    void (APIENTRY* getShaderiv)(GLuint, GLenum, GLint*);
+    void (APIENTRY* getShaderInfoLog)(GLuint, GLsizei, GLsizei*, GLchar*);
+    void (APIENTRY* deleteShader)(GLuint);
+    GLuint (APIENTRY* createProgram)();
+    void (APIENTRY* attachShader)(GLuint, GLuint);
+    void (APIENTRY* linkProgram)(GLuint);
+    void (APIENTRY* getProgramiv)(GLuint, GLenum, GLint*);
+    void (APIENTRY* getProgramInfoLog)(GLuint, GLsizei, GLsizei*, GLchar*);
+    void (APIENTRY* deleteProgram)(GLuint);
+    void (APIENTRY* useProgram)(GLuint);
+    GLint (APIENTRY* getUniformLocation)(GLuint, const GLchar*);
+    void (APIENTRY* uniform1i)(GLint, GLint);
+    void (APIENTRY* uniform1f)(GLint, GLfloat);
+    void (APIENTRY* uniform2f)(GLint, GLfloat, GLfloat);
+    void (APIENTRY* genVertexArrays)(GLsizei, GLuint*);
+    void (APIENTRY* bindVertexArray)(GLuint);
+    void (APIENTRY* deleteVertexArrays)(GLsizei, const GLuint*);
+    void (APIENTRY* genBuffers)(GLsizei, GLuint*);
+    void (APIENTRY* bindBuffer)(GLenum, GLuint);
+    void (APIENTRY* bufferData)(GLenum, GLsizeiptr, const void*, GLenum);
+    void (APIENTRY* bufferSubData)(GLenum, GLintptr, GLsizeiptr, const void*);
+    void (APIENTRY* deleteBuffers)(GLsizei, const GLuint*);
+    void (APIENTRY* vertexAttribPointer)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*);
+    void (APIENTRY* vertexAttribIPointer)(GLuint, GLint, GLenum, GLsizei, const void*);
+    void (APIENTRY* enableVertexAttribArray)(GLuint);
+    void (APIENTRY* vertexAttribDivisor)(GLuint, GLuint);
+    void (APIENTRY* drawArraysInstanced)(GLenum, GLint, GLsizei, GLsizei);
+    void (APIENTRY* activeTexture)(GLenum);
+    BOOL (APIENTRY* swapInterval)(int);  // WGL_EXT_swap_control, optional
+
+    bool load() {
+        return loadFunction(createShader, "glCreateShader") &&
+               loadFunction(shaderSource, "glShaderSource") &&
+               loadFunction(compileShader, "glCompileShader") &&
+               loadFunction(getShaderiv, "glGetShaderiv") &&
+               loadFunction(getShaderInfoLog, "glGetShaderInfoLog") &&
+               loadFunction(deleteShader, "glDeleteShader") &&
+               loadFunction(createProgram, "glCreateProgram") &&
+               loadFunction(attachShader, "glAttachShader") &&
+               loadFunction(linkProgram, "glLinkProgram") &&
+               loadFunction(getProgramiv, "glGetProgramiv") &&
+               loadFunction(getProgramInfoLog, "glGetProgramInfoLog") &&
+               loadFunction(deleteProgram, "glDeleteProgram") &&
+               loadFunction(useProgram, "glUseProgram") &&
+               loadFunction(getUniformLocation, "glGetUniformLocation") &&
+               loadFunction(uniform1i, "glUniform1i") &&
+               loadFunction(uniform1f, "glUniform1f") &&
+               loadFunction(uniform2f, "glUniform2f") &&
+               loadFunction(genVertexArrays, "glGenVertexArrays") &&
+               loadFunction(bindVertexArray, "glBindVertexArray") &&
+               loadFunction(deleteVertexArrays, "glDeleteVertexArrays") &&
+               loadFunction(genBuffers, "glGenBuffers") &&
+               loadFunction(bindBuffer, "glBindBuffer") &&
+               loadFunction(bufferData, "glBufferData") &&
+               loadFunction(bufferSubData, "glBufferSubData") &&
+               loadFunction(deleteBuffers, "glDeleteBuffers") &&
+               loadFunction(vertexAttribPointer, "glVertexAttribPointer") &&
+               loadFunction(vertexAttribIPointer, "glVertexAttribIPointer") &&
+               loadFunction(enableVertexAttribArray, "glEnableVertexAttribArray") &&
+               loadFunction(vertexAttribDivisor, "glVertexAttribDivisor") &&
+               loadFunction(drawArraysInstanced, "glDrawArraysInstanced") &&
+               loadFunction(activeTexture, "glActiveTexture");
+    }
+
+    GLuint compile(GLenum type, const char* source) {
+        const GLuint shader = createShader(type);
+        shaderSource(shader, 1, &source, nullptr);
+        compileShader(shader);
+
+        GLint ok = GL_FALSE;
+        getShaderiv(shader, GL_COMPILE_STATUS, &ok);
+        if (!ok) {
+            char log[1024];
+            getShaderInfoLog(shader, sizeof(log), nullptr, log);
+            utils::Logger::getInstance().error("Overlay shader failed to compile: {}", static_cast<const char*>(log));
+            deleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+};
+#else
+struct GlFunctions {};
+#endif
+
+OverlayRenderer::OverlayRenderer() = default;
+
+OverlayRenderer::~OverlayRenderer() {
+    shutdown();
+}
+
+bool OverlayRenderer::initialize() {
+#ifdef _WIN32
+    m_hudInstances.assign(HUD_INSTANCES, OverlayInstance{});
+    if (!createOverlayWindow() || !initializeOpenGL() || !createFontAtlas() || !createDrawState()) {
+        shutdown();
+        return false;
+    }
+
+    // Boxes and labels come from CUDA; without interop the HUD still works
+    if (!m_scene.initialize(m_instanceBuffer)) {
+        utils::Logger::getInstance().warning("Overlay card boxes disabled: CUDA-GL interop unavailable");
+    }
+
+    m_redrawRequested = true;
+    return true;
+#else
+    utils::Logger::getInstance().error("The overlay window requires Windows");
+    return false;
+#endif
+}
+
+void OverlayRenderer::shutdown() {
+#ifdef _WIN32
+    // Interop registration goes before the buffer it refers to
+    m_scene.shutdown();
+
+    if (m_glContext) {
+        if (m_gl) {
+            m_gl->deleteProgram(m_program);
+            m_gl->deleteVertexArrays(1, &m_vertexArray);
+            m_gl->deleteBuffers(1, &m_instanceBuffer);
+        }
+        glDeleteTextures(1, &m_fontTexture);
+        wglMakeCurrent(nullptr, nullptr);
+        wglDeleteContext(static_cast<HGLRC>(m_glContext));
+        m_glContext = nullptr;
+    }
+    m_program = m_vertexArray = m_instanceBuffer = m_fontTexture = 0;
+    m_gl.reset();
+
+    if (m_deviceContext) {
+        ReleaseDC(static_cast<HWND>(m_window), static_cast<HDC>(m_deviceContext));
+        m_deviceContext = nullptr;
+    }
+    if (m_window) {
+        DestroyWindow(static_cast<HWND>(m_window));
+        m_window = nullptr;
+    }
+#endif
+}
+
+bool OverlayRenderer::createOverlayWindow() {
+#ifdef _WIN32
+    auto& logger = utils::Logger::getInstance();
+    const HINSTANCE instance = GetModuleHandleW(nullptr);
+
+    WNDCLASSEXW windowClass{};
+    windowClass.cbSize = sizeof(windowClass);
+    windowClass.style = CS_OWNDC;
+    windowClass.lpfnWndProc = overlayWindowProc;
+    windowClass.hInstance = instance;
+    windowClass.lpszClassName = WINDOW_CLASS;
+    if (!RegisterClassExW(&windowClass) && GetLastError() != ERROR_CLASS_ALREADY_EXISTS) {
+        logger.error("Failed to register overlay window class: {}", static_cast<uint32_t>(GetLastError()));
+        return false;
+    }
+
+    m_windowWidth = static_cast<uint32_t>(GetSystemMetrics(SM_CXSCREEN));
+    m_windowHeight = static_cast<uint32_t>(GetSystemMetrics(SM_CYSCREEN));
+
+    // Click-through and never focused: input goes to the table underneath
+    HWND window = CreateWindowExW(
+        WS_EX_LAYERED | WS_EX_TRANSPARENT | WS_EX_TOPMOST | WS_EX_TOOLWINDOW | WS_EX_NOACTIVATE,
+        WINDOW_CLASS, L"Blackjack Overlay", WS_POPUP,
+        0, 0, static_cast<int>(m_windowWidth), static_cast<int>(m_windowHeight),
+        nullptr, nullptr, instance, nullptr);
+    if (!window) {
+        logger.error("Failed to create overlay window: {}", static_cast<uint32_t>(GetLastError()));
+        return false;
+    }
+    m_window = window;
+    SetWindowLongPtrW(window, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(&m_redrawRequested));
+
+    // Desktop duplication would otherwise feed our own boxes back into detection
+    if (!SetWindowDisplayAffinity(window, WDA_EXCLUDEFROMCAPTURE)) {
+        logger.warning("Overlay cannot be excluded from capture; boxes may be detected as cards");
+    }
+
+    SetLayeredWindowAttributes(window, RGB(0, 0, 0), static_cast<BYTE>(m_transparency * 255.0f),
+                               LWA_COLORKEY | LWA_ALPHA);
+    ShowWindow(window, m_visible ? SW_SHOWNOACTIVATE : SW_HIDE);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool OverlayRenderer::initializeOpenGL() {
+#ifdef _WIN32
+    auto& logger = utils::Logger::getInstance();
+    HDC deviceContext = GetDC(static_cast<HWND>(m_window));
+    m_deviceContext = deviceContext;
+
+    PIXELFORMATDESCRIPTOR format{};
+    format.nSize = sizeof(format);
+    format.nVersion = 1;
+    format.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
+    format.iPixelType = PFD_TYPE_RGBA;
+    format.cColorBits = 32;
+    format.cAlphaBits = 8;
+    format.iLayerType = PFD_MAIN_PLANE;
+    const int formatIndex = ChoosePixelFormat(deviceContext, &format);
+    if (formatIndex == 0 || !SetPixelFormat(deviceContext, formatIndex, &format)) {
+        logger.error("No OpenGL pixel format for the overlay window");
+        return false;
+    }
+
+    HGLRC context = wglCreateContext(deviceContext);
+    if (!context || !wglMakeCurrent(deviceContext, context)) {
+        logger.error("Failed to create OpenGL context");
+        if (context) wglDeleteContext(context);
+        return false;
+    }
+    m_glContext = context;
+
+    m_gl = std::make_unique<GlFunctions>();
+    if (!m_gl->load()) {
+        m_gl.reset();  // Partially resolved: nothing may call through it
+        logger.error("OpenGL 3.3 is required for the overlay");
+        return false;
+    }
+
+    // Presenting must not park the UI thread on vsync
+    m_gl->swapInterval = reinterpret_cast<BOOL (APIENTRY*)(int)>(wglGetProcAddress("wglSwapIntervalEXT"));
+    if (m_gl->swapInterval) {
+        m_gl->swapInterval(0);
+    }
+
+    logger.info("Overlay OpenGL {} on {}",
+                reinterpret_cast<const char*>(glGetString(GL_VERSION)),
+                reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Rasterizes ASCII 32..127 once with GDI into a single-channel texture
+bool OverlayRenderer::createFontAtlas() {
+#ifdef _WIN32
+    constexpr int width = ATLAS_COLUMNS * CELL_WIDTH;
+    constexpr int height = ATLAS_ROWS * CELL_HEIGHT;
+
+    HDC memory = CreateCompatibleDC(nullptr);
+    BITMAPINFO info{};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = width;
+    info.bmiHeader.biHeight = -height;  // Top-down, like the atlas rows
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+
+    void* bits = nullptr;
+    HBITMAP bitmap = CreateDIBSection(memory, &info, DIB_RGB_COLORS, &bits, nullptr, 0);
+    HFONT font = CreateFontW(CELL_HEIGHT - 2, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE, DEFAULT_CHARSET,
+                             OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, NONANTIALIASED_QUALITY,
+                             FIXED_PITCH | FF_MODERN, L"Consolas");
+    if (!memory || !bitmap || !bits || !font) {
+        utils::Logger::getInstance().error("Failed to rasterize the overlay font");
+        if (font) DeleteObject(font);
+        if (bitmap) DeleteObject(bitmap);
+        if (memory) DeleteDC(memory);
+        return false;
+    }
+
+    std::fill_n(static_cast<uint32_t*>(bits), width * height, 0u);
+    const HGDIOBJ previousBitmap = SelectObject(memory, bitmap);
+    const HGDIOBJ previousFont = SelectObject(memory, font);
+    SetTextColor(memory, RGB(255, 255, 255));
+    SetBkMode(memory, TRANSPARENT);
+    for (int code = 32; code < 32 + ATLAS_COLUMNS * ATLAS_ROWS; code++) {
+        const wchar_t glyph = static_cast<wchar_t>(code);
+        const int cell = code - 32;
+        TextOutW(memory, (cell % ATLAS_COLUMNS) * CELL_WIDTH, (cell / ATLAS_COLUMNS) * CELL_HEIGHT, &glyph, 1);
+    }
+    GdiFlush();
+
+    std::vector<uint8_t> coverage(static_cast<size_t>(width) * height);
+    const auto* pixels = static_cast<const uint8_t*>(bits);
+    for (size_t i = 0; i < coverage.size(); i++) {
+        coverage[i] = pixels[i * 4 + 1];  // Green of white-on-black BGRA
+    }
+
+    SelectObject(memory, previousFont);
+    SelectObject(memory, previousBitmap);
+    DeleteObject(font);
+    DeleteObject(bitmap);
+    DeleteDC(memory);
+
+    glGenTextures(1, &m_fontTexture);
+    glBindTexture(GL_TEXTURE_2D, m_fontTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, coverage.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Shader program and the instance buffer every draw reads
+bool OverlayRenderer::createDrawState() {
+#ifdef _WIN32
+    auto& gl = *m_gl;
+
+    const GLuint vertex = gl.compile(GL_VERTEX_SHADER, VERTEX_SHADER);
+    const GLuint fragment = gl.compile(GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+    if (!vertex || !fragment) {
+        if (vertex) gl.deleteShader(vertex);
+        if (fragment) gl.deleteShader(fragment);
+        return false;
+    }
+    m_program = gl.createProgram();
+    gl.attachShader(m_program, vertex);
+    gl.attachShader(m_program, fragment);
+    gl.linkProgram(m_program);
+    gl.deleteShader(vertex);
+    gl.deleteShader(fragment);
+
+    GLint linked = GL_FALSE;
+    gl.getProgramiv(m_program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        char log[1024];
+        gl.getProgramInfoLog(m_program, sizeof(log), nullptr, log);
+        utils::Logger::getInstance().error("Overlay shader failed to link: {}", static_cast<const char*>(log));
+        return false;
+    }
+
+    gl.useProgram(m_program);
+    gl.uniform1i(gl.getUniformLocation(m_program, "font"), 0);
+    gl.uniform1f(gl.getUniformLocation(m_program, "border"), BOX_BORDER);
+    m_viewportLocation = gl.getUniformLocation(m_program, "viewport");
+
+    // Zeroed: every instance starts with zero size and draws nothing
+    const std::vector<OverlayInstance> empty(MAX_OVERLAY_INSTANCES);
+    gl.genVertexArrays(1, &m_vertexArray);
+    gl.bindVertexArray(m_vertexArray);
+    gl.genBuffers(1, &m_instanceBuffer);
+    gl.bindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    gl.bufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(empty.size() * sizeof(OverlayInstance)),
+                  empty.data(), GL_DYNAMIC_DRAW);
+
+    constexpr GLsizei stride = sizeof(OverlayInstance);
+    gl.vertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride,
+                           reinterpret_cast<const void*>(offsetof(OverlayInstance, x)));
+    gl.vertexAttribIPointer(1, 1, GL_UNSIGNED_INT, stride,
+                            reinterpret_cast<const void*>(offsetof(OverlayInstance, glyph)));
+    gl.vertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                           reinterpret_cast<const void*>(offsetof(OverlayInstance, color)));
+    for (GLuint attribute = 0; attribute < 3; attribute++) {
+        gl.enableVertexAttribArray(attribute);
+        gl.vertexAttribDivisor(attribute, 1);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void OverlayRenderer::pumpMessages() {
+#ifdef _WIN32
+    MSG message;
+    while (PeekMessageW(&message, static_cast<HWND>(m_window), 0, 0, PM_REMOVE)) {
+        DispatchMessageW(&message);
+    }
+#endif
+}
+
+void OverlayRenderer::render() {
+#ifdef _WIN32
+    if (!m_glContext) return;
+    pumpMessages();
+    if (!m_visible || !needsRedraw()) return;
+
+    auto& gl = *m_gl;
+    if (m_tracksDirty) {
+        m_scene.updateTracks(m_tracks);
+        m_tracksDirty = false;
+    }
+    if (m_hudDirty) {
+        layoutHud();
+        gl.bindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+        gl.bufferSubData(GL_ARRAY_BUFFER, 0,
+                         static_cast<GLsizeiptr>(m_hudInstances.size() * sizeof(OverlayInstance)),
+                         m_hudInstances.data());
+        m_hudDirty = false;
+    }
+    m_redrawRequested = false;
+
+    // Boxes are in captured-frame pixels; stretch them over the window
+    const float viewportWidth = static_cast<float>(m_frameWidth ? m_frameWidth : m_windowWidth);
+    const float viewportHeight = static_cast<float>(m_frameHeight ? m_frameHeight : m_windowHeight);
+
+    glViewport(0, 0, static_cast<GLsizei>(m_windowWidth), static_cast<GLsizei>(m_windowHeight));
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);  // The color key: cleared pixels are see-through
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    gl.useProgram(m_program);
+    gl.uniform2f(m_viewportLocation, viewportWidth, viewportHeight);
+    gl.activeTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_fontTexture);
+    gl.bindVertexArray(m_vertexArray);
+    gl.drawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(m_scene.getInstanceCount()));
+
+    SwapBuffers(static_cast<HDC>(m_deviceContext));
+#endif
+}
+
+void OverlayRenderer::setTransparency(float alpha) {
+    m_transparency = std::clamp(alpha, 0.0f, 1.0f);
+#ifdef _WIN32
+    if (m_window) {
+        SetLayeredWindowAttributes(static_cast<HWND>(m_window), RGB(0, 0, 0),
+                                   static_cast<BYTE>(m_transparency * 255.0f), LWA_COLORKEY | LWA_ALPHA);
+    }
+#endif
+}
+
+void OverlayRenderer::setVisible(bool visible) {
+    if (visible == m_visible) return;
+    m_visible = visible;
+    m_redrawRequested = visible;
+#ifdef _WIN32
+    if (m_window) {
+        ShowWindow(static_cast<HWND>(m_window), visible ? SW_SHOWNOACTIVATE : SW_HIDE);
+    }
+#endif
+}
+
+void OverlayRenderer::updateCount(int runningCount, float trueCount) {
+    char text[HUD_LINE_GLYPHS + 1];
+    std::snprintf(text, sizeof(text), "RC %+d  TC %+.1f", runningCount, trueCount);
+    setHudLine(CountLine, text);
+}
+
+void OverlayRenderer::updateAction(const std::string& action) {
+    char text[HUD_LINE_GLYPHS + 1];
+    std::snprintf(text, sizeof(text), "%s", action.c_str());
+    setHudLine(ActionLine, text);
+}
+
+void OverlayRenderer::updateBet(double betAmount) {
+    char text[HUD_LINE_GLYPHS + 1];
+    std::snprintf(text, sizeof(text), "BET %.0f", betAmount);
+    setHudLine(BetLine, text);
+}
+
+void OverlayRenderer::updateMetrics(float fps, float latency) {
+    char text[HUD_LINE_GLYPHS + 1];
+    std::snprintf(text, sizeof(text), "%.0f FPS  %.2f MS", fps, latency);
+    setHudLine(MetricsLine, text);
+}
+
+void OverlayRenderer::updateLatencyTail(float p99LatencyMs, uint64_t budgetViolations) {
+    char text[HUD_LINE_GLYPHS + 1];
+    std::snprintf(text, sizeof(text), "P99 %.2f MS  %llu OVER", p99LatencyMs,
+                  static_cast<unsigned long long>(budgetViolations));
+    setHudLine(LatencyLine, text);
+}
+
+// Only a change in what is shown marks the HUD dirty
+void OverlayRenderer::setHudLine(HudLine line, const char* text) {
+    if (m_hudLines[line] != text) {
+        m_hudLines[line] = text;
+        m_hudDirty = true;
+    }
+}
+
+void OverlayRenderer::updateTracks(const OverlayTrackBatch& batch) {
+    const auto same = [](const OverlayTrack& a, const OverlayTrack& b) {
+        return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height &&
+               a.confidence == b.confidence && a.card_id == b.card_id && a.coasting == b.coasting;
+    };
+    const uint32_t count = std::min(batch.count, core::constants::MAX_TRACKS);
+    if (count == m_tracks.count &&
+        std::equal(batch.tracks, batch.tracks + count, m_tracks.tracks, same)) {
+        return;
+    }
+
+    m_tracks.count = count;
+    std::copy_n(batch.tracks, count, m_tracks.tracks);
+    m_tracksDirty = true;
+}
+
+void OverlayRenderer::setFrameSize(uint32_t width, uint32_t height) {
+    if (width != m_frameWidth || height != m_frameHeight) {
+        m_frameWidth = width;
+        m_frameHeight = height;
+        m_redrawRequested = true;
+    }
+}
+
+// One glyph instance per character, one fixed-width slot range per line
+void OverlayRenderer::layoutHud() {
+    std::fill(m_hudInstances.begin(), m_hudInstances.end(), OverlayInstance{});
+    for (size_t line = 0; line < HUD_LINES; line++) {
+        const std::string& text = m_hudLines[line];
+        const float y = HUD_MARGIN + line * HUD_LINE_SPACING;
+        for (size_t i = 0; i < std::min(text.size(), HUD_LINE_GLYPHS); i++) {
+            const auto glyph = static_cast<unsigned char>(text[i]);
+            if (glyph <= ' ' || glyph >= 127) continue;  // Spaces and non-ASCII stay empty
+
+            OverlayInstance& instance = m_hudInstances[line * HUD_LINE_GLYPHS + i];
+            instance.x = HUD_MARGIN + i * GLYPH_WIDTH;
+            instance.y = y;
+            instance.width = GLYPH_WIDTH;
+            instance.height = GLYPH_HEIGHT;
+            instance.glyph = glyph;
+            instance.color = HUD_COLOR;
+        }
+    }
+}
+
+} // namespace ui
@@ -1,34 +1,85 @@
 #pragma once
 
+#include "overlay_scene.hpp"
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace ui {
 
+struct GlFunctions;
+
+// Click-through, capture-excluded topmost window drawn with OpenGL. The
+// whole overlay, card boxes, labels and HUD text, is one instanced draw
+// over one instance buffer: boxes and labels are expanded into it by CUDA
+// (OverlayScene), the HUD by the host. render() only draws when something
+// visible changed; otherwise the last presented frame stays on screen.
 class OverlayRenderer {
 public:
     OverlayRenderer();
     ~OverlayRenderer();
 
+    // Window, GL context and interop are bound to the calling thread
     bool initialize();
     void render();
     void shutdown();
-    
+
     void setTransparency(float alpha);
     void setVisible(bool visible);
-    
+
     // Update display information
     void updateCount(int runningCount, float trueCount);
     void updateAction(const std::string& action);
     void updateBet(double betAmount);
     void updateMetrics(float fps, float latency);
+    void updateLatencyTail(float p99LatencyMs, uint64_t budgetViolations);
+
+    // Tracked cards, in frame pixels; unchanged tracks do not redraw
+    void updateTracks(const OverlayTrackBatch& batch);
+    // Captured frame size, which boxes and the HUD are laid out in
+    void setFrameSize(uint32_t width, uint32_t height);
+
+    bool needsRedraw() const { return m_hudDirty || m_tracksDirty || m_redrawRequested; }
 
 private:
+    enum HudLine : size_t { CountLine, BetLine, ActionLine, MetricsLine, LatencyLine, HUD_LINES };
+    static constexpr size_t HUD_LINE_GLYPHS = HUD_INSTANCES / HUD_LINES;
+
     bool createOverlayWindow();
     bool initializeOpenGL();
-    
-    void* m_window{nullptr};
-    void* m_glContext{nullptr};
-    
+    bool createFontAtlas();
+    bool createDrawState();
+    void pumpMessages();
+    void setHudLine(HudLine line, const char* text);
+    void layoutHud();
+
+    void* m_window{nullptr};         // HWND
+    void* m_deviceContext{nullptr};  // HDC
+    void* m_glContext{nullptr};      // HGLRC
+    std::unique_ptr<GlFunctions> m_gl;
+
+    uint32_t m_program{0};
+    uint32_t m_vertexArray{0};
+    uint32_t m_instanceBuffer{0};  // MAX_OVERLAY_INSTANCES, HUD range first
+    uint32_t m_fontTexture{0};
+    int32_t m_viewportLocation{-1};
+    OverlayScene m_scene;
+
+    std::array<std::string, HUD_LINES> m_hudLines;
+    std::vector<OverlayInstance> m_hudInstances;  // HUD range, rebuilt when a line changes
+    OverlayTrackBatch m_tracks{};
+
+    uint32_t m_windowWidth{0};
+    uint32_t m_windowHeight{0};
+    uint32_t m_frameWidth{0};
+    uint32_t m_frameHeight{0};
+
+    bool m_hudDirty{true};
+    bool m_tracksDirty{false};
+    bool m_redrawRequested{true};  // Repaint, resize or re-show
+
     bool m_visible{true};
     float m_transparency{0.7f};
 };
@@ -0,0 +1,85 @@
+#include "overlay_scene.hpp"
+#include "../../utils/logger.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <cuda_gl_interop.h>
+
+namespace ui {
+
+OverlayScene::~OverlayScene() {
+    shutdown();
+}
+
+bool OverlayScene::initialize(uint32_t instanceBuffer) {
+    auto& logger = utils::Logger::getInstance();
+
+    // Write-discard: CUDA rewrites the track range wholesale and never reads it
+    cudaError_t status = cudaGraphicsGLRegisterBuffer(&m_resource, instanceBuffer,
+                                                      cudaGraphicsRegisterFlagsWriteDiscard);
+    if (status != cudaSuccess) {
+        logger.error("Failed to register overlay buffer with CUDA: {}", cudaGetErrorString(status));
+        m_resource = nullptr;
+        return false;
+    }
+
+    // Lowest priority: overlay work yields to every inference stream
+    int leastPriority = 0;
+    int greatestPriority = 0;
+    cudaDeviceGetStreamPriorityRange(&leastPriority, &greatestPriority);
+    status = cudaStreamCreateWithPriority(&m_stream, cudaStreamNonBlocking, leastPriority);
+    if (status != cudaSuccess) {
+        logger.error("Failed to create overlay stream: {}", cudaGetErrorString(status));
+        shutdown();
+        return false;
+    }
+
+    m_trackCount = 0;
+    return true;
+}
+
+void OverlayScene::shutdown() {
+    if (m_stream) {
+        cudaStreamSynchronize(m_stream);
+        cudaStreamDestroy(m_stream);
+        m_stream = nullptr;
+    }
+    if (m_resource) {
+        cudaGraphicsUnregisterResource(m_resource);
+        m_resource = nullptr;
+    }
+    m_trackCount = 0;
+}
+
+bool OverlayScene::updateTracks(const OverlayTrackBatch& batch) {
+    if (!m_resource) return false;
+
+    cudaError_t status = cudaGraphicsMapResources(1, &m_resource, m_stream);
+    if (status != cudaSuccess) {
+        utils::Logger::getInstance().error("Failed to map overlay buffer: {}", cudaGetErrorString(status));
+        return false;
+    }
+
+    void* mapped = nullptr;
+    size_t size = 0;
+    status = cudaGraphicsResourceGetMappedPointer(&mapped, &size, m_resource);
+    if (status == cudaSuccess && size < MAX_OVERLAY_INSTANCES * sizeof(OverlayInstance)) {
+        status = cudaErrorInvalidValue;
+    }
+    if (status == cudaSuccess) {
+        status = cuda::expandTracks(batch, static_cast<OverlayInstance*>(mapped) + HUD_INSTANCES, m_stream);
+    }
+
+    // Unmapping fences GL's next use of the buffer behind the kernel; the host never waits
+    cudaGraphicsUnmapResources(1, &m_resource, m_stream);
+
+    if (status != cudaSuccess) {
+        utils::Logger::getInstance().error("Failed to update overlay tracks: {}", cudaGetErrorString(status));
+        return false;
+    }
+    m_trackCount = batch.count;
+    return true;
+}
+
+} // namespace ui
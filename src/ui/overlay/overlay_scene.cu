@@ -0,0 +1,82 @@
+// CUDA overlay kernel (track table -> box and label instances)
+
+#include "overlay_scene.hpp"
+#include <cuda_runtime.h>
+#include <device_launch_parameters.h>
+
+namespace ui {
+namespace cuda {
+
+constexpr uint32_t EXPAND_THREADS = 128;
+constexpr uint32_t MATCHED_COLOR = 0xFF40FF40u;   // Green, opaque
+constexpr uint32_t COASTING_COLOR = 0xFF20B0FFu;  // Amber: predicted, not matched this frame
+constexpr float LABEL_GAP = 2.0f;                 // Pixels between label and box
+
+// Class id layout: suit * 13 + (rank - 1), suits in CardSuit order
+__constant__ char RANK_GLYPHS[] = "A23456789TJQK";
+__constant__ char SUIT_GLYPHS[] = "HDCS";
+
+// "<rank><suit> <confidence>%", left to right; 0 past the end
+__device__ uint32_t labelGlyph(const OverlayTrack& track, uint32_t index) {
+    const uint32_t percent = min(100u, static_cast<uint32_t>(track.confidence * 100.0f + 0.5f));
+    const uint32_t digits = percent >= 100 ? 3 : (percent >= 10 ? 2 : 1);
+
+    if (index == 0) return RANK_GLYPHS[track.card_id % 13];
+    if (index == 1) return SUIT_GLYPHS[(track.card_id / 13) & 3];
+    if (index == 2) return ' ';
+    if (index < 3 + digits) {
+        uint32_t value = percent;
+        for (uint32_t i = index - 3 + 1; i < digits; i++) value /= 10;
+        return '0' + value % 10;
+    }
+    if (index == 3 + digits) return '%';
+    return 0;
+}
+
+/**
+ * One thread per instance slot: slot 0 of each track is its box outline,
+ * the rest are its label glyphs, placed above the box (inside it when the
+ * box touches the top edge). Unused glyph slots get zero size.
+ */
+__global__ void expandKernel(const OverlayTrackBatch batch, OverlayInstance* __restrict__ instances) {
+    const uint32_t slot = blockIdx.x * blockDim.x + threadIdx.x;
+    if (slot >= batch.count * INSTANCES_PER_TRACK) return;
+
+    const OverlayTrack& track = batch.tracks[slot / INSTANCES_PER_TRACK];
+    const uint32_t part = slot % INSTANCES_PER_TRACK;
+    const uint32_t color = track.coasting ? COASTING_COLOR : MATCHED_COLOR;
+
+    OverlayInstance instance{};
+    instance.color = color;
+    if (part == 0) {
+        instance.x = track.x;
+        instance.y = track.y;
+        instance.width = track.width;
+        instance.height = track.height;
+        instance.glyph = BOX_GLYPH;
+    } else if (const uint32_t glyph = labelGlyph(track, part - 1); glyph != 0) {
+        const float above = track.y - GLYPH_HEIGHT - LABEL_GAP;
+        instance.x = track.x + (part - 1) * GLYPH_WIDTH;
+        instance.y = above >= 0.0f ? above : track.y + LABEL_GAP;
+        instance.width = GLYPH_WIDTH;
+        instance.height = GLYPH_HEIGHT;
+        instance.glyph = glyph;
+    }
+    instances[slot] = instance;
+}
+
+cudaError_t expandTracks(const OverlayTrackBatch& batch, OverlayInstance* instances, cudaStream_t stream) {
+    if (!instances || batch.count > core::constants::MAX_TRACKS) {
+        return cudaErrorInvalidValue;
+    }
+    if (batch.count == 0) return cudaSuccess;
+
+    const uint32_t slots = batch.count * INSTANCES_PER_TRACK;
+    expandKernel<<<(slots + EXPAND_THREADS - 1) / EXPAND_THREADS, EXPAND_THREADS, 0, stream>>>(
+        batch, instances);
+
+    return cudaGetLastError();
+}
+
+} // namespace cuda
+} // namespace ui
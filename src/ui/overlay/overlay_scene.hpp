@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../../core/constants.hpp"
+#include <cuda_runtime_api.h>
+#include <cstdint>
+#include <span>
+
+namespace ui {
+
+// One screen-space quad of the overlay. The vertex shader expands it from
+// gl_VertexID, so the instance buffer is the whole scene.
+struct OverlayInstance {
+    float x, y, width, height;  // Frame pixels; zero size draws nothing
+    uint32_t glyph;             // ASCII glyph from the font atlas, or BOX_GLYPH
+    uint32_t color;             // RGBA8, red in the low byte
+};
+
+constexpr uint32_t BOX_GLYPH = 0xFFFFFFFFu;  // Outline of the quad instead of a glyph
+
+// A tracked card as the overlay draws it
+struct OverlayTrack {
+    float x, y, width, height;  // Frame pixels
+    float confidence;
+    uint8_t card_id;
+    uint8_t coasting;           // Not matched this frame
+};
+
+// Tracks of one frame, passed to the expand kernel by value: the table
+// travels in the launch parameters, no staging buffer or copy
+struct OverlayTrackBatch {
+    uint32_t count;
+    OverlayTrack tracks[core::constants::MAX_TRACKS];
+};
+
+constexpr float GLYPH_WIDTH = 12.0f;   // Frame pixels per glyph
+constexpr float GLYPH_HEIGHT = 18.0f;
+constexpr uint32_t HUD_INSTANCES = 160;              // Host-written text, ahead of the tracks
+constexpr uint32_t LABEL_GLYPHS = 8;                 // "QS 100%" and padding
+constexpr uint32_t INSTANCES_PER_TRACK = 1 + LABEL_GLYPHS;
+constexpr uint32_t MAX_OVERLAY_INSTANCES = HUD_INSTANCES + core::constants::MAX_TRACKS * INSTANCES_PER_TRACK;
+
+// Card boxes and labels, written by CUDA straight into the GL instance
+// buffer through graphics interop. Call from the thread owning the GL
+// context; unmapping orders the kernel before the next GL draw.
+class OverlayScene {
+public:
+    OverlayScene() = default;
+    ~OverlayScene();
+
+    OverlayScene(const OverlayScene&) = delete;
+    OverlayScene& operator=(const OverlayScene&) = delete;
+
+    // instanceBuffer: GL buffer name holding MAX_OVERLAY_INSTANCES instances
+    bool initialize(uint32_t instanceBuffer);
+    void shutdown();
+
+    // Rewrites the track range of the buffer; the HUD range is left alone
+    bool updateTracks(const OverlayTrackBatch& batch);
+
+    // Instances to draw: the HUD range plus every track's box and label
+    uint32_t getInstanceCount() const { return HUD_INSTANCES + m_trackCount * INSTANCES_PER_TRACK; }
+
+private:
+    cudaGraphicsResource_t m_resource{nullptr};
+    cudaStream_t m_stream{nullptr};
+    uint32_t m_trackCount{0};
+};
+
+namespace cuda {
+
+// Box plus label glyphs per track, INSTANCES_PER_TRACK apart from `instances`
+cudaError_t expandTracks(const OverlayTrackBatch& batch, OverlayInstance* instances, cudaStream_t stream);
+
+} // namespace cuda
+} // namespace ui
@@ -0,0 +1,253 @@
+#include "cpu_topology.hpp"
+#include <algorithm>
+#include <map>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fstream>
+#endif
+
+namespace utils {
+
+namespace {
+
+#ifndef _WIN32
+constexpr const char* SYSFS_CPU = "/sys/devices/system/cpu";
+constexpr const char* SYSFS_ATOM_CPUS = "/sys/devices/cpu_atom/cpus";  // Intel hybrid E-cores
+constexpr uint32_t MAX_CACHE_INDEX = 8;
+
+bool readLine(const std::string& path, std::string& line) {
+    std::ifstream file(path);
+    return file && std::getline(file, line) && !line.empty();
+}
+
+bool readNumber(const std::string& path, uint32_t& value) {
+    std::string line;
+    if (!readLine(path, line)) return false;
+    try {
+        value = static_cast<uint32_t>(std::stoul(line));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+// Inverse of formatCpuList; malformed ranges are skipped
+std::vector<uint32_t> parseCpuList(const std::string& list) {
+    std::vector<uint32_t> ids;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        const size_t comma = std::min(list.find(',', pos), list.size());
+        const std::string range = list.substr(pos, comma - pos);
+        pos = comma + 1;
+
+        const size_t dash = range.find('-');
+        try {
+            const uint32_t first = static_cast<uint32_t>(std::stoul(range.substr(0, dash)));
+            const uint32_t last = dash == std::string::npos
+                ? first : static_cast<uint32_t>(std::stoul(range.substr(dash + 1)));
+            for (uint32_t id = first; id <= last; id++) ids.push_back(id);
+        } catch (const std::exception&) {
+        }
+    }
+    return ids;
+}
+#endif
+
+// Dense indices in order of first appearance
+uint32_t indexOf(std::map<uint64_t, uint32_t>& indices, uint64_t key) {
+    return indices.try_emplace(key, static_cast<uint32_t>(indices.size())).first->second;
+}
+
+// Raw per-CPU keys, before they are renumbered densely
+struct RawCpu {
+    uint32_t id;
+    uint64_t coreKey;
+    uint64_t domainKey;
+    bool efficiency;
+};
+
+CpuTopology finish(std::vector<RawCpu> raw) {
+    std::sort(raw.begin(), raw.end(), [](const RawCpu& a, const RawCpu& b) { return a.id < b.id; });
+
+    CpuTopology topology;
+    std::map<uint64_t, uint32_t> cores;
+    std::map<uint64_t, uint32_t> domains;
+    for (const auto& cpu : raw) {
+        LogicalCpu logical;
+        logical.id = cpu.id;
+        const size_t coresBefore = cores.size();
+        logical.core = indexOf(cores, cpu.coreKey);
+        logical.primaryThread = cores.size() != coresBefore;  // Sorted by id: first seen is lowest
+        logical.cacheDomain = indexOf(domains, cpu.domainKey);
+        logical.coreClass = cpu.efficiency ? CoreClass::Efficiency : CoreClass::Performance;
+        topology.hybrid |= cpu.efficiency;
+        topology.cpus.push_back(logical);
+    }
+    topology.coreCount = static_cast<uint32_t>(cores.size());
+    topology.cacheDomainCount = static_cast<uint32_t>(domains.size());
+    return topology;
+}
+
+std::vector<RawCpu> detectFallback() {
+    std::vector<RawCpu> raw;
+    const uint32_t count = std::max(1u, std::thread::hardware_concurrency());
+    for (uint32_t id = 0; id < count; id++) {
+        raw.push_back({id, id, 0, false});
+    }
+    return raw;
+}
+
+#ifdef _WIN32
+std::vector<RawCpu> detectPlatform() {
+    DWORD length = 0;
+    GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+    std::vector<uint8_t> buffer(length);
+    if (length == 0 ||
+        !GetLogicalProcessorInformationEx(RelationAll,
+            reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data()), &length)) {
+        return {};
+    }
+
+    struct Core { KAFFINITY mask; BYTE efficiencyClass; };
+    std::vector<Core> cores;
+    std::vector<KAFFINITY> domains;
+    BYTE maxClass = 0;
+    for (DWORD offset = 0; offset < length;) {
+        const auto* entry = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(
+            buffer.data() + offset);
+        offset += entry->Size;
+
+        if (entry->Relationship == RelationProcessorCore) {
+            const auto& processor = entry->Processor;
+            // Only group 0 is addressable through SetThreadAffinityMask
+            if (processor.GroupMask[0].Group != 0) continue;
+            cores.push_back({processor.GroupMask[0].Mask, processor.EfficiencyClass});
+            maxClass = std::max(maxClass, processor.EfficiencyClass);
+        } else if (entry->Relationship == RelationCache && entry->Cache.Level == 3 &&
+                   entry->Cache.GroupMask.Group == 0) {
+            domains.push_back(entry->Cache.GroupMask.Mask);
+        }
+    }
+
+    // EfficiencyClass is higher for faster cores and all zero on non-hybrid parts
+    std::vector<RawCpu> raw;
+    for (size_t core = 0; core < cores.size(); core++) {
+        for (uint32_t id = 0; id < 64; id++) {
+            const KAFFINITY bit = KAFFINITY{1} << id;
+            if (!(cores[core].mask & bit)) continue;
+
+            uint64_t domain = 0;
+            for (size_t i = 0; i < domains.size(); i++) {
+                if (domains[i] & bit) domain = i;
+            }
+            raw.push_back({id, core, domain, cores[core].efficiencyClass < maxClass});
+        }
+    }
+    return raw;
+}
+#else
+std::vector<RawCpu> detectPlatform() {
+    std::string online;
+    if (!readLine(std::string(SYSFS_CPU) + "/online", online)) return {};
+
+    std::vector<uint32_t> efficiency;
+    if (std::string atom; readLine(SYSFS_ATOM_CPUS, atom)) {
+        efficiency = parseCpuList(atom);
+    }
+
+    std::vector<RawCpu> raw;
+    std::vector<uint32_t> capacities;
+    for (const uint32_t id : parseCpuList(online)) {
+        const std::string base = std::string(SYSFS_CPU) + "/cpu" + std::to_string(id);
+
+        uint32_t package = 0;
+        uint32_t core = id;
+        readNumber(base + "/topology/physical_package_id", package);
+        readNumber(base + "/topology/core_id", core);
+
+        // Domain keyed by the lowest CPU sharing the L3; no L3 reported means one domain
+        uint64_t domain = 0;
+        for (uint32_t index = 0; index < MAX_CACHE_INDEX; index++) {
+            const std::string cache = base + "/cache/index" + std::to_string(index);
+            uint32_t level = 0;
+            std::string shared;
+            if (!readNumber(cache + "/level", level)) break;
+            if (level == 3 && readLine(cache + "/shared_cpu_list", shared)) {
+                const auto sharing = parseCpuList(shared);
+                if (!sharing.empty()) domain = sharing.front();
+                break;
+            }
+        }
+
+        const bool isAtom = std::find(efficiency.begin(), efficiency.end(), id) != efficiency.end();
+        raw.push_back({id, (uint64_t{package} << 32) | core, domain, isAtom});
+
+        uint32_t capacity = 0;
+        capacities.push_back(readNumber(base + "/cpu_capacity", capacity) ? capacity : 0);
+    }
+
+    // Big.LITTLE without the Intel PMU split: lower capacity means a LITTLE core
+    if (efficiency.empty() && !capacities.empty()) {
+        const uint32_t maxCapacity = *std::max_element(capacities.begin(), capacities.end());
+        for (size_t i = 0; i < raw.size(); i++) {
+            raw[i].efficiency = capacities[i] != 0 && capacities[i] < maxCapacity;
+        }
+    }
+    return raw;
+}
+#endif
+
+} // anonymous namespace
+
+CpuTopology CpuTopology::detect() {
+    std::vector<RawCpu> raw = detectPlatform();
+    if (raw.empty()) {
+        raw = detectFallback();
+    }
+    return finish(std::move(raw));
+}
+
+const LogicalCpu* CpuTopology::find(uint32_t id) const {
+    const auto it = std::lower_bound(cpus.begin(), cpus.end(), id,
+                                     [](const LogicalCpu& cpu, uint32_t value) { return cpu.id < value; });
+    return it != cpus.end() && it->id == id ? &*it : nullptr;
+}
+
+std::string CpuTopology::describe() const {
+    uint32_t efficiencyCores = 0;
+    for (const auto& cpu : cpus) {
+        if (cpu.primaryThread && cpu.coreClass == CoreClass::Efficiency) efficiencyCores++;
+    }
+
+    std::string text = std::to_string(cpus.size()) + " logical CPUs, " + std::to_string(coreCount) + " cores";
+    if (hybrid) {
+        text += " (" + std::to_string(coreCount - efficiencyCores) + "P + " +
+                std::to_string(efficiencyCores) + "E)";
+    }
+    text += ", " + std::to_string(cacheDomainCount) + (cacheDomainCount == 1 ? " L3 domain" : " L3 domains");
+    return text;
+}
+
+std::string formatCpuList(std::span<const uint32_t> ids) {
+    std::vector<uint32_t> sorted(ids.begin(), ids.end());
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    std::string text;
+    for (size_t i = 0; i < sorted.size();) {
+        size_t last = i;
+        while (last + 1 < sorted.size() && sorted[last + 1] == sorted[last] + 1) last++;
+
+        if (!text.empty()) text += ',';
+        text += std::to_string(sorted[i]);
+        if (last > i) text += '-' + std::to_string(sorted[last]);
+        i = last + 1;
+    }
+    return text;
+}
+
+} // namespace utils
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace utils {
+
+enum class CoreClass : uint8_t {
+    Performance,  // P-core, or any core of a non-hybrid CPU
+    Efficiency    // E-core (Intel hybrid) or LITTLE core
+};
+
+// One logical processor, i.e. one hardware thread
+struct LogicalCpu {
+    uint32_t id{0};            // OS processor number, as affinity masks use it
+    uint32_t core{0};          // Physical core; SMT siblings share it
+    uint32_t cacheDomain{0};   // Shared L3: one Ryzen CCX, or the whole ring on Intel
+    CoreClass coreClass{CoreClass::Performance};
+    bool primaryThread{true};  // Lowest-numbered hardware thread of its core
+};
+
+// Cores, SMT siblings, L3 domains and P/E classes of the machine. Linux
+// reads sysfs, Windows GetLogicalProcessorInformationEx (processor group 0
+// only, which is what thread affinity masks address). Anything not
+// reported degrades to one core per CPU in a single domain.
+struct CpuTopology {
+    std::vector<LogicalCpu> cpus;  // Sorted by id
+    uint32_t coreCount{0};
+    uint32_t cacheDomainCount{0};
+    bool hybrid{false};
+
+    static CpuTopology detect();
+
+    const LogicalCpu* find(uint32_t id) const;
+    std::string describe() const;  // One line for the startup log
+};
+
+// "0-3,8,10-11", the sysfs cpulist notation
+std::string formatCpuList(std::span<const uint32_t> ids);
+
+} // namespace utils
@@ -0,0 +1,71 @@
+#include "file_watcher.hpp"
+#include "logger.hpp"
+
+namespace utils {
+
+FileWatcher::~FileWatcher() {
+    stop();
+}
+
+bool FileWatcher::start(const std::string& path, std::chrono::milliseconds interval, Callback callback) {
+    if (isRunning() || interval.count() <= 0 || !callback) {
+        return false;
+    }
+
+    m_path = path;
+    m_interval = interval;
+    m_callback = std::move(callback);
+    m_stopping = false;
+    m_thread = std::thread(&FileWatcher::watchLoop, this);
+
+    Logger::getInstance().info("Watching {} every {} ms", m_path, m_interval.count());
+    return true;
+}
+
+void FileWatcher::stop() {
+    if (!isRunning()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+FileWatcher::FileState FileWatcher::probe() const {
+    FileState state;
+    std::error_code error;
+    state.modified = std::filesystem::last_write_time(m_path, error);
+    if (error) return state;
+    state.size = std::filesystem::file_size(m_path, error);
+    state.exists = !error;
+    return state;
+}
+
+void FileWatcher::watchLoop() {
+    FileState reported = probe();
+    FileState pending = reported;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_wake.wait_for(lock, m_interval, [this] { return m_stopping; })) {
+        const FileState current = probe();
+        if (current == reported) {
+            pending = current;
+            continue;
+        }
+        // Still being written: wait until it holds for a whole interval
+        if (current != pending) {
+            pending = current;
+            continue;
+        }
+
+        reported = current;
+        if (!current.exists) continue;  // Deleted mid-save; the rewrite is the change
+
+        lock.unlock();
+        m_callback();
+        lock.lock();
+    }
+}
+
+} // namespace utils
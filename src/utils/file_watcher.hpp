@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace utils {
+
+// Calls back on its own thread when a file's modification time or size
+// changes. Polled rather than OS notifications: one stat per interval,
+// identical on every platform, and it survives editors that save by
+// replacing the file. A change is reported once it has held for a full
+// interval, so a truncate-then-write save is seen as one complete change.
+class FileWatcher {
+public:
+    using Callback = std::function<void()>;
+
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool start(const std::string& path, std::chrono::milliseconds interval, Callback callback);
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+private:
+    struct FileState {
+        std::filesystem::file_time_type modified{};
+        uintmax_t size{0};
+        bool exists{false};
+
+        bool operator==(const FileState&) const = default;
+    };
+
+    FileState probe() const;
+    void watchLoop();
+
+    std::string m_path;
+    std::chrono::milliseconds m_interval{0};
+    Callback m_callback;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;  // Cuts the poll sleep short on stop()
+    bool m_stopping{false};
+};
+
+} // namespace utils
@@ -0,0 +1,262 @@
+#include "gpu_memory_pool.hpp"
+#include "logger.hpp"
+#include <algorithm>
+
+namespace utils {
+
+namespace {
+
+constexpr size_t PITCH_ALIGNMENT = 512;  // Covers texture pitch alignment on every supported GPU
+constexpr size_t HOST_REUSE_FACTOR = 2;  // A cached block serves requests down to half its size
+constexpr double MB = 1024.0 * 1024.0;
+
+} // namespace
+
+const char* memoryTagName(MemoryTag tag) {
+    switch (tag) {
+        case MemoryTag::Capture: return "capture";
+        case MemoryTag::Frames: return "frames";
+        case MemoryTag::Preprocess: return "preprocess";
+        case MemoryTag::Inference: return "inference";
+        case MemoryTag::TensorRT: return "tensorrt";
+        case MemoryTag::Postprocess: return "postprocess";
+        case MemoryTag::Other: return "other";
+        case MemoryTag::Count: break;
+    }
+    return "unknown";
+}
+
+GpuMemoryPool& GpuMemoryPool::getInstance() {
+    static GpuMemoryPool instance;
+    return instance;
+}
+
+// Process exit tears down the CUDA context, and the pool with it
+GpuMemoryPool::~GpuMemoryPool() {
+}
+
+bool GpuMemoryPool::initialize(int device, size_t reserveBytes, size_t limitBytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_initialized) {
+        Logger::getInstance().warning("GPU memory pool already initialized");
+        return true;
+    }
+    return createPool(device, reserveBytes, limitBytes);
+}
+
+bool GpuMemoryPool::createPool(int device, size_t reserveBytes, size_t limitBytes) {
+    auto& logger = Logger::getInstance();
+
+    cudaMemPoolProps props{};
+    props.allocType = cudaMemAllocationTypePinned;
+    props.handleTypes = cudaMemHandleTypeNone;
+    props.location.type = cudaMemLocationTypeDevice;
+    props.location.id = device;
+
+    cudaError_t status = cudaMemPoolCreate(&m_pool, &props);
+    if (status == cudaSuccess) {
+        // Memory below the threshold stays in the pool across frees and syncs
+        uint64_t threshold = reserveBytes;
+        status = cudaMemPoolSetAttribute(m_pool, cudaMemPoolAttrReleaseThreshold, &threshold);
+    }
+    if (status == cudaSuccess) {
+        status = cudaStreamCreateWithFlags(&m_stream, cudaStreamNonBlocking);
+    }
+
+    // Fault the reserve in now, so no allocation up to it reaches the driver
+    if (status == cudaSuccess && reserveBytes > 0) {
+        void* reserve = nullptr;
+        status = cudaMallocFromPoolAsync(&reserve, reserveBytes, m_pool, m_stream);
+        if (status == cudaSuccess) {
+            status = cudaFreeAsync(reserve, m_stream);
+        }
+        if (status == cudaSuccess) {
+            status = cudaStreamSynchronize(m_stream);
+        }
+    }
+
+    if (status != cudaSuccess) {
+        logger.error("Failed to create the GPU memory pool: {}", cudaGetErrorString(status));
+        if (m_stream) cudaStreamDestroy(m_stream);
+        if (m_pool) cudaMemPoolDestroy(m_pool);
+        m_stream = nullptr;
+        m_pool = nullptr;
+        return false;
+    }
+
+    m_device = device;
+    m_reserveBytes = reserveBytes;
+    m_limitBytes = limitBytes;
+    m_initialized = true;
+
+    logger.info("GPU memory pool on device {}: {:.0f} MB reserved, {:.0f} MB limit", device,
+                reserveBytes / MB, limitBytes / MB);
+    return true;
+}
+
+void* GpuMemoryPool::allocate(size_t bytes, MemoryTag tag, cudaStream_t stream) {
+    auto& logger = Logger::getInstance();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_initialized) {
+        int device = 0;
+        cudaGetDevice(&device);
+        if (!createPool(device, 0, 0)) return nullptr;
+    }
+
+    if (m_limitBytes > 0 && m_deviceBytes + bytes > m_limitBytes) {
+        logger.error("GPU memory limit: {} needs {:.1f} MB, {:.1f} of {:.1f} MB in use",
+                     memoryTagName(tag), bytes / MB, m_deviceBytes / MB, m_limitBytes / MB);
+        return nullptr;
+    }
+
+    void* ptr = nullptr;
+    cudaError_t status = cudaMallocFromPoolAsync(&ptr, bytes, m_pool, stream ? stream : m_stream);
+    if (status == cudaSuccess && !stream) {
+        status = cudaStreamSynchronize(m_stream);
+    }
+    if (status != cudaSuccess) {
+        logger.error("Failed to allocate {:.1f} MB for {}: {}", bytes / MB, memoryTagName(tag),
+                     cudaGetErrorString(status));
+        return nullptr;
+    }
+
+    m_deviceBlocks[ptr] = {bytes, tag};
+    m_deviceBytes += bytes;
+    charge(m_deviceUsage, tag, bytes);
+    return ptr;
+}
+
+void* GpuMemoryPool::allocatePitch(size_t widthBytes, size_t height, size_t& pitch, MemoryTag tag) {
+    pitch = (widthBytes + PITCH_ALIGNMENT - 1) / PITCH_ALIGNMENT * PITCH_ALIGNMENT;
+    return allocate(pitch * height, tag);
+}
+
+void GpuMemoryPool::release(void* ptr, cudaStream_t stream) {
+    if (!ptr) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_deviceBlocks.find(ptr);
+        if (it == m_deviceBlocks.end()) {
+            Logger::getInstance().error("Release of a device pointer the pool did not allocate");
+            return;
+        }
+        m_deviceBytes -= it->second.bytes;
+        m_deviceUsage[static_cast<size_t>(it->second.tag)].bytes -= it->second.bytes;
+        m_deviceBlocks.erase(it);
+    }
+
+    // Frees never wait under the lock: other threads keep allocating meanwhile
+    if (stream) {
+        cudaFreeAsync(ptr, stream);
+    } else {
+        cudaDeviceSynchronize();
+        cudaFreeAsync(ptr, m_stream);
+        cudaStreamSynchronize(m_stream);
+    }
+}
+
+void* GpuMemoryPool::allocateHost(size_t bytes, MemoryTag tag) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    void* ptr = nullptr;
+    size_t blockBytes = bytes;
+
+    auto cached = m_hostCache.lower_bound(bytes);
+    if (cached != m_hostCache.end() && cached->first <= bytes * HOST_REUSE_FACTOR) {
+        blockBytes = cached->first;
+        ptr = cached->second;
+        m_hostCache.erase(cached);
+    } else {
+        const cudaError_t status = cudaMallocHost(&ptr, bytes);
+        if (status != cudaSuccess) {
+            Logger::getInstance().error("Failed to allocate {:.1f} MB pinned for {}: {}", bytes / MB,
+                                        memoryTagName(tag), cudaGetErrorString(status));
+            return nullptr;
+        }
+    }
+
+    m_hostBlocks[ptr] = {blockBytes, tag};
+    charge(m_hostUsage, tag, blockBytes);
+    return ptr;
+}
+
+void GpuMemoryPool::releaseHost(void* ptr) {
+    if (!ptr) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_hostBlocks.find(ptr);
+    if (it == m_hostBlocks.end()) {
+        Logger::getInstance().error("Release of a host pointer the pool did not allocate");
+        return;
+    }
+    m_hostUsage[static_cast<size_t>(it->second.tag)].bytes -= it->second.bytes;
+    m_hostCache.emplace(it->second.bytes, ptr);
+    m_hostBlocks.erase(it);
+}
+
+void GpuMemoryPool::markSteadyState() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_steadyState = true;
+}
+
+void GpuMemoryPool::trim() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (const auto& [bytes, ptr] : m_hostCache) {
+        cudaFreeHost(ptr);
+    }
+    m_hostCache.clear();
+
+    if (m_pool) {
+        cudaMemPoolTrimTo(m_pool, m_reserveBytes);
+    }
+}
+
+void GpuMemoryPool::charge(std::array<MemoryUsage, MEMORY_TAG_COUNT>& usage, MemoryTag tag, size_t bytes) {
+    auto& entry = usage[static_cast<size_t>(tag)];
+    entry.bytes += bytes;
+    entry.peakBytes = std::max(entry.peakBytes, entry.bytes);
+    entry.allocations++;
+
+    if (m_steadyState) {
+        m_lateAllocations++;
+        Logger::getInstance().debug("Allocation after warmup: {:.2f} MB for {}", bytes / MB,
+                                    memoryTagName(tag));
+    }
+}
+
+MemoryUsage GpuMemoryPool::getUsage(MemoryTag tag) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_deviceUsage[static_cast<size_t>(tag)];
+}
+
+MemoryUsage GpuMemoryPool::getHostUsage(MemoryTag tag) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hostUsage[static_cast<size_t>(tag)];
+}
+
+uint64_t GpuMemoryPool::getLateAllocations() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lateAllocations;
+}
+
+void GpuMemoryPool::logUsage() const {
+    auto& logger = Logger::getInstance();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (size_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+        const auto& device = m_deviceUsage[i];
+        const auto& host = m_hostUsage[i];
+        if (device.allocations == 0 && host.allocations == 0) continue;
+
+        logger.info("Memory {}: device {:.1f} MB (peak {:.1f}), pinned {:.1f} MB (peak {:.1f})",
+                    memoryTagName(static_cast<MemoryTag>(i)), device.bytes / MB, device.peakBytes / MB,
+                    host.bytes / MB, host.peakBytes / MB);
+    }
+    logger.info("Memory total: {:.1f} MB device of {:.0f} MB reserved, {} allocations after warmup",
+                m_deviceBytes / MB, m_reserveBytes / MB, m_lateAllocations);
+}
+
+} // namespace utils
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cuda_runtime_api.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace utils {
+
+// Subsystem an allocation is charged to
+enum class MemoryTag : uint8_t {
+    Capture,      // Backend staging surfaces
+    Frames,       // Frame ring slots
+    Preprocess,   // Upload buffers, motion gate
+    Inference,    // Engine I/O tensors and staging
+    TensorRT,     // Engine weights, activations and workspace (IGpuAllocator)
+    Postprocess,  // Decode / NMS scratch
+    Other,
+    Count
+};
+
+constexpr size_t MEMORY_TAG_COUNT = static_cast<size_t>(MemoryTag::Count);
+
+const char* memoryTagName(MemoryTag tag);
+
+struct MemoryUsage {
+    uint64_t bytes{0};        // Live
+    uint64_t peakBytes{0};
+    uint64_t allocations{0};  // Total calls
+};
+
+/**
+ * Process-wide device and pinned-host arena. Device memory comes from a
+ * cudaMallocAsync pool that reserves memory_pool_size_mb up front and that
+ * reserve is never returned to the driver (the release threshold), so
+ * freeing and re-allocating on an engine or resolution switch does not
+ * touch the driver. Pinned host blocks are cached on release and handed
+ * out again to requests of a similar size.
+ *
+ * Every allocation is charged to a MemoryTag. Allocations made after
+ * markSteadyState() are counted as late: after warmup there should be none.
+ */
+class GpuMemoryPool {
+public:
+    static GpuMemoryPool& getInstance();
+
+    GpuMemoryPool(const GpuMemoryPool&) = delete;
+    GpuMemoryPool& operator=(const GpuMemoryPool&) = delete;
+
+    // Creates the pool on device. Without a call, the first allocation
+    // creates one on the current device with no reserve.
+    bool initialize(int device, size_t reserveBytes, size_t limitBytes);
+
+    // Device memory. With a null stream the block is usable from any stream
+    // on return, and release() waits for the device before freeing it
+    // (cudaFree semantics, teardown only); with a stream both are ordered on
+    // that stream and nothing blocks. release() never waits under the pool lock.
+    // Buffers a single stream uses are best released on it: each null-stream
+    // release waits for the whole device.
+    void* allocate(size_t bytes, MemoryTag tag, cudaStream_t stream = nullptr);
+    void* allocatePitch(size_t widthBytes, size_t height, size_t& pitch, MemoryTag tag);
+    void release(void* ptr, cudaStream_t stream = nullptr);
+
+    // Pinned host memory
+    void* allocateHost(size_t bytes, MemoryTag tag);
+    void releaseHost(void* ptr);
+
+    // Allocations from now on are late
+    void markSteadyState();
+
+    // Return cached host blocks and device memory above the reserve
+    void trim();
+
+    MemoryUsage getUsage(MemoryTag tag) const;
+    MemoryUsage getHostUsage(MemoryTag tag) const;
+    uint64_t getLateAllocations() const;
+    void logUsage() const;
+
+private:
+    GpuMemoryPool() = default;
+    ~GpuMemoryPool();
+
+    struct Block {
+        size_t bytes;
+        MemoryTag tag;
+    };
+
+    bool createPool(int device, size_t reserveBytes, size_t limitBytes);
+    void charge(std::array<MemoryUsage, MEMORY_TAG_COUNT>& usage, MemoryTag tag, size_t bytes);
+
+    mutable std::mutex m_mutex;
+    bool m_initialized{false};
+    int m_device{0};
+    cudaMemPool_t m_pool{nullptr};
+    cudaStream_t m_stream{nullptr};  // Orders allocations made without a stream
+    size_t m_reserveBytes{0};
+    size_t m_limitBytes{0};
+    uint64_t m_deviceBytes{0};
+
+    std::unordered_map<void*, Block> m_deviceBlocks;
+    std::unordered_map<void*, Block> m_hostBlocks;
+    std::multimap<size_t, void*> m_hostCache;  // Released pinned blocks by size
+
+    std::array<MemoryUsage, MEMORY_TAG_COUNT> m_deviceUsage{};
+    std::array<MemoryUsage, MEMORY_TAG_COUNT> m_hostUsage{};
+    bool m_steadyState{false};
+    uint64_t m_lateAllocations{0};
+};
+
+} // namespace utils
@@ -0,0 +1,285 @@
+#include "json.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+
+namespace utils {
+
+namespace {
+
+constexpr uint32_t MAX_DEPTH = 64;  // Nesting deeper than any config, bounds the recursion
+
+// Recursive descent over one document; the first error stops the parse
+class JsonParser {
+public:
+    explicit JsonParser(std::string_view text) : m_text(text) {
+        // Windows editors like to prepend a byte order mark
+        if (m_text.substr(0, 3) == "\xEF\xBB\xBF") m_pos = 3;
+    }
+
+    bool parseDocument(JsonValue& out) {
+        skipWhitespace();
+        if (!parseValue(out, 0)) return false;
+        skipWhitespace();
+        return m_pos == m_text.size() || fail("trailing characters after the document");
+    }
+
+    // "line L, column C: reason" for the failure position
+    std::string error() const {
+        const std::string_view before = m_text.substr(0, m_errorPos);
+        const size_t line = 1 + static_cast<size_t>(std::count(before.begin(), before.end(), '\n'));
+        const size_t lineStart = before.rfind('\n');
+        const size_t column = m_errorPos - (lineStart == std::string_view::npos ? 0 : lineStart + 1) + 1;
+        return "line " + std::to_string(line) + ", column " + std::to_string(column) + ": " + m_error;
+    }
+
+private:
+    bool fail(const char* reason) {
+        m_error = reason;
+        m_errorPos = std::min(m_pos, m_text.size());
+        return false;
+    }
+
+    bool atEnd() const { return m_pos >= m_text.size(); }
+    char peek() const { return atEnd() ? '\0' : m_text[m_pos]; }
+
+    void skipWhitespace() {
+        while (!atEnd() && (peek() == ' ' || peek() == '\t' || peek() == '\n' || peek() == '\r')) {
+            m_pos++;
+        }
+    }
+
+    bool consume(char expected) {
+        if (peek() != expected) return false;
+        m_pos++;
+        return true;
+    }
+
+    bool parseValue(JsonValue& out, uint32_t depth) {
+        if (depth > MAX_DEPTH) return fail("nesting too deep");
+
+        switch (peek()) {
+            case '{': return parseObject(out, depth);
+            case '[': return parseArray(out, depth);
+            case '"': {
+                std::string value;
+                if (!parseString(value)) return false;
+                out = JsonValue(std::move(value));
+                return true;
+            }
+            case 't': return parseLiteral("true", JsonValue(true), out);
+            case 'f': return parseLiteral("false", JsonValue(false), out);
+            case 'n': return parseLiteral("null", JsonValue(), out);
+            default: break;
+        }
+        if (peek() == '-' || (peek() >= '0' && peek() <= '9')) {
+            return parseNumber(out);
+        }
+        return fail(atEnd() ? "unexpected end of input" : "unexpected character");
+    }
+
+    bool parseLiteral(std::string_view literal, JsonValue value, JsonValue& out) {
+        if (m_text.substr(m_pos, literal.size()) != literal) return fail("invalid literal");
+        m_pos += literal.size();
+        out = std::move(value);
+        return true;
+    }
+
+    bool parseObject(JsonValue& out, uint32_t depth) {
+        m_pos++;  // '{'
+        JsonValue::Object members;
+
+        skipWhitespace();
+        if (!consume('}')) {
+            for (;;) {
+                skipWhitespace();
+                if (peek() != '"') return fail("expected a member name");
+                std::string key;
+                if (!parseString(key)) return false;
+
+                skipWhitespace();
+                if (!consume(':')) return fail("expected ':' after the member name");
+                skipWhitespace();
+                JsonValue value;
+                if (!parseValue(value, depth + 1)) return false;
+                members.emplace_back(std::move(key), std::move(value));
+
+                skipWhitespace();
+                if (consume('}')) break;
+                if (!consume(',')) return fail("expected ',' or '}' in object");
+            }
+        }
+
+        out = JsonValue(std::move(members));
+        return true;
+    }
+
+    bool parseArray(JsonValue& out, uint32_t depth) {
+        m_pos++;  // '['
+        JsonValue::Array elements;
+
+        skipWhitespace();
+        if (!consume(']')) {
+            for (;;) {
+                skipWhitespace();
+                JsonValue value;
+                if (!parseValue(value, depth + 1)) return false;
+                elements.push_back(std::move(value));
+
+                skipWhitespace();
+                if (consume(']')) break;
+                if (!consume(',')) return fail("expected ',' or ']' in array");
+            }
+        }
+
+        out = JsonValue(std::move(elements));
+        return true;
+    }
+
+    bool parseNumber(JsonValue& out) {
+        const size_t start = m_pos;
+        auto digits = [this] {
+            const size_t first = m_pos;
+            while (peek() >= '0' && peek() <= '9') m_pos++;
+            return m_pos > first;
+        };
+
+        consume('-');
+        if (!consume('0') && !digits()) return fail("invalid number");
+        if (consume('.') && !digits()) return fail("expected digits after the decimal point");
+        if (consume('e') || consume('E')) {
+            if (!consume('+')) consume('-');
+            if (!digits()) return fail("expected digits in the exponent");
+        }
+
+        double value = 0.0;
+        const auto result = std::from_chars(m_text.data() + start, m_text.data() + m_pos, value);
+        if (result.ec != std::errc{}) {
+            m_pos = start;
+            return fail("number out of range");
+        }
+        out = JsonValue(value);
+        return true;
+    }
+
+    bool parseHex4(uint32_t& value) {
+        if (m_text.size() - m_pos < 4) return fail("truncated \\u escape");
+        value = 0;
+        for (int i = 0; i < 4; i++) {
+            const char c = m_text[m_pos++];
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') value |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') value |= static_cast<uint32_t>(c - 'A' + 10);
+            else return fail("invalid \\u escape");
+        }
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t codepoint) {
+        if (codepoint < 0x80) {
+            out += static_cast<char>(codepoint);
+        } else if (codepoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codepoint >> 6));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        } else if (codepoint < 0x10000) {
+            out += static_cast<char>(0xE0 | (codepoint >> 12));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (codepoint >> 18));
+            out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+    }
+
+    bool parseString(std::string& out) {
+        m_pos++;  // '"'
+        for (;;) {
+            if (atEnd()) return fail("unterminated string");
+            const char c = m_text[m_pos++];
+            if (c == '"') return true;
+            if (static_cast<unsigned char>(c) < 0x20) {
+                m_pos--;
+                return fail("control character in string");
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+
+            if (atEnd()) return fail("unterminated string");
+            switch (m_text[m_pos++]) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t codepoint = 0;
+                    if (!parseHex4(codepoint)) return false;
+                    // Characters outside the BMP arrive as a surrogate pair
+                    if (codepoint >= 0xD800 && codepoint < 0xDC00) {
+                        uint32_t low = 0;
+                        if (!consume('\\') || !consume('u') || !parseHex4(low) ||
+                            low < 0xDC00 || low >= 0xE000) {
+                            return fail("unpaired surrogate in \\u escape");
+                        }
+                        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    } else if (codepoint >= 0xDC00 && codepoint < 0xE000) {
+                        return fail("unpaired surrogate in \\u escape");
+                    }
+                    appendUtf8(out, codepoint);
+                    break;
+                }
+                default:
+                    m_pos--;
+                    return fail("invalid escape");
+            }
+        }
+    }
+
+    std::string_view m_text;
+    size_t m_pos{0};
+    std::string m_error;
+    size_t m_errorPos{0};
+};
+
+} // namespace
+
+bool JsonValue::parse(std::string_view text, JsonValue& out, std::string& error) {
+    JsonParser parser(text);
+    JsonValue value;
+    if (!parser.parseDocument(value)) {
+        error = parser.error();
+        return false;
+    }
+    out = std::move(value);
+    return true;
+}
+
+const JsonValue* JsonValue::find(std::string_view key) const {
+    if (!isObject()) return nullptr;
+    for (const auto& [name, value] : asObject()) {
+        if (name == key) return &value;
+    }
+    return nullptr;
+}
+
+const char* jsonTypeName(JsonValue::Type type) {
+    switch (type) {
+        case JsonValue::Type::Null: return "null";
+        case JsonValue::Type::Bool: return "a boolean";
+        case JsonValue::Type::Number: return "a number";
+        case JsonValue::Type::String: return "a string";
+        case JsonValue::Type::Array: return "an array";
+        case JsonValue::Type::Object: return "an object";
+    }
+    return "unknown";
+}
+
+} // namespace utils
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace utils {
+
+// Parsed JSON document (RFC 8259). Objects keep their members in file
+// order; a repeated key resolves to its first occurrence. Numbers are held
+// as double, which is exact for every integer a config file carries.
+class JsonValue {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+    using Array = std::vector<JsonValue>;
+    using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+    JsonValue() = default;
+    explicit JsonValue(bool value) : m_value(value) {}
+    explicit JsonValue(double value) : m_value(value) {}
+    explicit JsonValue(std::string value) : m_value(std::move(value)) {}
+    explicit JsonValue(Array value) : m_value(std::move(value)) {}
+    explicit JsonValue(Object value) : m_value(std::move(value)) {}
+
+    // Whole document; on failure error reads "line L, column C: reason"
+    static bool parse(std::string_view text, JsonValue& out, std::string& error);
+
+    Type type() const { return static_cast<Type>(m_value.index()); }
+    bool isNull() const { return type() == Type::Null; }
+    bool isBool() const { return type() == Type::Bool; }
+    bool isNumber() const { return type() == Type::Number; }
+    bool isString() const { return type() == Type::String; }
+    bool isArray() const { return type() == Type::Array; }
+    bool isObject() const { return type() == Type::Object; }
+
+    // Callers check the type first
+    bool asBool() const { return std::get<bool>(m_value); }
+    double asNumber() const { return std::get<double>(m_value); }
+    const std::string& asString() const { return std::get<std::string>(m_value); }
+    const Array& asArray() const { return std::get<Array>(m_value); }
+    const Object& asObject() const { return std::get<Object>(m_value); }
+
+    // Object member, or null when absent or this is not an object
+    const JsonValue* find(std::string_view key) const;
+
+private:
+    // Alternative order matches Type
+    std::variant<std::nullptr_t, bool, double, std::string, Array, Object> m_value{nullptr};
+};
+
+const char* jsonTypeName(JsonValue::Type type);
+
+} // namespace utils
@@ -0,0 +1,65 @@
+#include "latency_histogram.hpp"
+
+namespace utils {
+
+HistogramSummary LatencyHistogram::summarize() const {
+    HistogramSummary summary{};
+
+    // Copy first so every percentile comes from the same counts
+    std::array<uint64_t, BUCKET_COUNT> counts;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] = m_counts[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    summary.count = total;
+    if (total == 0) return summary;
+
+    summary.min_ns = m_min.load(std::memory_order_relaxed);
+    summary.max_ns = m_max.load(std::memory_order_relaxed);
+    summary.mean_ns = static_cast<double>(m_sum.load(std::memory_order_relaxed)) /
+                      m_count.load(std::memory_order_relaxed);
+
+    const uint64_t targets[4] = {
+        (total * 50 + 99) / 100, (total * 90 + 99) / 100,
+        (total * 99 + 99) / 100, (total * 999 + 999) / 1000
+    };
+    uint64_t* results[4] = {&summary.p50_ns, &summary.p90_ns, &summary.p99_ns, &summary.p999_ns};
+
+    uint64_t seen = 0;
+    uint32_t next = 0;
+    for (uint32_t i = 0; i < BUCKET_COUNT && next < 4; i++) {
+        seen += counts[i];
+        while (next < 4 && seen >= targets[next]) {
+            *results[next++] = bucketMidpoint(i);
+        }
+    }
+
+    // Midpoints can overshoot the largest sample
+    for (uint64_t* result : results) {
+        if (*result > summary.max_ns) *result = summary.max_ns;
+    }
+    return summary;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& count : m_counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+    m_min.store(UINT64_MAX, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::bucketMidpoint(uint32_t index) {
+    if (index < SUB_BUCKETS) return index;
+
+    const uint32_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    const uint64_t sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    const uint64_t lower = (SUB_BUCKETS + sub) << shift;
+    return lower + ((1ull << shift) >> 1);
+}
+
+} // namespace utils
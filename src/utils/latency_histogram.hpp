@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+namespace utils {
+
+struct HistogramSummary {
+    uint64_t count;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    double mean_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+};
+
+// HDR-style log-linear latency histogram: each power-of-two range is split
+// into SUB_BUCKETS linear buckets, so every recorded value keeps ~3% relative
+// precision from 1 ns to ~2 minutes in a fixed 8 KB table.
+//
+// One writer thread records with plain relaxed loads and stores (no RMW);
+// any thread may read concurrently and sees each bucket untorn.
+class LatencyHistogram {
+public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 5;
+    static constexpr uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr uint32_t MAX_EXPONENT = 36;  // Values saturate at 2^37 ns
+    static constexpr uint32_t BUCKET_COUNT = SUB_BUCKETS + (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    void record(uint64_t valueNs) {
+        bump(m_counts[bucketIndex(valueNs)]);
+        bump(m_count);
+        m_sum.store(m_sum.load(std::memory_order_relaxed) + valueNs, std::memory_order_relaxed);
+        if (valueNs > m_max.load(std::memory_order_relaxed)) {
+            m_max.store(valueNs, std::memory_order_relaxed);
+        }
+        if (valueNs < m_min.load(std::memory_order_relaxed)) {
+            m_min.store(valueNs, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t getCount() const { return m_count.load(std::memory_order_relaxed); }
+    double getMean() const {
+        const uint64_t count = getCount();
+        return count > 0 ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / count : 0.0;
+    }
+
+    // Percentiles are bucket midpoints, max and min are exact
+    HistogramSummary summarize() const;
+
+    // Writer thread only
+    void reset();
+
+    static uint32_t bucketIndex(uint64_t value) {
+        if (value < SUB_BUCKETS) return static_cast<uint32_t>(value);
+
+        uint32_t exponent = static_cast<uint32_t>(std::bit_width(value)) - 1;
+        if (exponent > MAX_EXPONENT) {
+            exponent = MAX_EXPONENT;
+            value = (2ull << MAX_EXPONENT) - 1;
+        }
+        const uint32_t shift = exponent - SUB_BUCKET_BITS;
+        const uint32_t sub = static_cast<uint32_t>(value >> shift) - SUB_BUCKETS;
+        return SUB_BUCKETS + shift * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t bucketMidpoint(uint32_t index);
+
+private:
+    static void bump(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_counts{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_max{0};
+    std::atomic<uint64_t> m_min{UINT64_MAX};
+};
+
+} // namespace utils
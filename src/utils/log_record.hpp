@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define BLACKJACK_LOG_TSC 1
+#endif
+
+namespace utils {
+
+enum class LogLevel : uint8_t {
+    DEBUG,
+    INFO,
+    WARNING,
+    ERROR,
+    CRITICAL
+};
+
+namespace log_detail {
+
+// Invariant TSC where available (a handful of cycles, no syscall);
+// the writer thread converts ticks to wall-clock time
+inline uint64_t readTimestamp() {
+#ifdef BLACKJACK_LOG_TSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+enum class ArgType : uint8_t {
+    Bool,
+    Char,
+    Int,     // int64_t
+    UInt,    // uint64_t
+    Float,
+    Double,
+    String   // uint16_t length, then the bytes
+};
+
+constexpr size_t RECORD_SIZE = 256;
+constexpr size_t RECORD_HEADER_SIZE = 24;
+constexpr size_t RECORD_PAYLOAD_SIZE = RECORD_SIZE - RECORD_HEADER_SIZE;
+
+// One log call: the format string by pointer (always a literal), the
+// arguments packed behind it. Strings are copied and truncated to fit.
+struct alignas(64) Record {
+    uint64_t timestamp;
+    const char* format;
+    LogLevel level;
+    uint8_t argCount;
+    uint16_t payloadSize;
+    uint32_t reserved;
+    std::array<uint8_t, RECORD_PAYLOAD_SIZE> payload;
+};
+
+static_assert(sizeof(Record) == RECORD_SIZE, "Log records are fixed-size ring slots");
+
+template<typename T>
+inline constexpr bool UNSUPPORTED_ARG = false;
+
+// Packs arguments into a record; an argument that no longer fits is left
+// out and shows as "{?}" in the output
+class Encoder {
+public:
+    explicit Encoder(Record& record) : m_record(record) {
+        m_record.argCount = 0;
+        m_record.payloadSize = 0;
+    }
+
+    template<typename T>
+    void add(const T& value) {
+        using D = std::decay_t<T>;
+        if constexpr (std::is_same_v<D, bool>) {
+            putScalar(ArgType::Bool, static_cast<uint8_t>(value));
+        } else if constexpr (std::is_same_v<D, char>) {
+            putScalar(ArgType::Char, value);
+        } else if constexpr (std::is_enum_v<D>) {
+            putScalar(ArgType::Int, static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+            putScalar(ArgType::Int, static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral_v<D>) {
+            putScalar(ArgType::UInt, static_cast<uint64_t>(value));
+        } else if constexpr (std::is_same_v<D, float>) {
+            putScalar(ArgType::Float, value);
+        } else if constexpr (std::is_floating_point_v<D>) {
+            putScalar(ArgType::Double, static_cast<double>(value));
+        } else if constexpr (std::is_pointer_v<D> && std::is_convertible_v<D, const char*>) {
+            putString(value ? std::string_view(value) : std::string_view("(null)"));
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            putString(std::string_view(value));
+        } else {
+            static_assert(UNSUPPORTED_ARG<T>, "Log arguments must be numbers, enums or strings");
+        }
+    }
+
+private:
+    template<typename V>
+    void putScalar(ArgType type, V value) {
+        if (m_record.payloadSize + 1 + sizeof(V) > RECORD_PAYLOAD_SIZE || m_full) {
+            m_full = true;
+            return;
+        }
+        uint8_t* out = m_record.payload.data() + m_record.payloadSize;
+        out[0] = static_cast<uint8_t>(type);
+        std::memcpy(out + 1, &value, sizeof(V));
+        m_record.payloadSize = static_cast<uint16_t>(m_record.payloadSize + 1 + sizeof(V));
+        m_record.argCount++;
+    }
+
+    void putString(std::string_view text) {
+        constexpr size_t STRING_HEADER = 1 + sizeof(uint16_t);
+        if (m_record.payloadSize + STRING_HEADER > RECORD_PAYLOAD_SIZE || m_full) {
+            m_full = true;
+            return;
+        }
+        const uint16_t length = static_cast<uint16_t>(
+            std::min(text.size(), RECORD_PAYLOAD_SIZE - m_record.payloadSize - STRING_HEADER));
+        uint8_t* out = m_record.payload.data() + m_record.payloadSize;
+        out[0] = static_cast<uint8_t>(ArgType::String);
+        std::memcpy(out + 1, &length, sizeof(length));
+        std::memcpy(out + STRING_HEADER, text.data(), length);
+        m_record.payloadSize = static_cast<uint16_t>(m_record.payloadSize + STRING_HEADER + length);
+        m_record.argCount++;
+    }
+
+    Record& m_record;
+    bool m_full{false};
+};
+
+// Single-producer single-consumer ring of records, one per logging thread.
+// The producer never blocks: a full ring drops the record and counts it.
+class LogRing {
+public:
+    static constexpr uint32_t CAPACITY = 1024;  // 256 KB per thread
+
+    LogRing() : m_records(std::make_unique<Record[]>(CAPACITY)) {}
+
+    // Producer
+    Record* tryClaim() {
+        if (m_head - m_cachedTail >= CAPACITY) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (m_head - m_cachedTail >= CAPACITY) {
+                m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+        return &m_records[m_head & (CAPACITY - 1)];
+    }
+
+    void commit() {
+        m_head++;
+        m_published.store(m_head, std::memory_order_release);
+    }
+
+    // Owning thread exited; the writer frees the ring once drained
+    void retire() { m_retired.store(true, std::memory_order_release); }
+
+    // Consumer
+    const Record* peek() const {
+        const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_published.load(std::memory_order_acquire)) return nullptr;
+        return &m_records[tail & (CAPACITY - 1)];
+    }
+
+    void pop() { m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    bool isRetired() const { return m_retired.load(std::memory_order_acquire); }
+    uint64_t getDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    // Producer side
+    alignas(64) uint64_t m_head{0};
+    uint64_t m_cachedTail{0};
+    std::atomic<uint64_t> m_published{0};
+    std::atomic<uint64_t> m_dropped{0};
+
+    // Consumer side
+    alignas(64) std::atomic<uint64_t> m_tail{0};
+    std::atomic<bool> m_retired{false};
+
+    std::unique_ptr<Record[]> m_records;
+};
+
+} // namespace log_detail
+} // namespace utils
@@ -1,57 +1,360 @@
 #include "logger.hpp"
-#include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iterator>
+#include <version>
+
+#ifdef __cpp_lib_format
+#include <format>
+#endif
 
 namespace utils {
 
+namespace {
+
+constexpr auto WRITER_IDLE_INTERVAL = std::chrono::milliseconds(2);
+constexpr auto MIN_CALIBRATION_INTERVAL = std::chrono::milliseconds(1);
+constexpr size_t MAX_BATCH_BYTES = 256 * 1024;  // Write out at least this often
+
+// Each thread's ring outlives the thread; its exit only marks it retired
+struct ThreadRing {
+    log_detail::LogRing* ring{nullptr};
+    ~ThreadRing() {
+        if (ring) ring->retire();
+    }
+};
+
+thread_local ThreadRing t_ring;
+
+const char* levelToString(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARNING: return "WARNING";
+        case LogLevel::ERROR: return "ERROR";
+        case LogLevel::CRITICAL: return "CRITICAL";
+        default: return "UNKNOWN";
+    }
+}
+
+template<typename T>
+T readScalar(const uint8_t*& cursor) {
+    T value;
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return value;
+}
+
+template<typename T>
+void appendNumber(std::string& out, T value) {
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// field is the whole replacement field, e.g. "{}" or "{:.2f}"
+template<typename T>
+void appendValue(std::string& out, std::string& scratch, std::string_view field, const T& value) {
+#ifdef __cpp_lib_format
+    const size_t colon = field.find(':');
+    if (colon == std::string_view::npos) {
+        std::format_to(std::back_inserter(out), "{}", value);
+        return;
+    }
+    scratch.assign("{");
+    scratch.append(field.substr(colon));
+    try {
+        std::vformat_to(std::back_inserter(out), scratch, std::make_format_args(value));
+    } catch (const std::format_error&) {
+        out.append(field);
+    }
+#else
+    // No <format> in this standard library: only ".Nf" precision is honoured
+    static_cast<void>(scratch);
+    if constexpr (std::is_floating_point_v<T>) {
+        const size_t dot = field.find(":.");
+        int precision = 0;
+        if (dot != std::string_view::npos &&
+            std::from_chars(field.data() + dot + 2, field.data() + field.size(), precision).ec == std::errc{}) {
+            char buffer[64];
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value,
+                                              std::chars_format::fixed, precision);
+            out.append(buffer, result.ptr);
+            return;
+        }
+    }
+    if constexpr (std::is_same_v<T, bool>) {
+        out.append(value ? "true" : "false");
+    } else if constexpr (std::is_same_v<T, char>) {
+        out.push_back(value);
+    } else if constexpr (std::is_same_v<T, std::string_view>) {
+        out.append(value);
+    } else {
+        appendNumber(out, value);
+    }
+#endif
+}
+
+} // namespace
+
 Logger& Logger::getInstance() {
     static Logger instance;
     return instance;
 }
 
+Logger::Logger() {
+    m_originTicks = log_detail::readTimestamp();
+    m_originSteady = std::chrono::steady_clock::now();
+    m_originWallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    m_writer = std::thread(&Logger::writerThreadFunc, this);
+}
+
 Logger::~Logger() {
+    m_running.store(false, std::memory_order_release);
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+
+    flush();
+
+    std::lock_guard<std::mutex> lock(m_drainMutex);
     if (m_logFile.is_open()) {
         m_logFile.close();
     }
 }
 
 void Logger::init(const std::string& logFilePath) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
+    std::lock_guard<std::mutex> lock(m_drainMutex);
+
     if (m_logFile.is_open()) {
         m_logFile.close();
     }
-    
-    m_logFile.open(logFilePath, std::ios::app);
+
+    m_logFile.open(logFilePath, std::ios::app | std::ios::binary);
 }
 
 void Logger::setLevel(LogLevel level) {
-    m_minLevel = level;
+    m_minLevel.store(level, std::memory_order_relaxed);
 }
 
-std::string Logger::levelToString(LogLevel level) {
-    switch (level) {
-        case LogLevel::DEBUG: return "DEBUG";
-        case LogLevel::INFO: return "INFO";
-        case LogLevel::WARNING: return "WARNING";
-        case LogLevel::ERROR: return "ERROR";
-        case LogLevel::CRITICAL: return "CRITICAL";
-        default: return "UNKNOWN";
+void Logger::flush() {
+    std::string batch;
+    std::lock_guard<std::mutex> lock(m_drainMutex);
+    while (drain(batch) > 0) {
+        write(batch);
+        batch.clear();
+    }
+    write(batch);  // Drop report, if any
+}
+
+uint64_t Logger::getDroppedRecords() const {
+    std::lock_guard<std::mutex> lock(m_ringsMutex);
+    uint64_t dropped = m_droppedRetired;
+    for (const auto& ring : m_rings) {
+        dropped += ring->getDropped();
+    }
+    return dropped;
+}
+
+log_detail::LogRing& Logger::threadRing() {
+    if (!t_ring.ring) {
+        // First log call on this thread; the only time a producer takes a lock
+        auto ring = std::make_unique<log_detail::LogRing>();
+        t_ring.ring = ring.get();
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        m_rings.push_back(std::move(ring));
+    }
+    return *t_ring.ring;
+}
+
+void Logger::writerThreadFunc() {
+    std::string batch;
+    batch.reserve(MAX_BATCH_BYTES);
+
+    while (m_running.load(std::memory_order_acquire)) {
+        size_t drained;
+        {
+            std::lock_guard<std::mutex> lock(m_drainMutex);
+            drained = drain(batch);
+            write(batch);
+        }
+        batch.clear();
+
+        if (drained == 0) {
+            std::this_thread::sleep_for(WRITER_IDLE_INTERVAL);
+        }
+    }
+}
+
+// Formats up to MAX_BATCH_BYTES of pending records into out, oldest ring
+// first. Caller holds m_drainMutex.
+size_t Logger::drain(std::string& out) {
+    {
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        m_drainRings.clear();
+        for (const auto& ring : m_rings) {
+            m_drainRings.push_back(ring.get());
+        }
     }
+
+    calibrateClock();
+
+    size_t drained = 0;
+    for (log_detail::LogRing* ring : m_drainRings) {
+        while (const log_detail::Record* record = ring->peek()) {
+            formatRecord(*record, out);
+            ring->pop();
+            drained++;
+            if (out.size() >= MAX_BATCH_BYTES) return drained;
+        }
+    }
+
+    // Free the rings of exited threads once they are empty
+    uint64_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        std::erase_if(m_rings, [this](const std::unique_ptr<log_detail::LogRing>& ring) {
+            if (!ring->isRetired() || ring->peek()) return false;
+            m_droppedRetired += ring->getDropped();
+            return true;
+        });
+        dropped = m_droppedRetired;
+        for (const auto& ring : m_rings) {
+            dropped += ring->getDropped();
+        }
+    }
+
+    if (dropped > m_droppedReported) {
+        appendTimestamp(log_detail::readTimestamp(), out);
+        out += " [WARNING] Logger dropped ";
+        appendNumber(out, dropped - m_droppedReported);
+        out += " records (ring full)\n";
+        m_droppedReported = dropped;
+    }
+    return drained;
+}
+
+void Logger::formatRecord(const log_detail::Record& record, std::string& out) {
+    appendTimestamp(record.timestamp, out);
+    out += " [";
+    out += levelToString(record.level);
+    out += "] ";
+
+    const uint8_t* cursor = record.payload.data();
+    uint32_t argsLeft = record.argCount;
+
+    for (const char* p = record.format; *p; p++) {
+        if (*p == '}' && p[1] == '}') {
+            out.push_back('}');
+            p++;
+            continue;
+        }
+        if (*p != '{') {
+            out.push_back(*p);
+            continue;
+        }
+        if (p[1] == '{') {
+            out.push_back('{');
+            p++;
+            continue;
+        }
+
+        const char* close = std::strchr(p, '}');
+        if (!close) {
+            out.append(p);
+            break;
+        }
+        const std::string_view field(p, static_cast<size_t>(close - p + 1));
+        p = close;
+
+        if (argsLeft == 0) {
+            out.append("{?}");
+            continue;
+        }
+        argsLeft--;
+
+        const auto type = static_cast<log_detail::ArgType>(*cursor++);
+        switch (type) {
+            case log_detail::ArgType::Bool:
+                appendValue(out, m_field, field, readScalar<uint8_t>(cursor) != 0);
+                break;
+            case log_detail::ArgType::Char:
+                appendValue(out, m_field, field, readScalar<char>(cursor));
+                break;
+            case log_detail::ArgType::Int:
+                appendValue(out, m_field, field, readScalar<int64_t>(cursor));
+                break;
+            case log_detail::ArgType::UInt:
+                appendValue(out, m_field, field, readScalar<uint64_t>(cursor));
+                break;
+            case log_detail::ArgType::Float:
+                appendValue(out, m_field, field, readScalar<float>(cursor));
+                break;
+            case log_detail::ArgType::Double:
+                appendValue(out, m_field, field, readScalar<double>(cursor));
+                break;
+            case log_detail::ArgType::String: {
+                const auto length = readScalar<uint16_t>(cursor);
+                const std::string_view text(reinterpret_cast<const char*>(cursor), length);
+                cursor += length;
+                appendValue(out, m_field, field, text);
+                break;
+            }
+        }
+    }
+    out.push_back('\n');
+}
+
+// Refines the tick rate against the steady clock; the longer the run, the
+// closer it gets. A no-op where ticks already are steady-clock nanoseconds.
+void Logger::calibrateClock() {
+#ifdef BLACKJACK_LOG_TSC
+    auto elapsed = std::chrono::steady_clock::now() - m_originSteady;
+    while (elapsed < MIN_CALIBRATION_INTERVAL) {
+        std::this_thread::yield();  // Writer thread only, right after startup
+        elapsed = std::chrono::steady_clock::now() - m_originSteady;
+    }
+    const uint64_t ticks = log_detail::readTimestamp() - m_originTicks;
+    m_ticksPerNs = static_cast<double>(ticks) /
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+#endif
+}
+
+// "YYYY-MM-DD HH:MM:SS.mmm", local time
+void Logger::appendTimestamp(uint64_t ticks, std::string& out) {
+    const double offsetTicks = static_cast<double>(static_cast<int64_t>(ticks - m_originTicks));
+    const int64_t wallNs = m_originWallNs + static_cast<int64_t>(offsetTicks / m_ticksPerNs);
+    const int64_t second = wallNs / 1'000'000'000;
+    const int64_t millis = (wallNs / 1'000'000) % 1000;
+
+    if (second != m_cachedSecond) {
+        const std::time_t time = static_cast<std::time_t>(second);
+        std::tm local{};
+#ifdef _WIN32
+        localtime_s(&local, &time);
+#else
+        localtime_r(&time, &local);
+#endif
+        std::strftime(m_cachedDate, sizeof(m_cachedDate), "%Y-%m-%d %H:%M:%S", &local);
+        m_cachedSecond = second;
+    }
+
+    char millisText[8];
+    std::snprintf(millisText, sizeof(millisText), ".%03d", static_cast<int>(millis));
+    out += '[';
+    out += m_cachedDate;
+    out += millisText;
+    out += ']';
 }
 
-std::string Logger::getCurrentTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
-    
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    
-    return ss.str();
+void Logger::write(const std::string& out) {
+    if (out.empty() || !m_logFile.is_open()) return;
+    m_logFile.write(out.data(), static_cast<std::streamsize>(out.size()));
+    m_logFile.flush();
 }
 
 } // namespace utils
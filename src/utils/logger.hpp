@@ -1,84 +1,119 @@
 #pragma once
 
-#include <string>
+#include "log_record.hpp"
+#include <atomic>
+#include <chrono>
+#include <fstream>
 #include <memory>
 #include <mutex>
-#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace utils {
 
-enum class LogLevel {
-    DEBUG,
-    INFO,
-    WARNING,
-    ERROR,
-    CRITICAL
-};
-
+// Asynchronous logger. A log call packs the format-string pointer and its
+// arguments into the calling thread's lock-free ring and returns; it never
+// allocates, locks or touches the disk. A background thread formats the
+// records ({} fields, std::format specs) and batch-writes them. When a
+// thread's ring is full the record is dropped and counted.
+//
+// Format strings must be string literals: only the pointer is stored.
 class Logger {
 public:
     static Logger& getInstance();
-    
+
     void init(const std::string& logFilePath);
     void setLevel(LogLevel level);
-    
+
+    // Blocks until every record logged before the call is on disk
+    void flush();
+
+    uint64_t getDroppedRecords() const;
+
     template<typename... Args>
-    void debug(const std::string& format, Args&&... args) {
-        log(LogLevel::DEBUG, format, std::forward<Args>(args)...);
+    void debug(const char* format, const Args&... args) {
+        log(LogLevel::DEBUG, format, args...);
     }
-    
+
     template<typename... Args>
-    void info(const std::string& format, Args&&... args) {
-        log(LogLevel::INFO, format, std::forward<Args>(args)...);
+    void info(const char* format, const Args&... args) {
+        log(LogLevel::INFO, format, args...);
     }
-    
+
     template<typename... Args>
-    void warning(const std::string& format, Args&&... args) {
-        log(LogLevel::WARNING, format, std::forward<Args>(args)...);
+    void warning(const char* format, const Args&... args) {
+        log(LogLevel::WARNING, format, args...);
     }
-    
+
     template<typename... Args>
-    void error(const std::string& format, Args&&... args) {
-        log(LogLevel::ERROR, format, std::forward<Args>(args)...);
+    void error(const char* format, const Args&... args) {
+        log(LogLevel::ERROR, format, args...);
     }
-    
+
     template<typename... Args>
-    void critical(const std::string& format, Args&&... args) {
-        log(LogLevel::CRITICAL, format, std::forward<Args>(args)...);
+    void critical(const char* format, const Args&... args) {
+        log(LogLevel::CRITICAL, format, args...);
     }
 
 private:
-    Logger() = default;
+    Logger();
     ~Logger();
-    
+
     template<typename... Args>
-    void log(LogLevel level, const std::string& format, Args&&... args);
-    
-    std::string levelToString(LogLevel level);
-    std::string getCurrentTimestamp();
-    
+    void log(LogLevel level, const char* format, const Args&... args);
+
+    log_detail::LogRing& threadRing();
+
+    void writerThreadFunc();
+    size_t drain(std::string& out);
+    void formatRecord(const log_detail::Record& record, std::string& out);
+    void calibrateClock();
+    void appendTimestamp(uint64_t ticks, std::string& out);
+    void write(const std::string& out);
+
+    std::atomic<LogLevel> m_minLevel{LogLevel::INFO};
+
+    // Ring registration (once per thread) and the writer's walk over them
+    mutable std::mutex m_ringsMutex;
+    std::vector<std::unique_ptr<log_detail::LogRing>> m_rings;
+    uint64_t m_droppedRetired{0};  // Drops of rings already freed
+    uint64_t m_droppedReported{0};
+
+    // Consumer side of every ring, the file and the clock calibration
+    std::mutex m_drainMutex;
     std::ofstream m_logFile;
-    std::mutex m_mutex;
-    LogLevel m_minLevel{LogLevel::INFO};
+
+    // Tick -> wall clock, refined by the writer as the run goes on
+    uint64_t m_originTicks{0};
+    int64_t m_originWallNs{0};
+    std::chrono::steady_clock::time_point m_originSteady;
+    double m_ticksPerNs{1.0};
+    int64_t m_cachedSecond{-1};
+    char m_cachedDate[24]{};
+
+    std::vector<log_detail::LogRing*> m_drainRings;  // Snapshot of m_rings per drain
+    std::string m_field;  // Scratch for one replacement field
+
+    std::atomic<bool> m_running{true};
+    std::thread m_writer;
 };
 
 // Template implementation
 template<typename... Args>
-void Logger::log(LogLevel level, const std::string& format, Args&&... args) {
-    if (level < m_minLevel) return;
-    
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
-    // Simple formatting (in production, use fmt library)
-    std::string message = format;
-    
-    std::string logEntry = "[" + getCurrentTimestamp() + "] [" + 
-                          levelToString(level) + "] " + message + "\n";
-    
-    if (m_logFile.is_open()) {
-        m_logFile << logEntry;
-        m_logFile.flush();
-    }
+void Logger::log(LogLevel level, const char* format, const Args&... args) {
+    if (level < m_minLevel.load(std::memory_order_relaxed)) return;
+
+    log_detail::LogRing& ring = threadRing();
+    log_detail::Record* record = ring.tryClaim();
+    if (!record) return;  // Ring full, counted as dropped
+
+    record->timestamp = log_detail::readTimestamp();
+    record->format = format;
+    record->level = level;
+    log_detail::Encoder encoder(*record);
+    (encoder.add(args), ...);
+    ring.commit();
 }
 
 } // namespace utils
@@ -0,0 +1,120 @@
+#include "mapped_file.hpp"
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utils {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+        m_file = std::exchange(other.m_file, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#else
+        m_fd = std::exchange(other.m_fd, -1);
+#endif
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    m_file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        close();
+        return false;
+    }
+
+    m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        close();
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data) {
+        close();
+        return false;
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    m_fd = ::open(path.c_str(), O_RDONLY);
+    if (m_fd < 0) return false;
+
+    struct stat info;
+    if (fstat(m_fd, &info) != 0 || info.st_size == 0) {
+        close();
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (mapped == MAP_FAILED) {
+        close();
+        return false;
+    }
+    m_data = static_cast<const uint8_t*>(mapped);
+    m_size = static_cast<size_t>(info.st_size);
+#endif
+
+    return true;
+}
+
+void MappedFile::prefetch(size_t offset, size_t length) const {
+    if (!m_data || offset >= m_size) return;
+    length = std::min(length, m_size - offset);
+
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY range{const_cast<uint8_t*>(m_data) + offset, length};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    // madvise wants a page-aligned start
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t aligned = offset & ~(page - 1);
+    madvise(const_cast<uint8_t*>(m_data) + aligned, length + (offset - aligned), MADV_WILLNEED);
+#endif
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+} // namespace utils
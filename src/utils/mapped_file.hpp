@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace utils {
+
+// Read-only memory mapping of a whole file. Pages are faulted in on first
+// touch and shared with the OS file cache instead of copied into the heap.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    std::span<const uint8_t> bytes() const { return {m_data, m_size}; }
+
+    // Hint that [offset, offset + length) is read soon; the kernel pages it in ahead
+    void prefetch(size_t offset, size_t length) const;
+
+private:
+    const uint8_t* m_data{nullptr};
+    size_t m_size{0};
+
+#ifdef _WIN32
+    void* m_file{nullptr};     // HANDLE
+    void* m_mapping{nullptr};  // HANDLE
+#else
+    int m_fd{-1};
+#endif
+};
+
+} // namespace utils
@@ -0,0 +1,81 @@
+#include "profiling.hpp"
+#include <array>
+
+namespace utils {
+
+namespace {
+
+constexpr std::array<const char*, 11> CATEGORY_NAMES = {
+    "Unknown", "Capture", "Preprocess", "Inference", "Graph", "Enqueue",
+    "Postprocess", "Tracking", "Counting", "Strategy", "UI"
+};
+
+} // namespace
+
+const char* traceCategoryName(TraceCategory category) {
+    const auto index = static_cast<uint32_t>(category);
+    return index < CATEGORY_NAMES.size() ? CATEGORY_NAMES[index] : CATEGORY_NAMES[0];
+}
+
+#ifdef BLACKJACK_NVTX
+
+namespace nvtx {
+
+namespace {
+
+// ARGB, indexed by category
+constexpr std::array<uint32_t, CATEGORY_NAMES.size()> CATEGORY_COLORS = {
+    0xFF808080,  // Unknown
+    0xFF4CAF50,  // Capture
+    0xFF8BC34A,  // Preprocess
+    0xFF2196F3,  // Inference
+    0xFF3F51B5,  // Graph
+    0xFF00BCD4,  // Enqueue
+    0xFFFF9800,  // Postprocess
+    0xFFFFC107,  // Tracking
+    0xFFE91E63,  // Counting
+    0xFF9C27B0,  // Strategy
+    0xFF607D8B   // UI
+};
+
+// Created on first use, categories named so Nsight can filter by them
+nvtxDomainHandle_t domain() {
+    static const nvtxDomainHandle_t handle = [] {
+        nvtxDomainHandle_t created = nvtxDomainCreateA("BlackjackAI");
+        for (uint32_t i = 1; i < CATEGORY_NAMES.size(); i++) {
+            nvtxDomainNameCategoryA(created, i, CATEGORY_NAMES[i]);
+        }
+        return created;
+    }();
+    return handle;
+}
+
+} // namespace
+
+nvtxStringHandle_t registerString(const char* name) {
+    return nvtxDomainRegisterStringA(domain(), name);
+}
+
+void pushRange(TraceCategory category, nvtxStringHandle_t name) {
+    const auto index = static_cast<uint32_t>(category);
+
+    nvtxEventAttributes_t attributes{};
+    attributes.version = NVTX_VERSION;
+    attributes.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
+    attributes.category = index;
+    attributes.colorType = NVTX_COLOR_ARGB;
+    attributes.color = CATEGORY_COLORS[index < CATEGORY_COLORS.size() ? index : 0];
+    attributes.messageType = NVTX_MESSAGE_TYPE_REGISTERED;
+    attributes.message.registered = name;
+    nvtxDomainRangePushEx(domain(), &attributes);
+}
+
+void popRange() {
+    nvtxDomainRangePop(domain());
+}
+
+} // namespace nvtx
+
+#endif
+
+} // namespace utils
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#ifdef BLACKJACK_NVTX
+#include <nvtx3/nvToolsExt.h>
+#endif
+
+namespace utils {
+
+// NVTX categories, one color per category in the Nsight Systems timeline
+enum class TraceCategory : uint32_t {
+    Capture = 1,
+    Preprocess,
+    Inference,
+    Graph,        // CUDA graph launches
+    Enqueue,      // TensorRT enqueueV3
+    Postprocess,
+    Tracking,
+    Counting,
+    Strategy,
+    UI
+};
+
+const char* traceCategoryName(TraceCategory category);
+
+namespace nvtx {
+
+// Runtime switch for SystemConfig::enable_nvtx_markers. Builds without
+// BLACKJACK_NVTX compile every range out, whatever this says.
+inline std::atomic<bool> g_enabled{false};
+
+inline void setEnabled(bool enabled) { g_enabled.store(enabled, std::memory_order_relaxed); }
+inline bool isEnabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+#ifdef BLACKJACK_NVTX
+
+// Registered once per call site, so a push never hashes the name
+nvtxStringHandle_t registerString(const char* name);
+void pushRange(TraceCategory category, nvtxStringHandle_t name);
+void popRange();
+
+class ScopedRange {
+public:
+    ScopedRange(TraceCategory category, nvtxStringHandle_t name) : m_active(isEnabled()) {
+        if (m_active) pushRange(category, name);
+    }
+    ~ScopedRange() {
+        if (m_active) popRange();
+    }
+
+    ScopedRange(const ScopedRange&) = delete;
+    ScopedRange& operator=(const ScopedRange&) = delete;
+
+private:
+    bool m_active;
+};
+
+#endif
+
+} // namespace nvtx
+} // namespace utils
+
+#define BLACKJACK_NVTX_CONCAT_IMPL(a, b) a##b
+#define BLACKJACK_NVTX_CONCAT(a, b) BLACKJACK_NVTX_CONCAT_IMPL(a, b)
+
+// Scoped range until the end of the enclosing block: NVTX_RANGE(utils::TraceCategory::UI, "render");
+#ifdef BLACKJACK_NVTX
+#define NVTX_RANGE(category, name)                                                        \
+    static const nvtxStringHandle_t BLACKJACK_NVTX_CONCAT(nvtxName_, __LINE__) =          \
+        ::utils::nvtx::registerString(name);                                              \
+    ::utils::nvtx::ScopedRange BLACKJACK_NVTX_CONCAT(nvtxRange_, __LINE__)(               \
+        category, BLACKJACK_NVTX_CONCAT(nvtxName_, __LINE__))
+#else
+#define NVTX_RANGE(category, name) static_cast<void>(0)
+#endif
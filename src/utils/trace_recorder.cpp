@@ -0,0 +1,178 @@
+#include "trace_recorder.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace utils {
+
+namespace {
+
+// Chrome trace timestamps are microseconds, fractions keep the nanoseconds
+void appendMicros(std::string& out, uint64_t ns) {
+    char buffer[32];
+    const int length = std::snprintf(buffer, sizeof(buffer), "%llu.%03llu",
+                                     static_cast<unsigned long long>(ns / 1000),
+                                     static_cast<unsigned long long>(ns % 1000));
+    out.append(buffer, static_cast<size_t>(length));
+}
+
+} // namespace
+
+TraceRecorder::TraceRecorder() {
+}
+
+TraceRecorder::~TraceRecorder() {
+    stop();
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+}
+
+bool TraceRecorder::arm(uint32_t frames, const std::string& outputPath) {
+    auto& logger = Logger::getInstance();
+
+    if (frames == 0 || outputPath.empty()) {
+        logger.error("Trace needs a frame count and an output path");
+        return false;
+    }
+    if (m_armed.load(std::memory_order_acquire)) {
+        logger.warning("Trace already in progress, ignoring request for {} frames", frames);
+        return false;
+    }
+    if (m_writer.joinable()) {
+        m_writer.join();  // Previous trace's file is written by now or shortly
+    }
+
+    m_events.resize(static_cast<size_t>(frames) * EVENTS_PER_FRAME);
+    m_nextEvent.store(0, std::memory_order_relaxed);
+    m_droppedEvents.store(0, std::memory_order_relaxed);
+    m_firstFrame.store(NO_FRAME, std::memory_order_relaxed);
+    m_frameCount = frames;
+    m_outputPath = outputPath;
+
+    m_armed.store(true, std::memory_order_seq_cst);
+    m_writer = std::thread(&TraceRecorder::writerThreadFunc, this);
+
+    logger.info("Tracing the next {} frames to {}", frames, outputPath);
+    return true;
+}
+
+void TraceRecorder::stop() {
+    if (m_armed.exchange(false, std::memory_order_seq_cst)) {
+        m_armed.notify_all();
+    }
+}
+
+void TraceRecorder::beginFrame(uint32_t frameId) {
+    if (!m_armed.load(std::memory_order_relaxed)) return;
+
+    uint32_t expected = NO_FRAME;
+    m_firstFrame.compare_exchange_strong(expected, frameId, std::memory_order_relaxed);
+}
+
+void TraceRecorder::endFrame(uint32_t frameId) {
+    if (!m_armed.load(std::memory_order_relaxed)) return;
+
+    const uint32_t first = m_firstFrame.load(std::memory_order_relaxed);
+    if (first != NO_FRAME && frameId >= first && frameId - first + 1 >= m_frameCount) {
+        stop();
+    }
+}
+
+void TraceRecorder::append(const char* name, TraceCategory category,
+                           uint64_t startNs, uint64_t endNs, uint32_t frameId) {
+    // Announce before re-checking, so the writer never reads a half-written event
+    m_activeWriters.fetch_add(1, std::memory_order_seq_cst);
+
+    const uint32_t first = m_firstFrame.load(std::memory_order_relaxed);
+    if (m_armed.load(std::memory_order_seq_cst) && first != NO_FRAME &&
+        (frameId == NO_FRAME || (frameId >= first && frameId - first < m_frameCount))) {
+        const uint32_t index = m_nextEvent.fetch_add(1, std::memory_order_relaxed);
+        if (index < m_events.size()) {
+            m_events[index] = {name, category, frameId, startNs, endNs > startNs ? endNs - startNs : 0};
+        } else {
+            m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    m_activeWriters.fetch_sub(1, std::memory_order_release);
+}
+
+void TraceRecorder::writerThreadFunc() {
+    m_armed.wait(true, std::memory_order_acquire);
+
+    while (m_activeWriters.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+
+    auto& logger = Logger::getInstance();
+    if (write()) {
+        const uint32_t recorded = std::min<uint32_t>(m_nextEvent.load(std::memory_order_relaxed),
+                                                    static_cast<uint32_t>(m_events.size()));
+        logger.info("Wrote trace of {} events to {} ({} dropped)", recorded, m_outputPath,
+                    m_droppedEvents.load(std::memory_order_relaxed));
+    }
+}
+
+bool TraceRecorder::write() const {
+    const uint32_t count = std::min<uint32_t>(m_nextEvent.load(std::memory_order_relaxed),
+                                             static_cast<uint32_t>(m_events.size()));
+
+    uint64_t origin = UINT64_MAX;
+    for (uint32_t i = 0; i < count; i++) {
+        origin = std::min(origin, m_events[i].start_ns);
+    }
+    if (count == 0) origin = 0;
+
+    std::string json;
+    json.reserve(static_cast<size_t>(count) * 128 + 1024);
+    json += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    // Row names, ordered by category
+    bool firstEntry = true;
+    for (uint32_t lane = static_cast<uint32_t>(TraceCategory::Capture);
+         lane <= static_cast<uint32_t>(TraceCategory::UI); lane++) {
+        if (!firstEntry) json += ',';
+        firstEntry = false;
+        json += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":";
+        json += std::to_string(lane);
+        json += ",\"args\":{\"name\":\"";
+        json += traceCategoryName(static_cast<TraceCategory>(lane));
+        json += "\"}},{\"ph\":\"M\",\"name\":\"thread_sort_index\",\"pid\":1,\"tid\":";
+        json += std::to_string(lane);
+        json += ",\"args\":{\"sort_index\":";
+        json += std::to_string(lane);
+        json += "}}";
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const TraceEvent& event = m_events[i];
+        json += ",{\"ph\":\"X\",\"pid\":1,\"tid\":";
+        json += std::to_string(static_cast<uint32_t>(event.category));
+        json += ",\"name\":\"";
+        json += event.name;
+        json += "\",\"cat\":\"";
+        json += traceCategoryName(event.category);
+        json += "\",\"ts\":";
+        appendMicros(json, event.start_ns - origin);
+        json += ",\"dur\":";
+        appendMicros(json, event.duration_ns);
+        if (event.frame_id != NO_FRAME) {
+            json += ",\"args\":{\"frame\":";
+            json += std::to_string(event.frame_id);
+            json += '}';
+        }
+        json += '}';
+    }
+    json += "]}\n";
+
+    std::ofstream file(m_outputPath, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(json.data(), static_cast<std::streamsize>(json.size()))) {
+        Logger::getInstance().error("Failed to write trace file: {}", m_outputPath);
+        return false;
+    }
+    return true;
+}
+
+} // namespace utils
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "profiling.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace utils {
+
+struct TraceEvent {
+    const char* name;  // String literal, never copied
+    TraceCategory category;
+    uint32_t frame_id;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+};
+
+// Records CPU-side stage timings for the next N captured frames and writes
+// them as Chrome trace JSON (chrome://tracing, ui.perfetto.dev), one row per
+// category. Disarmed, record() is a single relaxed load.
+//
+// Any thread may record. Events of the traced frames land in a buffer sized
+// at arm(); events without a frame (counting, strategy, UI) are kept while
+// the window is open. A background thread writes the file once the last
+// traced frame leaves postprocessing, so no stage thread touches the disk.
+class TraceRecorder {
+public:
+    static constexpr uint32_t NO_FRAME = UINT32_MAX;
+    static constexpr uint32_t EVENTS_PER_FRAME = 32;
+
+    TraceRecorder();
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    // False while a previous trace is still being recorded
+    bool arm(uint32_t frames, const std::string& outputPath);
+
+    // Ends an armed trace early and writes whatever was recorded
+    void stop();
+
+    bool isArmed() const { return m_armed.load(std::memory_order_relaxed); }
+
+    // Capture thread: the first frame published after arm() opens the window
+    void beginFrame(uint32_t frameId);
+
+    // Postprocess thread: the last traced frame closes it
+    void endFrame(uint32_t frameId);
+
+    void record(const char* name, TraceCategory category,
+                uint64_t startNs, uint64_t endNs, uint32_t frameId = NO_FRAME) {
+        if (!m_armed.load(std::memory_order_relaxed)) return;
+        append(name, category, startNs, endNs, frameId);
+    }
+
+private:
+    void append(const char* name, TraceCategory category,
+                uint64_t startNs, uint64_t endNs, uint32_t frameId);
+    void writerThreadFunc();
+    bool write() const;
+
+    std::vector<TraceEvent> m_events;
+    std::atomic<uint32_t> m_nextEvent{0};
+    std::atomic<uint32_t> m_activeWriters{0};  // Threads inside append()
+    std::atomic<uint64_t> m_droppedEvents{0};
+
+    std::atomic<bool> m_armed{false};
+    std::atomic<uint32_t> m_firstFrame{NO_FRAME};
+    uint32_t m_frameCount{0};
+    std::string m_outputPath;
+
+    std::thread m_writer;
+};
+
+} // namespace utils
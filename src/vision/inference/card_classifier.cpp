@@ -0,0 +1,200 @@
+#include "card_classifier.hpp"
+#include "../../utils/gpu_memory_pool.hpp"
+#include "../../utils/logger.hpp"
+#include "../../utils/mapped_file.hpp"
+#include "../../utils/profiling.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace vision {
+
+namespace {
+
+constexpr uint32_t CARD_CLASSES = 52;
+constexpr uint32_t RANK_CLASSES = 13;
+constexpr uint32_t SUIT_CLASSES = 4;
+
+// Index and probability of the largest logit
+std::pair<uint32_t, float> softmaxMax(const float* logits, uint32_t count) {
+    const float* best = std::max_element(logits, logits + count);
+    float sum = 0.0f;
+    for (uint32_t i = 0; i < count; i++) {
+        sum += std::exp(logits[i] - *best);
+    }
+    return {static_cast<uint32_t>(best - logits), 1.0f / sum};
+}
+
+} // namespace
+
+CardClassifier::CardClassifier(uint32_t maxBatch)
+    : m_maxBatch(std::max(maxBatch, 1u)) {
+    cudaStreamCreateWithFlags(&m_stream, cudaStreamNonBlocking);
+}
+
+CardClassifier::~CardClassifier() {
+    auto& pool = utils::GpuMemoryPool::getInstance();
+    pool.release(m_deviceInput);
+    pool.release(m_deviceOutput);
+    pool.releaseHost(m_hostOutput);
+    m_context.reset();
+    m_engine.reset();
+    if (m_stream) cudaStreamDestroy(m_stream);
+}
+
+bool CardClassifier::loadSerializedEngine(const std::string& enginePath) {
+    auto& logger = utils::Logger::getInstance();
+
+    utils::MappedFile plan;
+    if (!plan.open(enginePath)) {
+        logger.error("Failed to open classifier engine: {}", enginePath);
+        return false;
+    }
+
+    m_runtime.reset(nvinfer1::createInferRuntime(m_logger));
+    if (m_runtime) m_runtime->setGpuAllocator(&TRTGpuAllocator::getInstance());
+    m_engine.reset(m_runtime ? m_runtime->deserializeCudaEngine(plan.data(), plan.size()) : nullptr);
+    m_context.reset(m_engine ? m_engine->createExecutionContext() : nullptr);
+    if (!m_context) {
+        logger.error("Failed to deserialize classifier engine: {}", enginePath);
+        return false;
+    }
+
+    const auto inputDims = m_engine->getTensorShape(INPUT_TENSOR);
+    const auto outputDims = m_engine->getTensorShape(OUTPUT_TENSOR);
+    m_dynamicBatch = inputDims.d[0] < 0;
+    if (m_dynamicBatch) {
+        const auto maxDims = m_engine->getProfileShape(INPUT_TENSOR, 0, nvinfer1::OptProfileSelector::kMAX);
+        m_maxBatch = std::min(m_maxBatch, static_cast<uint32_t>(maxDims.d[0]));
+    } else {
+        m_maxBatch = static_cast<uint32_t>(inputDims.d[0]);
+        m_activeBatch = m_maxBatch;
+    }
+
+    m_inputSize = static_cast<uint32_t>(inputDims.d[3]);
+    m_outputWidth = static_cast<uint32_t>(outputDims.d[1]);
+    if (inputDims.d[2] != inputDims.d[3] ||
+        (m_outputWidth != CARD_CLASSES && m_outputWidth != RANK_CLASSES + SUIT_CLASSES)) {
+        logger.error("Classifier must take square crops and emit 52 or 13+4 logits");
+        return false;
+    }
+
+    // Crops are written in the plan's input type; the logits are read as FP32
+    const auto inputType = m_engine->getTensorDataType(INPUT_TENSOR);
+    if ((inputType != nvinfer1::DataType::kFLOAT && inputType != nvinfer1::DataType::kHALF) ||
+        m_engine->getTensorDataType(OUTPUT_TENSOR) != nvinfer1::DataType::kFLOAT) {
+        logger.error("Classifier needs an FP32/FP16 input and an FP32 output");
+        return false;
+    }
+    m_inputPrecision = inputType == nvinfer1::DataType::kHALF
+        ? cuda::TensorPrecision::FP16 : cuda::TensorPrecision::FP32;
+
+    const size_t inputBytes = static_cast<size_t>(m_maxBatch) * 3 * m_inputSize * m_inputSize *
+                              cuda::elementSize(m_inputPrecision);
+    const size_t outputBytes = static_cast<size_t>(m_maxBatch) * m_outputWidth * sizeof(float);
+    auto& pool = utils::GpuMemoryPool::getInstance();
+    m_deviceInput = pool.allocate(inputBytes, utils::MemoryTag::Inference);
+    m_deviceOutput = static_cast<float*>(pool.allocate(outputBytes, utils::MemoryTag::Inference));
+    m_hostOutput = static_cast<float*>(pool.allocateHost(outputBytes, utils::MemoryTag::Inference));
+    if (!m_deviceInput || !m_deviceOutput || !m_hostOutput) {
+        logger.error("Failed to allocate classifier buffers");
+        return false;
+    }
+
+    if (!m_context->setTensorAddress(INPUT_TENSOR, m_deviceInput) ||
+        !m_context->setTensorAddress(OUTPUT_TENSOR, m_deviceOutput) ||
+        !m_preprocessor.initialize(m_inputSize, m_inputSize, m_inputPrecision)) {
+        logger.error("Failed to bind classifier tensors");
+        return false;
+    }
+
+    logger.info("Card classifier: {}x{} crops, batch {}, {} head", m_inputSize, m_inputSize,
+                m_maxBatch, m_outputWidth == CARD_CLASSES ? "52-way" : "rank+suit");
+    return true;
+}
+
+bool CardClassifier::classify(const capture::Frame& frame,
+                              std::span<const capture::ROI> crops,
+                              std::vector<CardClass>& results) {
+    results.clear();
+
+    for (size_t offset = 0; offset < crops.size(); offset += m_maxBatch) {
+        const size_t count = std::min<size_t>(crops.size() - offset, m_maxBatch);
+        if (!classifyBatch(frame, crops.subspan(offset, count), results)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CardClassifier::classifyBatch(const capture::Frame& frame,
+                                   std::span<const capture::ROI> crops,
+                                   std::vector<CardClass>& results) {
+    auto& logger = utils::Logger::getInstance();
+
+    // Static engines always run their full batch; the tail is ignored
+    const uint32_t batch = static_cast<uint32_t>(crops.size());
+    const uint32_t runBatch = m_dynamicBatch ? batch : m_maxBatch;
+
+    if (m_dynamicBatch && runBatch != m_activeBatch) {
+        const nvinfer1::Dims4 dims(static_cast<int>(runBatch), 3,
+                                   static_cast<int>(m_inputSize), static_cast<int>(m_inputSize));
+        if (!m_context->setInputShape(INPUT_TENSOR, dims)) {
+            logger.error("Failed to set classifier batch {}", runBatch);
+            return false;
+        }
+        m_activeBatch = runBatch;
+    }
+
+    auto* input = static_cast<uint8_t*>(m_deviceInput);
+    const size_t imageBytes = static_cast<size_t>(3) * m_inputSize * m_inputSize *
+                              cuda::elementSize(m_inputPrecision);
+    for (uint32_t i = 0; i < batch; i++) {
+        if (!m_preprocessor.process(frame, input + i * imageBytes, m_stream, &crops[i])) {
+            logger.error("Failed to preprocess crop {}", i);
+            return false;
+        }
+    }
+
+    {
+        NVTX_RANGE(utils::TraceCategory::Enqueue, "classifier enqueueV3");
+        if (!m_context->enqueueV3(m_stream)) {
+            logger.error("Classifier execution failed");
+            return false;
+        }
+    }
+
+    cudaError_t status = cudaMemcpyAsync(m_hostOutput, m_deviceOutput,
+                                         static_cast<size_t>(batch) * m_outputWidth * sizeof(float),
+                                         cudaMemcpyDeviceToHost, m_stream);
+    if (status == cudaSuccess) {
+        status = cudaStreamSynchronize(m_stream);
+    }
+    if (status != cudaSuccess) {
+        logger.error("Classifier readback failed: {}", cudaGetErrorString(status));
+        return false;
+    }
+
+    decode(batch, results);
+    return true;
+}
+
+void CardClassifier::decode(uint32_t batch, std::vector<CardClass>& results) const {
+    const size_t base = results.size();
+    results.resize(base + batch);
+
+    for (uint32_t i = 0; i < batch; i++) {
+        const float* logits = m_hostOutput + static_cast<size_t>(i) * m_outputWidth;
+
+        if (m_outputWidth == CARD_CLASSES) {
+            const auto [card, probability] = softmaxMax(logits, CARD_CLASSES);
+            results[base + i] = {static_cast<uint8_t>(card), probability};
+        } else {
+            const auto [rank, rankProbability] = softmaxMax(logits, RANK_CLASSES);
+            const auto [suit, suitProbability] = softmaxMax(logits + RANK_CLASSES, SUIT_CLASSES);
+            results[base + i] = {static_cast<uint8_t>(suit * RANK_CLASSES + rank),
+                          rankProbability * suitProbability};
+        }
+    }
+}
+
+} // namespace vision
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "tensorrt_engine.hpp"
+#include "../preprocessing/preprocessor.hpp"
+#include "../../capture/capture_interface.hpp"
+#include "../../capture/roi_detector.hpp"
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace vision {
+
+struct CardClass {
+    uint8_t card_id;   // suit * 13 + rank index, as core::cardFromId expects
+    float confidence;  // Softmax probability (rank x suit for factored heads)
+};
+
+// Rank/suit classifier over small card crops, on its own runtime, context
+// and stream. Accepts either a 52-way head or a factored 13 rank + 4 suit
+// head; both are expected to emit logits.
+class CardClassifier {
+public:
+    explicit CardClassifier(uint32_t maxBatch);
+    ~CardClassifier();
+
+    bool loadSerializedEngine(const std::string& enginePath);
+
+    // Letterboxes each crop of the frame into the batch and classifies them,
+    // one execution per getMaxBatch() crops; blocks until the results are back
+    bool classify(const capture::Frame& frame,
+                  std::span<const capture::ROI> crops,
+                  std::vector<CardClass>& results);
+
+    uint32_t getInputSize() const { return m_inputSize; }
+    uint32_t getMaxBatch() const { return m_maxBatch; }
+    cudaStream_t getStream() const { return m_stream; }
+
+private:
+    static constexpr const char* INPUT_TENSOR = "images";
+    static constexpr const char* OUTPUT_TENSOR = "output0";
+
+    bool classifyBatch(const capture::Frame& frame,
+                       std::span<const capture::ROI> crops,
+                       std::vector<CardClass>& results);
+    // Appends one result per batch item
+    void decode(uint32_t batch, std::vector<CardClass>& results) const;
+
+    TRTLogger m_logger;
+    std::unique_ptr<nvinfer1::IRuntime> m_runtime;
+    std::unique_ptr<nvinfer1::ICudaEngine> m_engine;
+    std::unique_ptr<nvinfer1::IExecutionContext> m_context;
+
+    Preprocessor m_preprocessor;
+    cudaStream_t m_stream{nullptr};
+    void* m_deviceInput{nullptr};
+    float* m_deviceOutput{nullptr};
+    float* m_hostOutput{nullptr};  // Pinned
+
+    uint32_t m_maxBatch;
+    uint32_t m_inputSize{0};
+    uint32_t m_outputWidth{0};  // 52, or 17 for rank + suit
+    cuda::TensorPrecision m_inputPrecision{cuda::TensorPrecision::FP32};
+    uint32_t m_activeBatch{0};
+    bool m_dynamicBatch{false};
+};
+
+} // namespace vision
@@ -0,0 +1,172 @@
+#include "cascade_detector.hpp"
+#include "../../utils/logger.hpp"
+#include <algorithm>
+
+namespace vision {
+
+namespace {
+
+float overlap(const core::Detection& a, const core::Detection& b) {
+    const float x1 = std::max(a.x, b.x);
+    const float y1 = std::max(a.y, b.y);
+    const float x2 = std::min(a.x + a.width, b.x + b.width);
+    const float y2 = std::min(a.y + a.height, b.y + b.height);
+
+    const float intersection = std::max(0.0f, x2 - x1) * std::max(0.0f, y2 - y1);
+    const float unionArea = a.width * a.height + b.width * b.height - intersection;
+    return unionArea > 0.0f ? intersection / unionArea : 0.0f;
+}
+
+} // namespace
+
+CascadeDetector::CascadeDetector(const core::VisionConfig& config)
+    : m_localizerConfig(config)
+    , m_skipConfidence(config.cascade_skip_confidence) {
+    // Localizer engine: single "card" class at a reduced resolution
+    m_localizerConfig.model_path = config.localizer_model_path;
+    m_localizerConfig.input_resolution = {config.localizer_input_size, config.localizer_input_size};
+    m_localizerConfig.inflight_depth = 1;  // Driven synchronously, one frame at a time
+
+    m_classifier = std::make_unique<CardClassifier>(config.classifier_max_batch);
+
+    const size_t capacity = core::constants::MAX_DETECTIONS_PER_FRAME;
+    m_identified.reserve(capacity);
+    m_boxes.reserve(capacity);
+    m_crops.reserve(capacity);
+    m_cropOwners.reserve(capacity);
+    m_classes.reserve(capacity);
+}
+
+CascadeDetector::~CascadeDetector() {
+}
+
+bool CascadeDetector::initialize() {
+    auto& logger = utils::Logger::getInstance();
+
+    m_localizer = std::make_unique<TensorRTEngine>(m_localizerConfig);
+    if (!m_localizer->loadSerializedEngine(m_localizerConfig.model_path)) {
+        logger.error("Failed to load localizer engine: {}", m_localizerConfig.model_path);
+        return false;
+    }
+
+    if (m_localizer->getNumClasses() != 1) {
+        logger.warning("Localizer has {} classes, treating every class as \"card\"",
+                       m_localizer->getNumClasses());
+    }
+
+    if (!m_preprocessor.initialize(m_localizer->getInputWidth(), m_localizer->getInputHeight(),
+                                   m_localizer->getInputPrecision())) {
+        return false;
+    }
+
+    const std::string& classifierPath = m_localizerConfig.classifier_model_path;
+    if (!m_classifier->loadSerializedEngine(classifierPath)) {
+        logger.error("Failed to load classifier engine: {}", classifierPath);
+        return false;
+    }
+
+    logger.info("Cascade detector ready: {}x{} localizer, {}x{} classifier",
+                m_localizer->getInputWidth(), m_localizer->getInputHeight(),
+                m_classifier->getInputSize(), m_classifier->getInputSize());
+    return true;
+}
+
+void CascadeDetector::setIdentifiedCards(std::span<const core::Detection> cards) {
+    m_identified.clear();
+    for (const auto& card : cards) {
+        if (card.confidence >= m_skipConfidence) {
+            m_identified.push_back(card);
+        }
+    }
+}
+
+bool CascadeDetector::infer(const capture::Frame& frame,
+                            const capture::ROI* roi,
+                            std::vector<core::Detection>& detections,
+                            float confThreshold,
+                            float nmsThreshold) {
+    auto& logger = utils::Logger::getInstance();
+
+    m_frameWidth = frame.width;
+    m_frameHeight = frame.height;
+
+    // Stage 1: where are the cards
+    if (!m_preprocessor.process(frame, m_localizer->getDeviceInputBuffer(),
+                                m_localizer->getStream(), roi)) {
+        logger.error("Failed to preprocess frame for the localizer");
+        return false;
+    }
+    const auto transform = m_preprocessor.getLastTransform();
+    if (!m_localizer->inferDeviceInput(m_boxes, confThreshold, nmsThreshold,
+                                       std::span(&transform, 1))) {
+        return false;
+    }
+
+    // Known cards inherit their identity, the rest are queued for classification
+    detections.clear();
+    m_crops.clear();
+    m_cropOwners.clear();
+    m_lastReused = 0;
+
+    for (const auto& box : m_boxes) {
+        core::Detection det = box;
+        if (const core::Detection* known = findIdentified(box)) {
+            det.card_id = known->card_id;
+            det.confidence = std::min(box.confidence, known->confidence);
+            m_lastReused++;
+        } else {
+            m_crops.push_back(cropRegion(box));
+            m_cropOwners.push_back(detections.size());
+        }
+        detections.push_back(det);
+    }
+
+    // Stage 2: what are they
+    if (!m_crops.empty()) {
+        if (!m_classifier->classify(frame, m_crops, m_classes)) {
+            return false;
+        }
+
+        for (size_t i = 0; i < m_classes.size(); i++) {
+            auto& det = detections[m_cropOwners[i]];
+            det.card_id = m_classes[i].card_id;
+            det.confidence = det.confidence * m_classes[i].confidence;
+        }
+    }
+
+    // Localized but not confidently identified: not a detection yet
+    detections.erase(std::remove_if(detections.begin(), detections.end(),
+                                    [confThreshold](const core::Detection& d) {
+                                        return d.confidence < confThreshold;
+                                    }),
+                     detections.end());
+    return true;
+}
+
+capture::ROI CascadeDetector::cropRegion(const core::Detection& box) const {
+    const float marginX = box.width * CROP_MARGIN;
+    const float marginY = box.height * CROP_MARGIN;
+
+    const float x0 = std::clamp(box.x - marginX, 0.0f, static_cast<float>(m_frameWidth - 1));
+    const float y0 = std::clamp(box.y - marginY, 0.0f, static_cast<float>(m_frameHeight - 1));
+    const float x1 = std::clamp(box.x + box.width + marginX, x0 + 1.0f, static_cast<float>(m_frameWidth));
+    const float y1 = std::clamp(box.y + box.height + marginY, y0 + 1.0f, static_cast<float>(m_frameHeight));
+
+    return {static_cast<uint32_t>(x0), static_cast<uint32_t>(y0),
+            static_cast<uint32_t>(x1 - x0), static_cast<uint32_t>(y1 - y0)};
+}
+
+const core::Detection* CascadeDetector::findIdentified(const core::Detection& box) const {
+    const core::Detection* best = nullptr;
+    float bestOverlap = REUSE_IOU;
+    for (const auto& card : m_identified) {
+        const float iou = overlap(box, card);
+        if (iou >= bestOverlap) {
+            bestOverlap = iou;
+            best = &card;
+        }
+    }
+    return best;
+}
+
+} // namespace vision
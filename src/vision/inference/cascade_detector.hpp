@@ -0,0 +1,62 @@
+#pragma once
+
+#include "tensorrt_engine.hpp"
+#include "card_classifier.hpp"
+#include "../preprocessing/preprocessor.hpp"
+#include "../../capture/roi_detector.hpp"
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace vision {
+
+// Two-stage detection: a small single-class localizer finds the cards, then
+// only the crops that are not already known go through the rank/suit
+// classifier. Cards the tracker has identified with high confidence keep
+// their identity and cost no classifier work.
+class CascadeDetector {
+public:
+    explicit CascadeDetector(const core::VisionConfig& config);
+    ~CascadeDetector();
+
+    bool initialize();
+
+    // Latest high-confidence identities from the tracker, in frame coordinates
+    void setIdentifiedCards(std::span<const core::Detection> cards);
+
+    bool infer(const capture::Frame& frame,
+               const capture::ROI* roi,
+               std::vector<core::Detection>& detections,
+               float confThreshold,
+               float nmsThreshold);
+
+    cudaStream_t getStream() const { return m_localizer->getStream(); }
+    uint32_t getLastClassifiedCount() const { return static_cast<uint32_t>(m_crops.size()); }
+    uint32_t getLastReusedCount() const { return m_lastReused; }
+
+private:
+    capture::ROI cropRegion(const core::Detection& box) const;
+    const core::Detection* findIdentified(const core::Detection& box) const;
+
+    core::VisionConfig m_localizerConfig;  // Vision config retargeted at the localizer model
+    std::unique_ptr<TensorRTEngine> m_localizer;
+    std::unique_ptr<CardClassifier> m_classifier;
+    Preprocessor m_preprocessor;
+
+    float m_skipConfidence;
+    uint32_t m_frameWidth{0};
+    uint32_t m_frameHeight{0};
+    uint32_t m_lastReused{0};
+
+    // Reused every frame, capacity reserved up front
+    std::vector<core::Detection> m_identified;
+    std::vector<core::Detection> m_boxes;
+    std::vector<capture::ROI> m_crops;
+    std::vector<size_t> m_cropOwners;  // Index into detections for each crop
+    std::vector<CardClass> m_classes;
+
+    static constexpr float CROP_MARGIN = 0.1f;   // Context around a localized card
+    static constexpr float REUSE_IOU = 0.5f;     // Overlap to inherit a tracked identity
+};
+
+} // namespace vision
@@ -0,0 +1,408 @@
+#include "engine_cache.hpp"
+#include "../../core/constants.hpp"
+#include "../../utils/logger.hpp"
+#include "../../utils/mapped_file.hpp"
+#include "int8_calibrator.hpp"
+#include <cuda_runtime_api.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace vision {
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+uint64_t fnv1a(const uint8_t* data, size_t size, uint64_t hash = FNV_OFFSET) {
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+template<typename T>
+uint64_t fnv1a(const T& value, uint64_t hash) {
+    return fnv1a(reinterpret_cast<const uint8_t*>(&value), sizeof(T), hash);
+}
+
+// Readers never see a partially written plan: write aside, then rename
+bool writeFileAtomic(const std::filesystem::path& path, const void* data, size_t size) {
+    const auto temp = std::filesystem::path(path).concat(".tmp");
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file.good()) return false;
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        if (!file.good()) return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    if (error) {
+        std::filesystem::remove(temp, error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+uint64_t EngineCache::EngineKey::digest() const {
+    uint64_t hash = fnv1a(onnxHash, FNV_OFFSET);
+    hash = fnv1a(tensorrtVersion, hash);
+    hash = fnv1a(smVersion, hash);
+    hash = fnv1a(fp16, hash);
+    hash = fnv1a(fp16IO, hash);
+    hash = fnv1a(int8, hash);
+    hash = fnv1a(maxBatch, hash);
+    hash = fnv1a(inputWidth, hash);
+    hash = fnv1a(inputHeight, hash);
+    hash = fnv1a(calibrationHash, hash);
+    return fnv1a(profilesHash, hash);
+}
+
+EngineCache::EngineCache(const core::VisionConfig& config)
+    : m_config(config) {
+}
+
+EngineCache::~EngineCache() {
+    if (m_buildThread.joinable()) {
+        if (isBuilding()) {
+            utils::Logger::getInstance().info("Waiting for the background engine build to finish");
+        }
+        m_buildThread.join();
+    }
+}
+
+std::unique_ptr<TensorRTEngine> EngineCache::acquireEngine() {
+    auto& logger = utils::Logger::getInstance();
+
+    // No ONNX to build from: serve the prebuilt plan as before
+    if (!computeKey()) {
+        logger.info("No ONNX model at {}, loading {} directly", m_config.onnx_path, m_config.model_path);
+        return loadPlanFile(m_config.model_path);
+    }
+
+    if (auto engine = loadPlanFile(m_planPath)) {
+        logger.info("Engine cache hit: {}", m_planPath);
+        return engine;
+    }
+
+    logger.warning("Engine cache miss for {} (TensorRT {}, SM {})",
+                   m_config.onnx_path, m_key.tensorrtVersion, m_key.smVersion);
+    loadTimingCache();
+
+    if (!m_config.background_engine_build) {
+        auto plan = buildAndStore(-1, true);
+        if (!plan) return nullptr;
+
+        auto engine = std::make_unique<TensorRTEngine>(m_config);
+        if (!engine->loadPlan(plan->data(), plan->size())) return nullptr;
+        return engine;
+    }
+
+    auto fallback = loadFallback();
+    if (!fallback) {
+        logger.error("No fallback engine available");
+        return nullptr;
+    }
+
+    m_building.store(true, std::memory_order_release);
+    m_buildThread = std::thread(&EngineCache::backgroundBuild, this);
+    return fallback;
+}
+
+std::unique_ptr<TensorRTEngine> EngineCache::takeReadyEngine() {
+    std::lock_guard<std::mutex> lock(m_readyMutex);
+    m_ready.store(false, std::memory_order_release);
+    return std::move(m_readyEngine);
+}
+
+bool EngineCache::computeKey() {
+    auto& logger = utils::Logger::getInstance();
+
+    utils::MappedFile onnx;
+    if (!onnx.open(m_config.onnx_path)) {
+        return false;
+    }
+
+    int device = 0;
+    cudaDeviceProp properties{};
+    if (cudaGetDevice(&device) != cudaSuccess ||
+        cudaGetDeviceProperties(&properties, device) != cudaSuccess) {
+        logger.error("Failed to query the CUDA device for the engine cache key");
+        return false;
+    }
+
+    m_key.onnxHash = fnv1a(onnx.data(), onnx.size());
+    m_key.tensorrtVersion = getInferLibVersion();
+    m_key.smVersion = properties.major * 10 + properties.minor;
+    m_key.fp16 = m_config.use_fp16;
+    m_key.fp16IO = m_config.use_fp16 && m_config.fp16_io;
+    m_key.int8 = m_config.use_int8;
+    m_key.maxBatch = std::max(m_config.batch_size, 1u);
+    m_key.inputWidth = m_config.input_resolution[0];
+    m_key.inputHeight = m_config.input_resolution[1];
+    m_key.profilesHash = fnv1a(reinterpret_cast<const uint8_t*>(m_config.resolution_profiles.data()),
+                               m_config.resolution_profiles.size() * sizeof(uint32_t));
+
+    // New calibration scales must not be answered with the old INT8 plan
+    utils::MappedFile calibration;
+    if (m_config.use_int8 && calibration.open(m_config.calibration_cache)) {
+        m_key.calibrationHash = fnv1a(calibration.data(), calibration.size());
+    }
+
+    char digest[17];
+    std::snprintf(digest, sizeof(digest), "%016llx",
+                  static_cast<unsigned long long>(m_key.digest()));
+
+    const std::filesystem::path directory(m_config.engine_cache_dir);
+    const std::string stem = std::filesystem::path(m_config.onnx_path).stem().string();
+    m_planPath = (directory / (stem + "_" + digest + ".plan")).string();
+    m_timingCachePath = (directory / ("timing_trt" + std::to_string(m_key.tensorrtVersion) +
+                                      "_sm" + std::to_string(m_key.smVersion) + ".cache")).string();
+    return true;
+}
+
+std::unique_ptr<TensorRTEngine> EngineCache::loadPlanFile(const std::string& path) const {
+    if (!std::filesystem::exists(path)) {
+        return nullptr;
+    }
+
+    auto engine = std::make_unique<TensorRTEngine>(m_config);
+    if (!engine->loadSerializedEngine(path)) {
+        return nullptr;
+    }
+    return engine;
+}
+
+// Serve something now: previous plan of this model, then the light fallback
+// model, then a quick low-optimization build of the real model
+std::unique_ptr<TensorRTEngine> EngineCache::loadFallback() {
+    auto& logger = utils::Logger::getInstance();
+    std::error_code error;
+
+    // Previous plans of the same model, newest first. Plans from another
+    // TensorRT version fail to deserialize and are skipped.
+    const std::string prefix = std::filesystem::path(m_config.onnx_path).stem().string() + "_";
+    std::vector<std::filesystem::directory_entry> previous;
+    for (const auto& entry : std::filesystem::directory_iterator(m_config.engine_cache_dir, error)) {
+        const auto name = entry.path().filename().string();
+        if (entry.path().extension() == ".plan" && name.rfind(prefix, 0) == 0 &&
+            entry.path() != std::filesystem::path(m_planPath)) {
+            previous.push_back(entry);
+        }
+    }
+    std::sort(previous.begin(), previous.end(), [](const auto& a, const auto& b) {
+        std::error_code ignored;
+        return a.last_write_time(ignored) > b.last_write_time(ignored);
+    });
+
+    for (const auto& entry : previous) {
+        auto engine = loadPlanFile(entry.path().string());
+        if (engine && matchesInput(*engine)) {
+            logger.info("Serving previous plan {} until the rebuild completes", entry.path().string());
+            return engine;
+        }
+    }
+
+    if (!m_config.fallback_model_path.empty()) {
+        auto engine = loadPlanFile(m_config.fallback_model_path);
+        if (engine && matchesInput(*engine)) {
+            logger.info("Serving fallback model {} until the rebuild completes",
+                        m_config.fallback_model_path);
+            return engine;
+        }
+    }
+
+    // Level 0 skips tactic autotuning: seconds instead of minutes, slower kernels
+    logger.info("Building a low-optimization engine to serve during the full build");
+    auto plan = buildAndStore(0, false);
+    if (!plan) return nullptr;
+
+    auto engine = std::make_unique<TensorRTEngine>(m_config);
+    if (!engine->loadPlan(plan->data(), plan->size())) return nullptr;
+    return engine;
+}
+
+// The pipeline's preprocessing is sized for the configured input, so a
+// fallback or swapped-in engine must take exactly that input
+bool EngineCache::matchesInput(const TensorRTEngine& engine) const {
+    if (engine.getInputWidth() == m_config.input_resolution[0] &&
+        engine.getInputHeight() == m_config.input_resolution[1]) {
+        return true;
+    }
+
+    utils::Logger::getInstance().warning("Skipping {}x{} engine, pipeline input is {}x{}",
+                                         engine.getInputWidth(), engine.getInputHeight(),
+                                         m_config.input_resolution[0], m_config.input_resolution[1]);
+    return false;
+}
+
+std::unique_ptr<nvinfer1::IHostMemory> EngineCache::buildAndStore(int optimizationLevel, bool persist) {
+    auto& logger = utils::Logger::getInstance();
+    const auto start = std::chrono::steady_clock::now();
+
+    auto plan = TensorRTEngine::buildPlan(m_config, m_config.onnx_path, &m_timingCache, optimizationLevel);
+    if (!plan) {
+        return nullptr;
+    }
+
+    // A bad calibration costs cards: fall back to the FP16 plan
+    if (m_config.use_int8 && !passesAccuracyGate(*plan)) {
+        core::VisionConfig fp16Config = m_config;
+        fp16Config.use_int8 = false;
+        plan = TensorRTEngine::buildPlan(fp16Config, m_config.onnx_path, &m_timingCache, optimizationLevel);
+        if (!plan) {
+            return nullptr;
+        }
+    }
+
+    const auto seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+    logger.info("Engine build took {:.1f} s", seconds);
+
+    saveTimingCache();
+
+    // Calibration just wrote its cache: re-key so the next start hits this plan
+    if (m_config.use_int8) {
+        computeKey();
+    }
+
+    if (persist) {
+        std::error_code error;
+        std::filesystem::create_directories(m_config.engine_cache_dir, error);
+        if (writeFileAtomic(m_planPath, plan->data(), plan->size())) {
+            logger.info("Cached engine plan: {}", m_planPath);
+        } else {
+            logger.warning("Failed to write engine plan {}, it will be rebuilt next start", m_planPath);
+        }
+    }
+
+    return plan;
+}
+
+bool EngineCache::passesAccuracyGate(const nvinfer1::IHostMemory& plan) const {
+    auto& logger = utils::Logger::getInstance();
+
+    TensorRTEngine engine(m_config);
+    if (!engine.loadPlan(plan.data(), plan.size())) {
+        return false;
+    }
+    engine.writeLayerReport(m_planPath + ".layers.json");
+
+    if (!m_config.int8_accuracy_gate) {
+        return true;
+    }
+
+    // Scored on held-out frames: the calibrator fitted its ranges to calibration_dir
+    CalibrationDataset validation;
+    if (m_config.int8_validation_dir.empty() || m_config.int8_validation_dir == m_config.calibration_dir ||
+        !validation.open(m_config.int8_validation_dir, 0) || validation.getLabeledCount() == 0) {
+        logger.error("INT8 accuracy gate has no held-out labeled frames in {}, rejecting the INT8 plan",
+                     m_config.int8_validation_dir);
+        return false;
+    }
+
+    const auto accuracy = evaluateAccuracy(engine, validation,
+                                           m_config.confidence_threshold, m_config.nms_threshold);
+    logger.info("INT8 accuracy on {} frames: precision {:.4f}, recall {:.4f} ({} TP, {} FP, {} FN)",
+                accuracy.frames, accuracy.precision, accuracy.recall,
+                accuracy.truePositives, accuracy.falsePositives, accuracy.falseNegatives);
+
+    if (accuracy.precision < core::constants::DETECTION_PRECISION ||
+        accuracy.recall < core::constants::DETECTION_RECALL) {
+        logger.error("INT8 plan below the {:.3f} precision / {:.3f} recall gate, rebuilding as FP16",
+                     core::constants::DETECTION_PRECISION, core::constants::DETECTION_RECALL);
+        return false;
+    }
+    return true;
+}
+
+bool EngineCache::startRebuild() {
+    if (m_building.load(std::memory_order_acquire) || m_buildThread.joinable()) {
+        return false;
+    }
+
+    m_building.store(true, std::memory_order_release);
+    m_buildThread = std::thread(&EngineCache::backgroundRebuild, this);
+    return true;
+}
+
+void EngineCache::backgroundRebuild() {
+    auto& logger = utils::Logger::getInstance();
+
+    std::unique_ptr<TensorRTEngine> engine;
+    if (!computeKey()) {
+        logger.info("No ONNX model at {}, loading {} directly", m_config.onnx_path, m_config.model_path);
+        engine = loadPlanFile(m_config.model_path);
+    } else if ((engine = loadPlanFile(m_planPath))) {
+        logger.info("Engine cache hit: {}", m_planPath);
+    } else {
+        logger.warning("Engine cache miss for {}, building in the background", m_config.onnx_path);
+        loadTimingCache();
+        backgroundBuild();
+        return;
+    }
+
+    if (engine && matchesInput(*engine)) {
+        engine->warmup(3);
+        std::lock_guard<std::mutex> lock(m_readyMutex);
+        m_readyEngine = std::move(engine);
+        m_ready.store(true, std::memory_order_release);
+        logger.info("Rebuilt engine ready for hot-swap");
+    } else {
+        logger.error("Engine rebuild failed, staying on the current engine");
+    }
+
+    m_building.store(false, std::memory_order_release);
+}
+
+void EngineCache::backgroundBuild() {
+    auto& logger = utils::Logger::getInstance();
+
+    auto plan = buildAndStore(-1, true);
+    std::unique_ptr<TensorRTEngine> engine;
+    if (plan) {
+        engine = std::make_unique<TensorRTEngine>(m_config);
+        if (!engine->loadPlan(plan->data(), plan->size()) || !matchesInput(*engine)) {
+            engine.reset();
+        } else {
+            engine->warmup(3);
+        }
+    }
+
+    if (engine) {
+        std::lock_guard<std::mutex> lock(m_readyMutex);
+        m_readyEngine = std::move(engine);
+        m_ready.store(true, std::memory_order_release);
+        logger.info("Background engine build ready for hot-swap");
+    } else {
+        logger.error("Background engine build failed, staying on the fallback engine");
+    }
+
+    m_building.store(false, std::memory_order_release);
+}
+
+void EngineCache::loadTimingCache() {
+    utils::MappedFile file;
+    if (file.open(m_timingCachePath)) {
+        m_timingCache.assign(file.data(), file.data() + file.size());
+        utils::Logger::getInstance().info("Loaded timing cache {} ({} bytes)",
+                                          m_timingCachePath, m_timingCache.size());
+    }
+}
+
+void EngineCache::saveTimingCache() {
+    if (m_timingCache.empty()) return;
+
+    std::error_code error;
+    std::filesystem::create_directories(m_config.engine_cache_dir, error);
+    if (!writeFileAtomic(m_timingCachePath, m_timingCache.data(), m_timingCache.size())) {
+        utils::Logger::getInstance().warning("Failed to write timing cache {}", m_timingCachePath);
+    }
+}
+
+} // namespace vision
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "tensorrt_engine.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vision {
+
+// On-disk cache of TensorRT plans built from the configured ONNX model.
+// Plans are keyed by everything that invalidates them, so a driver or
+// TensorRT upgrade is a cache miss rather than a deserialization failure.
+// On a miss the caller gets a fallback engine immediately and the real plan
+// is built on a background thread, to be hot-swapped in when ready.
+class EngineCache {
+public:
+    explicit EngineCache(const core::VisionConfig& config);
+    ~EngineCache();  // Waits for a running build
+
+    EngineCache(const EngineCache&) = delete;
+    EngineCache& operator=(const EngineCache&) = delete;
+
+    // Engine to start serving with: the cached plan on a hit; on a miss a
+    // fallback (previous plan, the light fallback model, or a quick
+    // low-optimization build) while the full build runs in the background.
+    // Without background builds a miss blocks until the plan is built.
+    std::unique_ptr<TensorRTEngine> acquireEngine();
+
+    // Background build finished; the engine is loaded and warmed up
+    bool hasReadyEngine() const { return m_ready.load(std::memory_order_acquire); }
+
+    // Engine for a configuration change while another engine keeps serving:
+    // the cached plan is loaded, or the full plan built, entirely on the
+    // background thread and handed over through takeReadyEngine()
+    bool startRebuild();
+    std::unique_ptr<TensorRTEngine> takeReadyEngine();
+
+    bool isBuilding() const { return m_building.load(std::memory_order_acquire); }
+    const std::string& getPlanPath() const { return m_planPath; }
+
+private:
+    // Inputs a plan depends on
+    struct EngineKey {
+        uint64_t onnxHash{0};
+        int32_t tensorrtVersion{0};
+        int32_t smVersion{0};     // major * 10 + minor
+        bool fp16{false};
+        bool fp16IO{false};
+        bool int8{false};
+        uint32_t maxBatch{0};
+        uint32_t inputWidth{0};
+        uint32_t inputHeight{0};
+        uint64_t calibrationHash{0};  // INT8: calibration cache contents
+        uint64_t profilesHash{0};     // resolution_profiles
+
+        uint64_t digest() const;
+    };
+
+    bool computeKey();
+    std::unique_ptr<TensorRTEngine> loadPlanFile(const std::string& path) const;
+    std::unique_ptr<TensorRTEngine> loadFallback();
+    bool matchesInput(const TensorRTEngine& engine) const;
+
+    std::unique_ptr<nvinfer1::IHostMemory> buildAndStore(int optimizationLevel, bool persist);
+    bool passesAccuracyGate(const nvinfer1::IHostMemory& plan) const;
+    void backgroundBuild();
+    void backgroundRebuild();
+
+    void loadTimingCache();
+    void saveTimingCache();
+
+    const core::VisionConfig m_config;  // Copied, like the engines built from it
+    EngineKey m_key{};
+    std::string m_planPath;
+    std::string m_timingCachePath;
+    std::vector<char> m_timingCache;  // Only touched by one build at a time
+
+    std::thread m_buildThread;
+    std::atomic<bool> m_building{false};
+    std::atomic<bool> m_ready{false};
+    std::mutex m_readyMutex;
+    std::unique_ptr<TensorRTEngine> m_readyEngine;
+};
+
+} // namespace vision
@@ -0,0 +1,323 @@
+#include "int8_calibrator.hpp"
+#include "tensorrt_engine.hpp"
+#include "../../utils/gpu_memory_pool.hpp"
+#include "../../utils/logger.hpp"
+#include "../../utils/mapped_file.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace vision {
+
+namespace {
+
+// Skips whitespace and '#' comments between PPM header fields
+bool readHeaderValue(const uint8_t*& cursor, const uint8_t* end, uint32_t& value) {
+    while (cursor < end) {
+        if (*cursor == '#') {
+            while (cursor < end && *cursor != '\n') cursor++;
+        } else if (std::isspace(*cursor)) {
+            cursor++;
+        } else {
+            break;
+        }
+    }
+
+    value = 0;
+    const uint8_t* start = cursor;
+    while (cursor < end && std::isdigit(*cursor)) {
+        value = value * 10 + (*cursor - '0');
+        cursor++;
+    }
+    return cursor != start;
+}
+
+float iou(const core::Detection& a, const core::Detection& b) {
+    const float x1 = std::max(a.x, b.x);
+    const float y1 = std::max(a.y, b.y);
+    const float x2 = std::min(a.x + a.width, b.x + b.width);
+    const float y2 = std::min(a.y + a.height, b.y + b.height);
+
+    const float intersection = std::max(0.0f, x2 - x1) * std::max(0.0f, y2 - y1);
+    const float unionArea = a.width * a.height + b.width * b.height - intersection;
+    return unionArea > 0.0f ? intersection / unionArea : 0.0f;
+}
+
+} // namespace
+
+// CalibrationDataset
+
+bool CalibrationDataset::open(const std::string& directory, uint32_t maxFrames) {
+    m_frames.clear();
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (entry.path().extension() != ".ppm") continue;
+
+        Entry frame;
+        frame.framePath = entry.path().string();
+        auto label = entry.path();
+        label.replace_extension(".txt");
+        if (std::filesystem::exists(label, error)) {
+            frame.labelPath = label.string();
+        }
+        m_frames.push_back(std::move(frame));
+    }
+
+    // Stable order keeps calibration reproducible; spread the cap over the whole capture
+    std::sort(m_frames.begin(), m_frames.end(),
+              [](const Entry& a, const Entry& b) { return a.framePath < b.framePath; });
+    if (maxFrames > 0 && m_frames.size() > maxFrames) {
+        std::vector<Entry> sampled;
+        sampled.reserve(maxFrames);
+        for (uint32_t i = 0; i < maxFrames; i++) {
+            sampled.push_back(m_frames[i * m_frames.size() / maxFrames]);
+        }
+        m_frames = std::move(sampled);
+    }
+
+    return !m_frames.empty();
+}
+
+size_t CalibrationDataset::getLabeledCount() const {
+    return static_cast<size_t>(std::count_if(m_frames.begin(), m_frames.end(),
+                                             [](const Entry& e) { return !e.labelPath.empty(); }));
+}
+
+bool CalibrationDataset::loadFrame(size_t index, std::vector<uint8_t>& bgra,
+                                   uint32_t& width, uint32_t& height) const {
+    auto& logger = utils::Logger::getInstance();
+
+    utils::MappedFile file;
+    if (!file.open(m_frames[index].framePath)) {
+        logger.error("Failed to open calibration frame {}", m_frames[index].framePath);
+        return false;
+    }
+
+    const uint8_t* cursor = file.data();
+    const uint8_t* end = file.data() + file.size();
+    uint32_t maxValue = 0;
+
+    if (file.size() < 2 || cursor[0] != 'P' || cursor[1] != '6') {
+        logger.error("{} is not a binary PPM", m_frames[index].framePath);
+        return false;
+    }
+    cursor += 2;
+
+    if (!readHeaderValue(cursor, end, width) || !readHeaderValue(cursor, end, height) ||
+        !readHeaderValue(cursor, end, maxValue) || maxValue != 255) {
+        logger.error("Unsupported PPM header in {}", m_frames[index].framePath);
+        return false;
+    }
+    cursor++;  // Single whitespace before the raster
+
+    const size_t pixels = static_cast<size_t>(width) * height;
+    if (static_cast<size_t>(end - cursor) < pixels * 3) {
+        logger.error("Truncated PPM {}", m_frames[index].framePath);
+        return false;
+    }
+
+    bgra.resize(pixels * 4);
+    for (size_t i = 0; i < pixels; i++) {
+        bgra[i * 4 + 0] = cursor[i * 3 + 2];
+        bgra[i * 4 + 1] = cursor[i * 3 + 1];
+        bgra[i * 4 + 2] = cursor[i * 3 + 0];
+        bgra[i * 4 + 3] = 255;
+    }
+    return true;
+}
+
+bool CalibrationDataset::loadLabels(size_t index, uint32_t width, uint32_t height,
+                                    std::vector<core::Detection>& labels) const {
+    labels.clear();
+    if (m_frames[index].labelPath.empty()) return false;
+
+    std::ifstream file(m_frames[index].labelPath);
+    if (!file.good()) return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        int classId = 0;
+        float cx = 0.0f, cy = 0.0f, w = 0.0f, h = 0.0f;
+        if (!(fields >> classId >> cx >> cy >> w >> h)) continue;
+
+        core::Detection label{};
+        label.x = (cx - w * 0.5f) * width;
+        label.y = (cy - h * 0.5f) * height;
+        label.width = w * width;
+        label.height = h * height;
+        label.card_id = static_cast<uint8_t>(classId);
+        label.confidence = 1.0f;
+        labels.push_back(label);
+    }
+    return true;
+}
+
+// EntropyCalibrator
+
+EntropyCalibrator::EntropyCalibrator(const CalibrationDataset& dataset,
+                                     uint32_t batchSize,
+                                     uint32_t inputWidth,
+                                     uint32_t inputHeight,
+                                     const std::string& cachePath,
+                                     cuda::TensorPrecision precision)
+    : m_dataset(dataset)
+    , m_batchSize(std::max(batchSize, 1u))
+    , m_cachePath(cachePath) {
+
+    auto& logger = utils::Logger::getInstance();
+
+    m_imageBytes = static_cast<size_t>(3) * inputWidth * inputHeight * cuda::elementSize(precision);
+    // Filled and drained on m_stream in getBatch(), so ordered on it
+    if (m_preprocessor.initialize(inputWidth, inputHeight, precision) &&
+        cudaStreamCreateWithFlags(&m_stream, cudaStreamNonBlocking) == cudaSuccess) {
+        m_deviceBatch = utils::GpuMemoryPool::getInstance().allocate(
+            m_imageBytes * m_batchSize, utils::MemoryTag::Inference, m_stream);
+    }
+    if (!m_deviceBatch) {
+        logger.error("Failed to allocate INT8 calibration buffers");
+    }
+
+    logger.info("INT8 calibrator: {} frames, batch {}, cache {}",
+                m_dataset.size(), m_batchSize, m_cachePath);
+}
+
+EntropyCalibrator::~EntropyCalibrator() {
+    utils::GpuMemoryPool::getInstance().release(m_deviceBatch, m_stream);
+    if (m_stream) cudaStreamDestroy(m_stream);
+}
+
+bool EntropyCalibrator::isUsable() const {
+    if (!m_deviceBatch) return false;
+    return m_dataset.size() >= m_batchSize || std::filesystem::exists(m_cachePath);
+}
+
+bool EntropyCalibrator::getBatch(void* bindings[], const char* names[], int32_t nbBindings) noexcept {
+    (void)names;
+    if (nbBindings < 1 || m_nextFrame + m_batchSize > m_dataset.size()) {
+        return false;  // Calibration done
+    }
+
+    auto* batch = static_cast<uint8_t*>(m_deviceBatch);
+    for (uint32_t i = 0; i < m_batchSize; i++, m_nextFrame++) {
+        uint32_t width = 0, height = 0;
+        if (!m_dataset.loadFrame(m_nextFrame, m_hostFrame, width, height)) {
+            return false;
+        }
+
+        capture::Frame frame{};
+        frame.data = m_hostFrame.data();
+        frame.width = width;
+        frame.height = height;
+        frame.stride = width * 4;
+        frame.memory = capture::FrameMemory::Host;
+
+        // Host frame: pageable upload, so finish before the buffer is reused
+        if (!m_preprocessor.process(frame, batch + i * m_imageBytes, m_stream) ||
+            cudaStreamSynchronize(m_stream) != cudaSuccess) {
+            return false;
+        }
+    }
+
+    bindings[0] = m_deviceBatch;
+    return true;
+}
+
+const void* EntropyCalibrator::readCalibrationCache(std::size_t& length) noexcept {
+    m_cache.clear();
+
+    std::ifstream file(m_cachePath, std::ios::binary);
+    if (file.good()) {
+        m_cache.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    length = m_cache.size();
+    if (!m_cache.empty()) {
+        utils::Logger::getInstance().info("Using INT8 calibration cache {}", m_cachePath);
+    }
+    return m_cache.empty() ? nullptr : m_cache.data();
+}
+
+void EntropyCalibrator::writeCalibrationCache(const void* cache, std::size_t length) noexcept {
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(m_cachePath).parent_path(), error);
+
+    std::ofstream file(m_cachePath, std::ios::binary | std::ios::trunc);
+    file.write(static_cast<const char*>(cache), static_cast<std::streamsize>(length));
+    if (!file.good()) {
+        utils::Logger::getInstance().warning("Failed to write calibration cache {}", m_cachePath);
+    }
+}
+
+// Accuracy gate
+
+DetectionAccuracy evaluateAccuracy(TensorRTEngine& engine,
+                                   const CalibrationDataset& dataset,
+                                   float confThreshold,
+                                   float nmsThreshold) {
+    DetectionAccuracy accuracy;
+
+    Preprocessor preprocessor;
+    if (!preprocessor.initialize(engine.getInputWidth(), engine.getInputHeight(),
+                                 engine.getInputPrecision())) {
+        return accuracy;
+    }
+
+    std::vector<uint8_t> pixels;
+    std::vector<core::Detection> labels;
+    std::vector<core::Detection> detections;
+    std::vector<bool> matched;
+
+    for (size_t i = 0; i < dataset.size(); i++) {
+        uint32_t width = 0, height = 0;
+        if (!dataset.loadFrame(i, pixels, width, height) ||
+            !dataset.loadLabels(i, width, height, labels)) {
+            continue;
+        }
+
+        capture::Frame frame{};
+        frame.data = pixels.data();
+        frame.width = width;
+        frame.height = height;
+        frame.stride = width * 4;
+        frame.memory = capture::FrameMemory::Host;
+
+        if (!preprocessor.process(frame, engine.getDeviceInputBuffer(), engine.getStream())) {
+            continue;
+        }
+        const auto transform = preprocessor.getLastTransform();
+        if (!engine.inferDeviceInput(detections, confThreshold, nmsThreshold,
+                                     std::span(&transform, 1))) {
+            continue;
+        }
+
+        // Greedy one-to-one matching, most confident detection first
+        std::sort(detections.begin(), detections.end(),
+                  [](const auto& a, const auto& b) { return a.confidence > b.confidence; });
+        matched.assign(labels.size(), false);
+
+        for (const auto& det : detections) {
+            bool hit = false;
+            for (size_t l = 0; l < labels.size() && !hit; l++) {
+                if (!matched[l] && labels[l].card_id == det.card_id && iou(det, labels[l]) >= 0.5f) {
+                    matched[l] = true;
+                    hit = true;
+                }
+            }
+            hit ? accuracy.truePositives++ : accuracy.falsePositives++;
+        }
+        accuracy.falseNegatives += static_cast<uint32_t>(std::count(matched.begin(), matched.end(), false));
+        accuracy.frames++;
+    }
+
+    const uint32_t predicted = accuracy.truePositives + accuracy.falsePositives;
+    const uint32_t actual = accuracy.truePositives + accuracy.falseNegatives;
+    accuracy.precision = predicted > 0 ? static_cast<float>(accuracy.truePositives) / predicted : 0.0f;
+    accuracy.recall = actual > 0 ? static_cast<float>(accuracy.truePositives) / actual : 0.0f;
+    return accuracy;
+}
+
+} // namespace vision
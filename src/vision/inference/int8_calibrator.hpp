@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../../core/types.hpp"
+#include "../preprocessing/preprocessor.hpp"
+#include <NvInfer.h>
+#include <cuda_runtime_api.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vision {
+
+class TensorRTEngine;
+
+// Directory of captured table frames (binary PPM, P6). A frame may carry a
+// YOLO label file of the same stem ("class cx cy w h", normalized), which
+// makes it usable for the accuracy gate as well.
+class CalibrationDataset {
+public:
+    bool open(const std::string& directory, uint32_t maxFrames);
+
+    size_t size() const { return m_frames.size(); }
+    size_t getLabeledCount() const;
+
+    // Decoded to BGRA, the capture format, so it takes the real preprocessing path
+    bool loadFrame(size_t index, std::vector<uint8_t>& bgra, uint32_t& width, uint32_t& height) const;
+    // Ground truth in frame pixels; false when the frame has no label file
+    bool loadLabels(size_t index, uint32_t width, uint32_t height,
+                    std::vector<core::Detection>& labels) const;
+
+private:
+    struct Entry {
+        std::string framePath;
+        std::string labelPath;  // Empty when unlabeled
+    };
+
+    std::vector<Entry> m_frames;
+};
+
+// Entropy calibration over a CalibrationDataset. Batches are letterboxed by
+// the same Preprocessor the pipeline uses, so the activation ranges match
+// what the engine sees live. The scales are kept in a cache file and
+// reused on later builds without touching the frames. precision is the
+// type of the network input binding the batches are written for.
+class EntropyCalibrator : public nvinfer1::IInt8EntropyCalibrator2 {
+public:
+    EntropyCalibrator(const CalibrationDataset& dataset,
+                      uint32_t batchSize,
+                      uint32_t inputWidth,
+                      uint32_t inputHeight,
+                      const std::string& cachePath,
+                      cuda::TensorPrecision precision = cuda::TensorPrecision::FP32);
+    ~EntropyCalibrator() override;
+
+    // Frames to calibrate on, or a cache to read the scales from
+    bool isUsable() const;
+
+    int32_t getBatchSize() const noexcept override { return static_cast<int32_t>(m_batchSize); }
+    bool getBatch(void* bindings[], const char* names[], int32_t nbBindings) noexcept override;
+    const void* readCalibrationCache(std::size_t& length) noexcept override;
+    void writeCalibrationCache(const void* cache, std::size_t length) noexcept override;
+
+private:
+    const CalibrationDataset& m_dataset;
+    uint32_t m_batchSize;
+    size_t m_nextFrame{0};
+    std::string m_cachePath;
+    std::vector<char> m_cache;
+
+    Preprocessor m_preprocessor;
+    cudaStream_t m_stream{nullptr};
+    void* m_deviceBatch{nullptr};
+    size_t m_imageBytes{0};
+    std::vector<uint8_t> m_hostFrame;
+};
+
+struct DetectionAccuracy {
+    float precision{0.0f};
+    float recall{0.0f};
+    uint32_t truePositives{0};
+    uint32_t falsePositives{0};
+    uint32_t falseNegatives{0};
+    uint32_t frames{0};  // Labeled frames evaluated
+};
+
+// Runs the engine over the labeled frames; a detection matches a label of
+// the same card at IoU >= 0.5
+DetectionAccuracy evaluateAccuracy(TensorRTEngine& engine,
+                                   const CalibrationDataset& dataset,
+                                   float confThreshold,
+                                   float nmsThreshold);
+
+} // namespace vision
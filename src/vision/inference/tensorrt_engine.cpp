@@ -1,11 +1,61 @@
 #include "tensorrt_engine.hpp"
+#include "../../utils/gpu_memory_pool.hpp"
 #include "../../utils/logger.hpp"
+#include "../../utils/mapped_file.hpp"
+#include "../../utils/profiling.hpp"
+#include "int8_calibrator.hpp"
+#include <cuda_fp16.h>
 #include <algorithm>
+#include <numeric>
 #include <iostream>
 #include <cassert>
 
 namespace vision {
 
+namespace {
+
+// FP32 and FP16 bindings map onto the preprocessor/decode precisions
+bool toTensorPrecision(nvinfer1::DataType type, cuda::TensorPrecision& precision) {
+    switch (type) {
+        case nvinfer1::DataType::kFLOAT:
+            precision = cuda::TensorPrecision::FP32;
+            return true;
+        case nvinfer1::DataType::kHALF:
+            precision = cuda::TensorPrecision::FP16;
+            return true;
+        default:
+            return false;
+    }
+}
+
+const char* precisionName(cuda::TensorPrecision precision) {
+    return precision == cuda::TensorPrecision::FP16 ? "FP16" : "FP32";
+}
+
+// Build resolutions, ascending: each resolution_profiles entry is the input
+// width, the height keeps the input_resolution aspect on the 32-pixel grid
+// of the YOLO strides. input_resolution itself is always one of them.
+std::vector<std::pair<int, int>> profileResolutions(const core::VisionConfig& config) {
+    const uint32_t width = config.input_resolution[0];
+    const uint32_t height = config.input_resolution[1];
+
+    std::vector<std::pair<int, int>> resolutions{{static_cast<int>(width), static_cast<int>(height)}};
+    for (uint32_t size : config.resolution_profiles) {
+        const uint32_t profileWidth = std::max(size / 32, 1u) * 32;
+        const uint32_t profileHeight = std::max((profileWidth * height / width + 16) / 32, 1u) * 32;
+        resolutions.emplace_back(static_cast<int>(profileWidth), static_cast<int>(profileHeight));
+    }
+
+    std::sort(resolutions.begin(), resolutions.end());
+    resolutions.erase(std::unique(resolutions.begin(), resolutions.end()), resolutions.end());
+    return resolutions;
+}
+
+// Pool blocks start on the cudaMallocAsync granularity
+constexpr uint64_t POOL_ALIGNMENT = 256;
+
+} // namespace
+
 // TensorRT Logger Implementation
 void TRTLogger::log(Severity severity, const char* msg) noexcept {
     auto& logger = utils::Logger::getInstance();
@@ -16,7 +66,7 @@ void TRTLogger::log(Severity severity, const char* msg) noexcept {
             logger.error("[TensorRT] {}", msg);
             break;
         case Severity::kWARNING:
-            logger.warn("[TensorRT] {}", msg);
+            logger.warning("[TensorRT] {}", msg);
             break;
         case Severity::kINFO:
             logger.info("[TensorRT] {}", msg);
@@ -27,44 +77,87 @@ void TRTLogger::log(Severity severity, const char* msg) noexcept {
     }
 }
 
+TRTGpuAllocator& TRTGpuAllocator::getInstance() {
+    static TRTGpuAllocator instance;
+    return instance;
+}
+
+#if NV_TENSORRT_MAJOR >= 10
+void* TRTGpuAllocator::allocateAsync(uint64_t size, uint64_t alignment, nvinfer1::AllocatorFlags,
+                                     cudaStream_t stream) noexcept {
+    if (alignment > POOL_ALIGNMENT) return nullptr;
+    return utils::GpuMemoryPool::getInstance().allocate(size, utils::MemoryTag::TensorRT, stream);
+}
+
+bool TRTGpuAllocator::deallocateAsync(void* memory, cudaStream_t stream) noexcept {
+    utils::GpuMemoryPool::getInstance().release(memory, stream);
+    return true;
+}
+#else
+void* TRTGpuAllocator::allocate(uint64_t size, uint64_t alignment, nvinfer1::AllocatorFlags) noexcept {
+    if (alignment > POOL_ALIGNMENT) return nullptr;
+    return utils::GpuMemoryPool::getInstance().allocate(size, utils::MemoryTag::TensorRT);
+}
+
+bool TRTGpuAllocator::deallocate(void* memory) noexcept {
+    utils::GpuMemoryPool::getInstance().release(memory);
+    return true;
+}
+
+void TRTGpuAllocator::free(void* memory) noexcept {
+    deallocate(memory);
+}
+#endif
+
 // Constructor
 TensorRTEngine::TensorRTEngine(const core::VisionConfig& config)
     : m_config(config)
     , m_inputWidth(config.input_resolution[0])
     , m_inputHeight(config.input_resolution[1])
     , m_batchSize(config.batch_size)
-    , m_useCudaGraphs(config.enable_cuda_graphs) {
+    , m_useCudaGraphs(config.enable_cuda_graphs)
+    , m_gpuPostprocessing(config.gpu_postprocessing) {
 
     auto& logger = utils::Logger::getInstance();
     logger.info("Initializing TensorRT Engine with {}x{} resolution",
                 m_inputWidth, m_inputHeight);
 
+    m_slotCount = std::clamp(config.inflight_depth, 1u, core::constants::MAX_INFERENCE_SLOTS);
+    m_slots = std::make_unique<InferenceSlot[]>(m_slotCount);
+
     // Create CUDA stream with high priority if configured
     int leastPriority, greatestPriority;
     cudaDeviceGetStreamPriorityRange(&leastPriority, &greatestPriority);
 
-    if (m_config.cuda_stream_priority == "high") {
-        cudaStreamCreateWithPriority(&m_stream, cudaStreamNonBlocking, greatestPriority);
-    } else {
-        cudaStreamCreate(&m_stream);
-    }
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        auto& slot = m_slots[i];
 
-    // Create CUDA events for timing
-    cudaEventCreate(&m_startEvent);
-    cudaEventCreate(&m_endEvent);
+        if (m_config.cuda_stream_priority == "high") {
+            cudaStreamCreateWithPriority(&slot.stream, cudaStreamNonBlocking, greatestPriority);
+        } else {
+            cudaStreamCreate(&slot.stream);
+        }
+
+        // Create CUDA events for timing
+        cudaEventCreate(&slot.startEvent);
+        cudaEventCreate(&slot.endEvent);
+    }
 
-    logger.info("CUDA resources initialized successfully");
+    logger.info("CUDA resources initialized successfully ({} in-flight slots)", m_slotCount);
 }
 
 // Destructor
 TensorRTEngine::~TensorRTEngine() {
     deallocateBuffers();
 
-    if (m_cudaGraphExec) cudaGraphExecDestroy(m_cudaGraphExec);
-    if (m_cudaGraph) cudaGraphDestroy(m_cudaGraph);
-    if (m_startEvent) cudaEventDestroy(m_startEvent);
-    if (m_endEvent) cudaEventDestroy(m_endEvent);
-    if (m_stream) cudaStreamDestroy(m_stream);
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        auto& slot = m_slots[i];
+        destroyGraphs(slot);
+        if (slot.startEvent) cudaEventDestroy(slot.startEvent);
+        if (slot.endEvent) cudaEventDestroy(slot.endEvent);
+        if (slot.stream) cudaStreamDestroy(slot.stream);
+        slot.context.reset();
+    }
 
     auto& logger = utils::Logger::getInstance();
     logger.info("TensorRT Engine destroyed");
@@ -75,21 +168,20 @@ bool TensorRTEngine::loadSerializedEngine(const std::string& enginePath) {
     auto& logger = utils::Logger::getInstance();
     logger.info("Loading serialized TensorRT engine from: {}", enginePath);
 
-    std::ifstream file(enginePath, std::ios::binary);
-    if (!file.good()) {
+    // Deserialize straight from the page cache, no heap copy of the plan
+    utils::MappedFile plan;
+    if (!plan.open(enginePath)) {
         logger.error("Failed to open engine file: {}", enginePath);
         return false;
     }
 
-    file.seekg(0, std::ios::end);
-    size_t size = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    std::vector<char> engineData(size);
-    file.read(engineData.data(), size);
-    file.close();
+    logger.info("Mapped {} bytes from engine file", plan.size());
+    return loadPlan(plan.data(), plan.size());
+}
 
-    logger.info("Read {} bytes from engine file", size);
+// Deserialize a plan and set up contexts and buffers
+bool TensorRTEngine::loadPlan(const void* data, size_t size) {
+    auto& logger = utils::Logger::getInstance();
 
     // Create runtime and deserialize engine
     m_runtime.reset(nvinfer1::createInferRuntime(m_logger));
@@ -97,8 +189,9 @@ bool TensorRTEngine::loadSerializedEngine(const std::string& enginePath) {
         logger.error("Failed to create TensorRT runtime");
         return false;
     }
+    m_runtime->setGpuAllocator(&TRTGpuAllocator::getInstance());
 
-    m_engine.reset(m_runtime->deserializeCudaEngine(engineData.data(), size));
+    m_engine.reset(m_runtime->deserializeCudaEngine(data, size));
     if (!m_engine) {
         logger.error("Failed to deserialize CUDA engine");
         return false;
@@ -106,28 +199,17 @@ bool TensorRTEngine::loadSerializedEngine(const std::string& enginePath) {
 
     logger.info("Engine deserialized successfully");
 
-    // Get input/output indices and sizes
-    m_inputIndex = m_engine->getBindingIndex("images");
-    m_outputIndex = m_engine->getBindingIndex("output0");
-
-    if (m_inputIndex < 0 || m_outputIndex < 0) {
-        logger.error("Failed to find input/output bindings");
+    if (!resolveIOTensors()) {
         return false;
     }
 
-    auto inputDims = m_engine->getBindingDimensions(m_inputIndex);
-    auto outputDims = m_engine->getBindingDimensions(m_outputIndex);
-
-    // Calculate buffer sizes
-    m_inputSize = m_batchSize * 3 * m_inputWidth * m_inputHeight;
+    queryTensorShapes();
 
-    // YOLOv11 output format: [batch, num_predictions, 56] (52 classes + 4 bbox)
-    m_outputSize = m_batchSize * outputDims.d[1] * outputDims.d[2];
-
-    logger.info("Input tensor: {} x {} x {} x {}", m_batchSize, 3, m_inputHeight, m_inputWidth);
-    logger.info("Output tensor: {} x {} x {}", outputDims.d[0], outputDims.d[1], outputDims.d[2]);
+    if (!createExecutionContexts()) {
+        return false;
+    }
 
-    if (!createExecutionContext()) {
+    if (m_dynamicResolution && !queryResolutionProfiles()) {
         return false;
     }
 
@@ -141,15 +223,27 @@ bool TensorRTEngine::loadSerializedEngine(const std::string& enginePath) {
 
 // Build engine from ONNX model
 bool TensorRTEngine::buildEngineFromOnnx(const std::string& onnxPath) {
+    auto plan = buildPlan(m_config, onnxPath);
+    return plan && loadPlan(plan->data(), plan->size());
+}
+
+// Build a serialized plan from ONNX
+std::unique_ptr<nvinfer1::IHostMemory> TensorRTEngine::buildPlan(const core::VisionConfig& visionConfig,
+                                                                 const std::string& onnxPath,
+                                                                 std::vector<char>* timingCache,
+                                                                 int optimizationLevel) {
     auto& logger = utils::Logger::getInstance();
     logger.info("Building TensorRT engine from ONNX: {}", onnxPath);
 
+    // Builds may run off the main thread, next to live engines with their own loggers
+    static TRTLogger builderLogger;
+
     // Create builder
     auto builder = std::unique_ptr<nvinfer1::IBuilder>(
-        nvinfer1::createInferBuilder(m_logger));
+        nvinfer1::createInferBuilder(builderLogger));
     if (!builder) {
         logger.error("Failed to create TensorRT builder");
-        return false;
+        return nullptr;
     }
 
     // Network flags
@@ -160,15 +254,15 @@ bool TensorRTEngine::buildEngineFromOnnx(const std::string& onnxPath) {
         builder->createNetworkV2(explicitBatch));
     if (!network) {
         logger.error("Failed to create network definition");
-        return false;
+        return nullptr;
     }
 
     // ONNX parser
     auto parser = std::unique_ptr<nvonnxparser::IParser>(
-        nvonnxparser::createParser(*network, m_logger));
+        nvonnxparser::createParser(*network, builderLogger));
     if (!parser) {
         logger.error("Failed to create ONNX parser");
-        return false;
+        return nullptr;
     }
 
     // Parse ONNX file
@@ -178,7 +272,7 @@ bool TensorRTEngine::buildEngineFromOnnx(const std::string& onnxPath) {
         for (int i = 0; i < parser->getNbErrors(); ++i) {
             logger.error("Parser error: {}", parser->getError(i)->desc());
         }
-        return false;
+        return nullptr;
     }
 
     // Build configuration
@@ -186,56 +280,195 @@ bool TensorRTEngine::buildEngineFromOnnx(const std::string& onnxPath) {
         builder->createBuilderConfig());
     if (!config) {
         logger.error("Failed to create builder config");
-        return false;
+        return nullptr;
     }
 
     // Set workspace size
-    config->setMaxWorkspaceSize(static_cast<size_t>(m_config.max_workspace_size_mb) * (1 << 20));
+    config->setMemoryPoolLimit(nvinfer1::MemoryPoolType::kWORKSPACE,
+                               static_cast<size_t>(visionConfig.max_workspace_size_mb) * (1 << 20));
 
     // Enable FP16 if requested
-    if (m_config.use_fp16 && builder->platformHasFastFp16()) {
+    if (visionConfig.use_fp16 && builder->platformHasFastFp16()) {
         config->setFlag(nvinfer1::BuilderFlag::kFP16);
         logger.info("FP16 mode enabled");
     }
 
-    // Enable INT8 if requested
-    if (m_config.use_int8 && builder->platformHasFastInt8()) {
-        config->setFlag(nvinfer1::BuilderFlag::kINT8);
-        logger.info("INT8 mode enabled");
-        // Note: INT8 calibration would be needed here for best results
+    // Half bindings: the letterbox kernel writes FP16 and the decode reads
+    // it, so TensorRT adds no reformat layers at either end of the network.
+    // Linear layout, the CHW planes the preprocessor produces.
+    const bool halfIO = visionConfig.fp16_io && config->getFlag(nvinfer1::BuilderFlag::kFP16);
+    if (halfIO) {
+        const auto linear = 1U << static_cast<uint32_t>(nvinfer1::TensorFormat::kLINEAR);
+        for (int i = 0; i < network->getNbInputs(); i++) {
+            network->getInput(i)->setType(nvinfer1::DataType::kHALF);
+            network->getInput(i)->setAllowedFormats(linear);
+        }
+        for (int i = 0; i < network->getNbOutputs(); i++) {
+            network->getOutput(i)->setType(nvinfer1::DataType::kHALF);
+            network->getOutput(i)->setAllowedFormats(linear);
+        }
+        logger.info("FP16 I/O tensors enabled");
+    } else if (visionConfig.fp16_io) {
+        logger.warning("FP16 I/O requested without FP16 mode, keeping FP32 bindings");
+    }
+
+    // Dynamic ONNX export: profiles spanning 1..batch_size images (dynamic
+    // batch), one per resolution_profiles entry (dynamic H/W)
+    auto* input = network->getInput(0);
+    const auto inputDims = input->getDimensions();
+    const bool dynamicBatch = inputDims.d[0] < 0;
+    const bool dynamicResolution = inputDims.d[2] < 0 || inputDims.d[3] < 0;
+    if (dynamicBatch || dynamicResolution) {
+        const int maxBatch = dynamicBatch ? static_cast<int>(std::max(visionConfig.batch_size, 1u))
+                                          : static_cast<int>(inputDims.d[0]);
+        const int minBatch = dynamicBatch ? 1 : maxBatch;
+        const int optBatch = dynamicBatch ? std::max(maxBatch / 2, 1) : maxBatch;
+
+        auto resolutions = profileResolutions(visionConfig);
+        if (!dynamicResolution) {
+            resolutions = {{static_cast<int>(inputDims.d[3]), static_cast<int>(inputDims.d[2])}};
+        }
+
+        for (const auto& [width, height] : resolutions) {
+            auto* profile = builder->createOptimizationProfile();
+            profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMIN,
+                                   nvinfer1::Dims4(minBatch, 3, height, width));
+            profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kOPT,
+                                   nvinfer1::Dims4(optBatch, 3, height, width));
+            profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMAX,
+                                   nvinfer1::Dims4(maxBatch, 3, height, width));
+            config->addOptimizationProfile(profile);
+
+            logger.info("Optimization profile: batch {}..{} @ {}x{}", minBatch, maxBatch, width, height);
+        }
+    }
+    if (!dynamicResolution && !visionConfig.resolution_profiles.empty()) {
+        logger.warning("ONNX input has a fixed resolution, ignoring resolution_profiles");
+    }
+
+    // INT8 only with calibrated scales; FP16 stays enabled for the layers
+    // TensorRT keeps out of INT8. Both must outlive the build.
+    CalibrationDataset calibrationFrames;
+    std::unique_ptr<EntropyCalibrator> calibrator;
+    if (visionConfig.use_int8 && builder->platformHasFastInt8()) {
+        calibrationFrames.open(visionConfig.calibration_dir, visionConfig.calibration_max_frames);
+
+        const uint32_t calibrationBatch = dynamicBatch
+            ? std::clamp(visionConfig.calibration_batch_size, 1u, std::max(visionConfig.batch_size, 1u))
+            : static_cast<uint32_t>(input->getDimensions().d[0]);
+        calibrator = std::make_unique<EntropyCalibrator>(
+            calibrationFrames, calibrationBatch,
+            visionConfig.input_resolution[0], visionConfig.input_resolution[1],
+            visionConfig.calibration_cache,
+            halfIO ? cuda::TensorPrecision::FP16 : cuda::TensorPrecision::FP32);
+
+        if (calibrator->isUsable()) {
+            config->setFlag(nvinfer1::BuilderFlag::kINT8);
+            config->setInt8Calibrator(calibrator.get());
+
+            if (dynamicBatch || dynamicResolution) {
+                // Calibration runs at one fixed shape
+                auto* profile = builder->createOptimizationProfile();
+                const nvinfer1::Dims4 dims(static_cast<int>(calibrationBatch), 3,
+                                           static_cast<int>(visionConfig.input_resolution[1]),
+                                           static_cast<int>(visionConfig.input_resolution[0]));
+                profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMIN, dims);
+                profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kOPT, dims);
+                profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMAX, dims);
+                config->setCalibrationProfile(profile);
+            }
+            logger.info("INT8 mode enabled");
+        } else {
+            logger.error("INT8 requested but there are no frames in {} and no cache at {}, "
+                         "building without INT8", visionConfig.calibration_dir,
+                         visionConfig.calibration_cache);
+            calibrator.reset();
+        }
     }
 
     // Enable TF32 for Ampere and newer
     config->setFlag(nvinfer1::BuilderFlag::kTF32);
 
     // Set profiling verbosity
-    if (m_config.profiling_verbosity == "detailed") {
+    if (visionConfig.profiling_verbosity == "detailed") {
         config->setProfilingVerbosity(nvinfer1::ProfilingVerbosity::kDETAILED);
     }
 
+#if NV_TENSORRT_MAJOR * 100 + NV_TENSORRT_MINOR >= 806
+    // Lower levels trade kernel quality for a build in seconds
+    if (optimizationLevel >= 0) {
+        config->setBuilderOptimizationLevel(optimizationLevel);
+        logger.info("Builder optimization level {}", optimizationLevel);
+    }
+#else
+    (void)optimizationLevel;
+#endif
+
+    // Tactic timings from previous builds skip most of the autotuning
+    std::unique_ptr<nvinfer1::ITimingCache> cache;
+    if (timingCache) {
+        cache.reset(config->createTimingCache(timingCache->data(), timingCache->size()));
+        if (!cache || !config->setTimingCache(*cache, false)) {
+            logger.warning("Timing cache rejected, building without it");
+            cache.reset();
+        }
+    }
+
     // Build engine
     logger.info("Building CUDA engine (this may take several minutes)...");
-    m_engine.reset(builder->buildEngineWithConfig(*network, *config));
-
-    if (!m_engine) {
+    auto plan = std::unique_ptr<nvinfer1::IHostMemory>(
+        builder->buildSerializedNetwork(*network, *config));
+    if (!plan) {
         logger.error("Failed to build CUDA engine");
-        return false;
+        return nullptr;
     }
 
-    logger.info("CUDA engine built successfully");
+    if (cache) {
+        auto serialized = std::unique_ptr<nvinfer1::IHostMemory>(cache->serialize());
+        if (serialized) {
+            const auto* bytes = static_cast<const char*>(serialized->data());
+            timingCache->assign(bytes, bytes + serialized->size());
+        }
+    }
 
-    // Get binding indices
-    m_inputIndex = m_engine->getBindingIndex("images");
-    m_outputIndex = m_engine->getBindingIndex("output0");
+    logger.info("CUDA engine built successfully ({} bytes)", plan->size());
+    return plan;
+}
+
+// Per-layer precision dump; needs a plan built with detailed profiling verbosity
+bool TensorRTEngine::writeLayerReport(const std::string& outputPath) const {
+    auto& logger = utils::Logger::getInstance();
 
-    if (!createExecutionContext()) {
+    auto inspector = std::unique_ptr<nvinfer1::IEngineInspector>(m_engine->createEngineInspector());
+    const char* info = inspector
+        ? inspector->getEngineInformation(nvinfer1::LayerInformationFormat::kJSON)
+        : nullptr;
+    if (!info) {
+        logger.error("Engine inspector unavailable");
         return false;
     }
 
-    if (!allocateBuffers()) {
+    const std::string report(info);
+    std::ofstream file(outputPath, std::ios::trunc);
+    file << report;
+    if (!file.good()) {
+        logger.error("Failed to write layer report: {}", outputPath);
         return false;
     }
 
+    // Tally the output datatypes of every layer
+    uint32_t int8 = 0, fp16 = 0, fp32 = 0;
+    const std::string key = "\"Format/Datatype\"";
+    for (size_t pos = report.find(key); pos != std::string::npos; pos = report.find(key, pos + 1)) {
+        const size_t end = report.find('"', report.find('"', pos + key.size()) + 1);
+        const std::string format = report.substr(pos, end - pos);
+        if (format.find("Int8") != std::string::npos) int8++;
+        else if (format.find("FP16") != std::string::npos || format.find("Half") != std::string::npos) fp16++;
+        else fp32++;
+    }
+
+    logger.info("Layer precisions: {} INT8, {} FP16, {} FP32/other outputs ({})",
+                int8, fp16, fp32, outputPath);
     return true;
 }
 
@@ -269,17 +502,175 @@ bool TensorRTEngine::saveEngine(const std::string& outputPath) {
     return true;
 }
 
-// Create execution context
-bool TensorRTEngine::createExecutionContext() {
+// Check the engine exposes the expected I/O tensors
+bool TensorRTEngine::resolveIOTensors() {
+    auto& logger = utils::Logger::getInstance();
+
+    if (m_engine->getTensorIOMode(INPUT_TENSOR) != nvinfer1::TensorIOMode::kINPUT ||
+        m_engine->getTensorIOMode(OUTPUT_TENSOR) != nvinfer1::TensorIOMode::kOUTPUT) {
+        logger.error("Engine lacks '{}' input / '{}' output tensors", INPUT_TENSOR, OUTPUT_TENSOR);
+        return false;
+    }
+
+    // The letterbox kernel and the decode only handle linear FP32/FP16
+    if (!toTensorPrecision(m_engine->getTensorDataType(INPUT_TENSOR), m_inputPrecision) ||
+        !toTensorPrecision(m_engine->getTensorDataType(OUTPUT_TENSOR), m_outputPrecision)) {
+        logger.error("Engine I/O tensors must be FP32 or FP16");
+        return false;
+    }
+    if (m_engine->getTensorFormat(INPUT_TENSOR) != nvinfer1::TensorFormat::kLINEAR ||
+        m_engine->getTensorFormat(OUTPUT_TENSOR) != nvinfer1::TensorFormat::kLINEAR) {
+        logger.error("Engine I/O tensors must use the linear (NCHW) format");
+        return false;
+    }
+    return true;
+}
+
+// Derive buffer sizes from the engine tensor shapes
+void TensorRTEngine::queryTensorShapes() {
+    auto& logger = utils::Logger::getInstance();
+
+    auto inputDims = m_engine->getTensorShape(INPUT_TENSOR);
+    auto outputDims = m_engine->getTensorShape(OUTPUT_TENSOR);
+
+    // Dynamic batch: size buffers for the optimization profile maximum
+    m_dynamicBatch = inputDims.d[0] < 0;
+    if (m_dynamicBatch) {
+        auto maxDims = m_engine->getProfileShape(
+            INPUT_TENSOR, 0, nvinfer1::OptProfileSelector::kMAX);
+        m_batchSize = static_cast<uint32_t>(maxDims.d[0]);
+        logger.info("Dynamic batch engine (max {}), one CUDA graph per batch size", m_batchSize);
+    } else {
+        m_batchSize = static_cast<uint32_t>(inputDims.d[0]);
+    }
+
+    // NCHW: the engine, not the config, decides the input resolution.
+    // Dynamic H/W: one resolution per profile, read once contexts exist.
+    m_dynamicResolution = inputDims.d[2] < 0 || inputDims.d[3] < 0;
+    if (!m_dynamicResolution) {
+        m_inputHeight = static_cast<uint32_t>(inputDims.d[2]);
+        m_inputWidth = static_cast<uint32_t>(inputDims.d[3]);
+    }
+    const uint32_t profileCount = m_dynamicResolution
+        ? static_cast<uint32_t>(m_engine->getNbOptimizationProfiles()) : 1;
+
+    // Dynamic contexts start at 0 / NO_PROFILE to force setInputShape on first use
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        destroyGraphs(m_slots[i]);
+        m_slots[i].activeBatch = m_dynamicBatch ? 0 : m_batchSize;
+        m_slots[i].profile = 0;
+        m_slots[i].activeProfile = m_dynamicResolution ? NO_PROFILE : 0;
+        m_slots[i].graphs.resize(profileCount * (m_dynamicBatch ? m_batchSize : 1));
+    }
+
+    // YOLOv11 output format: [batch, num_predictions, 56] (52 classes + 4 bbox)
+    m_numClasses = static_cast<size_t>(outputDims.d[2] - 4);  // 52 cards, 1 for the cascade localizer
+
+    if (!m_dynamicResolution) {
+        m_predictionsPerImage = static_cast<uint32_t>(outputDims.d[1]);
+        m_profiles = {{m_inputWidth, m_inputHeight, m_predictionsPerImage}};
+        m_activeProfile = 0;
+
+        // Calculate buffer sizes
+        m_inputSize = m_batchSize * 3 * m_inputWidth * m_inputHeight;
+        m_outputSize = m_batchSize * m_predictionsPerImage * (4 + m_numClasses);
+
+        logger.info("Input tensor: {} x {} x {} x {}", m_batchSize, 3, m_inputHeight, m_inputWidth);
+        logger.info("Output tensor: {} x {} x {}", m_batchSize, m_predictionsPerImage, outputDims.d[2]);
+    }
+    logger.info("I/O precision: {} in, {} out",
+                precisionName(m_inputPrecision), precisionName(m_outputPrecision));
+}
+
+// Create one execution context per in-flight slot
+// Resolution and prediction count of every profile, through the slot 0
+// context; the buffers are sized for the largest. Starts on the profile
+// matching input_resolution, else the largest.
+bool TensorRTEngine::queryResolutionProfiles() {
     auto& logger = utils::Logger::getInstance();
+    auto& slot = m_slots[0];
+
+    m_profiles.clear();
+    const int32_t profileCount = m_engine->getNbOptimizationProfiles();
+    for (int32_t p = 0; p < profileCount; p++) {
+        const auto maxDims = m_engine->getProfileShape(INPUT_TENSOR, p, nvinfer1::OptProfileSelector::kMAX);
+        const auto minDims = m_engine->getProfileShape(INPUT_TENSOR, p, nvinfer1::OptProfileSelector::kMIN);
+        if (minDims.d[2] != maxDims.d[2] || minDims.d[3] != maxDims.d[3]) {
+            logger.error("Profile {} spans resolutions {}x{}..{}x{}, expected one per profile",
+                         p, minDims.d[3], minDims.d[2], maxDims.d[3], maxDims.d[2]);
+            return false;
+        }
+
+        // The output length follows the input resolution (anchors per stride)
+        const nvinfer1::Dims4 dims(1, 3, maxDims.d[2], maxDims.d[3]);
+        if (!slot.context->setOptimizationProfileAsync(p, slot.stream) ||
+            !slot.context->setInputShape(INPUT_TENSOR, dims)) {
+            logger.error("Failed to select optimization profile {}", p);
+            return false;
+        }
+        const auto outputDims = slot.context->getTensorShape(OUTPUT_TENSOR);
+
+        InputProfile profile;
+        profile.width = static_cast<uint32_t>(maxDims.d[3]);
+        profile.height = static_cast<uint32_t>(maxDims.d[2]);
+        profile.predictionsPerImage = static_cast<uint32_t>(outputDims.d[1]);
+        m_profiles.push_back(profile);
+
+        logger.info("Profile {}: {}x{}, {} predictions", p, profile.width, profile.height,
+                    profile.predictionsPerImage);
+    }
+    cudaStreamSynchronize(slot.stream);
+    slot.activeProfile = NO_PROFILE;
+    slot.activeBatch = m_dynamicBatch ? 0 : m_batchSize;
+
+    size_t maxPixels = 0;
+    uint32_t maxPredictions = 0;
+    m_activeProfile = static_cast<uint32_t>(m_profiles.size()) - 1;
+    for (uint32_t p = 0; p < m_profiles.size(); p++) {
+        maxPixels = std::max(maxPixels, static_cast<size_t>(m_profiles[p].width) * m_profiles[p].height);
+        maxPredictions = std::max(maxPredictions, m_profiles[p].predictionsPerImage);
+        if (m_profiles[p].width == m_config.input_resolution[0] &&
+            m_profiles[p].height == m_config.input_resolution[1]) {
+            m_activeProfile = p;
+        }
+    }
+
+    m_inputSize = m_batchSize * 3 * maxPixels;
+    m_outputSize = m_batchSize * maxPredictions * (4 + m_numClasses);
+    selectProfile(m_activeProfile);
+
+    logger.info("Input tensor: {} x 3 x H x W over {} profiles, starting at {}x{}",
+                m_batchSize, m_profiles.size(), m_inputWidth, m_inputHeight);
+    return true;
+}
 
-    m_context.reset(m_engine->createExecutionContext());
-    if (!m_context) {
-        logger.error("Failed to create execution context");
+// Latched by slots as they are acquired
+bool TensorRTEngine::selectProfile(uint32_t profile) {
+    if (profile >= m_profiles.size()) {
+        utils::Logger::getInstance().error("Profile {} out of range ({} profiles)",
+                                           profile, m_profiles.size());
         return false;
     }
 
-    logger.info("Execution context created successfully");
+    m_activeProfile = profile;
+    m_inputWidth = m_profiles[profile].width;
+    m_inputHeight = m_profiles[profile].height;
+    m_predictionsPerImage = m_profiles[profile].predictionsPerImage;
+    return true;
+}
+
+bool TensorRTEngine::createExecutionContexts() {
+    auto& logger = utils::Logger::getInstance();
+
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        m_slots[i].context.reset(m_engine->createExecutionContext());
+        if (!m_slots[i].context) {
+            logger.error("Failed to create execution context {}", i);
+            return false;
+        }
+    }
+
+    logger.info("{} execution contexts created successfully", m_slotCount);
     return true;
 }
 
@@ -288,114 +679,602 @@ bool TensorRTEngine::allocateBuffers() {
     auto& logger = utils::Logger::getInstance();
     logger.info("Allocating inference buffers");
 
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        auto& slot = m_slots[i];
+        if (!allocateSlotBuffers(slot)) {
+            deallocateBuffers();
+            return false;
+        }
+
+        // Addresses are fixed for the slot's lifetime, so captured graphs stay valid
+        if (!slot.context->setTensorAddress(INPUT_TENSOR, slot.deviceInput) ||
+            !slot.context->setTensorAddress(OUTPUT_TENSOR, slot.deviceOutput)) {
+            logger.error("Failed to bind tensors of context {}", i);
+            deallocateBuffers();
+            return false;
+        }
+    }
+
+    const size_t inputBytes = m_inputSize * cuda::elementSize(m_inputPrecision);
+    const size_t outputBytes = m_outputSize * cuda::elementSize(m_outputPrecision);
+    logger.info("Allocated {:.2f} MB for input buffers", m_slotCount * inputBytes / (1024.0f * 1024.0f));
+    logger.info("Allocated {:.2f} MB for output buffers", m_slotCount * outputBytes / (1024.0f * 1024.0f));
+
+    return true;
+}
+
+bool TensorRTEngine::allocateSlotBuffers(InferenceSlot& slot) {
+    auto& logger = utils::Logger::getInstance();
+
     // Allocate device memory
-    size_t inputBytes = m_inputSize * sizeof(float);
-    size_t outputBytes = m_outputSize * sizeof(float);
+    size_t inputBytes = m_inputSize * cuda::elementSize(m_inputPrecision);
+    size_t outputBytes = m_outputSize * cuda::elementSize(m_outputPrecision);
 
-    cudaError_t status;
+    auto& pool = utils::GpuMemoryPool::getInstance();
+    constexpr auto tag = utils::MemoryTag::Inference;
 
-    status = cudaMalloc(&m_deviceInputBuffer, inputBytes);
-    if (status != cudaSuccess) {
-        logger.error("Failed to allocate input buffer: {}", cudaGetErrorString(status));
+    slot.deviceInput = pool.allocate(inputBytes, tag);
+    slot.deviceOutput = pool.allocate(outputBytes, tag);
+    if (!slot.deviceInput || !slot.deviceOutput) {
+        logger.error("Failed to allocate inference I/O buffers");
         return false;
     }
 
-    status = cudaMalloc(&m_deviceOutputBuffer, outputBytes);
-    if (status != cudaSuccess) {
-        logger.error("Failed to allocate output buffer: {}", cudaGetErrorString(status));
-        cudaFree(m_deviceInputBuffer);
+    const size_t transformBytes = m_batchSize * sizeof(cuda::LetterboxTransform);
+    slot.deviceTransforms = static_cast<cuda::LetterboxTransform*>(pool.allocate(transformBytes, tag));
+    slot.hostTransforms = static_cast<cuda::LetterboxTransform*>(pool.allocateHost(transformBytes, tag));
+    if (!slot.deviceTransforms || !slot.hostTransforms) {
+        logger.error("Failed to allocate letterbox transform buffers");
         return false;
     }
 
-    // Allocate host memory
-    m_hostOutputBuffer.resize(m_outputSize);
+    slot.deviceLaunch = static_cast<cuda::LetterboxLaunch*>(pool.allocate(sizeof(cuda::LetterboxLaunch), tag));
+    slot.hostLaunch = static_cast<cuda::LetterboxLaunch*>(pool.allocateHost(sizeof(cuda::LetterboxLaunch), tag));
+    if (!slot.deviceLaunch || !slot.hostLaunch) {
+        logger.error("Failed to allocate preprocessing launch buffers");
+        return false;
+    }
 
-    logger.info("Allocated {:.2f} MB for input buffer", inputBytes / (1024.0f * 1024.0f));
-    logger.info("Allocated {:.2f} MB for output buffer", outputBytes / (1024.0f * 1024.0f));
+    if (m_gpuPostprocessing) {
+        // Decode scratch on the device, only the compact result comes back
+        if (!cuda::allocateDecodeWorkspace(slot.decodeWorkspace)) {
+            logger.error("Failed to allocate decode workspace");
+            return false;
+        }
+
+        slot.hostResult = static_cast<cuda::DetectionResult*>(pool.allocateHost(sizeof(cuda::DetectionResult), tag));
+        if (!slot.hostResult) {
+            logger.error("Failed to allocate pinned detection buffer");
+            return false;
+        }
+    } else {
+        // Allocate host memory
+        slot.hostOutput.resize(m_outputSize);
+        if (m_outputPrecision == cuda::TensorPrecision::FP16) {
+            slot.hostOutputHalf.resize(m_outputSize);
+        }
+    }
 
     return true;
 }
 
 // Deallocate buffers
+// A slot's buffers are only used on its stream: its device buffers are freed
+// on that stream, so a hot swap waits for the old slots alone rather than the
+// whole device once per buffer. One drain covers the pinned blocks going back
+// to the pool's cache.
 void TensorRTEngine::deallocateBuffers() {
-    if (m_deviceInputBuffer) {
-        cudaFree(m_deviceInputBuffer);
-        m_deviceInputBuffer = nullptr;
-    }
-    if (m_deviceOutputBuffer) {
-        cudaFree(m_deviceOutputBuffer);
-        m_deviceOutputBuffer = nullptr;
+    auto& pool = utils::GpuMemoryPool::getInstance();
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        auto& slot = m_slots[i];
+        if (slot.stream) cudaStreamSynchronize(slot.stream);
+        pool.release(slot.deviceInput, slot.stream);
+        pool.release(slot.deviceOutput, slot.stream);
+        pool.releaseHost(slot.hostResult);
+        pool.release(slot.deviceTransforms, slot.stream);
+        pool.releaseHost(slot.hostTransforms);
+        pool.release(slot.deviceLaunch, slot.stream);
+        pool.releaseHost(slot.hostLaunch);
+        slot.deviceInput = nullptr;
+        slot.deviceOutput = nullptr;
+        slot.hostResult = nullptr;
+        slot.deviceTransforms = nullptr;
+        slot.hostTransforms = nullptr;
+        slot.deviceLaunch = nullptr;
+        slot.hostLaunch = nullptr;
+        cuda::freeDecodeWorkspace(slot.decodeWorkspace, slot.stream);
+        slot.hostOutput.clear();
+        slot.hostOutputHalf.clear();
     }
-    m_hostOutputBuffer.clear();
 }
 
 // Synchronous inference
-bool TensorRTEngine::infer(const float* inputTensor,
+bool TensorRTEngine::infer(const void* inputTensor,
                           std::vector<core::Detection>& detections,
                           float confThreshold,
                           float nmsThreshold) {
     auto& logger = utils::Logger::getInstance();
+    auto& slot = m_slots[0];
 
-    if (!m_context) {
+    if (!slot.context) {
         logger.error("Execution context not initialized");
         return false;
     }
 
+    slot.profile = m_activeProfile;
+
     // Start timing
-    cudaEventRecord(m_startEvent, m_stream);
+    cudaEventRecord(slot.startEvent, slot.stream);
 
-    // Copy input to device
-    size_t inputBytes = m_inputSize * sizeof(float);
+    // Copy input to device (a full batch at the active resolution)
+    size_t inputBytes = getInputImageBytes() * m_batchSize;
     cudaError_t status = cudaMemcpyAsync(
-        m_deviceInputBuffer, inputTensor, inputBytes,
-        cudaMemcpyHostToDevice, m_stream);
+        slot.deviceInput, inputTensor, inputBytes,
+        cudaMemcpyHostToDevice, slot.stream);
 
     if (status != cudaSuccess) {
         logger.error("Failed to copy input to device: {}", cudaGetErrorString(status));
         return false;
     }
 
+    if (!enqueue(slot, confThreshold, nmsThreshold, {})) {
+        return false;
+    }
+
+    cudaEventSynchronize(slot.endEvent);
+    finish(slot, detections);
+    return true;
+}
+
+// Inference on an input already written to the device buffer (fused preprocessing)
+bool TensorRTEngine::inferDeviceInput(std::vector<core::Detection>& detections,
+                                      float confThreshold,
+                                      float nmsThreshold,
+                                      std::span<const cuda::LetterboxTransform> transforms) {
+    auto& logger = utils::Logger::getInstance();
+    auto& slot = m_slots[0];
+
+    if (!slot.context) {
+        logger.error("Execution context not initialized");
+        return false;
+    }
+
+    slot.profile = m_activeProfile;
+
+    // Start timing
+    cudaEventRecord(slot.startEvent, slot.stream);
+
+    if (!enqueue(slot, confThreshold, nmsThreshold, transforms)) {
+        return false;
+    }
+
+    cudaEventSynchronize(slot.endEvent);
+    finish(slot, detections);
+    return true;
+}
+
+// Claim a free slot; its input buffer may be written until submit()
+bool TensorRTEngine::acquireSlot(uint32_t& slotIndex) {
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        SlotState expected = SlotState::Free;
+        if (m_slots[i].state.compare_exchange_strong(expected, SlotState::Acquired,
+                                                     std::memory_order_acq_rel)) {
+            m_slots[i].profile = m_activeProfile;
+            slotIndex = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TensorRTEngine::releaseSlot(uint32_t slotIndex) {
+    m_slots[slotIndex].state.store(SlotState::Free, std::memory_order_release);
+}
+
+uint32_t TensorRTEngine::getFreeSlots() const {
+    uint32_t free = 0;
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        if (m_slots[i].state.load(std::memory_order_acquire) == SlotState::Free) free++;
+    }
+    return free;
+}
+
+// Enqueue an acquired slot without waiting; the input must be ordered
+// before this call on getStream(slot) (e.g. via cudaStreamWaitEvent)
+bool TensorRTEngine::submit(uint32_t slotIndex,
+                            float confThreshold,
+                            float nmsThreshold,
+                            std::span<const cuda::LetterboxTransform> transforms,
+                            InferenceTicket& ticket) {
+    auto& logger = utils::Logger::getInstance();
+
+    if (slotIndex >= m_slotCount ||
+        m_slots[slotIndex].state.load(std::memory_order_acquire) != SlotState::Acquired) {
+        logger.error("Submit on slot {} that was not acquired", slotIndex);
+        return false;
+    }
+
+    auto& slot = m_slots[slotIndex];
+    cudaEventRecord(slot.startEvent, slot.stream);
+
+    if (!enqueue(slot, confThreshold, nmsThreshold, transforms)) {
+        releaseSlot(slotIndex);
+        return false;
+    }
+
+    slot.sequence = m_nextSequence++;
+    slot.state.store(SlotState::InFlight, std::memory_order_release);
+
+    ticket.slot = slotIndex;
+    ticket.sequence = slot.sequence;
+    return true;
+}
+
+// Preprocess + infer + decode of one frame as a single graph launch
+bool TensorRTEngine::submitFrame(uint32_t slotIndex,
+                                 const cuda::LetterboxParams& params,
+                                 const cuda::LetterboxTransform& transform,
+                                 float confThreshold,
+                                 float nmsThreshold,
+                                 InferenceTicket& ticket) {
+    auto& logger = utils::Logger::getInstance();
+
+    if (slotIndex >= m_slotCount ||
+        m_slots[slotIndex].state.load(std::memory_order_acquire) != SlotState::Acquired) {
+        logger.error("Submit on slot {} that was not acquired", slotIndex);
+        return false;
+    }
+
+    auto& slot = m_slots[slotIndex];
+    cudaEventRecord(slot.startEvent, slot.stream);
+
+    if (!enqueue(slot, confThreshold, nmsThreshold,
+                 std::span<const cuda::LetterboxTransform>(&transform, 1), &params)) {
+        releaseSlot(slotIndex);
+        return false;
+    }
+
+    slot.sequence = m_nextSequence++;
+    slot.state.store(SlotState::InFlight, std::memory_order_release);
+
+    ticket.slot = slotIndex;
+    ticket.sequence = slot.sequence;
+    return true;
+}
+
+TicketStatus TensorRTEngine::poll(const InferenceTicket& ticket,
+                                  std::vector<core::Detection>& detections,
+                                  float* gpuMilliseconds) {
+    if (ticket.slot >= m_slotCount) return TicketStatus::Failed;
+
+    auto& slot = m_slots[ticket.slot];
+    if (slot.sequence != ticket.sequence ||
+        slot.state.load(std::memory_order_acquire) != SlotState::InFlight) {
+        return TicketStatus::Failed;
+    }
+
+    const cudaError_t status = cudaEventQuery(slot.endEvent);
+    if (status == cudaErrorNotReady) {
+        return TicketStatus::Pending;
+    }
+
+    if (status != cudaSuccess) {
+        utils::Logger::getInstance().error("Inference slot {} failed: {}",
+                                           ticket.slot, cudaGetErrorString(status));
+        releaseSlot(ticket.slot);
+        return TicketStatus::Failed;
+    }
+
+    const float milliseconds = finish(slot, detections);
+    if (gpuMilliseconds) *gpuMilliseconds = milliseconds;
+    releaseSlot(ticket.slot);
+    return TicketStatus::Ready;
+}
+
+bool TensorRTEngine::wait(const InferenceTicket& ticket, std::vector<core::Detection>& detections,
+                          float* gpuMilliseconds) {
+    if (ticket.slot >= m_slotCount) return false;
+
+    cudaEventSynchronize(m_slots[ticket.slot].endEvent);
+    return poll(ticket, detections, gpuMilliseconds) == TicketStatus::Ready;
+}
+
+// Bytes of one batch item in the input buffer
+size_t TensorRTEngine::getInputImageBytes() const {
+    return static_cast<size_t>(3) * m_inputWidth * m_inputHeight * cuda::elementSize(m_inputPrecision);
+}
+
+// Select the profile and batch size for the next enqueue on dynamic engines
+bool TensorRTEngine::setActiveShape(InferenceSlot& slot, uint32_t batch) {
+    const bool profileChange = slot.profile != slot.activeProfile;
+    if (batch == slot.activeBatch && !profileChange) return true;
+
+    if (batch != slot.activeBatch && !m_dynamicBatch) {
+        utils::Logger::getInstance().error("Static engine expects batch {}, got {}",
+                                           slot.activeBatch, batch);
+        return false;
+    }
+
+    if (batch == 0 || batch > m_batchSize) {
+        utils::Logger::getInstance().error("Batch {} outside profile range [1, {}]",
+                                           batch, m_batchSize);
+        return false;
+    }
+
+    // Enqueued on the slot stream, outside any graph capture
+    if (profileChange) {
+        if (!slot.context->setOptimizationProfileAsync(static_cast<int32_t>(slot.profile), slot.stream)) {
+            utils::Logger::getInstance().error("Failed to switch to optimization profile {}", slot.profile);
+            return false;
+        }
+        slot.activeProfile = slot.profile;
+    }
+
+    const auto& profile = m_profiles[slot.profile];
+    const nvinfer1::Dims4 dims(static_cast<int>(batch), 3,
+                               static_cast<int>(profile.height),
+                               static_cast<int>(profile.width));
+    if (!slot.context->setInputShape(INPUT_TENSOR, dims)) {
+        utils::Logger::getInstance().error("Failed to set input dimensions for batch {} at {}x{}",
+                                           batch, profile.width, profile.height);
+        return false;
+    }
+
+    slot.activeBatch = batch;
+    return true;
+}
+
+// Stage the per-frame arguments, then run the chain; endEvent marks completion
+bool TensorRTEngine::enqueue(InferenceSlot& slot,
+                             float confThreshold,
+                             float nmsThreshold,
+                             std::span<const cuda::LetterboxTransform> transforms,
+                             const cuda::LetterboxParams* preprocess) {
+    auto& logger = utils::Logger::getInstance();
+
+    const uint32_t batch = transforms.empty()
+        ? std::max(slot.activeBatch, 1u)
+        : static_cast<uint32_t>(transforms.size());
+    if (!setActiveShape(slot, batch)) {
+        return false;
+    }
+
+    slot.confThreshold = confThreshold;
+    slot.nmsThreshold = nmsThreshold;
+    slot.transformCount = transforms.size();
+
+    if (transforms.size() > m_batchSize) {
+        logger.error("{} transforms for a batch capacity of {}", transforms.size(), m_batchSize);
+        return false;
+    }
+
+    // Pinned staging: the upload nodes read these when the chain executes,
+    // so a graph picks up new values without an update
+    std::copy(transforms.begin(), transforms.end(), slot.hostTransforms);
+
+    GraphKey key;
+    key.batch = batch;
+    key.profile = slot.profile;
+    key.hasTransforms = !transforms.empty();
+    key.confThreshold = confThreshold;
+    key.nmsThreshold = nmsThreshold;
+
+    if (preprocess) {
+        const auto& profile = m_profiles[slot.profile];
+        if (batch != 1 || preprocess->outputWidth != profile.width ||
+            preprocess->outputHeight != profile.height) {
+            logger.error("Fused preprocessing expects one {}x{} image", profile.width, profile.height);
+            return false;
+        }
+        if (preprocess->precision != m_inputPrecision) {
+            logger.error("Fused preprocessing writes {}, the engine input is {}",
+                         precisionName(preprocess->precision), precisionName(m_inputPrecision));
+            return false;
+        }
+
+        slot.hostLaunch->source = preprocess->source;
+        slot.hostLaunch->sourcePitch = preprocess->sourcePitch;
+        slot.hostLaunch->roiX = preprocess->roiX;
+        slot.hostLaunch->roiY = preprocess->roiY;
+        slot.hostLaunch->roiWidth = preprocess->roiWidth;
+        slot.hostLaunch->roiHeight = preprocess->roiHeight;
+        slot.hostLaunch->transform = transforms.front();
+
+        key.fused = true;
+        key.precision = preprocess->precision;
+    }
+
+    if (!launch(slot, key)) {
+        return false;
+    }
+
+    // End timing
+    cudaEventRecord(slot.endEvent, slot.stream);
+    return true;
+}
+
+// Graph policy: replay a graph captured for this key; otherwise run eagerly
+// once (TensorRT defers shape-dependent setup to the first enqueueV3 after a
+// shape change, which must not land in a capture), then capture on the next
+// launch with the same key. A recapture first tries to update the existing
+// executable in place and re-instantiates only if the topology changed.
+bool TensorRTEngine::launch(InferenceSlot& slot, const GraphKey& key) {
+    NVTX_RANGE(utils::TraceCategory::Graph, "launch");
+    if (!m_useCudaGraphs) {
+        return enqueueChain(slot, key);
+    }
+
+    const uint32_t batches = m_dynamicBatch ? m_batchSize : 1;
+    auto& graph = slot.graphs[key.profile * batches + (m_dynamicBatch ? key.batch - 1 : 0)];
+
+    if (graph.exec && graph.key == key) {
+        const cudaError_t status = cudaGraphLaunch(graph.exec, slot.stream);
+        if (status != cudaSuccess) {
+            utils::Logger::getInstance().error("CUDA graph launch failed: {}",
+                                               cudaGetErrorString(status));
+            return false;
+        }
+        m_graphLaunches.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (!graph.hasWarmed || !(graph.warmed == key)) {
+        graph.warmed = key;
+        graph.hasWarmed = true;
+        return enqueueChain(slot, key);
+    }
+
+    if (!captureGraph(slot, graph, key)) {
+        // Keep the pipeline running uncaptured rather than recapturing every frame
+        utils::Logger::getInstance().warning("CUDA graph capture failed, running without graphs");
+        m_useCudaGraphs = false;
+        return enqueueChain(slot, key);
+    }
+
+    // Capture only records: launch it to run this frame
+    const cudaError_t status = cudaGraphLaunch(graph.exec, slot.stream);
+    if (status != cudaSuccess) {
+        utils::Logger::getInstance().error("CUDA graph launch failed: {}",
+                                           cudaGetErrorString(status));
+        return false;
+    }
+    m_graphLaunches.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool TensorRTEngine::captureGraph(InferenceSlot& slot, SlotGraph& graph, const GraphKey& key) {
+    auto& logger = utils::Logger::getInstance();
+
+    // Thread-local mode: other slots keep launching from their own threads
+    cudaError_t status = cudaStreamBeginCapture(slot.stream, cudaStreamCaptureModeThreadLocal);
+    if (status != cudaSuccess) {
+        logger.error("Failed to begin graph capture: {}", cudaGetErrorString(status));
+        return false;
+    }
+
+    const bool recorded = enqueueChain(slot, key);
+
+    cudaGraph_t captured = nullptr;
+    status = cudaStreamEndCapture(slot.stream, &captured);
+    if (!recorded || status != cudaSuccess) {
+        logger.error("Graph capture of the inference chain failed: {}", cudaGetErrorString(status));
+        if (captured) cudaGraphDestroy(captured);
+        return false;
+    }
+
+    // Same topology (e.g. only thresholds changed): patch the node parameters
+    if (graph.exec) {
+#if CUDART_VERSION >= 12000
+        cudaGraphExecUpdateResultInfo info;
+        status = cudaGraphExecUpdate(graph.exec, captured, &info);
+#else
+        cudaGraphNode_t errorNode = nullptr;
+        cudaGraphExecUpdateResult result;
+        status = cudaGraphExecUpdate(graph.exec, captured, &errorNode, &result);
+#endif
+        if (status != cudaSuccess) {
+            cudaGetLastError();  // Clear the update error, re-instantiate instead
+            cudaGraphExecDestroy(graph.exec);
+            graph.exec = nullptr;
+        }
+    }
+
+    if (!graph.exec) {
+        status = cudaGraphInstantiateWithFlags(&graph.exec, captured, 0);
+        if (status != cudaSuccess) {
+            logger.error("Failed to instantiate CUDA graph: {}", cudaGetErrorString(status));
+            cudaGraphDestroy(captured);
+            graph.exec = nullptr;
+            return false;
+        }
+    }
+
+    if (graph.graph) cudaGraphDestroy(graph.graph);
+    graph.graph = captured;
+    graph.key = key;
+    graph.hasWarmed = false;
+
+    m_graphCaptures.fetch_add(1, std::memory_order_relaxed);
+    logger.debug("Captured inference graph (batch {}, profile {}, fused {})",
+                 key.batch, key.profile, key.fused);
+    return true;
+}
+
+// Transform upload -> [letterbox] -> network -> decode/NMS -> readback
+bool TensorRTEngine::enqueueChain(InferenceSlot& slot, const GraphKey& key) {
+    auto& logger = utils::Logger::getInstance();
+    cudaError_t status;
+
+    if (key.hasTransforms) {
+        status = cudaMemcpyAsync(slot.deviceTransforms, slot.hostTransforms,
+                                 key.batch * sizeof(cuda::LetterboxTransform),
+                                 cudaMemcpyHostToDevice, slot.stream);
+        if (status != cudaSuccess) {
+            logger.error("Failed to upload letterbox transforms: {}", cudaGetErrorString(status));
+            return false;
+        }
+    }
+
+    if (key.fused) {
+        status = cudaMemcpyAsync(slot.deviceLaunch, slot.hostLaunch, sizeof(cuda::LetterboxLaunch),
+                                 cudaMemcpyHostToDevice, slot.stream);
+        if (status == cudaSuccess) {
+            status = cuda::letterboxBGRAToCHWIndirect(slot.deviceLaunch, slot.deviceInput,
+                                                      m_profiles[key.profile].width,
+                                                      m_profiles[key.profile].height,
+                                                      key.precision, slot.stream);
+        }
+        if (status != cudaSuccess) {
+            logger.error("Fused preprocessing failed: {}", cudaGetErrorString(status));
+            return false;
+        }
+    }
+
     // Execute inference
-    void* bindings[] = {m_deviceInputBuffer, m_deviceOutputBuffer};
-
-    if (m_useCudaGraphs && m_graphCaptured) {
-        // Use CUDA Graph for maximum performance
-        cudaGraphLaunch(m_cudaGraphExec, m_stream);
-    } else if (m_useCudaGraphs && !m_graphCaptured) {
-        // Capture CUDA Graph on first inference
-        cudaStreamBeginCapture(m_stream, cudaStreamCaptureModeGlobal);
-        m_context->enqueueV2(bindings, m_stream, nullptr);
-        cudaStreamEndCapture(m_stream, &m_cudaGraph);
-        cudaGraphInstantiate(&m_cudaGraphExec, m_cudaGraph, nullptr, nullptr, 0);
-        m_graphCaptured = true;
-    } else {
-        // Standard execution
-        if (!m_context->enqueueV2(bindings, m_stream, nullptr)) {
+    {
+        NVTX_RANGE(utils::TraceCategory::Enqueue, "enqueueV3");
+        if (!slot.context->enqueueV3(slot.stream)) {
             logger.error("Failed to execute inference");
             return false;
         }
     }
 
-    // Copy output to host
-    size_t outputBytes = m_outputSize * sizeof(float);
+    if (m_gpuPostprocessing) {
+        // Decode + NMS on the device, copy back only the survivors
+        return enqueueGpuPostprocessing(slot, key.confThreshold, key.nmsThreshold,
+                                        key.hasTransforms ? slot.deviceTransforms : nullptr);
+    }
+
+    // Copy output to host (active batch items only); half outputs are
+    // widened in finish()
+    size_t outputBytes = static_cast<size_t>(key.batch) * m_profiles[key.profile].predictionsPerImage *
+                         (4 + m_numClasses) * cuda::elementSize(m_outputPrecision);
+    void* hostOutput = m_outputPrecision == cuda::TensorPrecision::FP16
+        ? static_cast<void*>(slot.hostOutputHalf.data())
+        : static_cast<void*>(slot.hostOutput.data());
     status = cudaMemcpyAsync(
-        m_hostOutputBuffer.data(), m_deviceOutputBuffer, outputBytes,
-        cudaMemcpyDeviceToHost, m_stream);
+        hostOutput, slot.deviceOutput, outputBytes,
+        cudaMemcpyDeviceToHost, slot.stream);
 
     if (status != cudaSuccess) {
         logger.error("Failed to copy output to host: {}", cudaGetErrorString(status));
         return false;
     }
+    return true;
+}
 
-    // Wait for completion
-    cudaStreamSynchronize(m_stream);
-
-    // End timing
-    cudaEventRecord(m_endEvent, m_stream);
-    cudaEventSynchronize(m_endEvent);
+void TensorRTEngine::destroyGraphs(InferenceSlot& slot) {
+    for (auto& graph : slot.graphs) {
+        if (graph.exec) cudaGraphExecDestroy(graph.exec);
+        if (graph.graph) cudaGraphDestroy(graph.graph);
+        graph = SlotGraph{};
+    }
+}
 
+// Called once slot.endEvent has completed
+float TensorRTEngine::finish(InferenceSlot& slot, std::vector<core::Detection>& detections) {
     float milliseconds = 0;
-    cudaEventElapsedTime(&milliseconds, m_startEvent, m_endEvent);
+    cudaEventElapsedTime(&milliseconds, slot.startEvent, slot.endEvent);
 
     m_lastInferenceTime = milliseconds;
     m_avgInferenceTime = (m_avgInferenceTime * m_inferenceCount + milliseconds) /
@@ -403,25 +1282,91 @@ bool TensorRTEngine::infer(const float* inputTensor,
     m_inferenceCount++;
 
     // Parse output
-    parseYOLOv11Output(m_hostOutputBuffer.data(), detections,
-                      confThreshold, nmsThreshold);
+    if (m_gpuPostprocessing) {
+        collectGpuDetections(slot, detections);
+    } else {
+        const uint32_t predictionsPerImage = m_profiles[slot.profile].predictionsPerImage;
+        if (m_outputPrecision == cuda::TensorPrecision::FP16) {
+            const size_t count = static_cast<size_t>(slot.activeBatch) * predictionsPerImage *
+                                 (4 + m_numClasses);
+            for (size_t i = 0; i < count; i++) {
+                __half_raw raw;
+                raw.x = slot.hostOutputHalf[i];
+                slot.hostOutput[i] = __half2float(__half(raw));
+            }
+        }
+        parseYOLOv11Output(slot.hostOutput.data(), slot.activeBatch, predictionsPerImage, detections,
+                          slot.confThreshold, slot.nmsThreshold,
+                          std::span<const cuda::LetterboxTransform>(slot.hostTransforms,
+                                                                    slot.transformCount));
+    }
+    return milliseconds;
+}
+
+// Queue decode, NMS and the small result readback on the slot stream
+bool TensorRTEngine::enqueueGpuPostprocessing(InferenceSlot& slot,
+                                              float confThreshold,
+                                              float nmsThreshold,
+                                              const cuda::LetterboxTransform* deviceTransforms) {
+    auto& logger = utils::Logger::getInstance();
+
+    const uint32_t predictionsPerImage = m_profiles[slot.profile].predictionsPerImage;
+    cudaError_t status = cuda::decodeYOLOv11(
+        slot.deviceOutput, m_outputPrecision,
+        slot.activeBatch * predictionsPerImage, predictionsPerImage, deviceTransforms,
+        static_cast<uint32_t>(m_numClasses), confThreshold,
+        slot.decodeWorkspace, slot.stream);
+
+    if (status == cudaSuccess) {
+        status = cuda::suppressAndCompact(nmsThreshold, slot.decodeWorkspace, slot.stream);
+    }
+
+    if (status == cudaSuccess) {
+        status = cudaMemcpyAsync(
+            slot.hostResult, slot.decodeWorkspace.result, sizeof(cuda::DetectionResult),
+            cudaMemcpyDeviceToHost, slot.stream);
+    }
+
+    if (status != cudaSuccess) {
+        logger.error("GPU postprocessing failed: {}", cudaGetErrorString(status));
+        return false;
+    }
 
     return true;
 }
 
+// Copy the surviving detections out of the pinned result block
+void TensorRTEngine::collectGpuDetections(const InferenceSlot& slot,
+                                          std::vector<core::Detection>& detections) {
+    const uint32_t count = std::min(slot.hostResult->count,
+                                    core::constants::MAX_DETECTIONS_PER_FRAME);
+    const uint64_t timestamp = std::chrono::high_resolution_clock::now()
+                               .time_since_epoch().count();
+
+    detections.assign(slot.hostResult->detections,
+                      slot.hostResult->detections + count);
+    for (auto& det : detections) {
+        det.timestamp_ns = timestamp;
+    }
+}
+
 // Parse YOLOv11 output
 void TensorRTEngine::parseYOLOv11Output(const float* output,
+                                       uint32_t activeBatch,
+                                       uint32_t predictionsPerImage,
                                        std::vector<core::Detection>& detections,
                                        float confThreshold,
-                                       float nmsThreshold) {
+                                       float nmsThreshold,
+                                       std::span<const cuda::LetterboxTransform> transforms) {
     detections.clear();
 
     // YOLOv11 output format: [batch, num_predictions, 56]
     // 56 = 4 (bbox) + 52 (classes)
-    const int numPredictions = m_outputSize / 56;
+    const size_t stride = 4 + m_numClasses;
+    const int numPredictions = static_cast<int>(activeBatch * predictionsPerImage);
 
     for (int i = 0; i < numPredictions; i++) {
-        const float* pred = output + i * 56;
+        const float* pred = output + i * stride;
 
         // Get bbox coordinates (center x, center y, width, height)
         float cx = pred[0];
@@ -433,7 +1378,7 @@ void TensorRTEngine::parseYOLOv11Output(const float* output,
         float maxConf = 0.0f;
         int maxClassId = -1;
 
-        for (int j = 0; j < 52; j++) {
+        for (int j = 0; j < static_cast<int>(m_numClasses); j++) {
             float conf = pred[4 + j];
             if (conf > maxConf) {
                 maxConf = conf;
@@ -450,6 +1395,16 @@ void TensorRTEngine::parseYOLOv11Output(const float* output,
         float x = cx - w / 2.0f;
         float y = cy - h / 2.0f;
 
+        // Model space -> frame space for this batch item
+        if (!transforms.empty()) {
+            const auto& t = transforms[i / predictionsPerImage];
+            const float invScale = 1.0f / t.scale;
+            x = (x - t.padX) * invScale + t.offsetX;
+            y = (y - t.padY) * invScale + t.offsetY;
+            w *= invScale;
+            h *= invScale;
+        }
+
         core::Detection det;
         det.x = x;
         det.y = y;
@@ -474,7 +1429,7 @@ void TensorRTEngine::parseYOLOv11Output(const float* output,
     detections = std::move(filteredDetections);
 }
 
-// Non-Maximum Suppression
+// Non-Maximum Suppression, class-agnostic like the GPU suppressionMaskKernel
 std::vector<int> TensorRTEngine::performNMS(const std::vector<core::Detection>& boxes,
                                             float nmsThreshold) {
     std::vector<int> indices(boxes.size());
@@ -530,12 +1485,19 @@ void TensorRTEngine::warmup(int iterations) {
     auto& logger = utils::Logger::getInstance();
     logger.info("Warming up TensorRT engine ({} iterations)", iterations);
 
-    std::vector<float> dummyInput(m_inputSize, 0.5f);
+    // Zero bits are 0.0 in both FP32 and FP16
+    std::vector<uint8_t> dummyInput(m_inputSize * cuda::elementSize(m_inputPrecision), 0);
     std::vector<core::Detection> dummyOutput;
 
-    for (int i = 0; i < iterations; i++) {
-        infer(dummyInput.data(), dummyOutput, 0.5f, 0.4f);
+    // Every profile: the first run after a switch pays TensorRT's shape setup
+    const uint32_t activeProfile = m_activeProfile;
+    for (uint32_t p = 0; p < m_profiles.size(); p++) {
+        selectProfile(p);
+        for (int i = 0; i < iterations; i++) {
+            infer(dummyInput.data(), dummyOutput, 0.5f, 0.4f);
+        }
     }
+    selectProfile(activeProfile);
 
     logger.info("Warmup completed. Average inference time: {:.2f} ms",
                 m_avgInferenceTime);
@@ -1,14 +1,19 @@
 #pragma once
 
 #include "../../core/types.hpp"
+#include "../postprocessing/nms_processor.hpp"
+#include "../preprocessing/fused_preprocess.hpp"
+#include "../../utils/gpu_memory_pool.hpp"
 #include <string>
 #include <vector>
 #include <memory>
 #include <NvInfer.h>
 #include <NvOnnxParser.h>
 #include <cuda_runtime_api.h>
+#include <atomic>
 #include <chrono>
 #include <fstream>
+#include <span>
 
 namespace vision {
 
@@ -18,62 +23,285 @@ public:
     void log(Severity severity, const char* msg) noexcept override;
 };
 
-// RAII wrapper for CUDA resources
+// Routes engine weights, activations and scratch through the shared
+// GpuMemoryPool (tag TensorRT). Set on runtimes only: build workspace is
+// transient and may exceed the pool limit. TensorRT 10 allocators derive
+// from IGpuAsyncAllocator, which routes the sync calls to the async pair.
+#if NV_TENSORRT_MAJOR >= 10
+class TRTGpuAllocator : public nvinfer1::IGpuAsyncAllocator {
+#else
+class TRTGpuAllocator : public nvinfer1::IGpuAllocator {
+#endif
+public:
+    static TRTGpuAllocator& getInstance();
+
+#if NV_TENSORRT_MAJOR >= 10
+    void* allocateAsync(uint64_t size, uint64_t alignment, nvinfer1::AllocatorFlags flags,
+                        cudaStream_t stream) noexcept override;
+    bool deallocateAsync(void* memory, cudaStream_t stream) noexcept override;
+#else
+    void* allocate(uint64_t size, uint64_t alignment, nvinfer1::AllocatorFlags flags) noexcept override;
+    bool deallocate(void* memory) noexcept override;
+    void free(void* memory) noexcept override;
+#endif
+};
+
+// RAII wrapper for device memory from the GpuMemoryPool
 template<typename T>
 struct CUDADeleter {
     void operator()(T* ptr) const {
-        if (ptr) cudaFree(ptr);
+        utils::GpuMemoryPool::getInstance().release(ptr);
     }
 };
 
 template<typename T>
 using CUDAPtr = std::unique_ptr<T, CUDADeleter<T>>;
 
+// Handle for a submitted inference, redeemed with poll() or wait()
+struct InferenceTicket {
+    uint32_t slot{0};
+    uint64_t sequence{0};
+};
+
+// Input resolution of one optimization profile
+struct InputProfile {
+    uint32_t width{0};
+    uint32_t height{0};
+    uint32_t predictionsPerImage{0};
+};
+
+enum class TicketStatus {
+    Pending,  // Still executing
+    Ready,    // Detections collected, slot released
+    Failed    // Execution failed or ticket is stale, slot released
+};
+
 class TensorRTEngine {
 public:
     explicit TensorRTEngine(const core::VisionConfig& config);
     ~TensorRTEngine();
 
     // Model loading and building
-    bool loadSerializedEngine(const std::string& enginePath);
+    bool loadSerializedEngine(const std::string& enginePath);  // Memory-mapped
+    bool loadPlan(const void* data, size_t size);
     bool buildEngineFromOnnx(const std::string& onnxPath);
     bool saveEngine(const std::string& outputPath);
+    bool writeLayerReport(const std::string& outputPath) const;  // IEngineInspector JSON
+
+    // Build a serialized plan without loading it. timingCache, when given, is
+    // fed to the builder and replaced with the updated cache afterwards;
+    // optimizationLevel < 0 keeps the TensorRT default.
+    static std::unique_ptr<nvinfer1::IHostMemory> buildPlan(const core::VisionConfig& config,
+                                                            const std::string& onnxPath,
+                                                            std::vector<char>* timingCache = nullptr,
+                                                            int optimizationLevel = -1);
 
-    // Inference
-    bool infer(const float* inputTensor,
+    // Inference. inputTensor is a host NCHW batch in getInputPrecision()
+    bool infer(const void* inputTensor,
                std::vector<core::Detection>& detections,
                float confThreshold,
                float nmsThreshold);
 
+    // Synchronous calls run on slot 0 and must not be mixed with the
+    // pipelined API below on the same engine.
+    //
+    // Input already written to getDeviceInputBuffer() on getStream().
+    // One transform per batch item maps detections back to frame space;
+    // on dynamic-batch engines the transform count sets the active batch.
+    bool inferDeviceInput(std::vector<core::Detection>& detections,
+                          float confThreshold,
+                          float nmsThreshold,
+                          std::span<const cuda::LetterboxTransform> transforms = {});
+
     bool inferAsync(const float* inputTensor,
                     cudaStream_t stream,
                     std::vector<core::Detection>& detections);
 
-    // Getters
+    // Pipelined inference: up to getInFlightDepth() frames in flight, each
+    // slot with its own context, buffers, stream and CUDA graph.
+    // acquireSlot -> write getDeviceInputBuffer(slot) -> submit -> poll/wait
+    // The slot runs at the profile selected when it was acquired.
+    bool acquireSlot(uint32_t& slot);
+    void releaseSlot(uint32_t slot);  // Give back an acquired slot without submitting
+    bool submit(uint32_t slot,
+                float confThreshold,
+                float nmsThreshold,
+                std::span<const cuda::LetterboxTransform> transforms,
+                InferenceTicket& ticket);
+
+    // Fused submission: letterbox preprocessing of the frame runs inside the
+    // slot's graph, so a whole frame costs one cudaGraphLaunch. The source
+    // must be ordered before this call on getStream(slot); params.output is
+    // ignored, the kernel writes the slot's input buffer.
+    bool submitFrame(uint32_t slot,
+                     const cuda::LetterboxParams& params,
+                     const cuda::LetterboxTransform& transform,
+                     float confThreshold,
+                     float nmsThreshold,
+                     InferenceTicket& ticket);
+    // gpuMilliseconds: when Ready, this ticket's own GPU time. Unlike
+    // getLastInferenceTime() it cannot belong to a later frame.
+    TicketStatus poll(const InferenceTicket& ticket, std::vector<core::Detection>& detections,
+                      float* gpuMilliseconds = nullptr);
+    bool wait(const InferenceTicket& ticket, std::vector<core::Detection>& detections,
+              float* gpuMilliseconds = nullptr);
+
+    // Resolution profiles, ascending (plans built with resolution_profiles
+    // from an ONNX export with dynamic H/W; a single entry otherwise).
+    // selectProfile applies to slots acquired, and synchronous calls made,
+    // after it; call it from the thread that acquires slots.
+    const std::vector<InputProfile>& getProfiles() const { return m_profiles; }
+    uint32_t getActiveProfile() const { return m_activeProfile; }
+    bool selectProfile(uint32_t profile);
+
+    // Getters (input size and predictions of the active profile)
     uint32_t getInputWidth() const { return m_inputWidth; }
     uint32_t getInputHeight() const { return m_inputHeight; }
     uint32_t getBatchSize() const { return m_batchSize; }
+    bool hasDynamicBatch() const { return m_dynamicBatch; }
+    size_t getInputImageBytes() const;
+    // Binding types of the plan (FP16 when built with fp16_io)
+    cuda::TensorPrecision getInputPrecision() const { return m_inputPrecision; }
+    cuda::TensorPrecision getOutputPrecision() const { return m_outputPrecision; }
     size_t getNumClasses() const { return m_numClasses; }
+    uint32_t getPredictionsPerImage() const { return m_predictionsPerImage; }
+    void* getDeviceInputBuffer(uint32_t slot = 0) const { return m_slots[slot].deviceInput; }
+    cudaStream_t getStream(uint32_t slot = 0) const { return m_slots[slot].stream; }
+    uint32_t getInFlightDepth() const { return m_slotCount; }
+    uint32_t getFreeSlots() const;
 
     // Performance metrics
     float getAverageInferenceTime() const;
     float getLastInferenceTime() const { return m_lastInferenceTime; }
     size_t getTotalInferences() const { return m_inferenceCount; }
+    uint64_t getGraphLaunches() const { return m_graphLaunches.load(std::memory_order_relaxed); }
+    uint64_t getGraphCaptures() const { return m_graphCaptures.load(std::memory_order_relaxed); }
 
     // Warmup for optimal performance
     void warmup(int iterations = 10);
 
+    // Host decode + NMS of a raw [batch, N, 4 + classes] output block, the
+    // gpu_postprocessing = false path (exposed for blackjack_bench). FP32
+    // regardless of getOutputPrecision(); half outputs are widened first.
+    void decodeHostOutput(const float* output,
+                          uint32_t activeBatch,
+                          std::vector<core::Detection>& detections,
+                          float confThreshold,
+                          float nmsThreshold) {
+        parseYOLOv11Output(output, activeBatch, m_predictionsPerImage, detections,
+                           confThreshold, nmsThreshold);
+    }
+
 private:
+    enum class SlotState : uint8_t { Free, Acquired, InFlight };
+
+    // Everything baked into a captured graph. Frame source, ROI, letterbox
+    // and box transforms are read from pinned memory at launch and are not
+    // part of the key.
+    struct GraphKey {
+        uint32_t batch{0};
+        bool fused{false};          // Letterbox kernel ahead of the network
+        bool hasTransforms{false};  // Transform upload ahead of the decode
+        cuda::TensorPrecision precision{cuda::TensorPrecision::FP32};
+        uint32_t profile{0};
+        float confThreshold{0.0f};
+        float nmsThreshold{0.0f};
+
+        bool operator==(const GraphKey&) const = default;
+    };
+
+    // Graph of one batch size and profile on one slot
+    struct SlotGraph {
+        cudaGraph_t graph{nullptr};
+        cudaGraphExec_t exec{nullptr};
+        GraphKey key{};         // What exec was captured with
+        GraphKey warmed{};      // Ran eagerly once, capture on the next launch
+        bool hasWarmed{false};
+    };
+
+    // Everything one in-flight inference touches
+    struct InferenceSlot {
+        std::unique_ptr<nvinfer1::IExecutionContext> context;
+        std::atomic<SlotState> state{SlotState::Free};
+        uint64_t sequence{0};
+
+        // CUDA resources
+        cudaStream_t stream{nullptr};
+        cudaEvent_t startEvent{nullptr};
+        cudaEvent_t endEvent{nullptr};
+
+        // Buffers
+        void* deviceInput{nullptr};
+        void* deviceOutput{nullptr};
+        std::vector<float> hostOutput;
+        std::vector<uint16_t> hostOutputHalf;  // FP16 readback, widened into hostOutput
+
+        // GPU postprocessing (decode + NMS)
+        cuda::DecodeWorkspace decodeWorkspace{};
+        cuda::DetectionResult* hostResult{nullptr};          // Pinned
+        cuda::LetterboxTransform* deviceTransforms{nullptr};  // [m_batchSize]
+        cuda::LetterboxTransform* hostTransforms{nullptr};    // Pinned staging
+        size_t transformCount{0};
+
+        // Fused preprocessing arguments, staged the same way
+        cuda::LetterboxLaunch* deviceLaunch{nullptr};
+        cuda::LetterboxLaunch* hostLaunch{nullptr};  // Pinned
+
+        // Profile latched at acquire, and the one the context is set to
+        uint32_t profile{0};
+        uint32_t activeProfile{0};
+
+        // Settings of the pending execution, for the CPU decode path
+        uint32_t activeBatch{1};
+        float confThreshold{0.0f};
+        float nmsThreshold{0.0f};
+
+        // One graph per profile and batch size (a single entry on static engines)
+        std::vector<SlotGraph> graphs;
+    };
+
     // Engine creation and management
-    bool createExecutionContext();
+    bool createExecutionContexts();
     bool allocateBuffers();
+    bool allocateSlotBuffers(InferenceSlot& slot);
     void deallocateBuffers();
+    bool resolveIOTensors();
+    void queryTensorShapes();
+    bool queryResolutionProfiles();
+    // Switch the slot context to slot.profile and batch where they changed
+    bool setActiveShape(InferenceSlot& slot, uint32_t batch);
+
+    // Enqueue [preprocessing +] network + postprocessing on the slot stream,
+    // no host wait. preprocess selects the fused chain.
+    bool enqueue(InferenceSlot& slot,
+                 float confThreshold,
+                 float nmsThreshold,
+                 std::span<const cuda::LetterboxTransform> transforms,
+                 const cuda::LetterboxParams* preprocess = nullptr);
+    // Replay, capture or eagerly run the chain for key
+    bool launch(InferenceSlot& slot, const GraphKey& key);
+    bool captureGraph(InferenceSlot& slot, SlotGraph& graph, const GraphKey& key);
+    // The raw chain; the body of every graph
+    bool enqueueChain(InferenceSlot& slot, const GraphKey& key);
+    void destroyGraphs(InferenceSlot& slot);
+    // Slot stream has completed: record timing, decode detections
+    float finish(InferenceSlot& slot, std::vector<core::Detection>& detections);  // GPU ms
+
+    // Device-side decode + NMS, leaves the result block in pinned memory
+    bool enqueueGpuPostprocessing(InferenceSlot& slot,
+                                  float confThreshold,
+                                  float nmsThreshold,
+                                  const cuda::LetterboxTransform* deviceTransforms);
+    void collectGpuDetections(const InferenceSlot& slot, std::vector<core::Detection>& detections);
 
     // Post-processing
     void parseYOLOv11Output(const float* output,
+                           uint32_t activeBatch,
+                           uint32_t predictionsPerImage,
                            std::vector<core::Detection>& detections,
                            float confThreshold,
-                           float nmsThreshold);
+                           float nmsThreshold,
+                           std::span<const cuda::LetterboxTransform> transforms = {});
 
     std::vector<int> performNMS(const std::vector<core::Detection>& boxes,
                                 float nmsThreshold);
@@ -84,42 +312,48 @@ private:
     // TensorRT components
     std::unique_ptr<nvinfer1::IRuntime> m_runtime;
     std::unique_ptr<nvinfer1::ICudaEngine> m_engine;
-    std::unique_ptr<nvinfer1::IExecutionContext> m_context;
     TRTLogger m_logger;
 
-    // CUDA resources
-    cudaStream_t m_stream{nullptr};
-    cudaEvent_t m_startEvent{nullptr};
-    cudaEvent_t m_endEvent{nullptr};
+    // In-flight slots; slot 0 also serves the synchronous API
+    std::unique_ptr<InferenceSlot[]> m_slots;
+    uint32_t m_slotCount{1};
+    uint64_t m_nextSequence{1};
+
+    bool m_gpuPostprocessing{true};
+
+    // I/O tensor names of the YOLOv11 ONNX export
+    static constexpr const char* INPUT_TENSOR = "images";
+    static constexpr const char* OUTPUT_TENSOR = "output0";
 
-    // Buffers
-    void* m_deviceInputBuffer{nullptr};
-    void* m_deviceOutputBuffer{nullptr};
-    std::vector<float> m_hostOutputBuffer;
+    // Context profile not set yet; forces setInputShape on first use
+    static constexpr uint32_t NO_PROFILE = ~0u;
 
-    // Model configuration
-    const core::VisionConfig& m_config;
-    uint32_t m_inputWidth{1280};
+    // Model configuration, copied: an engine outlives the config snapshot it was built from
+    const core::VisionConfig m_config;
+    uint32_t m_inputWidth{1280};   // Active profile
     uint32_t m_inputHeight{1280};
-    uint32_t m_batchSize{1};
-    size_t m_numClasses{52};  // 52 cards in a deck
+    uint32_t m_batchSize{1};      // Buffer capacity (profile max for dynamic engines)
+    bool m_dynamicBatch{false};
+    bool m_dynamicResolution{false};  // Spatial input dims set per profile
+    std::vector<InputProfile> m_profiles;
+    uint32_t m_activeProfile{0};
+    size_t m_numClasses{52};  // From the output shape; 52 cards in a deck
+    cuda::TensorPrecision m_inputPrecision{cuda::TensorPrecision::FP32};
+    cuda::TensorPrecision m_outputPrecision{cuda::TensorPrecision::FP32};
 
-    // Input/Output dimensions
+    // Input/Output dimensions; buffer sizes cover the largest profile
     size_t m_inputSize{0};
     size_t m_outputSize{0};
-    int m_inputIndex{-1};
-    int m_outputIndex{-1};
+    uint32_t m_predictionsPerImage{0};  // Active profile
 
     // Performance tracking
     float m_avgInferenceTime{0.0f};
     float m_lastInferenceTime{0.0f};
     size_t m_inferenceCount{0};
 
-    // CUDA Graphs for optimization
     bool m_useCudaGraphs{true};
-    cudaGraph_t m_cudaGraph{nullptr};
-    cudaGraphExec_t m_cudaGraphExec{nullptr};
-    bool m_graphCaptured{false};
+    std::atomic<uint64_t> m_graphLaunches{0};
+    std::atomic<uint64_t> m_graphCaptures{0};
 };
 
 } // namespace vision
@@ -0,0 +1,120 @@
+#include "tile_planner.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace vision {
+
+TilePlanner::TilePlanner(uint32_t tileSize, uint32_t maxTiles)
+    : m_tileSize(tileSize), m_maxTiles(std::max(maxTiles, 1u)) {
+    m_regions.reserve(m_maxTiles);
+    m_tiles.reserve(m_maxTiles);
+}
+
+const std::vector<capture::ROI>& TilePlanner::plan(uint32_t frameWidth,
+                                                   uint32_t frameHeight,
+                                                   std::span<const capture::ROI> cardRegions,
+                                                   const capture::ROI& tableROI) {
+    m_frameWidth = frameWidth;
+    m_frameHeight = frameHeight;
+    m_regions.clear();
+    m_tiles.clear();
+
+    // Tracked card regions, except on the periodic rescan
+    if (m_framesSinceScan < RESCAN_INTERVAL) {
+        for (const auto& region : cardRegions) {
+            if (region.width > 0 && region.height > 0 &&
+                region.x < frameWidth && region.y < frameHeight) {
+                m_regions.push_back(expandRegion(region));
+            }
+        }
+    }
+
+    // The table ROI when nothing is tracked (or on rescan); full frame as a last resort
+    if (m_regions.empty()) {
+        m_framesSinceScan = 0;
+        if (tableROI.width > 0 && tableROI.height > 0) {
+            m_regions.push_back(tableROI);
+        } else {
+            m_regions.push_back({0, 0, frameWidth, frameHeight});
+        }
+    } else {
+        m_framesSinceScan++;
+    }
+
+    bool fits = true;
+    for (const auto& region : m_regions) {
+        if (!addRegionTiles(region)) {
+            fits = false;
+            break;
+        }
+    }
+
+    if (fits) return m_tiles;
+
+    // Too many tiles at native scale: one downscaled tile per region, or a
+    // single tile over their bounding box when even that does not fit
+    m_tiles.clear();
+    if (m_regions.size() <= m_maxTiles) {
+        m_tiles.assign(m_regions.begin(), m_regions.end());
+        return m_tiles;
+    }
+
+    uint32_t x0 = m_frameWidth, y0 = m_frameHeight, x1 = 0, y1 = 0;
+    for (const auto& region : m_regions) {
+        x0 = std::min(x0, region.x);
+        y0 = std::min(y0, region.y);
+        x1 = std::max(x1, region.x + region.width);
+        y1 = std::max(y1, region.y + region.height);
+    }
+    m_tiles.push_back({x0, y0, x1 - x0, y1 - y0});
+    return m_tiles;
+}
+
+bool TilePlanner::addRegionTiles(const capture::ROI& region) {
+    const float tileSize = static_cast<float>(m_tileSize);
+    const uint32_t longSide = std::max(region.width, region.height);
+
+    // Small enough to letterbox without losing glyph detail
+    if (longSide <= tileSize * MAX_DOWNSCALE) {
+        if (m_tiles.size() >= m_maxTiles) return false;
+        m_tiles.push_back(region);
+        return true;
+    }
+
+    // Grid the region with native-scale, overlapping tiles
+    const uint32_t side = m_tileSize;
+    const uint32_t step = static_cast<uint32_t>(tileSize * (1.0f - TILE_OVERLAP));
+    const uint32_t cols = region.width > side
+        ? static_cast<uint32_t>(std::ceil(static_cast<float>(region.width - side) / step)) + 1 : 1;
+    const uint32_t rows = region.height > side
+        ? static_cast<uint32_t>(std::ceil(static_cast<float>(region.height - side) / step)) + 1 : 1;
+
+    if (m_tiles.size() + cols * rows > m_maxTiles) return false;
+
+    for (uint32_t r = 0; r < rows; r++) {
+        for (uint32_t c = 0; c < cols; c++) {
+            capture::ROI tile;
+            tile.width = std::min(side, region.width);
+            tile.height = std::min(side, region.height);
+            // Last row/column snaps to the region edge
+            tile.x = region.x + std::min(c * step, region.width - tile.width);
+            tile.y = region.y + std::min(r * step, region.height - tile.height);
+            m_tiles.push_back(tile);
+        }
+    }
+    return true;
+}
+
+capture::ROI TilePlanner::expandRegion(const capture::ROI& region) const {
+    const uint32_t marginX = static_cast<uint32_t>(region.width * REGION_MARGIN);
+    const uint32_t marginY = static_cast<uint32_t>(region.height * REGION_MARGIN);
+
+    capture::ROI expanded;
+    expanded.x = region.x > marginX ? region.x - marginX : 0;
+    expanded.y = region.y > marginY ? region.y - marginY : 0;
+    expanded.width = std::min(region.x + region.width + marginX, m_frameWidth) - expanded.x;
+    expanded.height = std::min(region.y + region.height + marginY, m_frameHeight) - expanded.y;
+    return expanded;
+}
+
+} // namespace vision
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "../../capture/roi_detector.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace vision {
+
+// Picks the crops TiledInference runs for a frame: one tile per tracked
+// card region (gridded when a region is too large to letterbox), and every
+// RESCAN_INTERVAL frames, or when nothing is tracked, the table ROI or the
+// whole frame so cards entering the scene are found. Host only.
+class TilePlanner {
+public:
+    TilePlanner(uint32_t tileSize, uint32_t maxTiles);
+
+    const std::vector<capture::ROI>& plan(uint32_t frameWidth,
+                                          uint32_t frameHeight,
+                                          std::span<const capture::ROI> cardRegions,
+                                          const capture::ROI& tableROI);
+
+    static constexpr uint32_t RESCAN_INTERVAL = 30;  // Frames between table scans while tracking
+
+private:
+    bool addRegionTiles(const capture::ROI& region);
+    capture::ROI expandRegion(const capture::ROI& region) const;
+
+    uint32_t m_tileSize;
+    uint32_t m_maxTiles;
+    uint32_t m_frameWidth{0};
+    uint32_t m_frameHeight{0};
+    uint32_t m_framesSinceScan{0};
+
+    // Reused every frame, capacity reserved up front
+    std::vector<capture::ROI> m_regions;
+    std::vector<capture::ROI> m_tiles;
+
+    static constexpr float REGION_MARGIN = 0.15f;   // Context around card regions
+    static constexpr float TILE_OVERLAP = 0.2f;     // Overlap when gridding large regions
+    static constexpr float MAX_DOWNSCALE = 1.5f;    // Above this a region is gridded
+};
+
+} // namespace vision
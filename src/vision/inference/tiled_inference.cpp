@@ -0,0 +1,81 @@
+#include "tiled_inference.hpp"
+#include "../../utils/logger.hpp"
+#include <algorithm>
+
+namespace vision {
+
+TiledInference::TiledInference(const core::VisionConfig& config)
+    : m_tileConfig(config),
+      m_planner(config.tile_size, config.max_tiles) {
+    // Tile engine: small square input, batch dimension = tile capacity
+    m_tileConfig.model_path = config.tile_model_path;
+    m_tileConfig.input_resolution = {config.tile_size, config.tile_size};
+    m_tileConfig.batch_size = std::max(config.max_tiles, 1u);
+    m_tileConfig.inflight_depth = 1;  // Driven synchronously, one tile batch per frame
+
+    m_tiles.reserve(m_tileConfig.batch_size);
+    m_transforms.reserve(m_tileConfig.batch_size);
+}
+
+TiledInference::~TiledInference() {
+}
+
+bool TiledInference::initialize() {
+    auto& logger = utils::Logger::getInstance();
+
+    m_engine = std::make_unique<TensorRTEngine>(m_tileConfig);
+    if (!m_engine->loadSerializedEngine(m_tileConfig.model_path)) {
+        logger.error("Failed to load tile engine: {}", m_tileConfig.model_path);
+        return false;
+    }
+
+    if (!m_engine->hasDynamicBatch() && m_engine->getBatchSize() != 1) {
+        logger.error("Tile engine needs a dynamic batch profile (static batch {})",
+                     m_engine->getBatchSize());
+        return false;
+    }
+
+    if (!m_preprocessor.initialize(m_tileConfig.tile_size, m_tileConfig.tile_size,
+                                   m_engine->getInputPrecision())) {
+        return false;
+    }
+
+    logger.info("Tiled inference ready: up to {} tiles of {}x{}",
+                m_engine->getBatchSize(), m_tileConfig.tile_size, m_tileConfig.tile_size);
+    return true;
+}
+
+bool TiledInference::infer(const capture::Frame& frame,
+                           const capture::ROIDetector& roiDetector,
+                           std::vector<core::Detection>& detections,
+                           float confThreshold,
+                           float nmsThreshold) {
+    auto& logger = utils::Logger::getInstance();
+
+    m_tiles = m_planner.plan(frame.width, frame.height,
+                             roiDetector.getCardRegions(), roiDetector.getTableROI());
+
+    // Static single-image engines run one tile per frame
+    const size_t capacity = m_engine->hasDynamicBatch() ? m_engine->getBatchSize() : 1;
+    if (m_tiles.size() > capacity) {
+        m_tiles.resize(capacity);
+    }
+
+    // Letterbox every tile into its own batch slot of the engine input
+    auto* input = static_cast<uint8_t*>(m_engine->getDeviceInputBuffer());
+    const size_t tileBytes = m_engine->getInputImageBytes();
+    cudaStream_t stream = m_engine->getStream();
+
+    m_transforms.clear();
+    for (size_t i = 0; i < m_tiles.size(); i++) {
+        if (!m_preprocessor.process(frame, input + i * tileBytes, stream, &m_tiles[i])) {
+            logger.error("Failed to preprocess tile {}", i);
+            return false;
+        }
+        m_transforms.push_back(m_preprocessor.getLastTransform());
+    }
+
+    return m_engine->inferDeviceInput(detections, confThreshold, nmsThreshold, m_transforms);
+}
+
+} // namespace vision
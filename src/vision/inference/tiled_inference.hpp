@@ -0,0 +1,44 @@
+#pragma once
+
+#include "tensorrt_engine.hpp"
+#include "tile_planner.hpp"
+#include "../preprocessing/preprocessor.hpp"
+#include "../../capture/roi_detector.hpp"
+#include <memory>
+#include <vector>
+
+namespace vision {
+
+// ROI-cropped inference: the tracked card regions (or the table ROI when no
+// cards are tracked yet, see TilePlanner) are letterboxed into a batch of small fixed-size tiles
+// and run through a dynamic-batch engine. Detections come back in frame
+// coordinates, with NMS applied across overlapping tiles.
+class TiledInference {
+public:
+    explicit TiledInference(const core::VisionConfig& config);
+    ~TiledInference();
+
+    bool initialize();
+
+    bool infer(const capture::Frame& frame,
+               const capture::ROIDetector& roiDetector,
+               std::vector<core::Detection>& detections,
+               float confThreshold,
+               float nmsThreshold);
+
+    cudaStream_t getStream() const { return m_engine->getStream(); }
+    uint32_t getLastTileCount() const { return static_cast<uint32_t>(m_tiles.size()); }
+    const std::vector<capture::ROI>& getLastTiles() const { return m_tiles; }
+
+private:
+    core::VisionConfig m_tileConfig;  // Vision config retargeted at the tile model
+    std::unique_ptr<TensorRTEngine> m_engine;
+    Preprocessor m_preprocessor;
+    TilePlanner m_planner;
+
+    // Reused every frame, capacity reserved up front
+    std::vector<capture::ROI> m_tiles;
+    std::vector<cuda::LetterboxTransform> m_transforms;
+};
+
+} // namespace vision
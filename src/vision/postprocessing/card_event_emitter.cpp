@@ -0,0 +1,190 @@
+#include "card_event_emitter.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace vision {
+
+namespace {
+
+// How long a dropped card may stay hidden and how far its centre may move,
+// in box sizes, and still come back as the same card
+constexpr uint64_t REACQUIRE_WINDOW_NS = 2'000'000'000ull;
+constexpr float REACQUIRE_DISTANCE = 1.0f;
+
+} // namespace
+
+CardEventEmitter::CardEventEmitter() {
+}
+
+CardEventEmitter::~CardEventEmitter() {
+}
+
+void CardEventEmitter::configure(uint32_t confirmFrames, float minConfidence) {
+    m_confirmFrames = std::clamp(confirmFrames, 1u, CardTracker::HISTORY_LENGTH);
+    m_minConfidence = minConfidence;
+}
+
+std::span<const core::CardEvent> CardEventEmitter::update(const CardTracker& tracker,
+                                                          uint64_t timestamp_ns) {
+    m_eventCount = 0;
+
+    if (m_shufflePending) {
+        m_shufflePending = false;
+        emit(core::CardEventType::ShoeShuffled, core::Card{}, 0, timestamp_ns);
+    }
+
+    expireRetired(timestamp_ns);
+
+    const uint32_t back = m_front ^ 1;
+    auto& next = m_entries[back];
+    uint32_t nextCount = 0;
+    std::fill_n(m_carried.begin(), m_entryCount[m_front], false);
+
+    for (const auto& track : tracker.getTrackedCards()) {
+        Entry entry{track.trackId, track.trackId, false, core::Card{}, track.detection};
+        if (const Entry* previous = findEntry(track.trackId)) {
+            entry = *previous;
+            entry.box = track.detection;
+            m_carried[previous - m_entries[m_front].data()] = true;
+        }
+
+        // Only frames where the track was matched add evidence
+        if (!entry.confirmed && track.age == 0 &&
+            confirm(tracker, track, timestamp_ns, entry.card)) {
+            entry.confirmed = true;
+            if (!reacquire(entry)) {
+                m_cardsDealt++;
+                const auto& box = track.detection;
+                emit(core::CardEventType::CardDealt, entry.card, entry.eventTrackId, timestamp_ns,
+                     box.y + 0.5f * box.height);
+            }
+        }
+
+        next[nextCount++] = entry;
+    }
+
+    // Confirmed tracks the tracker no longer has
+    for (uint32_t i = 0; i < m_entryCount[m_front]; i++) {
+        const Entry& entry = m_entries[m_front][i];
+        if (!m_carried[i] && entry.confirmed) {
+            retire(entry, timestamp_ns);
+        }
+    }
+
+    m_entryCount[back] = nextCount;
+    m_front = back;
+    return {m_events.data(), m_eventCount};
+}
+
+void CardEventEmitter::reset() {
+    m_entryCount.fill(0);
+    m_retiredCount = 0;
+    m_eventCount = 0;
+    m_shufflePending = false;
+    m_cardsDealt = 0;
+}
+
+const CardEventEmitter::Entry* CardEventEmitter::findEntry(uint32_t trackId) const {
+    const auto& entries = m_entries[m_front];
+    for (uint32_t i = 0; i < m_entryCount[m_front]; i++) {
+        if (entries[i].trackId == trackId) return &entries[i];
+    }
+    return nullptr;
+}
+
+// Claims the nearest retired track of the same card within reach; the entry
+// takes over its identity
+bool CardEventEmitter::reacquire(Entry& entry) {
+    const float cx = entry.box.x + 0.5f * entry.box.width;
+    const float cy = entry.box.y + 0.5f * entry.box.height;
+
+    uint32_t best = m_retiredCount;
+    float bestDistance = 0.0f;
+    for (uint32_t i = 0; i < m_retiredCount; i++) {
+        const Retired& retired = m_retired[i];
+        if (retired.card.rank != entry.card.rank || retired.card.suit != entry.card.suit) continue;
+
+        const auto& box = retired.box;
+        const float distance = std::hypot(box.x + 0.5f * box.width - cx, box.y + 0.5f * box.height - cy);
+        const float reach = REACQUIRE_DISTANCE * std::max(box.width, box.height);
+        if (distance <= reach && (best == m_retiredCount || distance < bestDistance)) {
+            best = i;
+            bestDistance = distance;
+        }
+    }
+    if (best == m_retiredCount) return false;
+
+    entry.eventTrackId = m_retired[best].eventTrackId;
+    entry.card = m_retired[best].card;
+    std::move(m_retired.begin() + best + 1, m_retired.begin() + m_retiredCount, m_retired.begin() + best);
+    m_retiredCount--;
+    return true;
+}
+
+void CardEventEmitter::retire(const Entry& entry, uint64_t timestamp_ns) {
+    // Full: the oldest retiree is removed for good
+    if (m_retiredCount == m_retired.size()) {
+        const Retired& oldest = m_retired[0];
+        emit(core::CardEventType::CardRemoved, oldest.card, oldest.eventTrackId, timestamp_ns);
+        std::move(m_retired.begin() + 1, m_retired.end(), m_retired.begin());
+        m_retiredCount--;
+    }
+    m_retired[m_retiredCount++] = {entry.eventTrackId, entry.card, entry.box, timestamp_ns};
+}
+
+void CardEventEmitter::expireRetired(uint64_t timestamp_ns) {
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < m_retiredCount; i++) {
+        const Retired& retired = m_retired[i];
+        if (timestamp_ns - retired.retired_ns >= REACQUIRE_WINDOW_NS) {
+            emit(core::CardEventType::CardRemoved, retired.card, retired.eventTrackId, timestamp_ns);
+        } else {
+            m_retired[kept++] = retired;
+        }
+    }
+    m_retiredCount = kept;
+}
+
+bool CardEventEmitter::confirm(const CardTracker& tracker, const TrackedCard& track,
+                               uint64_t timestamp_ns, core::Card& card) {
+    if (track.hits < m_confirmFrames) return false;
+
+    const size_t count = tracker.getHistory(track.trackId, m_history);
+
+    // Confidence-weighted votes, class id layout suit * 13 + (rank - 1)
+    std::array<float, 13> rankVotes{};
+    std::array<float, 4> suitVotes{};
+    for (size_t i = 0; i < count; i++) {
+        const auto& det = m_history[i];
+        if (det.confidence < m_minConfidence || det.card_id >= 52) continue;
+        rankVotes[det.card_id % 13] += det.confidence;
+        suitVotes[det.card_id / 13] += det.confidence;
+    }
+
+    const auto rank = std::max_element(rankVotes.begin(), rankVotes.end()) - rankVotes.begin();
+    const auto suit = std::max_element(suitVotes.begin(), suitVotes.end()) - suitVotes.begin();
+    const uint8_t cardId = static_cast<uint8_t>(suit * 13 + rank);
+
+    // The voted card must itself have been seen confidently often enough
+    uint32_t consistent = 0;
+    float confidence = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        const auto& det = m_history[i];
+        if (det.card_id == cardId && det.confidence >= m_minConfidence) {
+            consistent++;
+            confidence += det.confidence;
+        }
+    }
+    if (consistent < m_confirmFrames) return false;
+
+    card = core::cardFromId(cardId, confidence / consistent, timestamp_ns);
+    return true;
+}
+
+void CardEventEmitter::emit(core::CardEventType type, const core::Card& card,
+                            uint32_t trackId, uint64_t timestamp_ns, float centerY) {
+    if (m_eventCount == m_events.size()) return;
+    m_events[m_eventCount++] = {type, card, trackId, timestamp_ns, centerY};
+}
+
+} // namespace vision
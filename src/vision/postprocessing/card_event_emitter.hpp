@@ -0,0 +1,90 @@
+#pragma once
+
+#include "card_tracker.hpp"
+#include "../../core/types.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace vision {
+
+// Turns tracker state into counting events. A track is confirmed once its
+// history holds confirmFrames detections of the same card above
+// minConfidence; rank and suit are voted separately over the history,
+// weighted by confidence. Each confirmed track yields exactly one CardDealt
+// and, when the tracker drops it, one CardRemoved.
+//
+// A card occluded long enough for the tracker to drop it comes back under a
+// new track id. Dropped confirmed tracks are therefore held as retired for a
+// short window first: a new track confirming as the same card near the same
+// spot inherits the retired identity, with no second CardDealt. CardRemoved
+// is emitted only when the window runs out unclaimed.
+class CardEventEmitter {
+public:
+    static constexpr uint32_t MAX_TRACKS = CardTracker::MAX_TRACKS;
+    // Dealt per live track, removed per expired and per evicted retiree
+    static constexpr uint32_t MAX_EVENTS = 3 * MAX_TRACKS + 1;
+
+    CardEventEmitter();
+    ~CardEventEmitter();
+
+    // confirmFrames is capped at the tracker history length
+    void configure(uint32_t confirmFrames, float minConfidence);
+
+    // Events since the previous update; valid until the next update()
+    std::span<const core::CardEvent> update(const CardTracker& tracker, uint64_t timestamp_ns);
+
+    // Emits ShoeShuffled ahead of the next update's events
+    void notifyShuffle() { m_shufflePending = true; }
+
+    void reset();
+
+    uint64_t getCardsDealt() const { return m_cardsDealt; }
+
+private:
+    struct Entry {
+        uint32_t trackId;       // Tracker id
+        uint32_t eventTrackId;  // Id the card's events carry; kept across reacquisition
+        bool confirmed;
+        core::Card card;
+        core::Detection box;    // Last matched detection
+    };
+
+    // Confirmed track the tracker dropped, awaiting reacquisition
+    struct Retired {
+        uint32_t eventTrackId;
+        core::Card card;
+        core::Detection box;
+        uint64_t retired_ns;
+    };
+
+    const Entry* findEntry(uint32_t trackId) const;
+    bool reacquire(Entry& entry);
+    void retire(const Entry& entry, uint64_t timestamp_ns);
+    void expireRetired(uint64_t timestamp_ns);
+    bool confirm(const CardTracker& tracker, const TrackedCard& track,
+                 uint64_t timestamp_ns, core::Card& card);
+    void emit(core::CardEventType type, const core::Card& card, uint32_t trackId, uint64_t timestamp_ns,
+              float centerY = 0.0f);
+
+    uint32_t m_confirmFrames{5};
+    float m_minConfidence{0.75f};
+    bool m_shufflePending{false};
+    uint64_t m_cardsDealt{0};
+
+    // Tracks known at the previous update, rebuilt into the back table each update
+    std::array<std::array<Entry, MAX_TRACKS>, 2> m_entries{};
+    std::array<uint32_t, 2> m_entryCount{};
+    std::array<bool, MAX_TRACKS> m_carried{};
+    uint32_t m_front{0};
+
+    // Oldest first
+    std::array<Retired, MAX_TRACKS> m_retired{};
+    uint32_t m_retiredCount{0};
+
+    std::array<core::CardEvent, MAX_EVENTS> m_events{};
+    uint32_t m_eventCount{0};
+    std::array<core::Detection, CardTracker::HISTORY_LENGTH> m_history{};
+};
+
+} // namespace vision
@@ -0,0 +1,253 @@
+#include "card_tracker.hpp"
+#include "../../utils/profiling.hpp"
+#include <algorithm>
+
+namespace vision {
+
+namespace {
+
+// Kalman tuning, in pixels per frame
+constexpr float PROCESS_NOISE_POSITION = 1.0f;
+constexpr float PROCESS_NOISE_VELOCITY = 0.5f;
+constexpr float MEASUREMENT_NOISE = 4.0f;
+constexpr float INITIAL_VELOCITY_VARIANCE = 100.0f;
+constexpr float SIZE_SMOOTHING = 0.3f;  // Weight of the new measurement
+
+} // namespace
+
+CardTracker::CardTracker() {
+}
+
+CardTracker::~CardTracker() {
+}
+
+void CardTracker::update(std::span<const core::Detection> newDetections) {
+    NVTX_RANGE(utils::TraceCategory::Tracking, "tracker update");
+    const auto detections = newDetections.first(std::min<size_t>(newDetections.size(), MAX_DETECTIONS));
+    const uint32_t detectionCount = static_cast<uint32_t>(detections.size());
+
+    predict();
+    buildCostMatrix(detections);
+    assign(detections);
+
+    for (uint32_t t = 0; t < m_count; t++) {
+        if (!m_trackMatched[t]) {
+            m_ages[t]++;
+        }
+    }
+    removeStale();
+
+    // Unclaimed detections start new tracks while there is room
+    for (uint32_t d = 0; d < detectionCount; d++) {
+        if (!m_detectionMatched[d]) {
+            spawn(detections[d]);
+        }
+    }
+
+    publish();
+}
+
+size_t CardTracker::getHistory(uint32_t trackId, std::span<core::Detection> out) const {
+    for (uint32_t t = 0; t < m_count; t++) {
+        if (m_ids[t] != trackId) continue;
+
+        const size_t count = std::min<size_t>(m_historySize[t], out.size());
+        // Oldest of the newest count entries first
+        uint32_t index = (m_historyHead[t] + HISTORY_LENGTH - static_cast<uint32_t>(count)) % HISTORY_LENGTH;
+        for (size_t i = 0; i < count; i++) {
+            out[i] = m_history[t][index];
+            index = (index + 1) % HISTORY_LENGTH;
+        }
+        return count;
+    }
+    return 0;
+}
+
+void CardTracker::reset() {
+    m_count = 0;
+    m_nextTrackId = 0;
+}
+
+// x' = F x, P' = F P F^T + Q with F = [[1, 1], [0, 1]], per axis
+void CardTracker::predict() {
+    for (uint32_t t = 0; t < m_count; t++) {
+        m_cx[t] += m_vx[t];
+        m_xpp[t] += 2.0f * m_xpv[t] + m_xvv[t] + PROCESS_NOISE_POSITION;
+        m_xpv[t] += m_xvv[t];
+        m_xvv[t] += PROCESS_NOISE_VELOCITY;
+
+        m_cy[t] += m_vy[t];
+        m_ypp[t] += 2.0f * m_ypv[t] + m_yvv[t] + PROCESS_NOISE_POSITION;
+        m_ypv[t] += m_yvv[t];
+        m_yvv[t] += PROCESS_NOISE_VELOCITY;
+    }
+}
+
+// IoU of every detection against every predicted track box. The inner loop
+// runs over contiguous track arrays without branches, so it vectorizes.
+void CardTracker::buildCostMatrix(std::span<const core::Detection> detections) {
+    std::array<float, MAX_TRACKS> x1, y1, x2, y2, area;
+    for (uint32_t t = 0; t < m_count; t++) {
+        x1[t] = m_cx[t] - 0.5f * m_w[t];
+        y1[t] = m_cy[t] - 0.5f * m_h[t];
+        x2[t] = m_cx[t] + 0.5f * m_w[t];
+        y2[t] = m_cy[t] + 0.5f * m_h[t];
+        area[t] = m_w[t] * m_h[t];
+    }
+
+    for (size_t d = 0; d < detections.size(); d++) {
+        const auto& det = detections[d];
+        const float dx2 = det.x + det.width;
+        const float dy2 = det.y + det.height;
+        const float detArea = det.width * det.height;
+        auto& row = m_cost[d];
+
+        for (uint32_t t = 0; t < m_count; t++) {
+            const float w = std::max(0.0f, std::min(dx2, x2[t]) - std::max(det.x, x1[t]));
+            const float h = std::max(0.0f, std::min(dy2, y2[t]) - std::max(det.y, y1[t]));
+            const float intersection = w * h;
+            const float unionArea = detArea + area[t] - intersection;
+            row[t] = unionArea > 0.0f ? intersection / unionArea : 0.0f;
+        }
+    }
+}
+
+// Greedy assignment: best overlapping pairs first, each side used once.
+// Matched tracks are corrected with their detection right away.
+void CardTracker::assign(std::span<const core::Detection> detections) {
+    const uint32_t detectionCount = static_cast<uint32_t>(detections.size());
+
+    std::fill_n(m_trackMatched.begin(), m_count, false);
+    std::fill_n(m_detectionMatched.begin(), detectionCount, false);
+
+    size_t candidates = 0;
+    for (uint32_t d = 0; d < detectionCount; d++) {
+        for (uint32_t t = 0; t < m_count; t++) {
+            if (m_cost[d][t] >= m_iouThreshold) {
+                m_matches[candidates++] = {m_cost[d][t], static_cast<uint16_t>(t), static_cast<uint16_t>(d)};
+            }
+        }
+    }
+
+    std::sort(m_matches.begin(), m_matches.begin() + candidates,
+              [](const Match& a, const Match& b) { return a.iou > b.iou; });
+
+    for (size_t i = 0; i < candidates; i++) {
+        const Match& match = m_matches[i];
+        if (m_trackMatched[match.track] || m_detectionMatched[match.detection]) continue;
+
+        m_trackMatched[match.track] = true;
+        m_detectionMatched[match.detection] = true;
+        correct(match.track, detections[match.detection]);
+    }
+}
+
+void CardTracker::correct(uint32_t t, const core::Detection& det) {
+    const float zx = det.x + 0.5f * det.width;
+    const float zy = det.y + 0.5f * det.height;
+
+    // H = [1, 0]: K = P H^T / (H P H^T + R), P' = (I - K H) P
+    const float sx = m_xpp[t] + MEASUREMENT_NOISE;
+    const float kxp = m_xpp[t] / sx;
+    const float kxv = m_xpv[t] / sx;
+    const float rx = zx - m_cx[t];
+    m_cx[t] += kxp * rx;
+    m_vx[t] += kxv * rx;
+    m_xvv[t] -= kxv * m_xpv[t];
+    m_xpv[t] -= kxp * m_xpv[t];
+    m_xpp[t] -= kxp * m_xpp[t];
+
+    const float sy = m_ypp[t] + MEASUREMENT_NOISE;
+    const float kyp = m_ypp[t] / sy;
+    const float kyv = m_ypv[t] / sy;
+    const float ry = zy - m_cy[t];
+    m_cy[t] += kyp * ry;
+    m_vy[t] += kyv * ry;
+    m_yvv[t] -= kyv * m_ypv[t];
+    m_ypv[t] -= kyp * m_ypv[t];
+    m_ypp[t] -= kyp * m_ypp[t];
+
+    m_w[t] += SIZE_SMOOTHING * (det.width - m_w[t]);
+    m_h[t] += SIZE_SMOOTHING * (det.height - m_h[t]);
+
+    m_last[t] = det;
+    m_ages[t] = 0;
+    m_hits[t]++;
+
+    m_history[t][m_historyHead[t]] = det;
+    m_historyHead[t] = (m_historyHead[t] + 1) % HISTORY_LENGTH;
+    m_historySize[t] = std::min(m_historySize[t] + 1, HISTORY_LENGTH);
+}
+
+void CardTracker::spawn(const core::Detection& det) {
+    if (m_count == MAX_TRACKS) return;
+
+    const uint32_t t = m_count++;
+    m_ids[t] = m_nextTrackId++;
+    m_ages[t] = 0;
+    m_hits[t] = 1;
+    m_last[t] = det;
+
+    m_cx[t] = det.x + 0.5f * det.width;
+    m_cy[t] = det.y + 0.5f * det.height;
+    m_vx[t] = 0.0f;
+    m_vy[t] = 0.0f;
+    m_xpp[t] = MEASUREMENT_NOISE;
+    m_ypp[t] = MEASUREMENT_NOISE;
+    m_xpv[t] = 0.0f;
+    m_ypv[t] = 0.0f;
+    m_xvv[t] = INITIAL_VELOCITY_VARIANCE;
+    m_yvv[t] = INITIAL_VELOCITY_VARIANCE;
+    m_w[t] = det.width;
+    m_h[t] = det.height;
+
+    m_history[t][0] = det;
+    m_historyHead[t] = 1 % HISTORY_LENGTH;
+    m_historySize[t] = 1;
+}
+
+// Swap-remove keeps the live tracks in the first m_count entries
+void CardTracker::removeStale() {
+    for (uint32_t t = 0; t < m_count;) {
+        if (m_ages[t] > m_maxAge) {
+            moveTrack(--m_count, t);
+        } else {
+            t++;
+        }
+    }
+}
+
+void CardTracker::moveTrack(uint32_t from, uint32_t to) {
+    if (from == to) return;
+
+    m_ids[to] = m_ids[from];
+    m_ages[to] = m_ages[from];
+    m_hits[to] = m_hits[from];
+    m_last[to] = m_last[from];
+    m_cx[to] = m_cx[from];
+    m_cy[to] = m_cy[from];
+    m_vx[to] = m_vx[from];
+    m_vy[to] = m_vy[from];
+    m_xpp[to] = m_xpp[from];
+    m_xpv[to] = m_xpv[from];
+    m_xvv[to] = m_xvv[from];
+    m_ypp[to] = m_ypp[from];
+    m_ypv[to] = m_ypv[from];
+    m_yvv[to] = m_yvv[from];
+    m_w[to] = m_w[from];
+    m_h[to] = m_h[from];
+    m_history[to] = m_history[from];
+    m_historyHead[to] = m_historyHead[from];
+    m_historySize[to] = m_historySize[from];
+}
+
+// One whole-struct store per view. Written field by field, GCC 12 (-O1 and
+// up) strength-reduces the addresses into a form ipa-pure-const takes for a
+// null dereference, marks publish() pure and drops the call from update().
+void CardTracker::publish() {
+    for (uint32_t t = 0; t < m_count; t++) {
+        m_view[t] = {m_last[t], m_ids[t], m_ages[t], m_hits[t], m_cx[t] + m_vx[t], m_cy[t] + m_vy[t]};
+    }
+}
+
+} // namespace vision
@@ -1,43 +1,96 @@
 #pragma once
 
 #include "../../core/types.hpp"
-#include <vector>
-#include <map>
+#include "../../core/constants.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
 
 namespace vision {
 
+// Published view of one track, rebuilt after every update
 struct TrackedCard {
-    core::Detection detection;
+    core::Detection detection;  // Last matched detection
     uint32_t trackId;
-    uint32_t age;  // Frames since last seen
-    float kalmanX, kalmanY;  // Predicted position
-    std::vector<core::Detection> history;
+    uint32_t age;               // Frames since last matched (0 = matched this frame)
+    uint32_t hits;              // Frames matched in total
+    float kalmanX, kalmanY;     // Predicted box center for the next frame
 };
 
+// Fixed-capacity multi-object tracker. Track state lives in parallel
+// arrays (structure of arrays) so prediction and the IoU cost matrix run as
+// straight loops over contiguous floats; tracks are kept dense by
+// swap-removal. Nothing allocates after construction.
 class CardTracker {
 public:
+    static constexpr uint32_t MAX_TRACKS = core::constants::MAX_TRACKS;
+    static constexpr uint32_t MAX_DETECTIONS = core::constants::MAX_DETECTIONS_PER_FRAME;
+    static constexpr uint32_t HISTORY_LENGTH = core::constants::TRACK_HISTORY_LENGTH;
+
     CardTracker();
     ~CardTracker();
 
-    void update(const std::vector<core::Detection>& newDetections);
-    std::vector<TrackedCard> getTrackedCards() const;
-    
+    void update(std::span<const core::Detection> newDetections);
+
+    // Valid until the next update()
+    std::span<const TrackedCard> getTrackedCards() const { return {m_view.data(), m_count}; }
+    uint32_t getTrackCount() const { return m_count; }
+
+    // Copies up to out.size() of the track's recent detections, oldest first
+    size_t getHistory(uint32_t trackId, std::span<core::Detection> out) const;
+
     void reset();
-    
+
     // Configuration
     void setMaxAge(uint32_t maxAge) { m_maxAge = maxAge; }
     void setIoUThreshold(float threshold) { m_iouThreshold = threshold; }
 
 private:
-    float calculateIoU(const core::Detection& a, const core::Detection& b);
-    void associateDetections(const std::vector<core::Detection>& detections);
-    void updateKalmanFilters();
-    void removeOldTracks();
-    
-    std::map<uint32_t, TrackedCard> m_tracks;
+    struct Match {
+        float iou;
+        uint16_t track;
+        uint16_t detection;
+    };
+
+    void predict();
+    void buildCostMatrix(std::span<const core::Detection> detections);
+    void assign(std::span<const core::Detection> detections);
+    void correct(uint32_t track, const core::Detection& detection);
+    void spawn(const core::Detection& detection);
+    void removeStale();
+    void moveTrack(uint32_t from, uint32_t to);
+    void publish();
+
+    uint32_t m_count{0};
     uint32_t m_nextTrackId{0};
     uint32_t m_maxAge{30};  // Remove after 30 frames
     float m_iouThreshold{0.3f};
+
+    // Track table (structure of arrays, first m_count entries live)
+    std::array<uint32_t, MAX_TRACKS> m_ids{};
+    std::array<uint32_t, MAX_TRACKS> m_ages{};
+    std::array<uint32_t, MAX_TRACKS> m_hits{};
+    std::array<core::Detection, MAX_TRACKS> m_last{};
+
+    // Constant-velocity Kalman filter, independent per axis: state (p, v),
+    // covariance [[pp, pv], [pv, vv]]; box size is smoothed separately
+    std::array<float, MAX_TRACKS> m_cx{}, m_cy{}, m_vx{}, m_vy{};
+    std::array<float, MAX_TRACKS> m_xpp{}, m_xpv{}, m_xvv{};
+    std::array<float, MAX_TRACKS> m_ypp{}, m_ypv{}, m_yvv{};
+    std::array<float, MAX_TRACKS> m_w{}, m_h{};
+
+    // Ring-buffer histories
+    std::array<std::array<core::Detection, HISTORY_LENGTH>, MAX_TRACKS> m_history{};
+    std::array<uint32_t, MAX_TRACKS> m_historyHead{};   // Next write position
+    std::array<uint32_t, MAX_TRACKS> m_historySize{};
+
+    // Per-update scratch
+    std::array<std::array<float, MAX_TRACKS>, MAX_DETECTIONS> m_cost{};  // IoU, detection x track
+    std::array<Match, MAX_TRACKS * MAX_DETECTIONS> m_matches{};
+    std::array<bool, MAX_TRACKS> m_trackMatched{};
+    std::array<bool, MAX_DETECTIONS> m_detectionMatched{};
+
+    std::array<TrackedCard, MAX_TRACKS> m_view{};
 };
 
 } // namespace vision
@@ -1,17 +1,52 @@
-// CUDA Non-Maximum Suppression Implementation
+// CUDA YOLOv11 Decode and Non-Maximum Suppression Implementation
 
+#include "nms_processor.hpp"
+#include "../../utils/gpu_memory_pool.hpp"
 #include <cuda_runtime.h>
+#include <cuda_fp16.h>
 #include <device_launch_parameters.h>
 
 namespace vision {
 namespace cuda {
 
-struct Box {
-    float x, y, width, height;
-    float confidence;
-    uint8_t classId;
+using core::constants::MAX_NMS_CANDIDATES;
+using core::constants::MAX_DETECTIONS_PER_FRAME;
+
+constexpr uint32_t WARP_SIZE = 32;
+constexpr uint32_t DECODE_BLOCK_SIZE = 256;
+constexpr uint32_t MASK_BLOCK_SIZE = 64;  // One 64-bit mask word per thread
+constexpr uint32_t MASK_WORDS = MAX_NMS_CANDIDATES / MASK_BLOCK_SIZE;
+constexpr uint32_t SCORE_BINS = 1024;      // Confidence histogram resolution for the top-k cut
+
+// Confidence histogram of the decode pass and the cut derived from it when
+// more than MAX_NMS_CANDIDATES boxes survive the confidence filter
+struct CandidateSelection {
+    uint32_t histogram[SCORE_BINS];
+    uint32_t cutoffBin;     // Lowest bin kept
+    uint32_t cutoffQuota;   // Boxes still admitted from the cutoff bin
+    uint32_t cutoffTaken;
+    uint32_t overflow;      // Set when the refine pass must rerun the decode
 };
 
+static_assert((MAX_NMS_CANDIDATES & (MAX_NMS_CANDIDATES - 1)) == 0,
+              "Bitonic sort requires a power-of-two candidate capacity");
+static_assert(MAX_NMS_CANDIDATES <= 1024,
+              "Candidate sort runs in a single thread block");
+static_assert(MASK_WORDS <= WARP_SIZE,
+              "Mask reduction runs in a single warp");
+
+__device__ __forceinline__ float loadValue(const float* row, uint32_t idx) {
+    return row[idx];
+}
+
+__device__ __forceinline__ float loadValue(const __half* row, uint32_t idx) {
+    return __half2float(row[idx]);
+}
+
+__device__ __forceinline__ uint32_t scoreBin(float confidence) {
+    return min(static_cast<uint32_t>(confidence * SCORE_BINS), SCORE_BINS - 1);
+}
+
 /**
  * Calculate Intersection over Union (IoU) between two boxes
  */
@@ -20,45 +55,386 @@ __device__ float calculateIoU(const Box& a, const Box& b) {
     const float y1 = fmaxf(a.y, b.y);
     const float x2 = fminf(a.x + a.width, b.x + b.width);
     const float y2 = fminf(a.y + a.height, b.y + b.height);
-    
+
     const float intersectionArea = fmaxf(0.0f, x2 - x1) * fmaxf(0.0f, y2 - y1);
     const float areaA = a.width * a.height;
     const float areaB = b.width * b.height;
     const float unionArea = areaA + areaB - intersectionArea;
-    
+
     return unionArea > 0.0f ? intersectionArea / unionArea : 0.0f;
 }
 
 /**
- * GPU-accelerated Non-Maximum Suppression
+ * Fused confidence filter + argmax + compaction.
+ * One warp per prediction: lanes stride over the class scores (coalesced
+ * reads of the 56-float row), reduce the argmax with shuffles, and lane 0
+ * appends the survivor with a single atomic. Rows are FP32 or FP16 (the
+ * fp16_io binding); scores are compared in FP32 either way.
+ *
+ * The first pass also histograms the survivors' confidences. Survivors past
+ * MAX_NMS_CANDIDATES land in whatever order the warps ran, so when the first
+ * pass overflows, the Refine pass decodes again and admits only the boxes at
+ * or above the cutoff bin: a top-k by confidence, exact to one bin width.
+ */
+template<typename T, bool Refine>
+__global__ void decodeKernel(const T* __restrict__ output,
+                             uint32_t numPredictions,
+                             uint32_t predictionsPerImage,
+                             const LetterboxTransform* __restrict__ transforms,
+                             uint32_t numClasses,
+                             float confThreshold,
+                             CandidateSelection* __restrict__ selection,
+                             Box* __restrict__ candidates,
+                             uint32_t* __restrict__ candidateCount) {
+    // Grid-uniform exit: the common case never overflows
+    if constexpr (Refine) {
+        if (!selection->overflow) return;
+    }
+
+    const uint32_t lane = threadIdx.x & (WARP_SIZE - 1);
+    const uint32_t pred = (blockIdx.x * blockDim.x + threadIdx.x) / WARP_SIZE;
+
+    // Warp-uniform exit
+    if (pred >= numPredictions) return;
+
+    const T* row = output + static_cast<size_t>(pred) * (4 + numClasses);
+
+    float bestConf = 0.0f;
+    int bestClass = -1;
+
+    for (uint32_t c = lane; c < numClasses; c += WARP_SIZE) {
+        const float conf = loadValue(row, 4 + c);
+        if (conf > bestConf) {
+            bestConf = conf;
+            bestClass = static_cast<int>(c);
+        }
+    }
+
+    // Warp argmax, lowest class index wins ties (matches the host decoder)
+    for (uint32_t offset = WARP_SIZE / 2; offset > 0; offset >>= 1) {
+        const float otherConf = __shfl_down_sync(0xffffffffu, bestConf, offset);
+        const int otherClass = __shfl_down_sync(0xffffffffu, bestClass, offset);
+
+        if (otherConf > bestConf ||
+            (otherConf == bestConf &&
+             static_cast<uint32_t>(otherClass) < static_cast<uint32_t>(bestClass))) {
+            bestConf = otherConf;
+            bestClass = otherClass;
+        }
+    }
+
+    if (lane != 0 || bestClass < 0 || bestConf < confThreshold) return;
+
+    const uint32_t bin = scoreBin(bestConf);
+    if constexpr (Refine) {
+        if (bin < selection->cutoffBin) return;
+        if (bin == selection->cutoffBin &&
+            atomicAdd(&selection->cutoffTaken, 1u) >= selection->cutoffQuota) return;
+    } else {
+        atomicAdd(&selection->histogram[bin], 1u);
+    }
+
+    const uint32_t slot = atomicAdd(candidateCount, 1u);
+    if (slot >= MAX_NMS_CANDIDATES) return;
+
+    // Center format -> corner format
+    const float cx = loadValue(row, 0);
+    const float cy = loadValue(row, 1);
+    const float w = loadValue(row, 2);
+    const float h = loadValue(row, 3);
+
+    Box box;
+    box.x = cx - w * 0.5f;
+    box.y = cy - h * 0.5f;
+    box.width = w;
+    box.height = h;
+
+    // Model space -> frame space for this batch item
+    if (transforms) {
+        const LetterboxTransform t = transforms[pred / predictionsPerImage];
+        const float invScale = 1.0f / t.scale;
+        box.x = (box.x - t.padX) * invScale + t.offsetX;
+        box.y = (box.y - t.padY) * invScale + t.offsetY;
+        box.width *= invScale;
+        box.height *= invScale;
+    }
+    box.confidence = bestConf;
+    box.classId = static_cast<uint8_t>(bestClass);
+
+    candidates[slot] = box;
+}
+
+/**
+ * Single warp, after the first decode pass: when more boxes survived than
+ * fit, walk the histogram from the top and find the bin where the running
+ * count reaches MAX_NMS_CANDIDATES. Everything above it is kept, the bin
+ * itself only up to the remaining quota. Resets the count for the refine pass.
+ */
+__global__ void selectCutoffKernel(uint32_t* __restrict__ candidateCount,
+                                   CandidateSelection* __restrict__ selection) {
+    const uint32_t lane = threadIdx.x;
+    if (*candidateCount <= MAX_NMS_CANDIDATES) return;
+
+    uint32_t above = 0;
+    for (uint32_t base = 0; base < SCORE_BINS; base += WARP_SIZE) {
+        const uint32_t bin = SCORE_BINS - 1 - (base + lane);
+        const uint32_t binCount = selection->histogram[bin];
+
+        // Inclusive prefix sum, highest bin first
+        uint32_t inclusive = binCount;
+        for (uint32_t offset = 1; offset < WARP_SIZE; offset <<= 1) {
+            const uint32_t other = __shfl_up_sync(0xffffffffu, inclusive, offset);
+            if (lane >= offset) inclusive += other;
+        }
+
+        const uint32_t reached = __ballot_sync(0xffffffffu, above + inclusive >= MAX_NMS_CANDIDATES);
+        if (reached) {
+            if (lane == static_cast<uint32_t>(__ffs(reached) - 1)) {
+                selection->cutoffBin = bin;
+                selection->cutoffQuota = MAX_NMS_CANDIDATES - (above + inclusive - binCount);
+                selection->overflow = 1;
+                *candidateCount = 0;
+            }
+            return;
+        }
+        above += __shfl_sync(0xffffffffu, inclusive, WARP_SIZE - 1);
+    }
+}
+
+/**
+ * Single-block bitonic sort of the candidates by descending confidence
+ */
+__global__ void sortCandidatesKernel(const Box* __restrict__ candidates,
+                                     const uint32_t* __restrict__ candidateCount,
+                                     Box* __restrict__ sortedCandidates) {
+    __shared__ float keys[MAX_NMS_CANDIDATES];
+    __shared__ uint16_t values[MAX_NMS_CANDIDATES];
+
+    const uint32_t tid = threadIdx.x;
+    const uint32_t count = min(*candidateCount, MAX_NMS_CANDIDATES);
+
+    keys[tid] = tid < count ? candidates[tid].confidence : -1.0f;
+    values[tid] = static_cast<uint16_t>(tid);
+    __syncthreads();
+
+    for (uint32_t k = 2; k <= MAX_NMS_CANDIDATES; k <<= 1) {
+        for (uint32_t j = k >> 1; j > 0; j >>= 1) {
+            const uint32_t partner = tid ^ j;
+            if (partner > tid) {
+                const bool descending = (tid & k) == 0;
+                if ((keys[tid] < keys[partner]) == descending) {
+                    const float key = keys[tid];
+                    keys[tid] = keys[partner];
+                    keys[partner] = key;
+
+                    const uint16_t value = values[tid];
+                    values[tid] = values[partner];
+                    values[partner] = value;
+                }
+            }
+            __syncthreads();
+        }
+    }
+
+    if (tid < count) {
+        sortedCandidates[tid] = candidates[values[tid]];
+    }
+}
+
+/**
+ * Pairwise suppression bitmask: bit i of mask[row][word] is set when
+ * candidate (word * 64 + i) overlaps the higher-confidence candidate `row`.
+ * Only the upper triangle is computed. Class-agnostic, like the host
+ * performNMS: two classes on one box are one card read two ways, and only
+ * the more confident reading survives.
+ */
+__global__ void suppressionMaskKernel(const Box* __restrict__ sortedCandidates,
+                                      const uint32_t* __restrict__ candidateCount,
+                                      float iouThreshold,
+                                      uint64_t* __restrict__ mask) {
+    const uint32_t count = min(*candidateCount, MAX_NMS_CANDIDATES);
+    const uint32_t rowStart = blockIdx.y * MASK_BLOCK_SIZE;
+    const uint32_t colStart = blockIdx.x * MASK_BLOCK_SIZE;
+
+    // Block-uniform exits: empty tiles and the lower triangle
+    if (rowStart >= count || colStart >= count || blockIdx.x < blockIdx.y) return;
+
+    __shared__ Box columnBoxes[MASK_BLOCK_SIZE];
+
+    const uint32_t tid = threadIdx.x;
+    if (colStart + tid < count) {
+        columnBoxes[tid] = sortedCandidates[colStart + tid];
+    }
+    __syncthreads();
+
+    const uint32_t row = rowStart + tid;
+    if (row >= count) return;
+
+    const Box current = sortedCandidates[row];
+    const uint32_t columnCount = min(count - colStart, MASK_BLOCK_SIZE);
+    const uint32_t first = (blockIdx.x == blockIdx.y) ? tid + 1 : 0;
+
+    uint64_t bits = 0;
+    for (uint32_t i = first; i < columnCount; i++) {
+        if (calculateIoU(current, columnBoxes[i]) > iouThreshold) {
+            bits |= 1ull << i;
+        }
+    }
+
+    mask[row * MASK_WORDS + blockIdx.x] = bits;
+}
+
+/**
+ * Greedy reduction of the bitmask in a single warp; writes the surviving
+ * boxes straight into the compact core::Detection result block.
  */
-__global__ void nmsKernel(const Box* __restrict__ boxes,
-                          bool* __restrict__ suppressed,
-                          uint32_t numBoxes,
-                          float iouThreshold) {
-    const uint32_t idx = blockIdx.x * blockDim.x + threadIdx.x;
-    
-    if (idx >= numBoxes || suppressed[idx]) return;
-    
-    const Box& current = boxes[idx];
-    
-    // Check against all other boxes
-    for (uint32_t i = idx + 1; i < numBoxes; i++) {
-        if (suppressed[i]) continue;
-        
-        const Box& other = boxes[i];
-        
-        // Same class only
-        if (current.classId != other.classId) continue;
-        
-        // Calculate IoU
-        const float iou = calculateIoU(current, other);
-        
-        // Suppress if IoU exceeds threshold and confidence is lower
-        if (iou > iouThreshold && other.confidence < current.confidence) {
-            suppressed[i] = true;
+__global__ void reduceSuppressionKernel(const Box* __restrict__ sortedCandidates,
+                                        const uint32_t* __restrict__ candidateCount,
+                                        const uint64_t* __restrict__ mask,
+                                        DetectionResult* __restrict__ result) {
+    __shared__ uint64_t removed[MASK_WORDS];
+
+    const uint32_t tid = threadIdx.x;
+    const uint32_t count = min(*candidateCount, MAX_NMS_CANDIDATES);
+    const uint32_t numWords = (count + MASK_BLOCK_SIZE - 1) / MASK_BLOCK_SIZE;
+
+    if (tid < MASK_WORDS) removed[tid] = 0;
+    __syncwarp();
+
+    uint32_t kept = 0;
+    for (uint32_t row = 0; row < count && kept < MAX_DETECTIONS_PER_FRAME; row++) {
+        const uint32_t word = row / MASK_BLOCK_SIZE;
+        const bool isRemoved = (removed[word] >> (row % MASK_BLOCK_SIZE)) & 1ull;
+        __syncwarp();
+
+        if (!isRemoved) {
+            if (tid == 0) {
+                const Box& box = sortedCandidates[row];
+                core::Detection& det = result->detections[kept];
+                det.x = box.x;
+                det.y = box.y;
+                det.width = box.width;
+                det.height = box.height;
+                det.card_id = box.classId;
+                det.confidence = box.confidence;
+                det.timestamp_ns = 0;  // Stamped on the host after readback
+            }
+            if (tid >= word && tid < numWords) {
+                removed[tid] |= mask[row * MASK_WORDS + tid];
+            }
+            kept++;
         }
+        __syncwarp();
     }
+
+    if (tid == 0) {
+        result->count = kept;
+    }
+}
+
+bool allocateDecodeWorkspace(DecodeWorkspace& workspace) {
+    const size_t boxBytes = MAX_NMS_CANDIDATES * sizeof(Box);
+    const size_t maskBytes = static_cast<size_t>(MAX_NMS_CANDIDATES) * MASK_WORDS * sizeof(uint64_t);
+
+    auto& pool = utils::GpuMemoryPool::getInstance();
+    constexpr auto tag = utils::MemoryTag::Postprocess;
+    workspace.candidates = static_cast<Box*>(pool.allocate(boxBytes, tag));
+    workspace.sortedCandidates = static_cast<Box*>(pool.allocate(boxBytes, tag));
+    workspace.candidateCount = static_cast<uint32_t*>(pool.allocate(sizeof(uint32_t), tag));
+    workspace.selection = static_cast<CandidateSelection*>(pool.allocate(sizeof(CandidateSelection), tag));
+    workspace.suppressionMask = static_cast<uint64_t*>(pool.allocate(maskBytes, tag));
+    workspace.result = static_cast<DetectionResult*>(pool.allocate(sizeof(DetectionResult), tag));
+    if (!workspace.candidates || !workspace.sortedCandidates || !workspace.candidateCount ||
+        !workspace.selection || !workspace.suppressionMask || !workspace.result) {
+        freeDecodeWorkspace(workspace);
+        return false;
+    }
+
+    return true;
+}
+
+void freeDecodeWorkspace(DecodeWorkspace& workspace, cudaStream_t stream) {
+    auto& pool = utils::GpuMemoryPool::getInstance();
+    pool.release(workspace.candidates, stream);
+    pool.release(workspace.sortedCandidates, stream);
+    pool.release(workspace.candidateCount, stream);
+    pool.release(workspace.selection, stream);
+    pool.release(workspace.suppressionMask, stream);
+    pool.release(workspace.result, stream);
+    workspace = DecodeWorkspace{};
+}
+
+template<typename T>
+void launchDecode(const T* output,
+                  uint32_t numBlocks,
+                  uint32_t numPredictions,
+                  uint32_t predictionsPerImage,
+                  const LetterboxTransform* transforms,
+                  uint32_t numClasses,
+                  float confThreshold,
+                  DecodeWorkspace& workspace,
+                  cudaStream_t stream) {
+    decodeKernel<T, false><<<numBlocks, DECODE_BLOCK_SIZE, 0, stream>>>(
+        output, numPredictions, predictionsPerImage, transforms, numClasses, confThreshold,
+        workspace.selection, workspace.candidates, workspace.candidateCount);
+
+    selectCutoffKernel<<<1, WARP_SIZE, 0, stream>>>(workspace.candidateCount, workspace.selection);
+
+    decodeKernel<T, true><<<numBlocks, DECODE_BLOCK_SIZE, 0, stream>>>(
+        output, numPredictions, predictionsPerImage, transforms, numClasses, confThreshold,
+        workspace.selection, workspace.candidates, workspace.candidateCount);
+}
+
+cudaError_t decodeYOLOv11(const void* output,
+                          TensorPrecision precision,
+                          uint32_t numPredictions,
+                          uint32_t predictionsPerImage,
+                          const LetterboxTransform* transforms,
+                          uint32_t numClasses,
+                          float confThreshold,
+                          DecodeWorkspace& workspace,
+                          cudaStream_t stream) {
+    cudaError_t status = cudaMemsetAsync(workspace.candidateCount, 0, sizeof(uint32_t), stream);
+    if (status == cudaSuccess) {
+        status = cudaMemsetAsync(workspace.selection, 0, sizeof(CandidateSelection), stream);
+    }
+    if (status != cudaSuccess) return status;
+
+    if (numPredictions == 0 || predictionsPerImage == 0) return cudaSuccess;
+
+    constexpr uint32_t predictionsPerBlock = DECODE_BLOCK_SIZE / WARP_SIZE;
+    const uint32_t numBlocks = (numPredictions + predictionsPerBlock - 1) / predictionsPerBlock;
+
+    // Decode, pick the top-k cutoff on overflow, and re-decode above it; the
+    // refine grid exits at once when the first pass fit
+    if (precision == TensorPrecision::FP16) {
+        launchDecode<__half>(static_cast<const __half*>(output), numBlocks, numPredictions,
+                             predictionsPerImage, transforms, numClasses, confThreshold,
+                             workspace, stream);
+    } else {
+        launchDecode<float>(static_cast<const float*>(output), numBlocks, numPredictions,
+                            predictionsPerImage, transforms, numClasses, confThreshold,
+                            workspace, stream);
+    }
+
+    return cudaGetLastError();
+}
+
+cudaError_t suppressAndCompact(float iouThreshold,
+                               DecodeWorkspace& workspace,
+                               cudaStream_t stream) {
+    sortCandidatesKernel<<<1, MAX_NMS_CANDIDATES, 0, stream>>>(
+        workspace.candidates, workspace.candidateCount, workspace.sortedCandidates);
+
+    suppressionMaskKernel<<<dim3(MASK_WORDS, MASK_WORDS), MASK_BLOCK_SIZE, 0, stream>>>(
+        workspace.sortedCandidates, workspace.candidateCount, iouThreshold,
+        workspace.suppressionMask);
+
+    reduceSuppressionKernel<<<1, WARP_SIZE, 0, stream>>>(
+        workspace.sortedCandidates, workspace.candidateCount,
+        workspace.suppressionMask, workspace.result);
+
+    return cudaGetLastError();
 }
 
 } // namespace cuda
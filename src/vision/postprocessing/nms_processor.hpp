@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../../core/types.hpp"
+#include "../../core/constants.hpp"
+#include "../preprocessing/fused_preprocess.hpp"
+#include <cuda_runtime_api.h>
+#include <cstdint>
+
+namespace vision {
+namespace cuda {
+
+struct Box {
+    float x, y, width, height;
+    float confidence;
+    uint8_t classId;
+};
+
+// Compact result block copied back to the host in a single transfer
+struct DetectionResult {
+    uint32_t count;
+    core::Detection detections[core::constants::MAX_DETECTIONS_PER_FRAME];
+};
+
+struct CandidateSelection;  // Top-k scratch, private to nms_processor.cu
+
+// Device scratch buffers for decode + NMS (allocated once per engine)
+struct DecodeWorkspace {
+    Box* candidates{nullptr};        // [MAX_NMS_CANDIDATES], unsorted
+    Box* sortedCandidates{nullptr};  // [MAX_NMS_CANDIDATES], by confidence
+    uint32_t* candidateCount{nullptr};
+    CandidateSelection* selection{nullptr};
+    uint64_t* suppressionMask{nullptr};  // [MAX_NMS_CANDIDATES][MAX_NMS_CANDIDATES / 64]
+    DetectionResult* result{nullptr};
+};
+
+bool allocateDecodeWorkspace(DecodeWorkspace& workspace);
+// With a stream the buffers are freed in order on it (see GpuMemoryPool::release)
+void freeDecodeWorkspace(DecodeWorkspace& workspace, cudaStream_t stream = nullptr);
+
+/**
+ * Fused confidence filter + class argmax + stream compaction over the raw
+ * YOLOv11 output ([batch, N, 4 + numClasses], row-major). Surviving boxes
+ * are appended to workspace.candidates in corner format. With per-image
+ * transforms (device memory, one per batch item) boxes are mapped back to
+ * frame coordinates, so NMS runs across tiles in a common space. precision
+ * is the element type of output. When more than MAX_NMS_CANDIDATES boxes
+ * pass the filter, the most confident ones are kept.
+ */
+cudaError_t decodeYOLOv11(const void* output,
+                          TensorPrecision precision,
+                          uint32_t numPredictions,
+                          uint32_t predictionsPerImage,
+                          const LetterboxTransform* transforms,
+                          uint32_t numClasses,
+                          float confThreshold,
+                          DecodeWorkspace& workspace,
+                          cudaStream_t stream);
+
+/**
+ * Sort candidates by confidence, build the pairwise suppression bitmask and
+ * reduce it into workspace.result (at most MAX_DETECTIONS_PER_FRAME boxes).
+ * Suppression is class-agnostic, matching TensorRTEngine::performNMS.
+ */
+cudaError_t suppressAndCompact(float iouThreshold,
+                               DecodeWorkspace& workspace,
+                               cudaStream_t stream);
+
+} // namespace cuda
+} // namespace vision
@@ -0,0 +1,178 @@
+// CUDA Fused Preprocessing Kernel (letterbox + normalize + CHW)
+
+#include "fused_preprocess.hpp"
+#include <cuda_runtime.h>
+#include <cuda_fp16.h>
+#include <device_launch_parameters.h>
+
+namespace vision {
+namespace cuda {
+
+constexpr float INV_255 = 0.00392156862745098f;  // 1/255
+constexpr float PAD_VALUE = 114.0f * INV_255;    // YOLO letterbox gray
+
+__device__ __forceinline__ void storeValue(float* out, size_t idx, float value) {
+    out[idx] = value;
+}
+
+__device__ __forceinline__ void storeValue(__half* out, size_t idx, float value) {
+    out[idx] = __float2half_rn(value);
+}
+
+__device__ __forceinline__ const uchar4& texel(const uint8_t* __restrict__ source,
+                                              size_t pitch, uint32_t x, uint32_t y) {
+    return reinterpret_cast<const uchar4*>(source + y * pitch)[x];
+}
+
+/**
+ * One output pixel: reads the four BGRA neighbours once and writes the
+ * three normalized planes; consecutive threads write consecutive
+ * addresses within each plane.
+ */
+template<typename T>
+__device__ __forceinline__ void letterboxPixel(uint32_t x, uint32_t y,
+                                               const uint8_t* __restrict__ source,
+                                               size_t sourcePitch,
+                                               uint32_t roiX, uint32_t roiY,
+                                               uint32_t roiWidth, uint32_t roiHeight,
+                                               T* __restrict__ output,
+                                               uint32_t outputWidth, uint32_t outputHeight,
+                                               const LetterboxTransform& transform) {
+    const size_t planeSize = static_cast<size_t>(outputWidth) * outputHeight;
+    const size_t idx = static_cast<size_t>(y) * outputWidth + x;
+
+    const float activeWidth = roiWidth * transform.scale;
+    const float activeHeight = roiHeight * transform.scale;
+    const float mx = x - transform.padX;
+    const float my = y - transform.padY;
+
+    if (mx < 0.0f || my < 0.0f || mx >= activeWidth || my >= activeHeight) {
+        storeValue(output, idx, PAD_VALUE);
+        storeValue(output, idx + planeSize, PAD_VALUE);
+        storeValue(output, idx + 2 * planeSize, PAD_VALUE);
+        return;
+    }
+
+    // Pixel-center mapping into ROI space
+    const float invScale = 1.0f / transform.scale;
+    const float u = fminf(fmaxf((mx + 0.5f) * invScale - 0.5f, 0.0f), roiWidth - 1.0f);
+    const float v = fminf(fmaxf((my + 0.5f) * invScale - 0.5f, 0.0f), roiHeight - 1.0f);
+
+    const uint32_t x0 = static_cast<uint32_t>(u);
+    const uint32_t y0 = static_cast<uint32_t>(v);
+    const uint32_t x1 = min(x0 + 1, roiWidth - 1);
+    const uint32_t y1 = min(y0 + 1, roiHeight - 1);
+    const float fx = u - x0;
+    const float fy = v - y0;
+
+    const uchar4 p00 = texel(source, sourcePitch, roiX + x0, roiY + y0);
+    const uchar4 p01 = texel(source, sourcePitch, roiX + x1, roiY + y0);
+    const uchar4 p10 = texel(source, sourcePitch, roiX + x0, roiY + y1);
+    const uchar4 p11 = texel(source, sourcePitch, roiX + x1, roiY + y1);
+
+    const float w00 = (1.0f - fx) * (1.0f - fy);
+    const float w01 = fx * (1.0f - fy);
+    const float w10 = (1.0f - fx) * fy;
+    const float w11 = fx * fy;
+
+    // BGRA in, RGB planes out
+    const float r = (p00.z * w00 + p01.z * w01 + p10.z * w10 + p11.z * w11) * INV_255;
+    const float g = (p00.y * w00 + p01.y * w01 + p10.y * w10 + p11.y * w11) * INV_255;
+    const float b = (p00.x * w00 + p01.x * w01 + p10.x * w10 + p11.x * w11) * INV_255;
+
+    storeValue(output, idx, r);
+    storeValue(output, idx + planeSize, g);
+    storeValue(output, idx + 2 * planeSize, b);
+}
+
+template<typename T>
+__global__ void letterboxKernel(const uint8_t* __restrict__ source,
+                                size_t sourcePitch,
+                                uint32_t roiX, uint32_t roiY,
+                                uint32_t roiWidth, uint32_t roiHeight,
+                                T* __restrict__ output,
+                                uint32_t outputWidth, uint32_t outputHeight,
+                                LetterboxTransform transform) {
+    const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+    const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (x >= outputWidth || y >= outputHeight) return;
+
+    letterboxPixel(x, y, source, sourcePitch, roiX, roiY, roiWidth, roiHeight,
+                   output, outputWidth, outputHeight, transform);
+}
+
+/**
+ * Same as letterboxKernel with the frame-dependent arguments read from
+ * device memory, so a captured graph node stays valid across frames.
+ */
+template<typename T>
+__global__ void letterboxIndirectKernel(const LetterboxLaunch* __restrict__ launch,
+                                        T* __restrict__ output,
+                                        uint32_t outputWidth, uint32_t outputHeight) {
+    const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+    const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (x >= outputWidth || y >= outputHeight) return;
+
+    const LetterboxLaunch args = *launch;
+    letterboxPixel(x, y, args.source, args.sourcePitch,
+                   args.roiX, args.roiY, args.roiWidth, args.roiHeight,
+                   output, outputWidth, outputHeight, args.transform);
+}
+
+cudaError_t letterboxBGRAToCHW(const LetterboxParams& params,
+                               const LetterboxTransform& transform,
+                               cudaStream_t stream) {
+    if (!params.source || !params.output || params.roiWidth == 0 || params.roiHeight == 0) {
+        return cudaErrorInvalidValue;
+    }
+
+    const dim3 block(32, 8);
+    const dim3 grid((params.outputWidth + block.x - 1) / block.x,
+                    (params.outputHeight + block.y - 1) / block.y);
+
+    if (params.precision == TensorPrecision::FP16) {
+        letterboxKernel<__half><<<grid, block, 0, stream>>>(
+            params.source, params.sourcePitch,
+            params.roiX, params.roiY, params.roiWidth, params.roiHeight,
+            static_cast<__half*>(params.output), params.outputWidth, params.outputHeight,
+            transform);
+    } else {
+        letterboxKernel<float><<<grid, block, 0, stream>>>(
+            params.source, params.sourcePitch,
+            params.roiX, params.roiY, params.roiWidth, params.roiHeight,
+            static_cast<float*>(params.output), params.outputWidth, params.outputHeight,
+            transform);
+    }
+
+    return cudaGetLastError();
+}
+
+cudaError_t letterboxBGRAToCHWIndirect(const LetterboxLaunch* deviceLaunch,
+                                       void* output,
+                                       uint32_t outputWidth,
+                                       uint32_t outputHeight,
+                                       TensorPrecision precision,
+                                       cudaStream_t stream) {
+    if (!deviceLaunch || !output) {
+        return cudaErrorInvalidValue;
+    }
+
+    const dim3 block(32, 8);
+    const dim3 grid((outputWidth + block.x - 1) / block.x,
+                    (outputHeight + block.y - 1) / block.y);
+
+    if (precision == TensorPrecision::FP16) {
+        letterboxIndirectKernel<__half><<<grid, block, 0, stream>>>(
+            deviceLaunch, static_cast<__half*>(output), outputWidth, outputHeight);
+    } else {
+        letterboxIndirectKernel<float><<<grid, block, 0, stream>>>(
+            deviceLaunch, static_cast<float*>(output), outputWidth, outputHeight);
+    }
+
+    return cudaGetLastError();
+}
+
+} // namespace cuda
+} // namespace vision
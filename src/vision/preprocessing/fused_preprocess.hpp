@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cuda_runtime_api.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace vision {
+namespace cuda {
+
+enum class TensorPrecision : uint8_t {
+    FP32,
+    FP16
+};
+
+// Bytes per tensor element
+inline size_t elementSize(TensorPrecision precision) {
+    return precision == TensorPrecision::FP16 ? 2 : sizeof(float);
+}
+
+// Maps model-input coordinates back to source-frame coordinates:
+//   source = (model - pad) / scale + offset
+struct LetterboxTransform {
+    float scale{1.0f};
+    float padX{0.0f}, padY{0.0f};
+    float offsetX{0.0f}, offsetY{0.0f};
+};
+
+struct LetterboxParams {
+    // Source BGRA8 surface (device, pitched)
+    const uint8_t* source{nullptr};
+    size_t sourcePitch{0};
+
+    // Region of the source to sample (full frame when no ROI is set)
+    uint32_t roiX{0}, roiY{0};
+    uint32_t roiWidth{0}, roiHeight{0};
+
+    // Planar RGB CHW destination (device)
+    void* output{nullptr};
+    uint32_t outputWidth{0}, outputHeight{0};
+    TensorPrecision precision{TensorPrecision::FP32};
+};
+
+// Aspect-preserving fit of the ROI into the output, centered with padding
+inline LetterboxTransform computeLetterbox(const LetterboxParams& params) {
+    LetterboxTransform transform;
+    if (params.roiWidth == 0 || params.roiHeight == 0) return transform;
+
+    transform.scale = std::min(static_cast<float>(params.outputWidth) / params.roiWidth,
+                               static_cast<float>(params.outputHeight) / params.roiHeight);
+    transform.padX = static_cast<float>(static_cast<uint32_t>(
+        (params.outputWidth - params.roiWidth * transform.scale) * 0.5f));
+    transform.padY = static_cast<float>(static_cast<uint32_t>(
+        (params.outputHeight - params.roiHeight * transform.scale) * 0.5f));
+    transform.offsetX = static_cast<float>(params.roiX);
+    transform.offsetY = static_cast<float>(params.roiY);
+    return transform;
+}
+
+/**
+ * Single-pass BGRA -> RGB, bilinear letterbox resize, [0, 1] normalization
+ * and HWC -> CHW reorder written straight into the network input tensor.
+ */
+cudaError_t letterboxBGRAToCHW(const LetterboxParams& params,
+                               const LetterboxTransform& transform,
+                               cudaStream_t stream);
+
+// Frame-dependent letterbox arguments, read by the kernel from device memory
+struct LetterboxLaunch {
+    const uint8_t* source{nullptr};
+    size_t sourcePitch{0};
+    uint32_t roiX{0}, roiY{0};
+    uint32_t roiWidth{0}, roiHeight{0};
+    LetterboxTransform transform{};
+};
+
+/**
+ * Graph-friendly variant: the launch is identical for every frame, the
+ * source, ROI and transform come from deviceLaunch, which is refreshed by
+ * a memcpy node ahead of it.
+ */
+cudaError_t letterboxBGRAToCHWIndirect(const LetterboxLaunch* deviceLaunch,
+                                       void* output,
+                                       uint32_t outputWidth,
+                                       uint32_t outputHeight,
+                                       TensorPrecision precision,
+                                       cudaStream_t stream);
+
+} // namespace cuda
+} // namespace vision
@@ -0,0 +1,152 @@
+#include "motion_gate.hpp"
+#include "../../utils/gpu_memory_pool.hpp"
+#include "../../utils/logger.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace vision {
+
+MotionGate::MotionGate() {
+}
+
+MotionGate::~MotionGate() {
+    release();
+}
+
+bool MotionGate::initialize(float threshold, uint32_t minChangedCells, uint32_t reverifyInterval,
+                            uint32_t cellDelta) {
+    auto& logger = utils::Logger::getInstance();
+
+    configure(threshold, minChangedCells, reverifyInterval, cellDelta);
+
+    auto& pool = utils::GpuMemoryPool::getInstance();
+    constexpr auto tag = utils::MemoryTag::Preprocess;
+    m_reference = static_cast<uint8_t*>(pool.allocate(cuda::MOTION_CELLS, tag));
+    m_current = static_cast<uint8_t*>(pool.allocate(cuda::MOTION_CELLS, tag));
+    m_deviceResult = static_cast<cuda::MotionResult*>(pool.allocate(sizeof(cuda::MotionResult), tag));
+    m_hostResult = static_cast<cuda::MotionResult*>(pool.allocateHost(sizeof(cuda::MotionResult), tag));
+    if (!m_reference || !m_current || !m_deviceResult || !m_hostResult) {
+        logger.error("Failed to allocate motion gate buffers");
+        release();
+        return false;
+    }
+
+    cudaError_t status = cudaEventCreateWithFlags(&m_resultEvent, cudaEventDisableTiming);
+    if (status != cudaSuccess) {
+        logger.error("Failed to create motion gate event: {}", cudaGetErrorString(status));
+        release();
+        return false;
+    }
+
+    logger.info("Motion gate: threshold {}, {} changed cells of delta {}, reverify every {} frames",
+                m_threshold, m_minChangedCells, m_cellDelta, m_reverifyInterval);
+    return true;
+}
+
+void MotionGate::configure(float threshold, uint32_t minChangedCells, uint32_t reverifyInterval,
+                           uint32_t cellDelta) {
+    m_threshold = threshold;
+    m_minChangedCells = minChangedCells;
+    m_reverifyInterval = reverifyInterval;
+    m_cellDelta = static_cast<uint8_t>(std::min<uint32_t>(cellDelta, 255));
+}
+
+MotionDecision MotionGate::evaluate(const capture::Frame& frame,
+                                    cudaStream_t stream,
+                                    const capture::ROI* roi) {
+    m_framesEvaluated.fetch_add(1, std::memory_order_relaxed);
+
+    // Host frames take the Preprocessor upload path, the gate only reads device memory
+    if (frame.memory != capture::FrameMemory::Device) {
+        return MotionDecision::Infer;
+    }
+
+    capture::ROI region = roi ? *roi : capture::ROI{0, 0, frame.width, frame.height};
+    if (region.width == 0 || region.height == 0) {
+        region = {0, 0, frame.width, frame.height};
+    }
+
+    // A moved ROI invalidates the reference thumbnail
+    if (region.x != m_lastRoi.x || region.y != m_lastRoi.y ||
+        region.width != m_lastRoi.width || region.height != m_lastRoi.height) {
+        m_hasReference = false;
+        m_lastRoi = region;
+    }
+
+    if (frame.ready_event) {
+        cudaStreamWaitEvent(stream, frame.ready_event, 0);
+    }
+
+    cuda::MotionParams params;
+    params.source = frame.data;
+    params.sourcePitch = frame.stride;
+    params.roiX = region.x;
+    params.roiY = region.y;
+    params.roiWidth = region.width;
+    params.roiHeight = region.height;
+    params.reference = m_reference;
+    params.current = m_current;
+    params.result = m_deviceResult;
+    params.cellDelta = m_cellDelta;
+
+    cudaError_t status = cuda::computeMotion(params, stream);
+    if (status == cudaSuccess) {
+        status = cudaMemcpyAsync(m_hostResult, m_deviceResult, sizeof(cuda::MotionResult),
+                                 cudaMemcpyDeviceToHost, stream);
+    }
+    if (status == cudaSuccess) {
+        cudaEventRecord(m_resultEvent, stream);
+        status = cudaEventSynchronize(m_resultEvent);  // Tiny kernel, a few microseconds
+    }
+
+    if (status != cudaSuccess) {
+        utils::Logger::getInstance().error("Motion gate failed: {}", cudaGetErrorString(status));
+        m_hasReference = false;
+        return MotionDecision::Infer;
+    }
+
+    m_lastScore = m_hostResult->sadSum / (255.0f * cuda::MOTION_CELLS);
+    const bool moved = !m_hasReference ||
+                       m_lastScore > m_threshold ||
+                       m_hostResult->changedCells >= m_minChangedCells;
+
+    MotionDecision decision;
+    if (moved) {
+        decision = MotionDecision::Infer;
+    } else if (++m_framesSinceInference >= m_reverifyInterval) {
+        decision = MotionDecision::Reverify;
+        m_framesReverified.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_framesReused.fetch_add(1, std::memory_order_relaxed);
+        return MotionDecision::Reuse;
+    }
+
+    // This frame gets inferred and becomes the new reference
+    std::swap(m_reference, m_current);
+    m_hasReference = true;
+    m_framesSinceInference = 0;
+    return decision;
+}
+
+float MotionGate::getSkipRate() const {
+    const uint64_t evaluated = getFramesEvaluated();
+    return evaluated > 0 ? static_cast<float>(getFramesReused()) / evaluated : 0.0f;
+}
+
+void MotionGate::release() {
+    auto& pool = utils::GpuMemoryPool::getInstance();
+    pool.release(m_reference);
+    pool.release(m_current);
+    pool.release(m_deviceResult);
+    pool.releaseHost(m_hostResult);
+    m_reference = nullptr;
+    m_current = nullptr;
+    m_deviceResult = nullptr;
+    m_hostResult = nullptr;
+    if (m_resultEvent) {
+        cudaEventDestroy(m_resultEvent);
+        m_resultEvent = nullptr;
+    }
+}
+
+} // namespace vision
@@ -0,0 +1,88 @@
+// CUDA Motion Gate Kernel (downsampled luma SAD)
+
+#include "motion_gate.hpp"
+#include <cuda_runtime.h>
+#include <device_launch_parameters.h>
+
+namespace vision {
+namespace cuda {
+
+constexpr uint32_t SAMPLES_PER_AXIS = 16;  // 16x16 samples per cell, one per thread
+constexpr uint32_t CELL_THREADS = SAMPLES_PER_AXIS * SAMPLES_PER_AXIS;
+
+/**
+ * One block per grid cell. Each thread samples one BGRA pixel of the cell,
+ * the block reduces them to the cell's mean luma (BT.709 weights) and
+ * thread 0 folds the delta against the reference into the frame totals.
+ */
+__global__ void motionKernel(const uint8_t* __restrict__ source,
+                             size_t sourcePitch,
+                             uint32_t roiX, uint32_t roiY,
+                             float cellWidth, float cellHeight,
+                             const uint8_t* __restrict__ reference,
+                             uint8_t* __restrict__ current,
+                             MotionResult* __restrict__ result,
+                             uint32_t cellDelta) {
+    __shared__ uint32_t warpSums[CELL_THREADS / 32];
+
+    const uint32_t cellX = blockIdx.x;
+    const uint32_t cellY = blockIdx.y;
+    const uint32_t sx = threadIdx.x % SAMPLES_PER_AXIS;
+    const uint32_t sy = threadIdx.x / SAMPLES_PER_AXIS;
+
+    const uint32_t x = roiX + static_cast<uint32_t>((cellX + (sx + 0.5f) / SAMPLES_PER_AXIS) * cellWidth);
+    const uint32_t y = roiY + static_cast<uint32_t>((cellY + (sy + 0.5f) / SAMPLES_PER_AXIS) * cellHeight);
+
+    const uchar4 pixel = reinterpret_cast<const uchar4*>(source + y * sourcePitch)[x];
+    uint32_t luma = (54u * pixel.z + 183u * pixel.y + 19u * pixel.x) >> 8;
+
+    for (int offset = 16; offset > 0; offset >>= 1) {
+        luma += __shfl_down_sync(0xffffffff, luma, offset);
+    }
+    if ((threadIdx.x & 31) == 0) {
+        warpSums[threadIdx.x >> 5] = luma;
+    }
+    __syncthreads();
+
+    if (threadIdx.x == 0) {
+        uint32_t total = 0;
+        for (uint32_t w = 0; w < CELL_THREADS / 32; w++) {
+            total += warpSums[w];
+        }
+
+        const uint32_t cell = cellY * MOTION_GRID_WIDTH + cellX;
+        const uint32_t mean = total / CELL_THREADS;
+        const uint32_t previous = reference[cell];
+        const uint32_t delta = mean > previous ? mean - previous : previous - mean;
+
+        current[cell] = static_cast<uint8_t>(mean);
+        atomicAdd(&result->sadSum, delta);
+        if (delta > cellDelta) {
+            atomicAdd(&result->changedCells, 1u);
+        }
+    }
+}
+
+cudaError_t computeMotion(const MotionParams& params, cudaStream_t stream) {
+    if (!params.source || !params.reference || !params.current || !params.result ||
+        params.roiWidth == 0 || params.roiHeight == 0) {
+        return cudaErrorInvalidValue;
+    }
+
+    cudaError_t status = cudaMemsetAsync(params.result, 0, sizeof(MotionResult), stream);
+    if (status != cudaSuccess) return status;
+
+    const float cellWidth = static_cast<float>(params.roiWidth) / MOTION_GRID_WIDTH;
+    const float cellHeight = static_cast<float>(params.roiHeight) / MOTION_GRID_HEIGHT;
+
+    const dim3 grid(MOTION_GRID_WIDTH, MOTION_GRID_HEIGHT);
+    motionKernel<<<grid, CELL_THREADS, 0, stream>>>(
+        params.source, params.sourcePitch, params.roiX, params.roiY,
+        cellWidth, cellHeight, params.reference, params.current,
+        params.result, params.cellDelta);
+
+    return cudaGetLastError();
+}
+
+} // namespace cuda
+} // namespace vision
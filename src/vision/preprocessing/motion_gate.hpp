@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../../capture/capture_interface.hpp"
+#include "../../capture/roi_detector.hpp"
+#include <cuda_runtime_api.h>
+#include <atomic>
+#include <cstdint>
+
+namespace vision {
+namespace cuda {
+
+// Downsampled luma grid the gate compares frames on
+constexpr uint32_t MOTION_GRID_WIDTH = 64;
+constexpr uint32_t MOTION_GRID_HEIGHT = 36;
+constexpr uint32_t MOTION_CELLS = MOTION_GRID_WIDTH * MOTION_GRID_HEIGHT;
+
+struct MotionResult {
+    uint32_t sadSum;        // Sum of per-cell |luma delta| (0-255 scale)
+    uint32_t changedCells;  // Cells whose delta exceeds cellDelta
+};
+
+struct MotionParams {
+    // Source BGRA8 surface (device, pitched) and the region to watch
+    const uint8_t* source{nullptr};
+    size_t sourcePitch{0};
+    uint32_t roiX{0}, roiY{0};
+    uint32_t roiWidth{0}, roiHeight{0};
+
+    const uint8_t* reference{nullptr};  // [MOTION_CELLS] luma of the last inferred frame
+    uint8_t* current{nullptr};          // [MOTION_CELLS] luma of this frame
+    MotionResult* result{nullptr};      // Device, zeroed by the launcher
+    uint8_t cellDelta{10};
+};
+
+/**
+ * Averages a subsampled patch of every grid cell into a luma thumbnail and
+ * accumulates the SAD against the reference thumbnail.
+ */
+cudaError_t computeMotion(const MotionParams& params, cudaStream_t stream);
+
+} // namespace cuda
+
+enum class MotionDecision : uint8_t {
+    Infer,     // Scene changed: run the detector
+    Reuse,     // Static: keep the previous detections
+    Reverify   // Static for too long: run the detector anyway to catch slow drift
+};
+
+// Frame-difference gate in front of inference. Frames are compared with the
+// last frame that was actually inferred, so gradual change still accumulates
+// past the threshold.
+class MotionGate {
+public:
+    MotionGate();
+    ~MotionGate();
+
+    // threshold: mean luma change (0-1) that counts as motion.
+    // minChangedCells: local change (e.g. one card placed) that counts as motion.
+    // cellDelta: luma change (0-255) that marks a single grid cell as changed.
+    bool initialize(float threshold, uint32_t minChangedCells, uint32_t reverifyInterval,
+                    uint32_t cellDelta);
+
+    // New thresholds from the next evaluate() on; call from the evaluating thread
+    void configure(float threshold, uint32_t minChangedCells, uint32_t reverifyInterval,
+                   uint32_t cellDelta);
+
+    // Waits on the frame's ready fence on stream; blocks until the score is back
+    MotionDecision evaluate(const capture::Frame& frame,
+                            cudaStream_t stream,
+                            const capture::ROI* roi = nullptr);
+
+    // Forget the reference, the next frame is always inferred
+    void reset() { m_hasReference = false; }
+
+    float getLastScore() const { return m_lastScore; }
+    uint64_t getFramesEvaluated() const { return m_framesEvaluated.load(std::memory_order_relaxed); }
+    uint64_t getFramesReused() const { return m_framesReused.load(std::memory_order_relaxed); }
+    uint64_t getFramesReverified() const { return m_framesReverified.load(std::memory_order_relaxed); }
+    float getSkipRate() const;
+
+private:
+    void release();
+
+    float m_threshold{0.015f};
+    uint32_t m_minChangedCells{4};
+    uint32_t m_reverifyInterval{30};
+    uint8_t m_cellDelta{10};
+
+    // Device thumbnails, swapped when a frame becomes the new reference
+    uint8_t* m_reference{nullptr};
+    uint8_t* m_current{nullptr};
+    cuda::MotionResult* m_deviceResult{nullptr};
+    cuda::MotionResult* m_hostResult{nullptr};  // Pinned
+    cudaEvent_t m_resultEvent{nullptr};
+
+    bool m_hasReference{false};
+    capture::ROI m_lastRoi{};
+    uint32_t m_framesSinceInference{0};
+    float m_lastScore{0.0f};
+
+    // Skip-rate counters
+    std::atomic<uint64_t> m_framesEvaluated{0};
+    std::atomic<uint64_t> m_framesReused{0};
+    std::atomic<uint64_t> m_framesReverified{0};
+};
+
+} // namespace vision
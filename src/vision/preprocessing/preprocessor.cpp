@@ -1,5 +1,7 @@
 #include "preprocessor.hpp"
+#include "../../utils/gpu_memory_pool.hpp"
 #include "../../utils/logger.hpp"
+#include <algorithm>
 
 namespace vision {
 
@@ -8,18 +10,23 @@ Preprocessor::Preprocessor() {
 
 Preprocessor::~Preprocessor() {
     // Free CUDA resources
+    utils::GpuMemoryPool::getInstance().release(m_uploadBuffer);
 }
 
-bool Preprocessor::initialize(uint32_t inputWidth, uint32_t inputHeight) {
+bool Preprocessor::initialize(uint32_t inputWidth, uint32_t inputHeight,
+                              cuda::TensorPrecision precision) {
     auto& logger = utils::Logger::getInstance();
     
     m_inputWidth = inputWidth;
     m_inputHeight = inputHeight;
+    m_precision = precision;
     
-    // Allocate CUDA workspace
-    m_workspaceSize = inputWidth * inputHeight * 3 * sizeof(float);
+    // Output tensor size (written in place, no intermediate workspace)
+    const size_t elementSize = cuda::elementSize(precision);
+    m_workspaceSize = static_cast<size_t>(inputWidth) * inputHeight * 3 * elementSize;
     
-    logger.info("Preprocessor initialized: {}x{}", inputWidth, inputHeight);
+    logger.info("Preprocessor initialized: {}x{} ({})", inputWidth, inputHeight,
+                precision == cuda::TensorPrecision::FP16 ? "FP16" : "FP32");
     return true;
 }
 
@@ -27,15 +34,114 @@ bool Preprocessor::process(const uint8_t* inputFrame,
                            uint32_t width, 
                            uint32_t height,
                            float* outputTensor) {
-    // TODO: Implement preprocessing pipeline
-    // 1. Color space conversion (RGB to YUV)
-    // 2. Resize to model input size
-    // 3. Normalize to [0, 1]
-    // 4. Histogram equalization if needed
-    
+    // Host BGRA frame -> device tensor on the default stream
+    capture::Frame frame{};
+    frame.data = const_cast<uint8_t*>(inputFrame);
+    frame.width = width;
+    frame.height = height;
+    frame.stride = width * 4;
+    frame.memory = capture::FrameMemory::Host;
+
+    return process(frame, outputTensor, nullptr);
+}
+
+bool Preprocessor::process(const capture::Frame& frame,
+                           void* deviceOutputTensor,
+                           cudaStream_t stream,
+                           const capture::ROI* roi) {
+    cuda::LetterboxParams params;
+    if (!prepare(frame, stream, roi, deviceOutputTensor, params)) {
+        return false;
+    }
+
+    cudaError_t status = cuda::letterboxBGRAToCHW(params, m_lastTransform, stream);
+    if (status != cudaSuccess) {
+        utils::Logger::getInstance().error("Preprocessing kernel failed: {}",
+                                           cudaGetErrorString(status));
+        return false;
+    }
+
+    return true;
+}
+
+bool Preprocessor::prepare(const capture::Frame& frame,
+                           cudaStream_t stream,
+                           const capture::ROI* roi,
+                           void* deviceOutputTensor,
+                           cuda::LetterboxParams& params) {
+    size_t pitch = 0;
+    const uint8_t* source = resolveDeviceSource(frame, stream, pitch);
+    if (!source) {
+        return false;
+    }
+
+    params = cuda::LetterboxParams{};
+    params.source = source;
+    params.sourcePitch = pitch;
+    params.output = deviceOutputTensor;
+    params.outputWidth = m_inputWidth;
+    params.outputHeight = m_inputHeight;
+    params.precision = m_precision;
+
+    // Clamp the ROI to the frame; fall back to the full frame if it is empty
+    if (roi && roi->width > 0 && roi->height > 0 &&
+        roi->x < frame.width && roi->y < frame.height) {
+        params.roiX = roi->x;
+        params.roiY = roi->y;
+        params.roiWidth = std::min(roi->width, frame.width - roi->x);
+        params.roiHeight = std::min(roi->height, frame.height - roi->y);
+    } else {
+        params.roiWidth = frame.width;
+        params.roiHeight = frame.height;
+    }
+
+    m_lastTransform = cuda::computeLetterbox(params);
     return true;
 }
 
+const uint8_t* Preprocessor::resolveDeviceSource(const capture::Frame& frame,
+                                                 cudaStream_t stream,
+                                                 size_t& pitch) {
+    if (frame.memory == capture::FrameMemory::Device) {
+        // Order against the capture copy without a host sync
+        if (frame.ready_event) {
+            cudaStreamWaitEvent(stream, frame.ready_event, 0);
+        }
+        pitch = frame.stride;
+        return frame.data;
+    }
+
+    auto& logger = utils::Logger::getInstance();
+
+    if (!m_uploadBuffer || m_uploadWidth != frame.width || m_uploadHeight != frame.height) {
+        // Freed behind the work still reading it: uploads run on one stream
+        auto& pool = utils::GpuMemoryPool::getInstance();
+        pool.release(m_uploadBuffer, stream);
+
+        m_uploadBuffer = static_cast<uint8_t*>(pool.allocatePitch(static_cast<size_t>(frame.width) * 4,
+                                                                  frame.height, m_uploadPitch,
+                                                                  utils::MemoryTag::Preprocess));
+        if (!m_uploadBuffer) {
+            logger.error("Failed to allocate upload buffer");
+            return nullptr;
+        }
+        m_uploadWidth = frame.width;
+        m_uploadHeight = frame.height;
+    }
+
+    cudaError_t status = cudaMemcpy2DAsync(m_uploadBuffer, m_uploadPitch,
+                                           frame.data, frame.stride,
+                                           static_cast<size_t>(frame.width) * 4, frame.height,
+                                           cudaMemcpyHostToDevice, stream);
+    if (status != cudaSuccess) {
+        logger.error("Failed to upload frame: {}", cudaGetErrorString(status));
+        return nullptr;
+    }
+
+    pitch = m_uploadPitch;
+    return m_uploadBuffer;
+}
+
 void Preprocessor::convertColorSpace(const uint8_t* input, uint8_t* output) {
     // TODO: CUDA kernel for color conversion
 }
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "../../core/types.hpp"
+#include "../../capture/capture_interface.hpp"
+#include "../../capture/roi_detector.hpp"
+#include "fused_preprocess.hpp"
+#include <cuda_runtime_api.h>
 #include <vector>
 #include <memory>
 
@@ -11,13 +15,37 @@ public:
     Preprocessor();
     ~Preprocessor();
 
-    bool initialize(uint32_t inputWidth, uint32_t inputHeight);
+    bool initialize(uint32_t inputWidth, uint32_t inputHeight,
+                    cuda::TensorPrecision precision = cuda::TensorPrecision::FP32);
     
     // Process frame and prepare for inference
     bool process(const uint8_t* inputFrame, 
                  uint32_t width, 
                  uint32_t height,
                  float* outputTensor);
+
+    // Process a captured frame; device-resident frames are consumed in place.
+    // Writes planar CHW (FP32 or FP16) straight into the network input buffer,
+    // optionally cropped to an ROI first.
+    bool process(const capture::Frame& frame,
+                 void* deviceOutputTensor,
+                 cudaStream_t stream,
+                 const capture::ROI* roi = nullptr);
+
+    // Resolve the device source and ROI without launching anything, for
+    // callers that run the letterbox kernel themselves (engine CUDA graph).
+    // Device frames get a wait on their ready fence on stream.
+    bool prepare(const capture::Frame& frame,
+                 cudaStream_t stream,
+                 const capture::ROI* roi,
+                 void* deviceOutputTensor,
+                 cuda::LetterboxParams& params);
+
+    // Model -> frame coordinate mapping of the last processed frame
+    const cuda::LetterboxTransform& getLastTransform() const { return m_lastTransform; }
+    cuda::TensorPrecision getPrecision() const { return m_precision; }
+    uint32_t getInputWidth() const { return m_inputWidth; }    // Network input written
+    uint32_t getInputHeight() const { return m_inputHeight; }
     
     // GPU-accelerated operations
     void convertColorSpace(const uint8_t* input, uint8_t* output);
@@ -27,10 +55,21 @@ public:
 private:
     uint32_t m_inputWidth{0};
     uint32_t m_inputHeight{0};
+    cuda::TensorPrecision m_precision{cuda::TensorPrecision::FP32};
+    cuda::LetterboxTransform m_lastTransform{};
     
     // CUDA resources
     void* m_cudaWorkspace{nullptr};
     size_t m_workspaceSize{0};
+
+    // Device copy of host-resident frames (staging capture, replay)
+    const uint8_t* resolveDeviceSource(const capture::Frame& frame,
+                                       cudaStream_t stream,
+                                       size_t& pitch);
+    uint8_t* m_uploadBuffer{nullptr};
+    size_t m_uploadPitch{0};
+    uint32_t m_uploadWidth{0};
+    uint32_t m_uploadHeight{0};
 };
 
 } // namespace vision
@@ -0,0 +1,72 @@
+#include "test_check.hpp"
+#include "intelligence/strategy/basic_strategy.hpp"
+
+using intelligence::Action;
+using intelligence::BasicStrategy;
+using core::CardRank;
+
+namespace {
+
+Action play(const BasicStrategy& strategy, uint32_t total, CardRank upcard, float trueCount,
+            bool canSurrender) {
+    return strategy.getPlay(total, upcard, trueCount, false, true, false, canSurrender);
+}
+
+// 16vT and 16v9 surrender at every count when offered; their stand indices
+// only apply without surrender
+void surrenderOutranksIndexPlays() {
+    for (const char* rules : {"s17_das_ls", "h17_das_ls"}) {
+        BasicStrategy strategy;
+        strategy.initialize(rules);
+        strategy.setDeviationSets(true, true);
+
+        for (float trueCount : {-3.0f, 0.0f, 2.0f, 5.0f, 8.0f}) {
+            CHECK(play(strategy, 16, CardRank::Ten, trueCount, true) == Action::Surrender);
+            CHECK(play(strategy, 16, CardRank::Nine, trueCount, true) == Action::Surrender);
+        }
+        CHECK(play(strategy, 16, CardRank::Ten, 0.0f, false) == Action::Stand);
+        CHECK(play(strategy, 16, CardRank::Ten, -1.0f, false) == Action::Hit);
+        CHECK(play(strategy, 16, CardRank::Nine, 5.0f, false) == Action::Stand);
+        CHECK(play(strategy, 16, CardRank::Nine, 4.0f, false) == Action::Hit);
+    }
+}
+
+// 15vT: Fab 4 surrenders from 0 and hits below it, ahead of the +4 stand;
+// 15vA likewise from +1, though the H17 chart surrenders it
+void fab4SurrenderBeforeStand() {
+    BasicStrategy strategy;
+    strategy.initialize("s17_das_ls");
+    strategy.setDeviationSets(true, true);
+
+    CHECK(play(strategy, 15, CardRank::Ten, 5.0f, true) == Action::Surrender);
+    CHECK(play(strategy, 15, CardRank::Ten, -1.0f, true) == Action::Hit);
+    CHECK(play(strategy, 15, CardRank::Ten, 5.0f, false) == Action::Stand);
+
+    BasicStrategy h17;
+    h17.initialize("h17_das_ls");
+    h17.setDeviationSets(true, true);
+    CHECK(play(h17, 15, CardRank::Ace, 1.0f, true) == Action::Surrender);
+    CHECK(play(h17, 15, CardRank::Ace, 0.0f, true) == Action::Hit);
+}
+
+// 11vA below +1: hit under S17, double (basic) under H17
+void elevenVersusAce() {
+    BasicStrategy s17;
+    s17.initialize("s17_das");
+    CHECK(play(s17, 11, CardRank::Ace, 0.0f, false) == Action::Hit);
+    CHECK(play(s17, 11, CardRank::Ace, 1.0f, false) == Action::Double);
+
+    BasicStrategy h17;
+    h17.initialize("h17_das");
+    CHECK(play(h17, 11, CardRank::Ace, 0.0f, false) == Action::Double);
+    CHECK(play(h17, 11, CardRank::Ace, -2.0f, false) == Action::Double);
+}
+
+} // namespace
+
+int main() {
+    surrenderOutranksIndexPlays();
+    fab4SurrenderBeforeStand();
+    elevenVersusAce();
+    return TEST_RESULT();
+}
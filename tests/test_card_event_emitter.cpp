@@ -0,0 +1,115 @@
+#include "test_check.hpp"
+#include "vision/postprocessing/card_event_emitter.hpp"
+
+#include <vector>
+
+using core::CardEventType;
+using core::Detection;
+using vision::CardEventEmitter;
+using vision::CardTracker;
+
+namespace {
+
+constexpr uint64_t FRAME_NS = 16'666'667;  // 60 fps
+constexpr uint32_t OCCLUDED_FRAMES = 45;   // Past the tracker's 30-frame max age
+constexpr uint32_t GONE_FRAMES = 180;      // Past the reacquire window
+
+struct EventLog {
+    uint32_t dealt{0};
+    uint32_t removed{0};
+    uint32_t lastTrackId{0};
+};
+
+class Table {
+public:
+    Table() { m_emitter.configure(5, 0.75f); }
+
+    // Runs frames frames showing cards (empty: nothing visible)
+    EventLog run(uint32_t frames, const std::vector<Detection>& cards) {
+        EventLog log;
+        for (uint32_t i = 0; i < frames; i++) {
+            m_timestamp += FRAME_NS;
+            m_tracker.update(cards);
+            for (const auto& event : m_emitter.update(m_tracker, m_timestamp)) {
+                if (event.type == CardEventType::CardDealt) log.dealt++;
+                if (event.type == CardEventType::CardRemoved) log.removed++;
+                log.lastTrackId = event.track_id;
+            }
+        }
+        return log;
+    }
+
+    const CardEventEmitter& emitter() const { return m_emitter; }
+
+private:
+    CardTracker m_tracker;
+    CardEventEmitter m_emitter;
+    uint64_t m_timestamp{0};
+};
+
+Detection card(uint8_t cardId, float x, float y) {
+    return {x, y, 120.0f, 170.0f, cardId, 0.9f, 0};
+}
+
+// A hand covers the card until its track drops; it reappears a little
+// off and must not be dealt a second time
+void occludeAndReappear() {
+    Table table;
+    const EventLog dealt = table.run(10, {card(0, 600, 500)});
+    CHECK(dealt.dealt == 1);
+
+    const EventLog occluded = table.run(OCCLUDED_FRAMES, {});
+    CHECK(occluded.dealt == 0 && occluded.removed == 0);
+
+    const EventLog back = table.run(10, {card(0, 630, 510)});
+    CHECK(back.dealt == 0 && back.removed == 0);
+    CHECK(table.emitter().getCardsDealt() == 1);
+
+    // Picked up for good: one removal, under the id it was dealt with
+    const EventLog gone = table.run(GONE_FRAMES, {});
+    CHECK(gone.removed == 1);
+    CHECK(gone.lastTrackId == dealt.lastTrackId);
+}
+
+// A different card in the same spot is a new card
+void differentCardIsDealt() {
+    Table table;
+    table.run(10, {card(0, 600, 500)});
+    table.run(OCCLUDED_FRAMES, {});
+
+    const EventLog next = table.run(10, {card(14, 600, 500)});
+    CHECK(next.dealt == 1);
+    CHECK(table.emitter().getCardsDealt() == 2);
+}
+
+// The same card far from where it vanished is another copy from the shoe
+void distantSameCardIsDealt() {
+    Table table;
+    table.run(10, {card(0, 600, 500)});
+    table.run(OCCLUDED_FRAMES, {});
+
+    const EventLog next = table.run(10, {card(0, 1300, 500)});
+    CHECK(next.dealt == 1);
+}
+
+// Hidden past the window: removed, then dealt again when it shows up
+void lateReturnIsDealt() {
+    Table table;
+    table.run(10, {card(0, 600, 500)});
+
+    const EventLog gone = table.run(GONE_FRAMES, {});
+    CHECK(gone.removed == 1);
+
+    const EventLog back = table.run(10, {card(0, 600, 500)});
+    CHECK(back.dealt == 1);
+}
+
+} // namespace
+
+int main() {
+    occludeAndReappear();
+    differentCardIsDealt();
+    distantSameCardIsDealt();
+    lateReturnIsDealt();
+    return TEST_RESULT();
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal checks for the test executables: report every failure, exit 1 if any
+inline int g_failures = 0;
+
+#define CHECK(condition)                                                          \
+    do {                                                                          \
+        if (!(condition)) {                                                       \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, \
+                         #condition);                                             \
+            g_failures++;                                                         \
+        }                                                                         \
+    } while (0)
+
+#define TEST_RESULT() (g_failures == 0 ? 0 : 1)
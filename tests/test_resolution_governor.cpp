@@ -0,0 +1,60 @@
+#include "test_check.hpp"
+#include "pipeline/resolution_governor.hpp"
+
+using pipeline::ResolutionGovernor;
+
+namespace {
+
+constexpr uint64_t BUDGET_NS = 8'000'000;
+constexpr float CONFIDENCE_THRESHOLD = 0.5f;
+constexpr uint32_t PROFILES[] = {640, 960, 1280};
+constexpr uint32_t FRAMES = 200;  // Several hold windows
+
+// Frames well inside the budget with confident detections: room to step up
+void reportSlack(ResolutionGovernor& governor) {
+    governor.report(BUDGET_NS / 4, 0.9f, 3);
+}
+
+uint32_t settle(ResolutionGovernor& governor, uint32_t roiSize) {
+    uint32_t profile = 0;
+    for (uint32_t i = 0; i < FRAMES; i++) profile = governor.select(PROFILES, roiSize);
+    return profile;
+}
+
+// The table ROI caps the profile at the first input that holds it
+void smallerRoiSmallerProfile() {
+    ResolutionGovernor small(BUDGET_NS, CONFIDENCE_THRESHOLD);
+    ResolutionGovernor medium(BUDGET_NS, CONFIDENCE_THRESHOLD);
+    ResolutionGovernor large(BUDGET_NS, CONFIDENCE_THRESHOLD);
+    reportSlack(small);
+    reportSlack(medium);
+    reportSlack(large);
+
+    CHECK(settle(small, 600) == 0);
+    CHECK(settle(medium, 900) == 1);
+    CHECK(settle(large, 1920) == 2);
+}
+
+// A table ROI that shrinks brings a large profile back down
+void shrinkingRoiStepsDown() {
+    ResolutionGovernor governor(BUDGET_NS, CONFIDENCE_THRESHOLD);
+    reportSlack(governor);
+    CHECK(settle(governor, 1920) == 2);
+    CHECK(settle(governor, 600) == 0);
+}
+
+// A hard scene may go past the ROI's size for the small-object gain
+void hardSceneIgnoresRoi() {
+    ResolutionGovernor governor(BUDGET_NS, CONFIDENCE_THRESHOLD);
+    for (uint32_t i = 0; i < FRAMES; i++) governor.report(BUDGET_NS / 4, 0.2f, 3);
+    CHECK(settle(governor, 600) == 2);
+}
+
+} // namespace
+
+int main() {
+    smallerRoiSmallerProfile();
+    shrinkingRoiStepsDown();
+    hardSceneIgnoresRoi();
+    return TEST_RESULT();
+}
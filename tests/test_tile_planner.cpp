@@ -0,0 +1,68 @@
+#include "test_check.hpp"
+#include "vision/inference/tile_planner.hpp"
+
+using capture::ROI;
+using vision::TilePlanner;
+
+namespace {
+
+constexpr uint32_t FRAME_WIDTH = 1920;
+constexpr uint32_t FRAME_HEIGHT = 1080;
+constexpr ROI NO_TABLE{0, 0, 0, 0};
+
+bool contains(const ROI& outer, const ROI& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.width <= outer.x + outer.width &&
+           inner.y + inner.height <= outer.y + outer.height;
+}
+
+// Two tracked cards on a 1080p frame: one native-scale crop around each
+void twoCardsTwoCrops() {
+    TilePlanner planner(416, 8);
+    const ROI cards[] = {{600, 500, 120, 170}, {1300, 520, 118, 168}};
+
+    const auto& tiles = planner.plan(FRAME_WIDTH, FRAME_HEIGHT, cards, NO_TABLE);
+    CHECK(tiles.size() == 2);
+    if (tiles.size() != 2) return;
+    for (size_t i = 0; i < 2; i++) {
+        CHECK(contains(tiles[i], cards[i]));
+        CHECK(tiles[i].width < FRAME_WIDTH / 4 && tiles[i].height < FRAME_HEIGHT / 4);
+    }
+}
+
+// Nothing tracked: the table ROI, else the whole frame
+void untrackedScansTable() {
+    TilePlanner planner(416, 8);
+    const ROI table{200, 150, 1500, 800};
+
+    const auto& tableTiles = planner.plan(FRAME_WIDTH, FRAME_HEIGHT, {}, table);
+    CHECK(!tableTiles.empty());
+    for (const auto& tile : tableTiles) CHECK(contains(table, tile));
+
+    const auto& frameTiles = planner.plan(FRAME_WIDTH, FRAME_HEIGHT, {}, NO_TABLE);
+    CHECK(frameTiles.size() == 1);
+    CHECK(frameTiles.size() == 1 && frameTiles[0].width == FRAME_WIDTH && frameTiles[0].height == FRAME_HEIGHT);
+}
+
+// While tracking, every RESCAN_INTERVAL-th frame scans for new cards
+void rescansWhileTracking() {
+    TilePlanner planner(416, 8);
+    const ROI cards[] = {{600, 500, 120, 170}};
+
+    for (uint32_t i = 0; i < TilePlanner::RESCAN_INTERVAL; i++) {
+        CHECK(planner.plan(FRAME_WIDTH, FRAME_HEIGHT, cards, NO_TABLE).size() == 1);
+    }
+    const auto& scan = planner.plan(FRAME_WIDTH, FRAME_HEIGHT, cards, NO_TABLE);
+    CHECK(scan.size() == 1 && scan[0].width == FRAME_WIDTH);
+    const auto& next = planner.plan(FRAME_WIDTH, FRAME_HEIGHT, cards, NO_TABLE);
+    CHECK(next.size() == 1 && contains(next[0], cards[0]) && next[0].width < FRAME_WIDTH);
+}
+
+} // namespace
+
+int main() {
+    twoCardsTwoCrops();
+    untrackedScansTable();
+    rescansWhileTracking();
+    return TEST_RESULT();
+}